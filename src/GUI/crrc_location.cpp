@@ -54,8 +54,11 @@ CGUILocationDialog::CGUILocationDialog()
   std::vector<std::string> extlist;
   std::vector<std::string> fileslist;
   std::vector<std::string> locationslist;
+  std::vector<std::string> candidates;
   extlist.push_back("xml");
   
+  // sceneries may have been installed or removed in the meantime
+  FileSysTools::invalidateDataPaths();
   T_Config::getLocationDirs(paths);
   
   for (unsigned int i = 0; i < paths.size(); i++)
@@ -69,47 +72,52 @@ CGUILocationDialog::CGUILocationDialog()
     }
     else
     {
-     while ((ent = readdir(dir)) != NULL)
+      while ((ent = readdir(dir)) != NULL)
       {
-        std::string tmp;
-        bool        fMatch = false;
-        
-        tmp = ent->d_name;
+        candidates.push_back(paths[i] + "/" + ent->d_name);
+      }
+      closedir(dir);
+    }
+  }
+
+  // sceneries in mounted data packs
+  FileSysTools::getArchiveFiles(candidates, "scenery");
+
+  for (unsigned int i = 0; i < candidates.size(); i++)
+  {
+    std::string fullpath = candidates[i];
+    bool        fMatch = false;
         
-        for (unsigned int n=0; n<extlist.size() && fMatch == false; n++)
-        {
-          if (T_GUI_Util::checkExtension(tmp, extlist[n]))
-            fMatch = true;
-        }
+    for (unsigned int n=0; n<extlist.size() && fMatch == false; n++)
+    {
+      if (T_GUI_Util::checkExtension(fullpath, extlist[n]))
+        fMatch = true;
+    }
                    
-        if (fMatch)
-        {
-        std::string fullpath = paths[i] + "/" + tmp;
-          //std::cout << fullpath << std::endl;
-        SimpleXMLTransfer *loc = NULL;
-        bool ok=false;
-        std::string name;
-        try
-        {
-          loc = new SimpleXMLTransfer(fullpath);
-          name = loc->getChild("name")->getContentString();
-          ok=true;
-        }
-        catch (XMLException e)
-        {
-          std::cerr << "Caught XML exception in CGUIlocationSelectDialog" << std::endl;
-        }
-        if(ok)
-        {
-          fileslist.push_back(fullpath);
-          locationslist.push_back(name);
-          if(name.compare(curLocName)==0) curLocIndex= lists_index;
-          lists_index++;
-        }
-        delete loc;
-        }
+    if (fMatch)
+    {
+      //std::cout << fullpath << std::endl;
+      SimpleXMLTransfer *loc = NULL;
+      bool ok=false;
+      std::string name;
+      try
+      {
+        loc = new SimpleXMLTransfer(fullpath);
+        name = loc->getChild("name")->getContentString();
+        ok=true;
       }
-      closedir(dir);
+      catch (XMLException e)
+      {
+        std::cerr << "Caught XML exception in CGUIlocationSelectDialog" << std::endl;
+      }
+      if(ok)
+      {
+        fileslist.push_back(fullpath);
+        locationslist.push_back(name);
+        if(name.compare(curLocName)==0) curLocIndex= lists_index;
+        lists_index++;
+      }
+      delete loc;
     }
   }
   filesList = T_GUI_Util::loadnames(fileslist, filesListSize);
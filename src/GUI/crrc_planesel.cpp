@@ -37,10 +37,9 @@
 #include "../mod_fdm/formats/airtoxml.h"
 #include "../mod_fdm/xmlmodelfile.h"
 #include "util.h"
+#include "modelcatalog.h"
 
 #include <iostream>
-#include <sys/types.h>
-#include <dirent.h>
 #include <string>
 
 static void CGUIPlaneSelCallback(puObject *obj);
@@ -63,8 +62,8 @@ CGUIPlaneSelectDialog::CGUIPlaneSelectDialog()
             : CRRCDialog(),
               cat(NULL), catList(NULL), catListSize(0),
               planes(NULL), planeList(NULL), planeListSize(0),
-              gbox(NULL), optsGraphics(NULL), nOptsGraphics(0), optsGrpGraphics(NULL),
-              cbox(NULL), optsConfig(NULL), nOptsConfig(0), optsGrpConfig(NULL),
+              gbox(NULL), optsGraphics(NULL), nOptsGraphics(0),
+              cbox(NULL), optsConfig(NULL), nOptsConfig(0),
               location_label(NULL)
 {
   // height of a text label
@@ -145,7 +144,9 @@ CGUIPlaneSelectDialog::CGUIPlaneSelectDialog()
   preview->setLabelPlace(PUPLACE_TOP_LEFT);
   preview->setLabel("Preview:");
 
-  // Airplane category selection combo box
+  // Airplane category selection combo box. Models may have been
+  // installed or removed in the meantime.
+  FileSysTools::invalidateDataPaths();
   updateCategories();
   cat = new puaComboBox( DLG_DEF_SPACE,
                         BUTTON_BOX_HEIGHT + 6*DLG_DEF_SPACE 
@@ -228,62 +229,6 @@ CGUIPlaneSelectDialog::~CGUIPlaneSelectDialog()
 }
 
 
-/** 
- *  Scans all model directories for .air and .xml files
- *  and adds their complete paths to the mfiles vector.
- */
-void CGUIPlaneSelectDialog::createMFileList(std::vector<std::string>& filelist)
-{
-  std::vector<std::string> paths;
-  DIR *dir;
-  struct dirent *ent;
-  std::vector<std::string> extlist;
-
-  filelist.clear();
-
-  // allowed extensions:
-  extlist.push_back("xml");
-  extlist.push_back("air");
-  
-  T_Config::getModelDirs(paths);
-
-  for (unsigned int i = 0; i < paths.size(); i++)
-  {
-    if ((dir = opendir(paths[i].c_str())) == NULL)
-    {
-      #ifdef DEBUG_GUI
-      std::cerr << "createMFileList(): unable to open directory " << paths[i];
-      std::cerr << std::endl; 
-      #endif
-    }
-    else
-    {
-      while ((ent = readdir(dir)) != NULL)
-      {
-        std::string tmp;
-        bool        fMatch = false;
-        
-        tmp = ent->d_name;
-        
-        for (unsigned int n=0; n<extlist.size() && fMatch == false; n++)
-        {
-          if (T_GUI_Util::checkExtension(tmp, extlist[n]))
-            fMatch = true;
-        }
-                   
-        if (fMatch)
-        {
-          std::string fullpath = paths[i] + "/" + tmp;
-          //std::cout << fullpath << std::endl;
-          filelist.push_back(fullpath);
-        }
-      }
-      closedir(dir);
-    }
-  }
-}
-
-
 /**
  *  Update the list for the category combo box
  *
@@ -291,9 +236,6 @@ void CGUIPlaneSelectDialog::createMFileList(std::vector<std::string>& filelist)
 void CGUIPlaneSelectDialog::updateCategories()
 {
   std::vector<std::string> cats;
-  std::vector<std::string> mfiles;
-
-  createMFileList(mfiles);
 
   if (catList != NULL)
   {
@@ -302,109 +244,12 @@ void CGUIPlaneSelectDialog::updateCategories()
     catListSize = 0;
   }
 
-  cats.push_back("All models");
-  
-  for (unsigned int i = 0; i < mfiles.size(); i++)
-  {
-    SimpleXMLTransfer *model = NULL;
-    try
-    {
-      model = new SimpleXMLTransfer(mfiles[i]);
-      SimpleXMLTransfer *xmlcateg = model->getChild("categories");
-      int numcats = xmlcateg->getChildCount();
-      
-      for (int k = 0; k < numcats; k++)
-      {
-        std::string currcat = xmlcateg->getChildAt(k)->getContentString();
-        bool found = false;
-        
-        std::vector<std::string>::iterator it = cats.begin();
-        it++;   // Allways start behind "All models"
-
-        while ((it != cats.end()) && (!found))
-        {
-          int c = currcat.compare(*it);
-          
-          if (c == 0)
-          {
-            // found a duplicate
-            found = true;
-          }
-          else if (c < 0)
-          {
-            // next item is lexicographically greater, insert
-            // current item right here
-            cats.insert(it, currcat);
-            found = true;
-          }
-          it++;
-        }
-        
-        if (!found)
-        {
-          // new category, lexicographically greater than all
-          // existing categories
-          cats.push_back(currcat);
-        }
-      }
-    }
-    catch (XMLException e)
-    {
-      // don't worry if child does not exist or a file isn't XML
-    }
-    delete model;
-  }
+  // only reads model files which are new or have been changed
+  T_ModelCatalog::update();
+  T_ModelCatalog::getCategories(cats);
+  cats.insert(cats.begin(), "All models");
 
   catList = T_GUI_Util::loadnames(cats, catListSize);
-  
-}
-
-
-/**
- * Get all planes of a given category.
- * \param planes list of planes with complete path
- * \param category the selected category
- */
-void CGUIPlaneSelectDialog::getPlanesByCategory(std::vector<std::string>& planes,
-                                                std::string category)
-{
-  std::vector<std::string> mfiles;
-  
-  planes.clear();
-  createMFileList(mfiles);
-  
-  if (category == "All models")
-  {
-    planes = mfiles;
-  }
-  else
-  {
-    for (unsigned int i = 0; i < mfiles.size(); i++)
-    {
-      SimpleXMLTransfer *model = NULL;
-      try
-      {
-        model = new SimpleXMLTransfer(mfiles[i]);
-        SimpleXMLTransfer *xmlcateg = model->getChild("categories");
-        int numcats = xmlcateg->getChildCount();
-        
-        for (int k = 0; k < numcats; k++)
-        {
-          std::string currcat = xmlcateg->getChildAt(k)->getContentString();
-          if (currcat == category)
-          {
-            planes.push_back(mfiles[i]);
-            break;
-          }
-        }
-      }
-      catch (XMLException e)
-      {
-        // don't worry if child does not exist or a file isn't XML
-      }
-      delete model;
-    }
-  }
 }
 
 
@@ -415,7 +260,8 @@ void CGUIPlaneSelectDialog::getPlanesByCategory(std::vector<std::string>& planes
 void CGUIPlaneSelectDialog::updatePlaneList()
 {
   std::vector<std::string> pnames;
-  std::vector<std::string> paths_temp;
+  std::vector<const T_ModelCatalog::T_Entry*> models;
+  std::string category = cat->getStringValue();
   
   plane_paths.clear();
   
@@ -426,42 +272,14 @@ void CGUIPlaneSelectDialog::updatePlaneList()
     planeListSize = 0;
   }
 
-  // get a list of all planes in the category selected by the combo box
-  getPlanesByCategory(paths_temp, cat->getStringValue());
-  
-  // walk through temporary array and copy to pnames and plane_paths,
+  // get a list of all planes in the category selected by the combo box,
   // sorted by model names
-  for (unsigned int i = 0; i < paths_temp.size(); i++)
+  T_ModelCatalog::getModels(models, (category == "All models") ? "" : category);
+  
+  for (unsigned int i = 0; i < models.size(); i++)
   {
-    std::string name = getModelName(paths_temp[i]);
-    
-    std::vector<std::string>::iterator name_it = pnames.begin();
-    std::vector<std::string>::iterator path_it = plane_paths.begin();
-    bool found = false;
-    
-    while ((name_it != pnames.end()) && !found)
-    {
-      int c = name.compare(*name_it);
-      
-      if (c <= 0)
-      {
-        // duplicate name or next element is lexicographically greater,
-        // insert current item here
-        pnames.insert(name_it, name);
-        plane_paths.insert(path_it, paths_temp[i]);
-        found = true;
-      }
-      
-      name_it++;
-      path_it++;
-    }
-    
-    if (!found)
-    {
-      // current item goes to the end of the list
-      pnames.push_back(name);
-      plane_paths.push_back(paths_temp[i]);
-    }
+    pnames.push_back(models[i]->name);
+    plane_paths.push_back(models[i]->path);
   }
 
   // create a list of all names that can be used by the PUI widget
@@ -474,70 +292,6 @@ void CGUIPlaneSelectDialog::updatePlaneList()
 }
 
 
-/**
- *  Get the name of an airplane model. This should be specified
- *  in the XML file. If not, the name will be derived from the
- *  file name.
- *
- *  \param path model file with full path
- *  \return name of the model
- */
-std::string CGUIPlaneSelectDialog::getModelName(std::string path)
-{
-  std::string name = "";
-  SimpleXMLTransfer *model = NULL;
-  
-  // first we try to read the name from the XML file
-  try
-  {
-    model = new SimpleXMLTransfer(path);
-    name = model->getChild("name.en")->getContentString();
-  }
-  catch (XMLException e)
-  {
-    #ifdef DEBUG_GUI
-    std::cerr << "Caught XML exception in CGUIPlaneSelectDialog::getModelName:" << std::endl;
-    std::cerr << "  " << e.what() << std::endl;
-    std::cerr << "  file " << path << std::endl;
-    #endif
-  }
-  delete model;
-
-  // name still empty? then we had no luck with the XML file...
-  if (name == "")
-  {
-    std::string::size_type dot_index;
-    std::string::size_type slash_index;
-    
-    dot_index = path.find_last_of('.');
-    if (dot_index == std::string::npos)
-    {
-      // path did not contain a dot, take everything up to the end
-      dot_index = path.length() - 1;
-    }
-
-    slash_index = path.find_last_of('/');
-    if (slash_index == std::string::npos)
-    {
-      // path did not contain a slash, take everything from the beginning
-      slash_index = 0;
-    }
-    
-    if (slash_index >= dot_index)
-    {
-      // something is terribly wrong, there is a slash after the last dot!
-      // just take the whole path and let the caller decide what to do...
-      slash_index = 0;
-      dot_index = path.length() -1;
-    }
-    
-    name = path.substr(slash_index + 1, (dot_index - slash_index) - 1);
-  }
-  
-  return name;
-}
-
-
 /**
  *  Free the configuration and graphics selection combo boxes
  *  and their related lists.
@@ -577,17 +331,14 @@ void CGUIPlaneSelectDialog::updateFileInfo()
     location_label_string += plane_paths[entry];
     location_label->setLabel(location_label_string.c_str());
     
+    const T_ModelCatalog::T_Entry* model = T_ModelCatalog::find(plane_paths[entry]);
+
     // Update the description box and launch default checkbox
     description_string = "";
-    try
+    if (model != NULL)
     {
-      SimpleXMLTransfer *model = new SimpleXMLTransfer(plane_paths[entry]);
-      description_string = model->getChild("description.en")->getContentString();
-      // The test for a "launch" child shouldn't throw an exception,
-      // so we let it create the child if the test fails and then
-      // test for its children to see if it was a real "launch" tag
-      SimpleXMLTransfer *launch = model->getChild("launch", true);
-      if (launch->getChildCount() > 0)
+      description_string = model->description;
+      if (model->fLaunch)
       {
         check_usedefault->setValue((int)cfgfile->getInt("airplane.use_default_launch", 1));
         check_usedefault->activate();
@@ -597,15 +348,6 @@ void CGUIPlaneSelectDialog::updateFileInfo()
         check_usedefault->setValue(1);  // always use "default" if there are no options
         check_usedefault->greyOut();
       }
-      delete model;
-    }
-    catch (XMLException e)
-    {
-      #ifdef DEBUG_GUI
-      std::cerr << "Caught XML exception in CGUIPlaneSelectDialog::updateFileInfo:" << std::endl;
-      std::cerr << "  " << e.what() << std::endl;
-      std::cerr << "  file " << plane_paths[entry] << std::endl;
-      #endif
     }
     description_string = T_GUI_Util::trimWhitespace(description_string);
     description_string = T_GUI_Util::breakLines(description_string, 64);
@@ -615,47 +357,13 @@ void CGUIPlaneSelectDialog::updateFileInfo()
     // clean up the configuration option boxes
     cleanUpConfigAndGraphics();
     
-    // Check if there are any configuration options
-    try
+    // configuration options, if the file could be read
+    if (model != NULL && model->graphics.size() > 0)
     {
-      SimpleXMLTransfer* xml = new SimpleXMLTransfer(plane_paths[entry]);
-
-      if (XMLModelFile::ListOptions(xml))
-      {
-        optsGrpGraphics = xml->getChild("options.graphics");
-        optsGrpConfig   = xml->getChild("options.config");
-        optsGraphics    = T_GUI_Util::loadnames(optsGrpGraphics, nOptsGraphics, false);
-        optsConfig      = T_GUI_Util::loadnames(optsGrpConfig, nOptsConfig, false);
-      }
-      else
-      {
-        optsGraphics = (char **) malloc(2 * sizeof(char *));
-        optsGraphics[0] = strdup("default");
-        optsGraphics[1] = NULL;
-        nOptsGraphics = 1;
-
-        optsConfig = (char **) malloc(2 * sizeof(char *));
-        optsConfig[0] = strdup("default");
-        optsConfig[1] = NULL;
-        nOptsConfig = 1;
-
-        // no options
-        optsGrpGraphics = NULL;
-        optsGrpConfig = NULL;
-      }
+      optsGraphics = T_GUI_Util::loadnames(model->graphics, nOptsGraphics);
+      optsConfig   = T_GUI_Util::loadnames(model->config, nOptsConfig);
       gbox->newList(optsGraphics);
       cbox->newList(optsConfig);
-      
-      delete xml;
-    }
-    catch (XMLException e)
-    {
-      #ifdef DEBUG_GUI
-      std::string msg = "Error opening airplane specification file: ";
-      msg += plane_paths[entry];
-      msg += ": ";
-      msg += e.what();
-      #endif
     }
   }
 }
@@ -667,7 +375,6 @@ void CGUIPlaneSelectDialog::updateFileInfo()
  */
 void CGUIPlaneSelectDialog::updatePreview()
 {
-  SimpleXMLTransfer *xml = NULL;
   int graphics = 0;
   int entry;
   std::string modelFile;
@@ -683,33 +390,10 @@ void CGUIPlaneSelectDialog::updatePreview()
   {
     graphics = gbox->getCurrentItem();
 
-    try 
-    {
-      xml = new SimpleXMLTransfer(fname);
-      for (int i = 0; i < xml->getChildCount(); i++) 
-      {
-        SimpleXMLTransfer *child = xml->getChildAt(i);
-        if (!child->getName().compare("graphics") && (graphics-- == 0))
-        {
-          modelFile = child->getString("model");
-          break;
-        }
-      }
-      delete xml;
-    }
-    catch (XMLException e)
-    {
-      if (xml) 
-      {
-        delete xml;
-      }
-      #ifdef DEBUG_GUI
-      std::string msg = "Error opening airplane specification file: ";
-      msg += fname;
-      msg += ": ";
-      msg += e.what();
-      #endif
-    }
+    const T_ModelCatalog::T_Entry* model = T_ModelCatalog::find(fname);
+
+    if (model != NULL && graphics >= 0 && graphics < (int)model->models.size())
+      modelFile = model->models[graphics];
 
     std::string objectFile = FileSysTools::getDataPath("objects/" + modelFile);
     std::string texturePath  = objectFile.substr(0, objectFile.length() - modelFile.length() - 1 - 7) + "textures";
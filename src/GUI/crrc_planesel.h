@@ -81,12 +81,10 @@ class CGUIPlaneSelectDialog : public CRRCDialog
     puaComboBox    *gbox;
     char**        optsGraphics;
     int           nOptsGraphics;
-    SimpleXMLTransfer* optsGrpGraphics;
 
     puaComboBox    *cbox;
     char**        optsConfig;
     int           nOptsConfig;
-    SimpleXMLTransfer* optsGrpConfig;
   
     puText        *location_label;
     std::string   location_label_string;
@@ -96,18 +94,9 @@ class CGUIPlaneSelectDialog : public CRRCDialog
     
     puButton      *check_usedefault;
   
-    /// Fill the mfiles vector with the paths of all model files
-    void  createMFileList(std::vector<std::string>& filelist);
-    
     /// Assign a list of categories to the catList
     void  updateCategories();
     
-    /// Get all planes of one category
-    void  getPlanesByCategory(std::vector<std::string>& planes, std::string category);
-    
-    /// Get the name of a model
-    std::string getModelName(std::string path);
-    
     /// Clean up config boxes
     void cleanUpConfigAndGraphics();
     
@@ -0,0 +1,515 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+  
+
+// implementation of class T_ModelCatalog
+
+#include "modelcatalog.h"
+#include "util.h"
+#include "../config.h"
+#include "../mod_misc/SimpleXMLTransfer.h"
+#include "../mod_misc/filesystools.h"
+#include "../mod_fdm/xmlmodelfile.h"
+
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+/// Changes whenever the index holds something new
+#define CATALOG_VERSION  (1)
+
+//#define DEBUG_GUI
+
+T_ModelCatalog::T_EntryMap T_ModelCatalog::entries;
+bool                       T_ModelCatalog::fLoaded = false;
+
+
+/**
+ *  Derive the name of a model from the name of its file
+ *
+ *  \param path model file with full path
+ *  \return name of the model
+ */
+static std::string getNameFromPath(std::string path)
+{
+  std::string::size_type dot_index;
+  std::string::size_type slash_index;
+
+  dot_index = path.find_last_of('.');
+  if (dot_index == std::string::npos)
+  {
+    // path did not contain a dot, take everything up to the end
+    dot_index = path.length() - 1;
+  }
+
+  slash_index = path.find_last_of('/');
+  if (slash_index == std::string::npos)
+  {
+    // path did not contain a slash, take everything from the beginning
+    slash_index = 0;
+  }
+
+  if (slash_index >= dot_index)
+  {
+    // something is terribly wrong, there is a slash after the last dot!
+    // just take the whole path and let the caller decide what to do...
+    slash_index = 0;
+    dot_index = path.length() -1;
+  }
+
+  return (path.substr(slash_index + 1, (dot_index - slash_index) - 1));
+}
+
+
+static bool compareNames(const T_ModelCatalog::T_Entry* a,
+                         const T_ModelCatalog::T_Entry* b)
+{
+  return (a->name < b->name);
+}
+
+
+static std::string unsignedToString(unsigned int n)
+{
+  char buf[16];
+
+  sprintf(buf, "%u", n);
+  return (std::string(buf));
+}
+
+
+// see header
+void T_ModelCatalog::update()
+{
+  std::vector<std::string> mfiles;
+  T_EntryMap               current;
+  bool                     fChanged = false;
+
+  if (!fLoaded)
+  {
+    loadIndex();
+    fLoaded = true;
+  }
+
+  createFileList(mfiles);
+
+  for (unsigned int i = 0; i < mfiles.size(); i++)
+  {
+    struct stat          st;
+    T_EntryMap::iterator it = entries.find(mfiles[i]);
+    T_Entry&             entry = current[mfiles[i]];
+
+    if (stat(mfiles[i].c_str(), &st) != 0)
+    {
+      // files in a data pack change with the pack
+      std::string            item;
+      FileSysTools::Archive* pack = FileSysTools::findArchive(mfiles[i], item);
+
+      if (pack == NULL || stat(pack->getPath().c_str(), &st) != 0)
+      {
+        st.st_size  = 0;
+        st.st_mtime = 0;
+      }
+    }
+
+    if (it != entries.end()
+        && it->second.size  == (unsigned int)st.st_size
+        && it->second.mtime == (unsigned int)st.st_mtime)
+    {
+      entry = it->second;
+    }
+    else
+    {
+      entry.path  = mfiles[i];
+      entry.size  = (unsigned int)st.st_size;
+      entry.mtime = (unsigned int)st.st_mtime;
+      readEntry(entry);
+      fChanged = true;
+    }
+  }
+
+  // files which have been removed
+  if (current.size() != entries.size())
+    fChanged = true;
+
+  entries.swap(current);
+
+  if (fChanged)
+    saveIndex();
+}
+
+
+// see header
+void T_ModelCatalog::getCategories(std::vector<std::string>& cats)
+{
+  std::set<std::string> found;
+
+  for (T_EntryMap::iterator it = entries.begin(); it != entries.end(); it++)
+  {
+    found.insert(it->second.categories.begin(), it->second.categories.end());
+  }
+
+  cats.assign(found.begin(), found.end());
+}
+
+
+// see header
+void T_ModelCatalog::getModels(std::vector<const T_Entry*>& models, std::string category)
+{
+  models.clear();
+
+  for (T_EntryMap::iterator it = entries.begin(); it != entries.end(); it++)
+  {
+    std::vector<std::string>& cats = it->second.categories;
+
+    if (category == "" || std::find(cats.begin(), cats.end(), category) != cats.end())
+      models.push_back(&it->second);
+  }
+
+  std::stable_sort(models.begin(), models.end(), compareNames);
+}
+
+
+// see header
+const T_ModelCatalog::T_Entry* T_ModelCatalog::find(std::string path)
+{
+  T_EntryMap::iterator it = entries.find(path);
+
+  if (it == entries.end())
+    return (NULL);
+  else
+    return (&it->second);
+}
+
+
+/**
+ *  Scans all model directories for .air and .xml files
+ *  and adds their complete paths to filelist.
+ */
+void T_ModelCatalog::createFileList(std::vector<std::string>& filelist)
+{
+  std::vector<std::string> paths;
+  DIR *dir;
+  struct dirent *ent;
+  std::vector<std::string> extlist;
+  std::vector<std::string> candidates;
+
+  filelist.clear();
+
+  // allowed extensions:
+  extlist.push_back("xml");
+  extlist.push_back("air");
+
+  T_Config::getModelDirs(paths);
+
+  for (unsigned int i = 0; i < paths.size(); i++)
+  {
+    if ((dir = opendir(paths[i].c_str())) == NULL)
+    {
+      #ifdef DEBUG_GUI
+      std::cerr << "createFileList(): unable to open directory " << paths[i];
+      std::cerr << std::endl;
+      #endif
+    }
+    else
+    {
+      while ((ent = readdir(dir)) != NULL)
+      {
+        candidates.push_back(paths[i] + "/" + ent->d_name);
+      }
+      closedir(dir);
+    }
+  }
+
+  // models in mounted data packs
+  FileSysTools::getArchiveFiles(candidates, "models");
+
+  for (unsigned int i = 0; i < candidates.size(); i++)
+  {
+    bool fMatch = false;
+
+    for (unsigned int n=0; n<extlist.size() && fMatch == false; n++)
+    {
+      if (T_GUI_Util::checkExtension(candidates[i], extlist[n]))
+        fMatch = true;
+    }
+
+    if (fMatch)
+      filelist.push_back(candidates[i]);
+  }
+}
+
+
+/**
+ *  Read everything the dialog needs from a model file. Files which
+ *  can't be read (like .air files) are listed by their file name only.
+ */
+void T_ModelCatalog::readEntry(T_Entry& entry)
+{
+  SimpleXMLTransfer *model = NULL;
+
+  entry.name        = "";
+  entry.description = "";
+  entry.fLaunch     = false;
+  entry.categories.clear();
+  entry.graphics.clear();
+  entry.config.clear();
+  entry.models.clear();
+
+  try
+  {
+    model = new SimpleXMLTransfer(entry.path);
+  }
+  catch (XMLException e)
+  {
+    #ifdef DEBUG_GUI
+    std::cerr << "Caught XML exception in T_ModelCatalog::readEntry:" << std::endl;
+    std::cerr << "  " << e.what() << std::endl;
+    std::cerr << "  file " << entry.path << std::endl;
+    #endif
+    model = NULL;
+  }
+
+  if (model != NULL)
+  {
+    try
+    {
+      SimpleXMLTransfer *xmlcateg = model->getChild("categories");
+
+      for (int k = 0; k < xmlcateg->getChildCount(); k++)
+        entry.categories.push_back(xmlcateg->getChildAt(k)->getContentString());
+    }
+    catch (XMLException e)
+    {
+      // don't worry if child does not exist
+    }
+
+    try
+    {
+      entry.name = model->getChild("name.en")->getContentString();
+    }
+    catch (XMLException e)
+    {
+    }
+
+    try
+    {
+      entry.description = model->getChild("description.en")->getContentString();
+    }
+    catch (XMLException e)
+    {
+    }
+
+    // The test for a "launch" child shouldn't throw an exception,
+    // so we let it create the child if the test fails and then
+    // test for its children to see if it was a real "launch" tag
+    entry.fLaunch = (model->getChild("launch", true)->getChildCount() > 0);
+
+    // model of each graphics option, for the preview
+    for (int i = 0; i < model->getChildCount(); i++)
+    {
+      SimpleXMLTransfer *child = model->getChildAt(i);
+
+      if (child->getName() == "graphics")
+      {
+        try
+        {
+          entry.models.push_back(child->getString("model"));
+        }
+        catch (XMLException e)
+        {
+          entry.models.push_back("");
+        }
+      }
+    }
+
+    // Check if there are any configuration options
+    try
+    {
+      if (XMLModelFile::ListOptions(model))
+      {
+        SimpleXMLTransfer* grp = model->getChild("options.graphics");
+        SimpleXMLTransfer* cfg = model->getChild("options.config");
+
+        for (int i = 0; i < grp->getChildCount(); i++)
+          entry.graphics.push_back(grp->getChildAt(i)->getContentString());
+        for (int i = 0; i < cfg->getChildCount(); i++)
+          entry.config.push_back(cfg->getChildAt(i)->getContentString());
+      }
+      else
+      {
+        entry.graphics.push_back("default");
+        entry.config.push_back("default");
+      }
+    }
+    catch (XMLException e)
+    {
+      entry.graphics.clear();
+      entry.config.clear();
+    }
+
+    delete model;
+  }
+
+  // name still empty? then we had no luck with the XML file...
+  if (entry.name == "")
+    entry.name = getNameFromPath(entry.path);
+}
+
+
+std::string T_ModelCatalog::getIndexFileName()
+{
+  std::string home = FileSysTools::getHomePath();
+
+  if (home == "")
+    return (home);
+  else
+    return (home + "/cache/models/catalog.xml");
+}
+
+
+/**
+ *  Read the index file. Nothing happens if there is none or it
+ *  has been written by another version.
+ */
+void T_ModelCatalog::loadIndex()
+{
+  std::string file = getIndexFileName();
+
+  entries.clear();
+  if (file == "" || !FileSysTools::fileExists(file))
+    return;
+
+  try
+  {
+    SimpleXMLTransfer index(file);
+
+    if (index.attributeAsInt("version", 0) != CATALOG_VERSION)
+      return;
+
+    for (int i = 0; i < index.getChildCount(); i++)
+    {
+      SimpleXMLTransfer* m = index.getChildAt(i);
+      T_Entry&           entry = entries[m->attribute("path")];
+
+      entry.path        = m->attribute("path");
+      entry.size        = strtoul(m->attribute("size").c_str(), NULL, 10);
+      entry.mtime       = strtoul(m->attribute("mtime").c_str(), NULL, 10);
+      entry.name        = m->attribute("name");
+      entry.description = m->attribute("description");
+      entry.fLaunch     = (m->attributeAsInt("launch") != 0);
+
+      for (int k = 0; k < m->getChildCount(); k++)
+      {
+        SimpleXMLTransfer* c = m->getChildAt(k);
+
+        if (c->getName() == "category")
+          entry.categories.push_back(c->attribute("name"));
+        else if (c->getName() == "graphics")
+          entry.graphics.push_back(c->attribute("name"));
+        else if (c->getName() == "config")
+          entry.config.push_back(c->attribute("name"));
+        else if (c->getName() == "preview")
+          entry.models.push_back(c->attribute("model"));
+      }
+    }
+  }
+  catch (XMLException e)
+  {
+    // read everything again
+    entries.clear();
+  }
+}
+
+
+/**
+ *  Add an element with one attribute
+ */
+static void addItem(SimpleXMLTransfer* parent, std::string name,
+                    std::string attribute, std::string value)
+{
+  SimpleXMLTransfer* item = new SimpleXMLTransfer();
+
+  item->setName(name);
+  item->addAttribute(attribute, value);
+  parent->addChild(item);
+}
+
+
+/**
+ *  Write the index file
+ */
+void T_ModelCatalog::saveIndex()
+{
+  std::string file = getIndexFileName();
+
+  if (file == "")
+    return;
+
+  SimpleXMLTransfer index;
+
+  index.setName("catalog");
+  index.addAttribute("version", CATALOG_VERSION);
+
+  for (T_EntryMap::iterator it = entries.begin(); it != entries.end(); it++)
+  {
+    T_Entry&           entry = it->second;
+    SimpleXMLTransfer* m     = new SimpleXMLTransfer();
+
+    m->setName("model");
+    m->addAttribute("path",        entry.path);
+    m->addAttribute("size",        unsignedToString(entry.size));
+    m->addAttribute("mtime",       unsignedToString(entry.mtime));
+    m->addAttribute("name",        entry.name);
+    m->addAttribute("description", entry.description);
+    m->addAttribute("launch",      entry.fLaunch ? "1" : "0");
+
+    for (unsigned int i = 0; i < entry.categories.size(); i++)
+      addItem(m, "category", "name", entry.categories[i]);
+    for (unsigned int i = 0; i < entry.graphics.size(); i++)
+      addItem(m, "graphics", "name", entry.graphics[i]);
+    for (unsigned int i = 0; i < entry.config.size(); i++)
+      addItem(m, "config", "name", entry.config[i]);
+    for (unsigned int i = 0; i < entry.models.size(); i++)
+      addItem(m, "preview", "model", entry.models[i]);
+
+    index.addChild(m);
+  }
+
+  FileSysTools::makeSurePathExists(file.substr(0, file.rfind('/')));
+
+  std::ofstream outfile;
+
+  outfile.open(file.c_str());
+  if (outfile)
+  {
+    index.print(outfile);
+    outfile.close();
+    if (!outfile)
+      remove(file.c_str());
+  }
+}
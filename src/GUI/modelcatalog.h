@@ -0,0 +1,99 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+  
+
+// modelcatalog.h - index of the installed airplane models
+
+#ifndef MODELCATALOG_H
+#define MODELCATALOG_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+
+/** \brief Index of all airplane models
+ *
+ *  Holds what the airplane selection dialog shows of a model, so that
+ *  the model files don't have to be read each time it is opened. The
+ *  index is kept in memory and in cache/models/catalog.xml in the user
+ *  directory. update() only reads files which have been added or whose
+ *  size or modification time have changed since they were indexed.
+ */
+class T_ModelCatalog
+{
+  public:
+    /**
+     *  What is known about one model file
+     */
+    typedef struct
+    {
+      std::string  path;           ///< full path of the file
+      unsigned int size;
+      unsigned int mtime;
+      std::string  name;           ///< name.en, derived from the file name if there is none
+      std::string  description;    ///< description.en
+      std::vector<std::string> categories;
+      bool         fLaunch;        ///< has launch presets
+      std::vector<std::string> graphics;   ///< graphics options to choose from, empty on error
+      std::vector<std::string> config;     ///< config options to choose from, empty on error
+      std::vector<std::string> models;     ///< model of each graphics (preview)
+    } T_Entry;
+
+    /**
+     *  Brings the index up to date with the model directories.
+     *  The first call also reads the index file.
+     */
+    static void update();
+
+    /**
+     *  Get the sorted list of all categories
+     */
+    static void getCategories(std::vector<std::string>& cats);
+
+    /**
+     *  Get all models of a category, sorted by name.
+     *
+     *  \param models   list of models
+     *  \param category category, "" for all models
+     */
+    static void getModels(std::vector<const T_Entry*>& models, std::string category);
+
+    /**
+     *  Get the entry of a model file, NULL if it isn't indexed.
+     */
+    static const T_Entry* find(std::string path);
+
+  private:
+    typedef std::map<std::string, T_Entry> T_EntryMap;
+
+    static void createFileList(std::vector<std::string>& filelist);
+    static void readEntry(T_Entry& entry);
+    static void loadIndex();
+    static void saveIndex();
+    static std::string getIndexFileName();
+
+    static T_EntryMap entries;
+    static bool       fLoaded;
+};
+
+#endif // MODELCATALOG_H
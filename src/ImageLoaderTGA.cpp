@@ -164,8 +164,6 @@ CImageLoaderTGA::CImageLoaderTGA(const char *filename)
   int mode;
   int total;
 
-  savedImages = 0;
-
 // open the file for reading (binary mode)
   file = fopen(filename, "rb");
   if (file == NULL) {
@@ -283,29 +281,6 @@ void CImageLoaderTGA::toGreyscale()
   imageData = newImageData;
 }
 
-/** \brief (deprecated) Take a screenshot from a GL framebuffer and save it.
- *
- *  This method reads the pixel data from the current OpenGL
- *  framebuffer and saves it as a TGA image.
- *
- *  DO NOT USE THIS METHOD, WILL BE REMOVED IN FUTURE VERSIONS
- *  OF THIS LIB!
- */
-
-int CImageLoaderTGA::GrabScreenSeries(char *filename, int x,int y, int w, int h) 
-{
-  unsigned char *imageData;
-
-  // allocate memory for the pixels
-  imageData = (unsigned char *)malloc(sizeof(unsigned char) * w * h * 4);
-
-  // read the pixels from the frame buffer
-  glReadPixels(x,y,w,h,GL_RGBA,GL_UNSIGNED_BYTE, (GLvoid *)imageData);
-
-  // save the image 
-  return(SaveSeries(filename,w,h,32,imageData));
-}
-
 /** \brief Save an array of pixels as a TGA image.
  *
  *  Comment by JR: Untested, use at your own risk!
@@ -390,31 +365,6 @@ int CImageLoaderTGA::Save(char          *filename,
   return(TGA_OK);
 }
 
-/** \brief saves a series of files with names "filenameX.tga"
- *
- *  Comment by JR: Untested, use at your own risk!
- */
-int CImageLoaderTGA::SaveSeries( char    *filename, 
-                                 short int    width, 
-                                 short int    height, 
-                                 unsigned char  pixelDepth,
-                                 unsigned char  *imageData) 
-{
-  char *newFilename;
-  int status;
-  // compute the new filename by adding the series number and the extension
-
-  newFilename = (char *)malloc(sizeof(char) * strlen(filename)+8);
-
-  sprintf(newFilename,"%s%d.tga",filename,savedImages);
-  // save the image
-  status = Save(newFilename,width,height,pixelDepth,imageData);
-  //increase the counter
-  savedImages++;
-  return(status);
-}
-
-
 /** \brief Release the memory used for the image.
  *
  *
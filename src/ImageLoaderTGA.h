@@ -132,21 +132,13 @@ class CImageLoaderTGA
               unsigned char *imageData);
 
     void toGreyscale();
-    int GrabScreenSeries(char *filename, int x,int y, int w, int h);
 
   private:
     FILE *file;
-    // this variable is used for image series
-    int savedImages;
     
     int Load(char *filename);
     void LoadHeader();
     void LoadImageData();
-    int SaveSeries (char          *filename, 
-                    short int      width, 
-                    short int      height, 
-                    unsigned char  pixelDepth,
-                    unsigned char  *imageData);
 };
 
   
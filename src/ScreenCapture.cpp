@@ -0,0 +1,535 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file ScreenCapture.cpp
+ *
+ *  Implementation of class ScreenCapture.
+ */
+
+#include "ScreenCapture.h"
+#include "global.h"
+#include "glconsole.h"
+#include "crrc_graphics.h"
+#include "ImageLoaderTGA.h"
+#include "mod_misc/SimpleXMLTransfer.h"
+#include "mod_misc/filesystools.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef GL_BGRA
+# define GL_BGRA                   0x80E1
+#endif
+#define GL_PIXEL_PACK_BUFFER_ARB   0x88EB
+#define GL_STREAM_READ_ARB         0x88E1
+#define GL_READ_ONLY_ARB           0x88B8
+
+#ifndef APIENTRY
+# define APIENTRY
+#endif
+
+// ARB_vertex_buffer_object entry points, used with ARB_pixel_buffer_object
+typedef void      (APIENTRY *T_glGenBuffersARB)(GLsizei n, GLuint* buffers);
+typedef void      (APIENTRY *T_glDeleteBuffersARB)(GLsizei n, const GLuint* buffers);
+typedef void      (APIENTRY *T_glBindBufferARB)(GLenum target, GLuint buffer);
+typedef void      (APIENTRY *T_glBufferDataARB)(GLenum target, ptrdiff_t size,
+                                                const GLvoid* data, GLenum usage);
+typedef GLvoid*   (APIENTRY *T_glMapBufferARB)(GLenum target, GLenum access);
+typedef GLboolean (APIENTRY *T_glUnmapBufferARB)(GLenum target);
+
+static T_glGenBuffersARB    p_glGenBuffersARB    = NULL;
+static T_glDeleteBuffersARB p_glDeleteBuffersARB = NULL;
+static T_glBindBufferARB    p_glBindBufferARB    = NULL;
+static T_glBufferDataARB    p_glBufferDataARB    = NULL;
+static T_glMapBufferARB     p_glMapBufferARB     = NULL;
+static T_glUnmapBufferARB   p_glUnmapBufferARB   = NULL;
+
+
+bool                         ScreenCapture::fRecording  = false;
+int                          ScreenCapture::format      = ScreenCapture::FORMAT_TGA;
+int                          ScreenCapture::fps         = 25;
+int                          ScreenCapture::num_buffers = 8;
+int                          ScreenCapture::num_pbos    = 3;
+std::string                  ScreenCapture::path;
+int                          ScreenCapture::width       = 0;
+int                          ScreenCapture::height      = 0;
+int                          ScreenCapture::frame_count = 0;
+int                          ScreenCapture::dropped     = 0;
+Uint32                       ScreenCapture::next_time   = 0;
+std::string                  ScreenCapture::basename;
+std::vector<GLuint>          ScreenCapture::pbos;
+int                          ScreenCapture::pbo_next    = 0;
+int                          ScreenCapture::pbo_pending = 0;
+std::vector<unsigned char*>  ScreenCapture::buffers;
+std::vector<unsigned char*>  ScreenCapture::free_buffers;
+std::deque<ScreenCapture::T_Frame> ScreenCapture::queue;
+std::vector<unsigned char>   ScreenCapture::yuv;
+FILE*                        ScreenCapture::stream      = NULL;
+SDL_Thread*                  ScreenCapture::thread      = NULL;
+SDL_mutex*                   ScreenCapture::mutex       = NULL;
+SDL_cond*                    ScreenCapture::cond        = NULL;
+
+
+// see header
+void ScreenCapture::init(SimpleXMLTransfer* cfg)
+{
+  std::string fmt = cfg->getString("video.capture.format", "tga");
+
+  if (fmt == "y4m")
+    format = FORMAT_Y4M;
+  else
+    format = FORMAT_TGA;
+
+  fps         = cfg->getInt("video.capture.fps", 25);
+  num_buffers = cfg->getInt("video.capture.buffers", 8);
+  num_pbos    = cfg->getInt("video.capture.pbos", 3);
+  path        = cfg->getString("video.capture.path", "");
+
+  if (fps < 1)
+    fps = 1;
+  if (num_buffers < 2)
+    num_buffers = 2;
+  if (num_pbos < 0)
+    num_pbos = 0;
+  if (path == "")
+    path = FileSysTools::getHomePath() + "/capture";
+}
+
+
+// see header
+void ScreenCapture::toggle(int w, int h)
+{
+  if (fRecording)
+    stop();
+  else
+    start(w, h);
+}
+
+
+// see header
+void ScreenCapture::start(int w, int h)
+{
+  if (fRecording)
+    return;
+
+  // YUV 4:2:0 needs even dimensions, use it for all formats
+  width       = w & ~1;
+  height      = h & ~1;
+  frame_count = 0;
+  dropped     = 0;
+  pbo_next    = 0;
+  pbo_pending = 0;
+
+  {
+    char      timestr[32];
+    time_t    now = time(NULL);
+
+    strftime(timestr, sizeof(timestr), "%Y%m%d_%H%M%S", localtime(&now));
+    FileSysTools::makeSurePathExists(path);
+    basename = path + "/crrcsim_" + timestr;
+  }
+
+  if (format == FORMAT_Y4M)
+  {
+    std::string file = basename + ".y4m";
+
+    stream = fopen(file.c_str(), "wb");
+    if (stream == NULL)
+    {
+      fprintf(stderr, "ScreenCapture: unable to write %s\n", file.c_str());
+      LOG("Unable to start recording.");
+      return;
+    }
+    fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    yuv.resize(width * height * 3 / 2);
+  }
+
+  buffers.resize(num_buffers);
+  for (int i = 0; i < num_buffers; i++)
+  {
+    buffers[i] = (unsigned char*)malloc(width * height * 4);
+  }
+  free_buffers = buffers;
+
+  if (!initPBOs())
+  {
+    printf("ScreenCapture: pixel buffer objects not available, reading frames synchronously\n");
+  }
+
+  mutex  = SDL_CreateMutex();
+  cond   = SDL_CreateCond();
+  thread = SDL_CreateThread(writerThread, NULL);
+
+  next_time  = SDL_GetTicks();
+  fRecording = true;
+  LOG("Recording started, press <F12> to stop.");
+  printf("ScreenCapture: recording %dx%d to %s\n", width, height, basename.c_str());
+}
+
+
+// see header
+void ScreenCapture::stop()
+{
+  if (!fRecording)
+    return;
+  fRecording = false;
+
+  // collect the frames which are still in transfer
+  while (pbo_pending > 0)
+  {
+    readPBO((pbo_next + num_pbos - pbo_pending) % num_pbos);
+    pbo_pending--;
+  }
+  if (pbos.size() > 0)
+  {
+    p_glDeleteBuffersARB(pbos.size(), &pbos[0]);
+    pbos.clear();
+  }
+
+  // tell the writer thread to finish after the last frame
+  {
+    T_Frame end;
+
+    end.pixels = NULL;
+    end.number = -1;
+    SDL_LockMutex(mutex);
+    queue.push_back(end);
+    SDL_CondSignal(cond);
+    SDL_UnlockMutex(mutex);
+  }
+  SDL_WaitThread(thread, NULL);
+  thread = NULL;
+  SDL_DestroyCond(cond);
+  SDL_DestroyMutex(mutex);
+  cond  = NULL;
+  mutex = NULL;
+
+  if (stream != NULL)
+  {
+    fclose(stream);
+    stream = NULL;
+  }
+
+  for (unsigned int i = 0; i < buffers.size(); i++)
+  {
+    free(buffers[i]);
+  }
+  buffers.clear();
+  free_buffers.clear();
+  yuv.clear();
+
+  printf("ScreenCapture: %d frames written, %d dropped\n", frame_count, dropped);
+  LOG("Recording stopped.");
+}
+
+
+// see header
+void ScreenCapture::captureFrame(int w, int h)
+{
+  if (!fRecording)
+    return;
+
+  if ((w & ~1) != width || (h & ~1) != height)
+  {
+    stop();
+    LOG("Window size has changed, recording stopped.");
+    return;
+  }
+
+  // limit to the frame rate of the recording
+  Uint32 now = SDL_GetTicks();
+  if ((Sint32)(now - next_time) < 0)
+    return;
+  next_time += 1000 / fps;
+  if ((Sint32)(now - next_time) > 0)
+    next_time = now;
+
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+  if (pbos.size() > 0)
+  {
+    // the oldest frame has to leave the ring first
+    if (pbo_pending == num_pbos)
+    {
+      readPBO(pbo_next);
+      pbo_pending--;
+    }
+
+    p_glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, pbos[pbo_next]);
+    glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+    p_glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    pbo_next = (pbo_next + 1) % num_pbos;
+    pbo_pending++;
+  }
+  else
+  {
+    unsigned char* buf = getFreeBuffer();
+
+    if (buf == NULL)
+    {
+      dropped++;
+      return;
+    }
+    glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, buf);
+    queueFrame(buf);
+  }
+}
+
+
+/**
+ *  Look up the buffer object functions and create the PBO ring.
+ *  Returns false if PBOs are not supported.
+ */
+bool ScreenCapture::initPBOs()
+{
+  const char* ext = (const char*)glGetString(GL_EXTENSIONS);
+
+  if (num_pbos < 2 || ext == NULL
+      ||
+      (strstr(ext, "GL_ARB_pixel_buffer_object") == NULL
+       && strstr(ext, "GL_EXT_pixel_buffer_object") == NULL))
+  {
+    return false;
+  }
+
+  p_glGenBuffersARB    = (T_glGenBuffersARB)graphics_getProcAddress("glGenBuffersARB");
+  p_glDeleteBuffersARB = (T_glDeleteBuffersARB)graphics_getProcAddress("glDeleteBuffersARB");
+  p_glBindBufferARB    = (T_glBindBufferARB)graphics_getProcAddress("glBindBufferARB");
+  p_glBufferDataARB    = (T_glBufferDataARB)graphics_getProcAddress("glBufferDataARB");
+  p_glMapBufferARB     = (T_glMapBufferARB)graphics_getProcAddress("glMapBufferARB");
+  p_glUnmapBufferARB   = (T_glUnmapBufferARB)graphics_getProcAddress("glUnmapBufferARB");
+
+  if (p_glGenBuffersARB == NULL || p_glDeleteBuffersARB == NULL
+      || p_glBindBufferARB == NULL || p_glBufferDataARB == NULL
+      || p_glMapBufferARB == NULL || p_glUnmapBufferARB == NULL)
+  {
+    return false;
+  }
+
+  pbos.resize(num_pbos);
+  p_glGenBuffersARB(num_pbos, &pbos[0]);
+  for (int i = 0; i < num_pbos; i++)
+  {
+    p_glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, pbos[i]);
+    p_glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, width * height * 4, NULL, GL_STREAM_READ_ARB);
+  }
+  p_glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+  return true;
+}
+
+
+/**
+ *  Copy the frame in a PBO to a free buffer and queue it.
+ */
+void ScreenCapture::readPBO(int pbo)
+{
+  unsigned char* buf = getFreeBuffer();
+
+  p_glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, pbos[pbo]);
+  GLvoid* src = p_glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+  if (src != NULL && buf != NULL)
+  {
+    memcpy(buf, src, width * height * 4);
+    queueFrame(buf);
+    buf = NULL;
+  }
+  else
+  {
+    dropped++;
+  }
+  if (src != NULL)
+    p_glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+  p_glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+  // not used after all
+  if (buf != NULL)
+  {
+    SDL_LockMutex(mutex);
+    free_buffers.push_back(buf);
+    SDL_UnlockMutex(mutex);
+  }
+}
+
+
+/**
+ *  Get a buffer which is not in use by the writer thread,
+ *  or NULL if there is none.
+ */
+unsigned char* ScreenCapture::getFreeBuffer()
+{
+  unsigned char* buf = NULL;
+
+  SDL_LockMutex(mutex);
+  if (free_buffers.size() > 0)
+  {
+    buf = free_buffers.back();
+    free_buffers.pop_back();
+  }
+  SDL_UnlockMutex(mutex);
+
+  return buf;
+}
+
+
+/**
+ *  Hand a frame over to the writer thread.
+ */
+void ScreenCapture::queueFrame(unsigned char* pixels)
+{
+  T_Frame frame;
+
+  frame.pixels = pixels;
+  frame.number = frame_count++;
+
+  SDL_LockMutex(mutex);
+  queue.push_back(frame);
+  SDL_CondSignal(cond);
+  SDL_UnlockMutex(mutex);
+}
+
+
+/**
+ *  Writer thread entry point
+ */
+int ScreenCapture::writerThread(void* data)
+{
+  while (true)
+  {
+    T_Frame frame;
+
+    SDL_LockMutex(mutex);
+    while (queue.empty())
+    {
+      SDL_CondWait(cond, mutex);
+    }
+    frame = queue.front();
+    queue.pop_front();
+    SDL_UnlockMutex(mutex);
+
+    if (frame.pixels == NULL)
+      break;
+
+    if (format == FORMAT_Y4M)
+      writeY4M(frame);
+    else
+      writeTGA(frame);
+
+    SDL_LockMutex(mutex);
+    free_buffers.push_back(frame.pixels);
+    SDL_UnlockMutex(mutex);
+  }
+
+  return 0;
+}
+
+
+/**
+ *  Write a frame as uncompressed 24 bit TGA. TGA stores BGR with
+ *  the bottom row first, just like glReadPixels() delivers it.
+ */
+void ScreenCapture::writeTGA(const T_Frame& frame)
+{
+  char           name[16];
+  unsigned char  header[18];
+  std::string    file;
+  FILE*          fp;
+
+  sprintf(name, "_%05d.tga", frame.number);
+  file = basename + name;
+  fp = fopen(file.c_str(), "wb");
+  if (fp == NULL)
+  {
+    fprintf(stderr, "ScreenCapture: unable to write %s\n", file.c_str());
+    return;
+  }
+
+  memset(header, 0, sizeof(header));
+  header[2]  = TGA_TYPE_RGBA_UNCOMPRESSED;
+  header[12] = width & 0xFF;
+  header[13] = (width >> 8) & 0xFF;
+  header[14] = height & 0xFF;
+  header[15] = (height >> 8) & 0xFF;
+  header[16] = 24;
+  fwrite(header, 1, sizeof(header), fp);
+
+  std::vector<unsigned char> row(width * 3);
+  for (int y = 0; y < height; y++)
+  {
+    const unsigned char* src = frame.pixels + y * width * 4;
+
+    for (int x = 0; x < width; x++)
+    {
+      row[3*x]   = src[4*x];
+      row[3*x+1] = src[4*x+1];
+      row[3*x+2] = src[4*x+2];
+    }
+    fwrite(&row[0], 1, row.size(), fp);
+  }
+  fclose(fp);
+}
+
+
+/**
+ *  Append a frame to the YUV4MPEG2 stream: full range BT.601,
+ *  chroma averaged over 2x2 pixels, top row first.
+ */
+void ScreenCapture::writeY4M(const T_Frame& frame)
+{
+  unsigned char* py = &yuv[0];
+  unsigned char* pu = py + width * height;
+  unsigned char* pv = pu + (width / 2) * (height / 2);
+
+  for (int y = 0; y < height; y += 2)
+  {
+    const unsigned char* row0 = frame.pixels + (height - 1 - y) * width * 4;
+    const unsigned char* row1 = row0 - width * 4;
+
+    for (int x = 0; x < width; x += 2)
+    {
+      const unsigned char* p[4] = { row0 + 4*x, row0 + 4*x + 4, row1 + 4*x, row1 + 4*x + 4 };
+      int r = 0;
+      int g = 0;
+      int b = 0;
+
+      for (int i = 0; i < 4; i++)
+      {
+        int Y = (77 * p[i][2] + 150 * p[i][1] + 29 * p[i][0]) >> 8;
+
+        py[(y + i/2) * width + x + (i & 1)] = (unsigned char)Y;
+        r += p[i][2];
+        g += p[i][1];
+        b += p[i][0];
+      }
+      r >>= 2;
+      g >>= 2;
+      b >>= 2;
+      *pu++ = (unsigned char)(((-43 * r -  85 * g + 128 * b) >> 8) + 128);
+      *pv++ = (unsigned char)(((128 * r - 107 * g -  21 * b) >> 8) + 128);
+    }
+  }
+
+  fputs("FRAME\n", stream);
+  fwrite(&yuv[0], 1, yuv.size(), stream);
+}
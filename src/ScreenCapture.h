@@ -0,0 +1,156 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file ScreenCapture.h
+ *
+ *  Recording of the rendered frames as an image sequence or a
+ *  video stream.
+ */
+
+#ifndef SCREENCAPTURE_H
+#define SCREENCAPTURE_H
+
+#include <SDL.h>
+#include <string>
+#include <deque>
+#include <vector>
+#include <stdio.h>
+#include "include_gl.h"
+
+class SimpleXMLTransfer;
+
+
+/** \brief Asynchronous frame capture
+ *
+ *  The render thread never waits for the pixels of a frame:
+ *
+ *  - The frame is read into one of a ring of pixel buffer objects,
+ *    glReadPixels() returns immediately. The buffer is mapped again
+ *    when the ring comes back to it, a few frames later, when the
+ *    transfer has finished.
+ *  - The pixels are copied into one of a fixed number of frame
+ *    buffers which are allocated when recording starts. If all of
+ *    them are still waiting to be written, the frame is dropped.
+ *  - A background thread writes the frames to disk, either as
+ *    numbered TGA images or as one YUV4MPEG2 (.y4m) stream.
+ *
+ *  Without pixel buffer objects the frame is read synchronously,
+ *  but the file is still written by the background thread.
+ *
+ *  Configuration (see documentation/options.txt):
+ *  video.capture.format, video.capture.fps, video.capture.path,
+ *  video.capture.buffers, video.capture.pbos
+ */
+class ScreenCapture
+{
+  public:
+    /**
+     *  Read the configuration.
+     *
+     *  \param cfg configuration file
+     */
+    static void init(SimpleXMLTransfer* cfg);
+
+    /**
+     *  Start recording. Needs a current OpenGL context.
+     *
+     *  \param w frame width
+     *  \param h frame height
+     */
+    static void start(int w, int h);
+
+    /**
+     *  Stop recording. Pending frames are written before
+     *  this returns.
+     */
+    static void stop();
+
+    /**
+     *  Start or stop recording, depending on the current state
+     */
+    static void toggle(int w, int h);
+
+    static bool isRecording() { return fRecording; };
+
+    /**
+     *  Capture the current frame if recording. Has to be called after
+     *  everything has been drawn and before the buffers are swapped.
+     *
+     *  \param w frame width
+     *  \param h frame height
+     */
+    static void captureFrame(int w, int h);
+
+  private:
+    enum
+    {
+      FORMAT_TGA = 0,   ///< numbered TGA images
+      FORMAT_Y4M        ///< YUV4MPEG2 stream
+    };
+
+    /**
+     *  A frame waiting to be written. pixels == NULL tells the
+     *  writer thread to finish.
+     */
+    typedef struct
+    {
+      unsigned char* pixels;   ///< BGRA, bottom row first
+      int            number;
+    } T_Frame;
+
+    static bool initPBOs();
+    static void readPBO(int pbo);
+    static unsigned char* getFreeBuffer();
+    static void queueFrame(unsigned char* pixels);
+    static int  writerThread(void* data);
+    static void writeTGA(const T_Frame& frame);
+    static void writeY4M(const T_Frame& frame);
+
+    static bool   fRecording;
+    static int    format;
+    static int    fps;
+    static int    num_buffers;
+    static int    num_pbos;
+    static std::string path;
+
+    static int    width;
+    static int    height;
+    static int    frame_count;     ///< frames captured in this recording
+    static int    dropped;         ///< frames dropped because all buffers were in use
+    static Uint32 next_time;       ///< SDL_GetTicks() of the next frame to capture
+    static std::string basename;   ///< path and name of this recording without suffix
+
+    static std::vector<GLuint> pbos;
+    static int    pbo_next;        ///< PBO to read the next frame into
+    static int    pbo_pending;     ///< number of PBOs containing a frame
+
+    static std::vector<unsigned char*> buffers;
+    static std::vector<unsigned char*> free_buffers;  ///< protected by mutex
+    static std::deque<T_Frame>         queue;         ///< protected by mutex
+    static std::vector<unsigned char>  yuv;           ///< writer thread only
+    static FILE*       stream;                        ///< writer thread only
+    static SDL_Thread* thread;
+    static SDL_mutex*  mutex;
+    static SDL_cond*   cond;
+};
+
+#endif
@@ -80,7 +80,7 @@ void idle(TSimInputs* inputs)
   Global::Simulation->incSimSteps(multiloop);
 
   if (nAircraftOutsideWindfieldSim)
-    Global::verboseString += " Outside windfield simulation!";
+    Global::verboseString.append(" Outside windfield simulation!");
 
   double X_cg_rwy =    Global::aircraft->getPos().r[0];
   double Y_cg_rwy =    Global::aircraft->getPos().r[1];
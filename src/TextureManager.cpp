@@ -0,0 +1,471 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file TextureManager.cpp
+ *
+ *  Implementation of the shared texture cache.
+ */
+
+#include "TextureManager.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "crrc_graphics.h"
+#include "mod_misc/SimpleXMLTransfer.h"
+#include "mod_misc/filesystools.h"
+
+/// "CRTX" -- also detects cache files written on a machine with different endianness
+#define TEXCACHE_MAGIC    (0x43525458)
+#define TEXCACHE_VERSION  (1)
+
+/// Number of unsigned ints in the cache file header
+#define TEXCACHE_HDR_LEN  (8)
+
+TextureManager::T_TexMap  TextureManager::textures;
+bool                      TextureManager::fUseCache = false;
+std::string               TextureManager::cachedir;
+
+
+/** \brief Check whether n is a power of two
+ */
+static bool isPowerOfTwo(int n)
+{
+  return (n > 0) && ((n & (n - 1)) == 0);
+}
+
+
+/** \brief Read an image file into memory.
+ *
+ *  \param file name of the file
+ *  \param w    will be set to image width
+ *  \param h    will be set to image height
+ *  \param bpp  will be set to bytes per pixel (1 for .bw, 4 for .rgb)
+ *  \return pixel data (to be free()d by the caller) or NULL on error
+ */
+static unsigned char* readImage(const std::string& file, int* w, int* h, int* bpp)
+{
+  std::string::size_type len = file.length();
+
+  if (len > 3 && file.compare(len - 3, 3, ".bw") == 0)
+  {
+    // raw .bw images are always square
+    struct stat   st;
+    unsigned long size;
+    if (stat(file.c_str(), &st) == 0)
+    {
+      size = st.st_size;
+    }
+    else
+    {
+      // in a data pack?
+      std::string            item;
+      FileSysTools::Archive* pack = FileSysTools::findArchive(file, item);
+      const char*            data;
+
+      if (pack == NULL || (data = pack->open(item, size)) == NULL)
+      {
+        return NULL;
+      }
+      pack->close(data);
+    }
+    int side = (int)(sqrt((double)size) + 0.5);
+    if (side * side != (int)size)
+    {
+      fprintf(stderr, "Error loading texture %s:\nRaw image is not square.\n", file.c_str());
+      return NULL;
+    }
+    *w   = side;
+    *h   = side;
+    *bpp = 1;
+    return read_bwimage(file.c_str(), w, h);
+  }
+  else
+  {
+    *bpp = 4;
+    return read_rgbimage(file.c_str(), w, h);
+  }
+}
+
+
+/** \brief Upload a complete mipmap chain.
+ *
+ *  \param data   level 0 followed directly by all smaller levels
+ *  \param w      width of level 0
+ *  \param h      height of level 0
+ *  \param bpp    bytes per pixel
+ *  \param levels number of levels in data
+ */
+static GLuint uploadLevels(unsigned char* data, int w, int h, int bpp, int levels)
+{
+  GLenum format = (bpp == 1) ? GL_ALPHA : GL_RGBA;
+  GLuint tex;
+
+  glGenTextures(1, &tex);
+  glBindTexture(GL_TEXTURE_2D, tex);
+  glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+  glTexEnvf(GL_TEXTURE_ENV,GL_TEXTURE_ENV_MODE,GL_MODULATE);
+  glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,
+                  (levels > 1) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+
+  for (int i = 0; i < levels; i++)
+  {
+    glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, w, h,
+                 0, format, GL_UNSIGNED_BYTE, data);
+    data += w * h * bpp;
+    if (w > 1) w >>= 1;
+    if (h > 1) h >>= 1;
+  }
+
+  return tex;
+}
+
+
+/** \brief Build a mipmap chain using a 2x2 box filter.
+ *
+ *  Only works for power-of-two images.
+ *
+ *  \param pixels level 0
+ *  \param w      width of level 0
+ *  \param h      height of level 0
+ *  \param bpp    bytes per pixel
+ *  \param levels will be set to the number of levels
+ *  \param size   will be set to the size of the chain in bytes
+ *  \return the complete chain (to be free()d by the caller), level 0 included
+ */
+static unsigned char* buildMipmaps(unsigned char* pixels, int w, int h, int bpp,
+                                   int* levels, unsigned long* size)
+{
+  unsigned long total = 0;
+  int n = 0;
+  int lw = w;
+  int lh = h;
+
+  while (1)
+  {
+    total += lw * lh * bpp;
+    n++;
+    if (lw == 1 && lh == 1)
+      break;
+    if (lw > 1) lw >>= 1;
+    if (lh > 1) lh >>= 1;
+  }
+
+  unsigned char* chain = (unsigned char*)malloc(total);
+  if (chain == NULL)
+  {
+    return NULL;
+  }
+  memcpy(chain, pixels, w * h * bpp);
+
+  unsigned char* src = chain;
+  lw = w;
+  lh = h;
+  for (int i = 1; i < n; i++)
+  {
+    unsigned char* dst = src + lw * lh * bpp;
+    int nw = (lw > 1) ? (lw >> 1) : 1;
+    int nh = (lh > 1) ? (lh >> 1) : 1;
+    int dx = (lw > 1) ? bpp : 0;
+    int dy = (lh > 1) ? lw * bpp : 0;
+
+    for (int y = 0; y < nh; y++)
+    {
+      unsigned char* s = src + (y * ((lh > 1) ? 2 : 1)) * lw * bpp;
+      for (int x = 0; x < nw; x++)
+      {
+        for (int c = 0; c < bpp; c++)
+        {
+          *dst++ = (unsigned char)((s[c] + s[c+dx] + s[c+dy] + s[c+dx+dy] + 2) >> 2);
+        }
+        s += (lw > 1) ? 2 * bpp : bpp;
+      }
+    }
+    src += lw * lh * bpp;
+    lw = nw;
+    lh = nh;
+  }
+
+  *levels = n;
+  *size   = total;
+  return chain;
+}
+
+
+// see header
+void TextureManager::init(SimpleXMLTransfer* cfg)
+{
+  fUseCache = (cfg->getInt("video.textures.fUse_cache", 0) != 0);
+  cachedir  = FileSysTools::getHomePath();
+  if (cachedir == "")
+  {
+    fUseCache = false;
+  }
+  else
+  {
+    cachedir += "/cache/textures/";
+  }
+}
+
+
+// see header
+GLuint TextureManager::getTexture(std::string file, bool use_mipmaps)
+{
+  std::string key = file;
+  if (use_mipmaps)
+    key += "#mipmap";
+
+  T_TexMap::iterator it = textures.find(key);
+  if (it != textures.end())
+  {
+    it->second.refcount++;
+    return it->second.handle;
+  }
+
+  GLuint tex = loadTexture(file, use_mipmaps);
+  if (tex != 0)
+  {
+    T_TexEntry entry;
+    entry.handle   = tex;
+    entry.refcount = 1;
+    textures[key] = entry;
+  }
+  return tex;
+}
+
+
+// see header
+void TextureManager::releaseTexture(GLuint& tex)
+{
+  if (tex == 0)
+    return;
+
+  for (T_TexMap::iterator it = textures.begin(); it != textures.end(); it++)
+  {
+    if (it->second.handle == tex)
+    {
+      if (--it->second.refcount <= 0)
+      {
+        if (glIsTexture(tex))
+          glDeleteTextures(1, &tex);
+        textures.erase(it);
+      }
+      break;
+    }
+  }
+  tex = 0;
+}
+
+
+GLuint TextureManager::loadTexture(const std::string& file, bool use_mipmaps)
+{
+  std::string cachefile;
+
+  if (fUseCache)
+  {
+    cachefile = getCacheFileName(file, use_mipmaps);
+    GLuint tex = loadFromCache(cachefile, file, use_mipmaps);
+    if (tex != 0)
+      return tex;
+  }
+
+  int w, h, bpp;
+  unsigned char* pixels = readImage(file, &w, &h, &bpp);
+  if (pixels == NULL)
+    return 0;
+
+  GLuint tex = make_texture(pixels, GL_RGBA, (bpp == 1) ? GL_ALPHA : GL_RGBA,
+                            w, h, use_mipmaps);
+
+  if (fUseCache)
+    writeToCache(cachefile, file, pixels, w, h, bpp, use_mipmaps);
+
+  free(pixels);
+  return tex;
+}
+
+
+std::string TextureManager::getCacheFileName(const std::string& file, bool use_mipmaps)
+{
+  // FNV-1a hash of the full path
+  unsigned int hash = 2166136261u;
+  for (std::string::size_type i = 0; i < file.length(); i++)
+  {
+    hash ^= (unsigned char)file[i];
+    hash *= 16777619u;
+  }
+
+  char buf[16];
+  sprintf(buf, "%08x", hash);
+
+  std::string name = cachedir + buf;
+  if (use_mipmaps)
+    name += "m";
+  name += ".tex";
+  return name;
+}
+
+
+GLuint TextureManager::loadFromCache(const std::string& cachefile,
+                                     const std::string& file, bool use_mipmaps)
+{
+  struct stat st;
+  if (stat(file.c_str(), &st) != 0)
+    return 0;
+
+  FILE* fp = fopen(cachefile.c_str(), "rb");
+  if (fp == NULL)
+    return 0;
+
+  fseek(fp, 0, SEEK_END);
+  long file_size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  unsigned int hdr[TEXCACHE_HDR_LEN];
+  if (fread(hdr, sizeof(hdr), 1, fp) != 1
+      || hdr[0] != TEXCACHE_MAGIC
+      || hdr[1] != TEXCACHE_VERSION
+      || hdr[2] != (unsigned int)st.st_size
+      || hdr[3] != (unsigned int)st.st_mtime)
+  {
+    fclose(fp);
+    return 0;
+  }
+
+  // The rest of the header is checked before it is used, a damaged
+  // cache file is ignored and written again.
+  GLint max_size = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+
+  unsigned int w      = hdr[4];
+  unsigned int h      = hdr[5];
+  unsigned int bpp    = hdr[6];
+  unsigned int levels = hdr[7];
+
+  // levels of a full chain
+  unsigned int max_levels = 1;
+  for (unsigned int n = (w > h) ? w : h; n > 1; n >>= 1)
+    max_levels++;
+
+  if ((bpp != 1 && bpp != 4)
+      || w == 0 || h == 0
+      || w > (unsigned int)max_size || h > (unsigned int)max_size
+      || levels < 1 || levels > max_levels
+      || (levels > 1 && !(isPowerOfTwo(w) && isPowerOfTwo(h))))
+  {
+    fclose(fp);
+    return 0;
+  }
+
+  // size of the complete chain
+  size_t size = 0;
+  size_t lw   = w;
+  size_t lh   = h;
+  for (unsigned int i = 0; i < levels; i++)
+  {
+    size += lw * lh * bpp;
+    if (lw > 1) lw >>= 1;
+    if (lh > 1) lh >>= 1;
+  }
+
+  if (file_size < 0 || size != (size_t)file_size - sizeof(hdr))
+  {
+    fclose(fp);
+    return 0;
+  }
+
+  unsigned char* data = (unsigned char*)malloc(size);
+  if (data == NULL || fread(data, size, 1, fp) != 1)
+  {
+    free(data);
+    fclose(fp);
+    return 0;
+  }
+  fclose(fp);
+
+  GLuint tex;
+  if (use_mipmaps && levels == 1)
+  {
+    // no pre-built chain for non-power-of-two images
+    tex = make_texture(data, GL_RGBA, (bpp == 1) ? GL_ALPHA : GL_RGBA,
+                       w, h, true);
+  }
+  else
+  {
+    tex = uploadLevels(data, w, h, bpp, levels);
+  }
+  free(data);
+
+  return tex;
+}
+
+
+void TextureManager::writeToCache(const std::string& cachefile, const std::string& file,
+                                  unsigned char* pixels, int w, int h, int bpp,
+                                  bool use_mipmaps)
+{
+  struct stat st;
+  if (stat(file.c_str(), &st) != 0)
+    return;
+
+  unsigned char* data   = pixels;
+  unsigned long  size   = w * h * bpp;
+  int            levels = 1;
+
+  if (use_mipmaps && isPowerOfTwo(w) && isPowerOfTwo(h))
+  {
+    data = buildMipmaps(pixels, w, h, bpp, &levels, &size);
+    if (data == NULL)
+      return;
+  }
+
+  FileSysTools::makeSurePathExists(cachedir);
+  FILE* fp = fopen(cachefile.c_str(), "wb");
+  if (fp != NULL)
+  {
+    unsigned int hdr[TEXCACHE_HDR_LEN];
+    hdr[0] = TEXCACHE_MAGIC;
+    hdr[1] = TEXCACHE_VERSION;
+    hdr[2] = (unsigned int)st.st_size;
+    hdr[3] = (unsigned int)st.st_mtime;
+    hdr[4] = w;
+    hdr[5] = h;
+    hdr[6] = bpp;
+    hdr[7] = levels;
+
+    bool ok = (fwrite(hdr, sizeof(hdr), 1, fp) == 1)
+              && (fwrite(data, size, 1, fp) == 1);
+    fclose(fp);
+    if (!ok)
+      remove(cachefile.c_str());
+  }
+
+  if (data != pixels)
+    free(data);
+}
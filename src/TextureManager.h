@@ -0,0 +1,111 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file TextureManager.h
+ *
+ *  Shared cache for OpenGL textures which are loaded from
+ *  SGI .rgb or raw .bw files outside of SSG.
+ */
+
+#ifndef TEXTUREMANAGER_H
+#define TEXTUREMANAGER_H
+
+#include <string>
+#include <map>
+#include "include_gl.h"
+
+class SimpleXMLTransfer;
+
+
+/** \brief Reference counted cache of OpenGL textures
+ *
+ *  Every texture file is decoded and uploaded only once, no matter
+ *  how many users request it. The texture is deleted when the last
+ *  user released it.
+ *
+ *  Optionally the decoded pixels (including the mipmap chain) are
+ *  stored in a binary cache file in the user's CRRCsim directory,
+ *  so that the next start only needs a single read and no conversion.
+ *
+ *  Textures loaded by SSG (sky, aircraft, model-based sceneries) are
+ *  shared by plib itself and are not handled here.
+ */
+class TextureManager
+{
+  public:
+    /**
+     *  Read the cache configuration. Must be called before the
+     *  first texture is requested.
+     *
+     *  \param cfg configuration file
+     */
+    static void init(SimpleXMLTransfer* cfg);
+
+    /**
+     *  Get a texture handle for a file. If the file has been loaded
+     *  before, the existing texture is returned and its reference
+     *  count is increased.
+     *
+     *  Files ending in ".bw" are loaded as square GL_ALPHA images,
+     *  everything else is expected to be an uncompressed 4 channel
+     *  SGI .rgb file.
+     *
+     *  \param file         full path to the image file
+     *  \param use_mipmaps  build the texture with mipmaps
+     *  \return OpenGL texture handle or 0 on error
+     */
+    static GLuint getTexture(std::string file, bool use_mipmaps);
+
+    /**
+     *  Release a texture obtained from getTexture(). The OpenGL
+     *  texture is deleted when there are no users left.
+     *
+     *  \param tex texture handle, will be set to 0
+     */
+    static void releaseTexture(GLuint& tex);
+
+  private:
+    /**
+     *  Cache entry for one texture
+     */
+    typedef struct
+    {
+      GLuint handle;    ///< OpenGL texture handle
+      int    refcount;  ///< number of users
+    } T_TexEntry;
+
+    typedef std::map<std::string, T_TexEntry> T_TexMap;
+
+    static GLuint loadTexture(const std::string& file, bool use_mipmaps);
+    static GLuint loadFromCache(const std::string& cachefile,
+                                const std::string& file, bool use_mipmaps);
+    static void   writeToCache(const std::string& cachefile, const std::string& file,
+                               unsigned char* pixels, int w, int h, int bpp,
+                               bool use_mipmaps);
+    static std::string getCacheFileName(const std::string& file, bool use_mipmaps);
+
+    static T_TexMap     textures;
+    static bool         fUseCache;
+    static std::string  cachedir;
+};
+
+#endif
@@ -28,6 +28,7 @@
 #include "aircraft.h"
 #include "mod_fdm/formats/airtoxml.h"
 #include "mod_fdm/xmlmodelfile.h"
+#include "mod_fdm/xmlmodelcache.h"
 #include "crrc_graphics.h"  /// for scene; \todo airplane could bring its own scenegraph
 
 
@@ -164,7 +165,8 @@ void Aircraft::load(SimpleXMLTransfer *configfile, FDMEnviroment* fdmEnvironment
 
   try
   {
-    SimpleXMLTransfer* xml = new SimpleXMLTransfer(filename);
+    SimpleXMLTransfer* xml = XMLModelCache::load(filename,
+                                                 configfile->getInt("airplane.fUse_cache", 1) != 0);
 
     SimpleXMLTransfer* ap = configfile->getChild("airplane");
 
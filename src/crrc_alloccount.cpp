@@ -0,0 +1,152 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file crrc_alloccount.cpp
+ *
+ *  Counting replacement of the global operator new, see crrc_alloccount.h.
+ */
+
+#include "crrc_alloccount.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if __cplusplus >= 201103L
+# define THROW_BAD_ALLOC
+# define THROW_NOTHING    noexcept
+#else
+# define THROW_BAD_ALLOC  throw(std::bad_alloc)
+# define THROW_NOTHING    throw()
+#endif
+
+static unsigned long nAllocations = 0;
+
+static void* countedAlloc(std::size_t size)
+{
+  void* ptr;
+
+  nAllocations++;
+  ptr = malloc(size ? size : 1);
+  if (ptr == NULL)
+    throw std::bad_alloc();
+  return(ptr);
+}
+
+void* operator new(std::size_t size) THROW_BAD_ALLOC
+{
+  return(countedAlloc(size));
+}
+
+void* operator new[](std::size_t size) THROW_BAD_ALLOC
+{
+  return(countedAlloc(size));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) THROW_NOTHING
+{
+  nAllocations++;
+  return(malloc(size ? size : 1));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) THROW_NOTHING
+{
+  nAllocations++;
+  return(malloc(size ? size : 1));
+}
+
+void operator delete(void* ptr) THROW_NOTHING
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr) THROW_NOTHING
+{
+  free(ptr);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* ptr, std::size_t) THROW_NOTHING
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) THROW_NOTHING
+{
+  free(ptr);
+}
+#endif
+
+void operator delete(void* ptr, const std::nothrow_t&) THROW_NOTHING
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) THROW_NOTHING
+{
+  free(ptr);
+}
+
+unsigned long AllocCount::getCount()
+{
+  return(nAllocations);
+}
+
+void AllocCount::frameDone(int nFrames)
+{
+  static unsigned long nLast   = 0;
+  static unsigned long nSum    = 0;
+  static unsigned long nMin    = 0;
+  static unsigned long nMax    = 0;
+  static int           nFrame  = -1;
+  unsigned long        nNow    = nAllocations;
+  unsigned long        nDelta  = nNow - nLast;
+
+  nLast = nNow;
+
+  // The first call only marks the end of the initialization.
+  if (nFrame < 0)
+  {
+    nFrame = 0;
+    return;
+  }
+
+  if (nFrame == 0 || nDelta < nMin)
+    nMin = nDelta;
+  if (nFrame == 0 || nDelta > nMax)
+    nMax = nDelta;
+  nSum += nDelta;
+
+  if (++nFrame >= nFrames)
+  {
+    // printf() doesn't use operator new, so this doesn't show up in
+    // the next report.
+    printf("Heap allocations per frame: min %lu, avg %.1f, max %lu\n",
+           nMin, (double)nSum / nFrame, nMax);
+    nSum   = 0;
+    nFrame = 0;
+  }
+}
+
+#endif
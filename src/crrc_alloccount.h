@@ -0,0 +1,57 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file crrc_alloccount.h
+ *
+ *  Heap allocation counter for finding allocations in the main loop.
+ *
+ *  Compile with -DCOUNT_ALLOCATIONS to replace the global operator
+ *  new by one that counts its calls. The main loop then prints the
+ *  number of allocations per frame every 60 frames. See
+ *  documentation/compile.txt for what is known to allocate while
+ *  flying; src/mod_fdm/alloc_test.cpp checks the flight model alone.
+ *  Without COUNT_ALLOCATIONS, nothing is changed.
+ */
+#ifndef CRRC_ALLOCCOUNT_H
+#define CRRC_ALLOCCOUNT_H
+
+#ifdef COUNT_ALLOCATIONS
+
+namespace AllocCount
+{
+  /**
+   *  Number of calls to operator new and operator new[] so far.
+   *  Not protected against other threads; they only add some noise.
+   */
+  unsigned long getCount();
+
+  /**
+   *  Call once per frame. Collects the allocations since the last call
+   *  and prints minimum, average and maximum per frame every
+   *  nFrames frames.
+   */
+  void frameDone(int nFrames);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file crrc_benchmark.cpp
+ *
+ *  Implementation of the render benchmark.
+ */
+
+#include "crrc_main.h"
+#include "crrc_benchmark.h"
+#include "crrc_graphics.h"
+#include "global.h"
+#include "glconsole.h"
+#include "mod_misc/SimpleXMLTransfer.h"
+#include "mod_misc/filesystools.h"
+
+#include <vector>
+#include <algorithm>
+
+
+/**
+ *  One key of the camera path, in graphics coordinates
+ */
+typedef struct
+{
+  CVector eye;
+  CVector look;
+} T_CameraKey;
+
+
+/**
+ *  Wall clock time in milliseconds with sub-millisecond resolution
+ *  (SDL_GetTicks() is too coarse for timing single frames).
+ */
+static double getTimeMs()
+{
+#ifdef WIN32
+  LARGE_INTEGER freq;
+  LARGE_INTEGER count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (1000.0 * (double)count.QuadPart / (double)freq.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (1000.0 * tv.tv_sec + 0.001 * tv.tv_usec);
+#endif
+}
+
+
+/**
+ *  Read the camera path. Positions in the file are given as
+ *  north/east/height in ft.
+ */
+static void readCameraPath(const std::string& file, std::vector<T_CameraKey>& keys)
+{
+  try
+  {
+    SimpleXMLTransfer xml(FileSysTools::getDataPath(file));
+
+    for (int i = 0; i < xml.getChildCount(); i++)
+    {
+      SimpleXMLTransfer* k = xml.getChildAt(i);
+
+      if (k->getName() == "key")
+      {
+        T_CameraKey key;
+
+        key.eye  = CVector(k->attributeAsDouble("east", 0.0),
+                           k->attributeAsDouble("height", 5.0),
+                           -k->attributeAsDouble("north", 0.0));
+        key.look = CVector(k->attributeAsDouble("look_east", 0.0),
+                           k->attributeAsDouble("look_height", 5.0),
+                           -k->attributeAsDouble("look_north", 0.0));
+        keys.push_back(key);
+      }
+    }
+  }
+  catch (XMLException e)
+  {
+    fprintf(stderr, "Unable to read camera path %s: %s\n", file.c_str(), e.what());
+    keys.clear();
+  }
+}
+
+
+/**
+ *  Camera position and direction for a frame. t runs from 0 to 1.
+ */
+static void setCamera(std::vector<T_CameraKey>& keys, double t,
+                      double radius, double height)
+{
+  if (keys.size() == 0)
+  {
+    // pan around the pilot once
+    double psi = 2 * M_PI * t;
+
+    looking_pos = *player_pos + CVector(radius * sin(psi), height, -radius * cos(psi));
+  }
+  else if (keys.size() == 1)
+  {
+    *player_pos = keys[0].eye;
+    looking_pos = keys[0].look;
+  }
+  else
+  {
+    double       f = t * (keys.size() - 1);
+    unsigned int n = (unsigned int)f;
+
+    if (n >= keys.size() - 1)
+      n = keys.size() - 2;
+    f -= n;
+
+    *player_pos = keys[n].eye  + (keys[n+1].eye  - keys[n].eye)  * f;
+    looking_pos = keys[n].look + (keys[n+1].look - keys[n].look) * f;
+  }
+}
+
+
+// see header
+bool benchmark_enabled(SimpleXMLTransfer* cfg)
+{
+  return (cfg->getInt("video.benchmark.frames", 0) > 0);
+}
+
+
+// see header
+void benchmark_run(SimpleXMLTransfer* cfg)
+{
+  int         frames = cfg->getInt("video.benchmark.frames", 0);
+  int         warmup = cfg->getInt("video.benchmark.warmup", 10);
+  double      radius = cfg->getDouble("video.benchmark.radius", 300.0);
+  double      height = cfg->getDouble("video.benchmark.height", 50.0);
+  std::string path   = cfg->getString("video.benchmark.path", "");
+  std::string output = cfg->getString("video.benchmark.output", "");
+
+  std::vector<T_CameraKey> keys;
+  std::vector<double>      times;
+
+  if (path.length())
+    readCameraPath(path, keys);
+
+  // The console fades out depending on the wall clock,
+  // which would make the frames differ between runs.
+  Global::console->hide();
+  adjust_zoom(cfg->getDouble("video.zoom.field_of_view", 35));
+
+  printf("Render benchmark: %d frames at %dx%d (%s), camera path: %s\n",
+         frames, window_xsize, window_ysize,
+         video_is_offscreen() ? "offscreen" : "window",
+         keys.size() ? path.c_str() : "pan around pilot");
+
+  times.reserve(frames);
+  for (int i = -warmup; i < frames; i++)
+  {
+    double t = (i < 0 || frames < 2) ? 0.0 : (double)i / (frames - 1);
+
+    setCamera(keys, t, radius, height);
+
+    double t0 = getTimeMs();
+    display();
+    glFinish();
+    double t1 = getTimeMs();
+
+    // keep the window responsive
+    if (!video_is_offscreen())
+      SDL_PumpEvents();
+
+    if (i >= 0)
+      times.push_back(t1 - t0);
+  }
+
+  // per-frame render times
+  FILE* fp = stdout;
+  if (output.length())
+  {
+    fp = fopen(output.c_str(), "w");
+    if (fp == NULL)
+    {
+      fprintf(stderr, "Unable to write %s, using stdout.\n", output.c_str());
+      fp = stdout;
+    }
+  }
+  fprintf(fp, "# frame  time/ms\n");
+  for (unsigned int i = 0; i < times.size(); i++)
+  {
+    fprintf(fp, "%6u  %8.3f\n", i, times[i]);
+  }
+  if (fp != stdout)
+    fclose(fp);
+
+  // summary
+  if (times.size() > 0)
+  {
+    std::vector<double> sorted(times);
+    double              sum = 0;
+
+    std::sort(sorted.begin(), sorted.end());
+    for (unsigned int i = 0; i < sorted.size(); i++)
+      sum += sorted[i];
+
+    double avg = sum / sorted.size();
+
+    printf("Render benchmark results (ms per frame):\n");
+    printf("  min:    %8.3f\n", sorted[0]);
+    printf("  median: %8.3f\n", sorted[sorted.size() / 2]);
+    printf("  95%%:    %8.3f\n", sorted[(sorted.size() * 95) / 100]);
+    printf("  max:    %8.3f\n", sorted[sorted.size() - 1]);
+    printf("  avg:    %8.3f  (%.1f fps)\n", avg, (avg > 0) ? 1000.0 / avg : 0.0);
+  }
+}
@@ -0,0 +1,53 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file crrc_benchmark.h
+ *
+ *  Render benchmark: draws a fixed number of frames along a scripted
+ *  camera path and reports how long each frame took.
+ */
+
+#ifndef CRRC_BENCHMARK_H
+#define CRRC_BENCHMARK_H
+
+class SimpleXMLTransfer;
+
+/**
+ *  Returns true if a render benchmark has been requested
+ *  (video.benchmark.frames > 0, see command line option -r).
+ */
+bool benchmark_enabled(SimpleXMLTransfer* cfg);
+
+/**
+ *  Run the render benchmark. Everything must have been set up
+ *  as for the main loop. The simulation is not advanced, the
+ *  airplane stays at its start position and only the camera moves,
+ *  so that the same frames are drawn in every run.
+ *
+ *  The camera path is either read from the file given in
+ *  video.benchmark.path or the camera pans around the pilot
+ *  position once. See documentation/options.txt.
+ *
+ *  \param cfg configuration
+ */
+void benchmark_run(SimpleXMLTransfer* cfg);
+
+#endif
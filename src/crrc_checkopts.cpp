@@ -48,10 +48,13 @@ void crrc_usage(char *progname)
   fprintf(stderr,  "         -b <nr:string> : joystick buttonnr function: RESUME|RESET|PAUSE|ZOOMIN|ZOOMOUT|INCTHROTTLE|DECTHROTTLE\n");
   fprintf(stderr,  "         -c <value>     : color_depth in bits per pixel\n");
   fprintf(stderr,  "         -d <value>     : wind direction in deg (0-360)\n");
+  fprintf(stderr,  "         -e <string>    : sample the windfield, write it to this .npy file and exit\n");
   fprintf(stderr,  "         -f             : use fullscreen\n");
   fprintf(stderr,  "         -g <string>    : specify config file\n");
   fprintf(stderr,  "         -i <string>    : input method : KEYBOARD|MOUSE|JOYSTICK|RCTRAN|SERIAL2|PARALLEL|AUDIO|MNAV|ZHENHUA\n");
   fprintf(stderr,  "         -m <string>    : mouse x motion : AILERON|RUDDER\n");
+  fprintf(stderr,  "         -o             : render offscreen, no window needed (requires OSMesa)\n");
+  fprintf(stderr,  "         -r <value>     : render benchmark: draw <value> frames along a camera path and exit\n");
   fprintf(stderr,  "         -s <on/off>    : sound on/off\n");
   fprintf(stderr,  "         -u <on/off>    : user interface on/off\n");
   fprintf(stderr,  "         -w <value>     : wind velocity in ft/sec\n");
@@ -80,7 +83,7 @@ int crrc_checkopts (int                argc,
   int new_res_x = 0;
   int new_res_y = 0;
 
-  while ((c = getopt(argc, argv, "b:c:d:fg:hi:j:l:m:s:u:vw:x:y:")) != EOF)
+  while ((c = getopt(argc, argv, "b:c:d:e:fg:hi:j:l:m:or:s:u:vw:x:y:")) != EOF)
   {
     switch (c)
     {
@@ -118,6 +121,9 @@ int crrc_checkopts (int                argc,
       case 'd':
         cfg->wind->setDirection((float)atof(optarg), cfg);
         break;
+      case 'e':
+        cfgfile->setAttributeOverwrite("windfield.dump.file", optarg);
+        break;
       case 'f':
         cfgfile->setAttributeOverwrite("video.fullscreen.fUse", "1");
         break;
@@ -143,6 +149,12 @@ int crrc_checkopts (int                argc,
         else if (strcasecmp(optarg,"RUDDER")==0)
           Global::inputDev.mouse_bind_x = T_AxisMapper::RUDDER;
         break;
+      case 'o':
+        cfgfile->setAttributeOverwrite("video.offscreen", "1");
+        break;
+      case 'r':
+        cfgfile->setAttributeOverwrite("video.benchmark.frames", optarg);
+        break;
       case 's':
         if      (strcasecmp(optarg,"ON")==0)
           cfgfile->setAttributeOverwrite("sound.enabled", "1");
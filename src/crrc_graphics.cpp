@@ -29,6 +29,9 @@
  */
 
 #include <errno.h>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
 
 #include "global.h"
 #include "aircraft.h"
@@ -49,6 +52,13 @@
 #include "gloverlay.h"
 #include "zoom.h"
 #include "mod_misc/filesystools.h"
+#include "TextureManager.h"
+#include "ScreenCapture.h"
+#include "crrc_ssgutils.h"
+
+#if (OSMESA != 0)
+# include <GL/osmesa.h>
+#endif
 
 // Debug and error handling settings
 #define DONT_REPEAT_GL_ERRORS  1
@@ -72,6 +82,17 @@ float top_shadow_matrix[4][4];  // Matrix used to calculate shadow on slope
 
 T_VideoBitDepthInfo vidbits;
 
+/**
+ * '1' if rendering into an offscreen buffer instead of a window
+ * (see video_setup_offscreen())
+ */
+static int offscreen = 0;
+
+#if (OSMESA != 0)
+static OSMesaContext  osmesa_context = NULL;
+static GLubyte*       osmesa_buffer  = NULL;
+#endif
+
 /**
  * Sloppy camera setting
  */
@@ -190,23 +211,57 @@ static void ShadowMatrix(float ground[4],float light[4],float m[4][4])
 
 
 /*****************************************************************************/
-unsigned short getshort(FILE *inf)
+/** \brief Read a big-endian unsigned short from a buffer
+ */
+static inline unsigned short getshort(const unsigned char *buf)
 {
-  unsigned char buf[2];
-  int nNotUsed;
-  
-  nNotUsed = fread(buf,2,1,inf);
   return (buf[0]<<8)+(buf[1]<<0);
 }
 
-/*****************************************************************************/
-unsigned short getrgbchar(FILE *inf)
+
+/** \brief Interleave four planar channels into RGBA pixels.
+ *
+ *  \param r     red plane
+ *  \param g     green plane
+ *  \param b     blue plane
+ *  \param a     alpha plane
+ *  \param dest  destination, 4*n bytes
+ *  \param n     number of pixels
+ */
+static void interleave_rgba(const unsigned char *r, const unsigned char *g,
+                            const unsigned char *b, const unsigned char *a,
+                            unsigned char *dest, unsigned long n)
 {
-  unsigned char buf[1];
-  int nNotUsed;
+  unsigned long loop = 0;
+
+#ifdef __SSE2__
+  // 16 pixels per iteration: r,g and b,a are zipped into
+  // 16 bit pairs, then the pairs are zipped into pixels.
+  for (; loop + 16 <= n; loop += 16)
+  {
+    __m128i vr = _mm_loadu_si128((const __m128i*)(r + loop));
+    __m128i vg = _mm_loadu_si128((const __m128i*)(g + loop));
+    __m128i vb = _mm_loadu_si128((const __m128i*)(b + loop));
+    __m128i va = _mm_loadu_si128((const __m128i*)(a + loop));
+    __m128i rg_lo = _mm_unpacklo_epi8(vr, vg);
+    __m128i rg_hi = _mm_unpackhi_epi8(vr, vg);
+    __m128i ba_lo = _mm_unpacklo_epi8(vb, va);
+    __m128i ba_hi = _mm_unpackhi_epi8(vb, va);
+    __m128i *out  = (__m128i*)(dest + loop*4);
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(rg_hi, ba_hi));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(rg_hi, ba_hi));
+  }
+#endif
 
-  nNotUsed = fread(buf,1,1,inf);
-  return (buf[0]);
+  for (; loop < n; loop++)
+  {
+    dest[loop*4+0] = r[loop];
+    dest[loop*4+1] = g[loop];
+    dest[loop*4+2] = b[loop];
+    dest[loop*4+3] = a[loop];
+  }
 }
 
 
@@ -214,6 +269,9 @@ unsigned short getrgbchar(FILE *inf)
  *
  *  Reads an .rgb file, allocates memory for the pixels
  *  and sets *w and *h to image width and height.
+ *  The file is read with a single call, the planar
+ *  channels are then interleaved into RGBA pixels.
+ *  Files in a data pack are used where they are mapped.
  *
  *  \param name file name
  *  \param w will be set to image width
@@ -222,15 +280,37 @@ unsigned short getrgbchar(FILE *inf)
  */
 unsigned char * read_rgbimage(const char *name, int *w, int *h)
 {
-  unsigned char *image, *temp;
+  unsigned char *image, *buffer = NULL;
+  const unsigned char *file = NULL;
   FILE *image_in;
-  unsigned char input_char;
-  unsigned short int input_short;
-  unsigned char header[512];
-  unsigned long int loop;
-  int nNotUsed;
+  long filesize = 0;
+  unsigned long npix = 0;
+  std::string item;
+  FileSysTools::Archive* pack = NULL;
 
-  if ( (image_in = fopen(name, "rb")) == NULL)
+  if ( (image_in = fopen(name, "rb")) != NULL)
+  {
+    fseek(image_in, 0, SEEK_END);
+    filesize = ftell(image_in);
+    fseek(image_in, 0, SEEK_SET);
+
+    buffer = (filesize >= 512) ? (unsigned char*)malloc(filesize) : NULL;
+    if (buffer != NULL && fread(buffer, filesize, 1, image_in) != 1)
+    {
+      free(buffer);
+      buffer = NULL;
+    }
+    fclose(image_in);
+    file = buffer;
+  }
+  else if ((pack = FileSysTools::findArchive(name, item)) != NULL)
+  {
+    unsigned long len;
+
+    file     = (const unsigned char*)pack->open(item, len);
+    filesize = len;
+  }
+  else
   {
     printf("%s\n", name);
     std::string s = "read_rgbimage: Unable to open ";
@@ -238,93 +318,73 @@ unsigned char * read_rgbimage(const char *name, int *w, int *h)
     perror(s.c_str());
     return NULL;
   }
-  input_short=getshort(image_in);
-  if (input_short == 0x01da)
+
+  if (file == NULL || filesize < 512)
   {
-    input_char=getrgbchar(image_in);
-    if (input_char == 0)
-    {
-      input_char=getrgbchar(image_in);
-      input_short=getshort(image_in);
-      if (input_short == 3)
-      {
-        input_short=getshort(image_in);
-        *w=input_short;
-        input_short=getshort(image_in);
-        *h=input_short;
-        image=(unsigned char*)malloc(*w * *h *4 *sizeof(unsigned char));
-        temp=(unsigned char*)malloc(*w * *h *sizeof(unsigned char));
-        if ((image == NULL) || (temp == NULL))
-        {
-          fprintf(stderr, "Error allocating memory for %s\n", name);
-          // just in case one of the two was malloc'ed correctly:
-          free(image);
-          free(temp);
-          return NULL;
-        }
-        input_short=getshort(image_in);
-        if (input_short == 4)
-        {
-          nNotUsed = fread(header,sizeof(unsigned char),500,image_in);
-          nNotUsed = fread(temp, sizeof image[0], *w * *h, image_in);
-          for (loop=0;loop<(unsigned long int)(*w * *h);loop++)
-          {
-            image[loop*4+0]=temp[loop];
-          }
-          nNotUsed = fread(temp, sizeof image[0], *w * *h, image_in);
-          for (loop=0;loop<(unsigned long int)(*w * *h);loop++)
-          {
-            image[loop*4+1]=temp[loop];
-          }
-          nNotUsed = fread(temp, sizeof image[0], *w * *h, image_in);
-          for (loop=0;loop<(unsigned long int)(*w * *h);loop++)
-          {
-            image[loop*4+2]=temp[loop];
-          }
-          nNotUsed = fread(temp, sizeof image[0], *w * *h, image_in);
-          for (loop=0;loop<(unsigned long int)(*w * *h);loop++)
-          {
-            image[loop*4+3]=temp[loop];
-          }
-          free(temp);
-          return image;
-        }
-        else
-        {
-          std::string s = "Error loading texture ";
-          s += name;
-          s += ":\nThis file isn't a 4 channel RGBA file.";
-          fprintf(stderr, "%s\n", s.c_str());
-          return NULL;
-        }
-      }
-      else
-      {
-        std::string s = "Error loading texture ";
-        s += name;
-        s += ":\nNot a useable RGB file.";
-        fprintf(stderr, "%s\n", s.c_str());
-        return NULL;
-      }
-    }
-    else
+    if (pack != NULL)
+      pack->close((const char*)file);
+    free(buffer);
+    fprintf(stderr, "Error loading texture %s:\nUnable to read file.\n", name);
+    return NULL;
+  }
+
+  std::string err;
+  if (getshort(file) != 0x01da)
+  {
+    err = "File doesn't appear to be an SGI rgb file!";
+  }
+  else if (file[2] != 0)
+  {
+    err = "RLE encoded SGI files are not supported.";
+  }
+  else if (getshort(file + 4) != 3)
+  {
+    err = "Not a useable RGB file.";
+  }
+  else if (getshort(file + 10) != 4)
+  {
+    err = "This file isn't a 4 channel RGBA file.";
+  }
+  else
+  {
+    *w   = getshort(file + 6);
+    *h   = getshort(file + 8);
+    npix = (unsigned long)(*w * *h);
+    if ((unsigned long)filesize < 512 + 4*npix)
     {
-      std::string s = "Error loading texture ";
-      s += name;
-      s += ":\nRLE encoded SGI files are not supported.";
-      fprintf(stderr, "%s\n", s.c_str());
-      return NULL;
+      err = "File is truncated.";
     }
   }
-  else
+
+  image = NULL;
+  if (err != "")
   {
     std::string s = "Error loading texture ";
     s += name;
-    s += ":\nFile doesn't appear to be an SGI rgb file!";
+    s += ":\n";
+    s += err;
     fprintf(stderr, "%s\n", s.c_str());
-    return NULL;
   }
-  return NULL;
+  else
+  {
+    image = (unsigned char*)malloc(npix * 4 * sizeof(unsigned char));
+    if (image == NULL)
+    {
+      fprintf(stderr, "Error allocating memory for %s\n", name);
+    }
+    else
+    {
+      // pixel data starts after the 512 byte header, one plane per channel
+      const unsigned char *planes = file + 512;
+      interleave_rgba(planes, planes + npix, planes + 2*npix, planes + 3*npix,
+                      image, npix);
+    }
+  }
+
+  if (pack != NULL)
+    pack->close((const char*)file);
+  free(buffer);
+  return image;
 }
 
 
@@ -343,12 +403,29 @@ unsigned char * read_bwimage(const char *name, int *w, int *h)
   int             img_bytes;
   int             bytes_read;
 
+  img_bytes = *w * *h;
+
   if ( (image_in = fopen(name, "rb")) == NULL)
   {
-    return NULL;
+    // in a data pack?
+    std::string            item;
+    FileSysTools::Archive* pack = FileSysTools::findArchive(name, item);
+    const char*            data;
+    unsigned long          len;
+
+    if (pack == NULL || (data = pack->open(item, len)) == NULL)
+      return NULL;
+
+    image = NULL;
+    if (len >= (unsigned long)img_bytes)
+    {
+      image = (unsigned char *)malloc(sizeof(unsigned char) * img_bytes);
+      memcpy(image, data, img_bytes);
+    }
+    pack->close(data);
+    return image;
   }
 
-  img_bytes = *w * *h;
   image = (unsigned char *)malloc(sizeof(unsigned char) * img_bytes);
 
   bytes_read = fread(image, sizeof image[0], img_bytes, image_in);
@@ -422,6 +499,8 @@ void initialize_scenegraph()
   // add to SSG function for read JPEG Textures 
   bool ssgLoadJPG ( const char *fname, ssgTextureInfo* info );
   ssgAddTextureFormat ( ".jpg",ssgLoadJPG);
+  // models and textures in data packs
+  SSGUtil::addDataPackLoaders();
   
   // Some basic OpenGL setup
   sgVec4 skycol;
@@ -438,6 +517,8 @@ void initialize_scenegraph()
 
   ssgModelPath("");
   ssgTexturePath("textures");  
+  TextureManager::init(cfgfile);
+  ScreenCapture::init(cfgfile);
   
   // Create a root node
   scene    = new ssgRoot();
@@ -772,9 +853,21 @@ void display()
   // check for any OpenGL errors
   evaluateOpenGLErrors();
 
-  // Force pipeline flushing and flip front and back buffer
-  glFlush();
-  SDL_GL_SwapBuffers();
+  // Recording: read back the finished frame
+  ScreenCapture::captureFrame(window_xsize, window_ysize);
+
+  // Force pipeline flushing and flip front and back buffer.
+  // There is nothing to flip when rendering offscreen, but the
+  // frame has to be complete before the next one is started.
+  if (offscreen)
+  {
+    glFinish();
+  }
+  else
+  {
+    glFlush();
+    SDL_GL_SwapBuffers();
+  }
 }
 
 
@@ -1034,6 +1127,74 @@ int video_setup(int nX, int nY, int nFullscreen)
   return(0);
 }
 
+/*****************************************************************************/
+int video_setup_offscreen(int nX, int nY)
+{
+#if (OSMESA != 0)
+  if (nX < 100 || nY < 100)
+  {
+    nX = cfgfile->getInt("video.resolution.window.x", 800);
+    nY = cfgfile->getInt("video.resolution.window.y", 600);
+  }
+
+  osmesa_context = OSMesaCreateContextExt(OSMESA_RGBA, 24, 0, 0, NULL);
+  if (osmesa_context == NULL)
+  {
+    fprintf(stderr, "Unable to create offscreen rendering context. Exiting.\n");
+    crrc_exit(CRRC_EXIT_FAILURE, "Unable to create offscreen rendering context.");
+  }
+
+  osmesa_buffer = (GLubyte*)malloc(nX * nY * 4 * sizeof(GLubyte));
+  if (osmesa_buffer == NULL
+      ||
+      !OSMesaMakeCurrent(osmesa_context, osmesa_buffer, GL_UNSIGNED_BYTE, nX, nY))
+  {
+    fprintf(stderr, "Unable to set up offscreen buffer %ix%i. Exiting.\n", nX, nY);
+    crrc_exit(CRRC_EXIT_FAILURE, "Unable to set up offscreen buffer.");
+  }
+  offscreen = 1;
+
+  // The offscreen buffer behaves like a window of fixed size.
+  cfgfile->setAttributeOverwrite("video.fullscreen.fUse", "0");
+  reshape(nX, nY);
+
+  // Store the received buffer depths for fast access
+  glGetIntegerv(GL_RED_BITS, &(vidbits.red));
+  glGetIntegerv(GL_GREEN_BITS, &(vidbits.green));
+  glGetIntegerv(GL_BLUE_BITS, &(vidbits.blue));
+  glGetIntegerv(GL_ALPHA_BITS, &(vidbits.alpha));
+  glGetIntegerv(GL_DEPTH_BITS, &(vidbits.depth));
+  glGetIntegerv(GL_STENCIL_BITS, &(vidbits.stencil));
+
+  std::string s = GetVideoInfoString("  ");
+  printf("Rendering offscreen (%ix%i) using:\n%s", nX, nY, s.c_str());
+  printf("  ");
+  dumpGLStackInfo(stdout);
+
+  return(0);
+#else
+  fprintf(stderr, "Offscreen rendering is not available, CRRCsim has been compiled without OSMesa.\n");
+  crrc_exit(CRRC_EXIT_FAILURE, "Offscreen rendering is not available.");
+  return(-1);
+#endif
+}
+
+/*****************************************************************************/
+void* graphics_getProcAddress(const char* name)
+{
+#if (OSMESA != 0)
+  if (offscreen)
+    return (void*)OSMesaGetProcAddress(name);
+#endif
+  return SDL_GL_GetProcAddress(name);
+}
+
+/*****************************************************************************/
+int video_is_offscreen()
+{
+  return offscreen;
+}
+
 /*****************************************************************************/
 void setWindowTitleString()
 {
@@ -1090,6 +1251,19 @@ void resize_window(int w, int h)
 
 void graphics_cleanup()
 {
+  ScreenCapture::stop();
+#if (OSMESA != 0)
+  if (osmesa_context != NULL)
+  {
+    OSMesaDestroyContext(osmesa_context);
+    osmesa_context = NULL;
+  }
+  if (osmesa_buffer != NULL)
+  {
+    free(osmesa_buffer);
+    osmesa_buffer = NULL;
+  }
+#endif
 }
 
 
@@ -65,6 +65,28 @@ extern CVector looking_pos;
 // --- functions defined in crrc_graphics.cpp --------------
 
 int video_setup(int nX, int nY, int nFullscreen);
+
+/**
+ * Set up an offscreen rendering context (OSMesa) instead of a
+ * window. Everything is rendered into a buffer of fixed size in
+ * main memory, so neither a display nor a graphics card is needed.
+ * Exits if CRRCsim has been compiled without OSMesa.
+ *
+ * \param nX width, or 0 to use the configured window size
+ * \param nY height, or 0 to use the configured window size
+ */
+int video_setup_offscreen(int nX, int nY);
+
+/**
+ * Returns 1 if video_setup_offscreen() has been used.
+ */
+int video_is_offscreen();
+
+/**
+ * Get the address of an OpenGL extension function for the current
+ * context, or NULL if it is not available.
+ */
+void* graphics_getProcAddress(const char* name);
 void setWindowTitleString();
 
 unsigned char * read_bwimage(const char *name, int *w, int *h);
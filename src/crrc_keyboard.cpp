@@ -33,6 +33,8 @@
 #include "mod_windfield_config.h"
 #include "zoom.h"
 #include "GUI/crrc_gui_main.h"
+#include "crrc_graphics.h"
+#include "ScreenCapture.h"
 
 #if DEBUG_THERMAL_SCRSHOT == 1
 # include "mod_windfield/windfield.h"
@@ -117,6 +119,10 @@ void key_down(SDL_keysym *keysym)
       }
       break;
 
+    case KEY_CAPTURE:
+      ScreenCapture::toggle(window_xsize, window_ysize);
+      break;
+
     case SDLK_KP5:
       Global::TXInterface->centerControls();
       break;
@@ -97,6 +97,53 @@ CRRCAirplaneLaRCSim::~CRRCAirplaneLaRCSim()
 }
 
 
+/**
+ *  Full path of the file of a sound sample, the default sound if
+ *  the file can't be found.
+ *
+ *  \param child "sample" element of the sound description
+ */
+static std::string getSoundFile(SimpleXMLTransfer* child)
+{
+  // assemble relative path
+  std::string soundfile;
+  soundfile           = child->attribute("filename");
+
+  if (soundfile != "")
+  {
+    // Get full path (considering search paths). 
+    soundfile = FileSysTools::getDataPath("sounds/" + soundfile);
+  }
+      
+  // File ok? Use default otherwise.
+  if (!FileSysTools::fileExists(soundfile))
+    soundfile = FileSysTools::getDataPath("sounds/fan.wav");
+
+  return soundfile;
+}
+
+
+void CRRCAirplaneLaRCSim::preloadSound(SimpleXMLTransfer* xml, SDL_AudioSpec* fmt)
+{
+  SimpleXMLTransfer* cfg = XMLModelFile::getConfig(xml);
+  SimpleXMLTransfer* sndcfg = cfg->getChild("sound", true);
+  int children = sndcfg->getChildCount();
+
+  for (int i = 0; i < children; i++)
+  {
+    SimpleXMLTransfer *child = sndcfg->getChildAt(i);
+
+    if (child->getName().compare("sample") == 0)
+    {
+      std::string soundfile = getSoundFile(child);
+
+      if (soundfile != "")
+        T_SoundSample::preload(soundfile.c_str(), fmt);
+    }
+  }
+}
+
+
 void CRRCAirplaneLaRCSim::initSound(SimpleXMLTransfer* xml)
 {
   SimpleXMLTransfer* cfg = XMLModelFile::getConfig(xml);
@@ -113,9 +160,8 @@ void CRRCAirplaneLaRCSim::initSound(SimpleXMLTransfer* xml)
     {
       T_AirplaneSound *sample;
 
-      // assemble relative path
-      std::string soundfile;
-      soundfile           = child->attribute("filename");
+      // full path of the sample
+      std::string soundfile = getSoundFile(child);
 
       // other sound attributes
       int sound_type      = child->getInt("type", SOUND_TYPE_GLIDER);
@@ -136,16 +182,6 @@ void CRRCAirplaneLaRCSim::initSound(SimpleXMLTransfer* xml)
   //~ else
     //~ max_thrust = 1;
   
-      if (soundfile != "")
-      {
-        // Get full path (considering search paths). 
-        soundfile = FileSysTools::getDataPath("sounds/" + soundfile);
-      }
-      
-      // File ok? Use default otherwise.
-      if (!FileSysTools::fileExists(soundfile))
-        soundfile = FileSysTools::getDataPath("sounds/fan.wav");
-    
       std::cout << "soundfile: " << soundfile << "\n";
       //~ std::cout << "max_thrust: " << max_thrust << "\n";
       std::cout << "soundserver: " << Global::soundserver << "\n";
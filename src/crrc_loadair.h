@@ -101,6 +101,15 @@ class CRRCAirplaneLaRCSim : public CRRCAirplane
    CRRCAirplaneLaRCSim(SimpleXMLTransfer* xml);
    virtual ~CRRCAirplaneLaRCSim();
 
+  /** \brief Decode the airplane's sound samples ahead of time.
+    *
+    *  Uses T_SoundSample::preload() for all samples which initSound()
+    *  will load, so it may run in another thread (see crrc_startup.h).
+    *  \param xml airplane description with the configuration selected
+    *  \param fmt format of the sound server
+    */
+   static void preloadSound(SimpleXMLTransfer* xml, SDL_AudioSpec* fmt);
+
   protected:
    
   /** \brief Initialize the airplane's sound.
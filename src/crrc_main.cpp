@@ -58,13 +58,21 @@ If you'd like to help with CRRCSIM, then send me an email!
 #include "mod_landscape/crrc_scenery.h"
 #include "SimStateHandler.h"
 #include "crrc_graphics.h"
+#include "crrc_benchmark.h"
+#include "crrc_alloccount.h"
 #include "mod_windfield/windfield.h"
+#include "mod_windfield/windfield_dump.h"
 #include "GUI/crrc_gui_main.h"
 #include "GUI/crrc_joy.h"
 #include "mod_misc/SimpleXMLTransfer.h"
 #include "mod_misc/lib_conversions.h"
 #include "config.h"
 #include "mod_misc/filesystools.h"
+#include "mod_misc/datapack.h"
+#include "mod_fdm/xmlmodelcache.h"
+#include "GUI/modelcatalog.h"
+#include "crrc_startup.h"
+#include "crrc_loadair.h"
 #include "zoom.h"
 #include "CTime.h"
 #include "mod_mode/T_GameHandler.h"
@@ -493,6 +501,67 @@ void set_aux(int aux_num, int setting)
 
 
 
+/*****************************************************************************/
+/**
+ *  Data of the startup tasks (see crrc_startup.h)
+ */
+static struct
+{
+  std::string        airplane_file;     ///< airplane to read ahead of time
+  int                airplane_config;   ///< configuration to use
+  bool               fUse_cache;
+  SimpleXMLTransfer* airplane;          ///< read by readAirplaneTask(), NULL on error
+  SDL_AudioSpec*     audio_spec;        ///< NULL: no sound
+} startup;
+
+
+/**
+ *  Startup task: read the airplane file, this puts it into XMLModelCache.
+ */
+static void readAirplaneTask(void*)
+{
+  try
+  {
+    startup.airplane = XMLModelCache::load(startup.airplane_file, startup.fUse_cache);
+    XMLModelFile::SetConfig(startup.airplane, startup.airplane_config);
+  }
+  catch (XMLException e)
+  {
+    // will be reported when the airplane is loaded
+    startup.airplane = NULL;
+  }
+}
+
+
+/**
+ *  Startup task: decode the sound samples of the airplane.
+ */
+static void preloadSoundTask(void*)
+{
+  if (startup.airplane != NULL && startup.audio_spec != NULL)
+  {
+    try
+    {
+      CRRCAirplaneLaRCSim::preloadSound(startup.airplane, startup.audio_spec);
+    }
+    catch (XMLException e)
+    {
+    }
+  }
+  delete startup.airplane;
+  startup.airplane = NULL;
+}
+
+
+/**
+ *  Startup task: read the models for the airplane selection dialog.
+ */
+static void updateModelCatalogTask(void*)
+{
+  T_ModelCatalog::update();
+}
+
+
 /*****************************************************************************/
 int main(int argc,char **argv)
 {
@@ -501,6 +570,8 @@ int main(int argc,char **argv)
 
   try
   {
+    StartupTasks::begin("initialization");
+
     Global::TXInterface = (T_TX_Interface*)0;
 
     FileSysTools::SetAppname("crrcsim");
@@ -536,6 +607,9 @@ int main(int argc,char **argv)
       {
         std::cout << "  " << search_path[i] << std::endl;
       }
+
+      // data packs in the search path are used like the directories
+      DataPack::mountAll();
     }
 
     initializeRandomNumberGenerator();
@@ -544,10 +618,13 @@ int main(int argc,char **argv)
       unsigned int SDLFlags = SDL_INIT_JOYSTICK;
       int nRetCodeCmdline;
       int i;
+      int airplane_task = -1;
+      int sound_task    = -1;
 
       try
       {
         // ***** Read configuration, parse commandline... ***********************
+        StartupTasks::phase("configuration");
         for (i = 1; i < argc - 1; i++)
         {
           if (!strcmp(argv[i], "-g"))
@@ -574,9 +651,32 @@ int main(int argc,char **argv)
         if (nRetCodeCmdline)
           crrc_exit(CRRC_EXIT_FAILURE);
 
+        // ***** Background tasks ***********************************************
+        // Everything which needs the OpenGL context stays in this thread,
+        // reading files and decoding samples runs in the meantime.
+        StartupTasks::startThreads(cfgfile->getInt("startup.threads", 0));
+        StartupTasks::add("model catalog", updateModelCatalogTask, NULL);
+        {
+          std::string file = cfgfile->getString("airplane.file", "models/allegro.xml");
+
+          // .air files are converted when they are loaded
+          if (getXMLFilename(file) == "")
+          {
+            startup.airplane_file   = file;
+            startup.airplane_config = cfgfile->getInt("airplane.config", 0);
+            startup.fUse_cache      = (cfgfile->getInt("airplane.fUse_cache", 1) != 0);
+            startup.airplane        = NULL;
+            startup.audio_spec      = NULL;
+            airplane_task = StartupTasks::add("airplane file", readAirplaneTask, NULL);
+          }
+        }
+
+        StartupTasks::phase("SDL and input method");
+
         // must be after crrc_checkopts because crrc_checkopts can change
         //   video.enabled and sound.enabled based on command line options
-        if (cfgfile->getInt("video.enabled", 1))
+        // no display is needed for offscreen rendering
+        if (cfgfile->getInt("video.enabled", 1) && !cfgfile->getInt("video.offscreen", 0))
           SDLFlags |= SDL_INIT_VIDEO;
         if (cfgfile->getInt("sound.enabled", 1))
           SDLFlags |= SDL_INIT_AUDIO;
@@ -591,14 +691,21 @@ int main(int argc,char **argv)
           printf("%s", msg.c_str());
 
         // ***** Video setup ****************************************************
+        StartupTasks::phase("video setup");
         if (cfgfile->getInt("video.enabled", 1))
-          video_setup(0, 0, 0);
+        {
+          if (cfgfile->getInt("video.offscreen", 0))
+            video_setup_offscreen(0, 0);
+          else
+            video_setup(0, 0, 0);
+        }
 
         // ***** Setting window caption *****************************************
-        if (cfgfile->getInt("video.enabled", 1))
+        if (cfgfile->getInt("video.enabled", 1) && !video_is_offscreen())
           setWindowTitleString();
 
         // ***** Sound **********************************************************
+        StartupTasks::phase("sound server");
         if (cfgfile->getInt("sound.enabled", 1))
         {
           try
@@ -625,10 +732,18 @@ int main(int argc,char **argv)
         else
           Global::soundserver = (CRRCAudioServer*)0;
 
-        // ***** Video **********************************************************
+        if (airplane_task >= 0)
+        {
+          if (Global::soundserver != (CRRCAudioServer*)0)
+            startup.audio_spec = Global::soundserver->getAudioSpec();
+          sound_task = StartupTasks::add("sound samples", preloadSoundTask, NULL, airplane_task);
+        }
 
+        // ***** Video **********************************************************
+        StartupTasks::phase("scenegraph");
         initialize_scenegraph();
     
+        StartupTasks::phase("scenery");
         std::string sceneryfile = cfg->getLocationName();
         Global::scenery = loadScenery(FileSysTools::getDataPath(sceneryfile).c_str());
         if (Global::scenery == NULL)
@@ -655,18 +770,22 @@ int main(int argc,char **argv)
         // no wind config is present in the cfgfile for this location
         cfg->wind->read(cfgfile, cfg);
 
+        StartupTasks::phase("window and windfield");
         if (cfgfile->getInt("video.enabled", 1))
           initialize_window(cfg);
         Init_mod_windfield();
 
         player_pos = new CVector(Global::scenery->getPlayerPosition());
 				// Create invisible GUI
+        StartupTasks::phase("GUI");
         if (cfgfile->getInt("video.enabled", 1))
           Global::gui = new CGUIMain(false);
         else
           Global::gui = NULL;
 
         // load airplane
+        StartupTasks::phase("airplane");
+        StartupTasks::wait(sound_task);
         {
           bool airplane_failed = false;
           try
@@ -701,6 +820,7 @@ int main(int argc,char **argv)
         }
 
         //initialise game mode
+        StartupTasks::phase("game mode");
         if (cfgfile->getInt("game.f3f.enabled",0))
           Global::gameHandler= new HandlerF3F();
         else
@@ -728,6 +848,9 @@ int main(int argc,char **argv)
       crrc_exit(CRRC_EXIT_FAILURE, "Unable to initialize console.");
     }
     Global::console->setAutoHide(4000, 1000);
+    StartupTasks::end();
+    // samples of sounds the airplane doesn't use after all
+    T_SoundSample::releasePreloaded();
     LOG("CRRCsim successfully started!");
     LOG("Press <ESC> to show the setup menu.");
     
@@ -739,6 +862,18 @@ int main(int argc,char **argv)
     }
 #endif
     
+    // The render benchmark and the windfield dump replace the main loop.
+    if (windfield_dump_enabled(cfgfile))
+    {
+      windfield_dump(cfgfile);
+      Global::Simulation->quit();
+    }
+    else if (Global::gui && benchmark_enabled(cfgfile))
+    {
+      benchmark_run(cfgfile);
+      Global::Simulation->quit();
+    }
+
     Scheduler scheduler;
     EventHandler eventHandler(&scheduler);
     
@@ -771,33 +906,33 @@ int main(int argc,char **argv)
       calc_fps();
       
       #if 0
-      Global::verboseString += " X: " + ftoStr(vFdmPos.r[0], 2, 2, true, false);
-      Global::verboseString += " Y: " + ftoStr(vFdmPos.r[1], 2, 2, true, false);
-      Global::verboseString += " Z: " + ftoStr(vFdmPos.r[2], 2, 2, true, false);
-      Global::verboseString += " Phi: " + ftoStr(Global::aircraft->getFDM()->getPhi() * SG_RADIANS_TO_DEGREES, 2, 2, true, false);
-      Global::verboseString += " Theta: " + ftoStr(Global::aircraft->getFDM()->getTheta() * SG_RADIANS_TO_DEGREES, 2, 2, true, false);
-      Global::verboseString += " Psi: " + ftoStr(Global::aircraft->getFDM()->getPsi() * SG_RADIANS_TO_DEGREES, 2, 2, true, false);
+      Global::verboseString.appendf(" X: %6.2f Y: %6.2f Z: %6.2f",
+                                    vFdmPos.r[0], vFdmPos.r[1], vFdmPos.r[2]);
+      Global::verboseString.appendf(" Phi: %6.2f Theta: %6.2f Psi: %6.2f",
+                                    Global::aircraft->getFDM()->getPhi() * SG_RADIANS_TO_DEGREES,
+                                    Global::aircraft->getFDM()->getTheta() * SG_RADIANS_TO_DEGREES,
+                                    Global::aircraft->getFDM()->getPsi() * SG_RADIANS_TO_DEGREES);
       if (Global::gui)
         Global::gui->setVerboseText(Global::verboseString.c_str());
       #else
+      // The text is formatted into a fixed buffer, so this doesn't
+      // allocate any memory.
       switch (Global::nVerbosity)
       {
        case 3:
-        Global::verboseString += "FPS: " + itoStr(Global::nFPS, ' ', 1);
+        Global::verboseString.appendf("FPS: %d", Global::nFPS);
         //fallthrough
        case 2:
-        Global::verboseString += " FoV: " + ftoStr(field_of_view, 2, 1, false, false);
+        Global::verboseString.appendf(" FoV: %4.1f", field_of_view);
         //fallthrough
        case 1:
-        Global::verboseString += 
-            "\nAil: " + ftoStr(Global::inputs.aileron,  2, 2, true, false)
-          + " Ele: "  + ftoStr(Global::inputs.elevator, 2, 2, true, false)
-          + " Rud: "  + ftoStr(Global::inputs.rudder,   2, 2, true, false)
-          + " Thr: "  + ftoStr(Global::inputs.throttle, 2, 2, true, false)
-          + "\nFlp: " + ftoStr(Global::inputs.flap,     2, 2, true, false)
-          + " Spo: "  + ftoStr(Global::inputs.spoiler,  2, 2, true, false)
-          + " Ret: "  + ftoStr(Global::inputs.retract,  2, 2, true, false)
-          + " Pit: "  + ftoStr(Global::inputs.pitch,    2, 2, true, false);
+        Global::verboseString.appendf(
+            "\nAil: %5.2f Ele: %5.2f Rud: %5.2f Thr: %5.2f"
+            "\nFlp: %5.2f Spo: %5.2f Ret: %5.2f Pit: %5.2f",
+            Global::inputs.aileron, Global::inputs.elevator,
+            Global::inputs.rudder,  Global::inputs.throttle,
+            Global::inputs.flap,    Global::inputs.spoiler,
+            Global::inputs.retract, Global::inputs.pitch);
         if (Global::gui)
           Global::gui->setVerboseText(Global::verboseString.c_str());
         else
@@ -805,8 +940,8 @@ int main(int argc,char **argv)
           static int verbose_print_c = 0;
           if (++verbose_print_c >= 30)
           {
-            Global::verboseString += "\n";
-            std::cout << Global::verboseString;
+            Global::verboseString.append("\n");
+            std::cout << Global::verboseString.c_str();
             verbose_print_c = 0;
           }
         }
@@ -820,8 +955,15 @@ int main(int argc,char **argv)
       #endif
       
       if (Global::gui)
+      {
         display();
-      Global::verboseString = "";
+        StartupTasks::frameDrawn();
+      }
+      Global::verboseString.clear();
+
+#ifdef COUNT_ALLOCATIONS
+      AllocCount::frameDone(60);
+#endif
 
 #ifdef LOG_FRAMES
       fprintf(fp, "%lu\n", (unsigned long)SDL_GetTicks());
@@ -34,6 +34,12 @@
 
 #include "crrc_soundserver.h"
 #include "crrc_main.h"
+#include "mod_misc/filesystools.h"
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
 
 
 // --- generic functions ----------------------------------
@@ -379,6 +385,48 @@ void CRRCAudioServer::setChannelVolume(int c, unsigned char vol)
 
 // --- Implementation of class T_SoundSample --------------
 
+std::map<std::string, T_SoundSample*> T_SoundSample::preloaded;
+
+
+/**
+ *  Protects T_SoundSample::preloaded, samples are preloaded by the
+ *  startup threads (see crrc_startup.h). Locked while an object of
+ *  this class exists. Not an SDL mutex, it has to exist before
+ *  SDL_Init() has been called.
+ */
+class T_PreloadLock
+{
+  public:
+#ifdef WIN32
+    T_PreloadLock()  { EnterCriticalSection(&mutex.cs); };
+    ~T_PreloadLock() { LeaveCriticalSection(&mutex.cs); };
+
+  private:
+    /**
+     *  Initialized during static initialization, so it is ready before
+     *  any startup thread exists, whichever thread uses it first.
+     */
+    static struct T_Mutex
+    {
+      T_Mutex() { InitializeCriticalSection(&cs); };
+      CRITICAL_SECTION cs;
+    } mutex;
+#else
+    T_PreloadLock()  { pthread_mutex_lock(&mutex); };
+    ~T_PreloadLock() { pthread_mutex_unlock(&mutex); };
+
+  private:
+    static pthread_mutex_t mutex;
+#endif
+};
+
+#ifdef WIN32
+T_PreloadLock::T_Mutex T_PreloadLock::mutex;
+#else
+pthread_mutex_t T_PreloadLock::mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
 /** \brief Create an empty sound sample.
  *
  *  This ctor is mainly useful for derived classes which
@@ -413,7 +461,38 @@ T_SoundSample::T_SoundSample(SDL_AudioSpec *fmt)
 T_SoundSample::T_SoundSample(const char *filename, SDL_AudioSpec *fmt)
   : samplename(""), length(0), buffer(NULL)
 {
-  SDL_AudioSpec *ret = SDL_LoadWAV(filename, &spec, &buffer, &length);
+  // decoded ahead of time?
+  if (takePreloaded(filename, fmt))
+    return;
+
+  SDL_AudioSpec *ret;
+  std::string            item;
+  FileSysTools::Archive* pack;
+  FILE*                  fp = fopen(filename, "rb");
+
+  if (fp == NULL && (pack = FileSysTools::findArchive(filename, item)) != NULL)
+  {
+    // read the sample from the mapped data pack
+    unsigned long len;
+    const char*   data = pack->open(item, len);
+
+    ret = NULL;
+    if (data != NULL)
+    {
+      ret = SDL_LoadWAV_RW(SDL_RWFromConstMem(data, len), 1, &spec, &buffer, &length);
+      pack->close(data);
+    }
+    else
+    {
+      SDL_SetError("Unable to read %s", filename);
+    }
+  }
+  else
+  {
+    if (fp != NULL)
+      fclose(fp);
+    ret = SDL_LoadWAV(filename, &spec, &buffer, &length);
+  }
   if (NULL == ret)
   {
     std::string s = "T_SoundSample: ";
@@ -434,6 +513,78 @@ T_SoundSample::T_SoundSample(const char *filename, SDL_AudioSpec *fmt)
 }
 
 
+// see header
+void T_SoundSample::preload(const char *filename, SDL_AudioSpec *fmt)
+{
+  T_SoundSample* sample;
+
+  try
+  {
+    sample = new T_SoundSample(filename, fmt);
+  }
+  catch (std::runtime_error& e)
+  {
+    return;
+  }
+
+  T_PreloadLock lock;
+  std::map<std::string, T_SoundSample*>::iterator it = preloaded.find(filename);
+  if (it != preloaded.end())
+    delete it->second;
+  preloaded[filename] = sample;
+}
+
+
+// see header
+void T_SoundSample::releasePreloaded()
+{
+  T_PreloadLock lock;
+  std::map<std::string, T_SoundSample*>::iterator it;
+  for (it = preloaded.begin(); it != preloaded.end(); it++)
+    delete it->second;
+  preloaded.clear();
+}
+
+
+/** \brief Take over a preloaded sample.
+ *
+ *  \param filename the file to be loaded
+ *  \param fmt desired audio format
+ *  \return true if this sample has been set up from a preloaded one
+ */
+bool T_SoundSample::takePreloaded(const char *filename, SDL_AudioSpec *fmt)
+{
+  T_SoundSample* sample = NULL;
+
+  {
+    T_PreloadLock lock;
+    std::map<std::string, T_SoundSample*>::iterator it = preloaded.find(filename);
+    if (it != preloaded.end())
+    {
+      sample = it->second;
+      preloaded.erase(it);
+    }
+  }
+
+  if (sample == NULL)
+    return false;
+
+  bool ok = (sample->spec.format   == fmt->format
+             && sample->spec.channels == fmt->channels
+             && sample->spec.freq     == fmt->freq);
+  if (ok)
+  {
+    samplename = sample->samplename;
+    spec       = sample->spec;
+    length     = sample->length;
+    buffer     = sample->buffer;
+    sample->buffer = NULL;
+  }
+  delete sample;
+  return ok;
+}
+
+
 /** \brief Convert the sample to the given format.
  *
  *  Converts the sample to the audio format specified
@@ -37,6 +37,7 @@
 #include <stdexcept>
 #include <string>
 #include <vector>
+#include <map>
 #include <math.h>
 #include <SDL.h>
 #include "mod_misc/SimpleXMLTransfer.h"
@@ -187,6 +188,25 @@ class T_SoundSample
      *  full path that was specified in the ctor.
      */
     std::string getName() {return samplename;};
+
+    /** \brief Decode a sample ahead of time.
+     *
+     *  Reads and converts a file, possibly in another thread. The
+     *  next sample created from this file for the same format takes
+     *  over the data instead of reading the file again. Errors are
+     *  ignored, they show up when the sample is created.
+     *
+     *  \param filename the file to be loaded
+     *  \param fmt desired audio format
+     */
+    static void preload(const char *filename, SDL_AudioSpec *fmt);
+
+    /** \brief Free the preloaded samples which haven't been used.
+     *
+     *  Has to be called when no more samples are preloaded, i.e.
+     *  after the startup tasks have ended.
+     */
+    static void releasePreloaded();
   
    protected:
     std::string   samplename;   ///< sample filename, including full path
@@ -197,6 +217,12 @@ class T_SoundSample
     int   getSampleSize();
     int   bits();
     bool  isSigned();
+
+  private:
+    bool  takePreloaded(const char *filename, SDL_AudioSpec *fmt);
+
+    /// protected by T_PreloadLock (crrc_soundserver.cpp)
+    static std::map<std::string, T_SoundSample*> preloaded;
 };
 
 
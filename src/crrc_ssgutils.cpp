@@ -26,8 +26,25 @@
  */
 
 #include "crrc_ssgutils.h"
+#include "mod_misc/filesystools.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef WIN32
+# include <process.h>
+# include <io.h>
+#else
+# include <unistd.h>
+# include <errno.h>
+#endif
 //#include <iostream>
 
+// texture loaders from plib and mod_landscape/ssgLoadJPG.cpp
+bool ssgLoadSGI(const char* fname, ssgTextureInfo* info);
+bool ssgLoadJPG(const char* fname, ssgTextureInfo* info);
+
 
 /**
  *  \brief Locate a named SSG node in a branch.
@@ -196,3 +213,185 @@ void SSGUtil::removeLeafFromGraph(ssgLeaf *leaf)
   }
 }
 
+
+
+#ifndef WIN32
+/**
+ *  Directory for temporary files which only the user can access,
+ *  $TMPDIR/crrcsim-<uid>. Returns false if it can't be created or
+ *  if something else (like a link) is in its place.
+ */
+static bool getPrivateTempDir(std::string& path)
+{
+  const char* dir = getenv("TMPDIR");
+  char        name[32];
+  struct stat st;
+
+  sprintf(name, "/crrcsim-%lu", (unsigned long)getuid());
+  path = std::string((dir != NULL && *dir) ? dir : "/tmp") + name;
+
+  if (mkdir(path.c_str(), 0700) != 0 && errno != EEXIST)
+  {
+    return false;
+  }
+  return (lstat(path.c_str(), &st) == 0
+          && S_ISDIR(st.st_mode)
+          && st.st_uid == getuid()
+          && (st.st_mode & 077) == 0);
+}
+#endif
+
+
+/**
+ *  plib is only able to load models and textures from a file.
+ *  If <code>fname</code> is in a mounted data pack, it is written
+ *  to a temporary file with the same extension.
+ *
+ *  \param  fname  file which plib wants to read
+ *  \param  tmp    will be set to the name of the temporary file
+ *  \return true if the temporary file has been written and has to be
+ *          removed after loading
+ */
+static bool extractFromPack(const char* fname, std::string& tmp)
+{
+  std::string            item;
+  FileSysTools::Archive* pack;
+
+  if (fname == NULL)
+  {
+    return false;
+  }
+
+  // files on disk take precedence
+  FILE* fp = fopen(fname, "rb");
+  if (fp != NULL)
+  {
+    fclose(fp);
+    return false;
+  }
+  if ((pack = FileSysTools::findArchive(fname, item)) == NULL)
+  {
+    return false;
+  }
+
+  unsigned long len;
+  const char*   data = pack->open(item, len);
+  if (data == NULL)
+  {
+    return false;
+  }
+
+  std::string ext;
+  std::string::size_type dot = item.rfind('.');
+
+  if (dot != std::string::npos && item.find('/', dot) == std::string::npos)
+  {
+    ext = item.substr(dot);
+  }
+
+  // The file is created exclusively, so an attacker can't make us
+  // write through a link put there in advance.
+  int fd = -1;
+#ifdef WIN32
+  // TEMP is private to the user on Windows. Models are only loaded by
+  // the main thread, so a plain counter makes the name unique.
+  static int  count = 0;
+  const char* dir   = getenv("TEMP");
+  char        name[64];
+
+  sprintf(name, "crrcsim-pack-%d-%d", (int)getpid(), ++count);
+  tmp = std::string((dir != NULL && *dir) ? dir : ".") + "/" + name + ext;
+  fd  = _open(tmp.c_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  if (getPrivateTempDir(tmp))
+  {
+    std::string templ = tmp + "/pack-XXXXXX" + ext;
+    std::vector<char> buf(templ.begin(), templ.end());
+
+    buf.push_back(0);
+    fd  = mkstemps(&buf[0], ext.length());
+    tmp = &buf[0];
+  }
+#endif
+
+  fp = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+  bool ok = (fp != NULL);
+  if (ok)
+  {
+    ok = (len == 0 || fwrite(data, len, 1, fp) == 1);
+    ok = (fclose(fp) == 0) && ok;
+  }
+  pack->close(data);
+
+  if (!ok)
+  {
+    fprintf(stderr, "Unable to extract %s to %s\n", fname, tmp.c_str());
+    if (fd >= 0)
+    {
+      if (fp == NULL)
+        close(fd);
+      remove(tmp.c_str());
+    }
+  }
+  return ok;
+}
+
+
+static ssgEntity* loadAC(const char* fname, const ssgLoaderOptions* options)
+{
+  std::string tmp;
+
+  if (!extractFromPack(fname, tmp))
+  {
+    return ssgLoadAC(fname, options);
+  }
+  ssgEntity* model = ssgLoadAC(tmp.c_str(), options);
+  remove(tmp.c_str());
+  return model;
+}
+
+
+static bool loadTexture(const char* fname, ssgTextureInfo* info,
+                        bool (*loader)(const char*, ssgTextureInfo*))
+{
+  std::string tmp;
+
+  if (!extractFromPack(fname, tmp))
+  {
+    return loader(fname, info);
+  }
+  bool ok = loader(tmp.c_str(), info);
+  remove(tmp.c_str());
+  return ok;
+}
+
+
+static bool loadSGI(const char* fname, ssgTextureInfo* info)
+{
+  return loadTexture(fname, info, ssgLoadSGI);
+}
+
+
+static bool loadJPG(const char* fname, ssgTextureInfo* info)
+{
+  return loadTexture(fname, info, ssgLoadJPG);
+}
+
+
+/**
+ *  Replaces the plib loaders for the model and texture formats used
+ *  by CRRCsim with wrappers which extract files from mounted data
+ *  packs to a temporary file first. Files on disk are passed to the
+ *  original loaders directly.
+ */
+void SSGUtil::addDataPackLoaders()
+{
+  static const char* sgi[] = { ".rgb", ".rgba", ".int", ".inta", ".sgi", ".bw" };
+
+  ssgAddModelFormat(".ac", loadAC, ssgSaveAC);
+  for (unsigned int i = 0; i < sizeof(sgi) / sizeof(sgi[0]); i++)
+  {
+    ssgAddTextureFormat(sgi[i], loadSGI);
+  }
+  ssgAddTextureFormat(".jpg", loadJPG);
+}
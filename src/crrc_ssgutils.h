@@ -67,6 +67,13 @@ SSGUtil::NodeAttributes getNodeAttributes(ssgEntity* node);
 /** Remove a leaf node from a scenegraph */
 void removeLeafFromGraph(ssgLeaf *leaf);
 
+/**
+ *  Register model and texture loaders which are able to read
+ *  files from mounted data packs. Has to be called after
+ *  ssgInit().
+ */
+void addDataPackLoaders();
+
 } // end namespace
 
 #endif  // CRRC_SSGUTILS_H_
@@ -0,0 +1,310 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file crrc_startup.cpp
+ *
+ *  Implementation of the startup tasks and report.
+ */
+
+#include "crrc_startup.h"
+
+#include <stdio.h>
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <unistd.h>     // sysconf
+# include <sys/time.h>   // gettimeofday
+#endif
+
+
+std::vector<StartupTasks::T_Task> StartupTasks::tasks;
+std::vector<SDL_Thread*>          StartupTasks::threads;
+SDL_mutex* StartupTasks::mutex       = NULL;
+SDL_cond*  StartupTasks::cond        = NULL;
+bool       StartupTasks::fQuit       = false;
+int        StartupTasks::nextThread  = 1;
+int        StartupTasks::current     = -1;
+double     StartupTasks::t0          = 0;
+bool       StartupTasks::fFirstFrame = false;
+
+
+/**
+ *  Wall clock time in milliseconds (SDL_GetTicks() doesn't work
+ *  before SDL_Init()).
+ */
+double StartupTasks::getTime()
+{
+#ifdef WIN32
+  LARGE_INTEGER freq;
+  LARGE_INTEGER count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (1000.0 * (double)count.QuadPart / (double)freq.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (1000.0 * tv.tv_sec + 0.001 * tv.tv_usec);
+#endif
+}
+
+
+// see header
+void StartupTasks::begin(const char* name)
+{
+  t0          = getTime();
+  fQuit       = false;
+  fFirstFrame = false;
+  mutex       = SDL_CreateMutex();
+  cond        = SDL_CreateCond();
+  phase(name);
+}
+
+
+// see header
+void StartupTasks::startThreads(int nThreads)
+{
+  if (nThreads == 0)
+  {
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    nThreads = (int)info.dwNumberOfProcessors - 1;
+#else
+    nThreads = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+#endif
+    if (nThreads > 4)
+      nThreads = 4;
+  }
+
+  for (int i = 0; i < nThreads; i++)
+  {
+    SDL_Thread* thread = SDL_CreateThread(workerThread, NULL);
+    if (thread != NULL)
+      threads.push_back(thread);
+  }
+}
+
+
+// see header
+void StartupTasks::phase(const char* name)
+{
+  T_Task t;
+  double now = getTime() - t0;
+
+  t.name     = name;
+  t.func     = NULL;
+  t.data     = NULL;
+  t.after    = -1;
+  t.state    = TASK_RUNNING;
+  t.thread   = 0;
+  t.start    = now;
+  t.duration = 0;
+  t.waited   = 0;
+
+  SDL_mutexP(mutex);
+  if (current >= 0)
+  {
+    tasks[current].state    = TASK_DONE;
+    tasks[current].duration = now - tasks[current].start;
+  }
+  tasks.push_back(t);
+  current = tasks.size() - 1;
+  SDL_mutexV(mutex);
+}
+
+
+// see header
+int StartupTasks::add(const char* name, T_TaskFunc func, void* data, int after)
+{
+  T_Task t;
+  int    id;
+
+  t.name     = name;
+  t.func     = func;
+  t.data     = data;
+  t.after    = after;
+  t.state    = TASK_WAITING;
+  t.thread   = 0;
+  t.start    = 0;
+  t.duration = 0;
+  t.waited   = 0;
+
+  SDL_mutexP(mutex);
+  tasks.push_back(t);
+  id = tasks.size() - 1;
+  SDL_CondBroadcast(cond);
+  SDL_mutexV(mutex);
+
+  return (id);
+}
+
+
+/**
+ *  First task which is waiting and may start, -1 if there is none.
+ *  mutex has to be locked.
+ */
+int StartupTasks::findReadyTask()
+{
+  for (unsigned int i = 0; i < tasks.size(); i++)
+  {
+    if (tasks[i].state == TASK_WAITING
+        && (tasks[i].after < 0 || tasks[tasks[i].after].state == TASK_DONE))
+      return (i);
+  }
+  return (-1);
+}
+
+
+/**
+ *  Run a task which has been found by findReadyTask(). mutex has to be
+ *  locked, it is unlocked while the task runs.
+ */
+void StartupTasks::runTask(int task, int thread)
+{
+  T_TaskFunc func  = tasks[task].func;
+  void*      data  = tasks[task].data;
+  double     start = getTime() - t0;
+
+  tasks[task].state  = TASK_RUNNING;
+  tasks[task].thread = thread;
+  tasks[task].start  = start;
+  SDL_mutexV(mutex);
+
+  func(data);
+
+  double end = getTime() - t0;
+  SDL_mutexP(mutex);
+  tasks[task].state    = TASK_DONE;
+  tasks[task].duration = end - start;
+  SDL_CondBroadcast(cond);
+}
+
+
+/**
+ *  Runs tasks until end() is called.
+ */
+int StartupTasks::workerThread(void*)
+{
+  SDL_mutexP(mutex);
+  int thread = nextThread++;
+
+  while (true)
+  {
+    int task = findReadyTask();
+
+    if (task >= 0)
+      runTask(task, thread);
+    else if (fQuit)
+      break;
+    else
+      SDL_CondWait(cond, mutex);
+  }
+  SDL_mutexV(mutex);
+
+  return 0;
+}
+
+
+// see header
+void StartupTasks::wait(int task)
+{
+  double start = getTime();
+
+  SDL_mutexP(mutex);
+  while (task >= 0 && tasks[task].state != TASK_DONE)
+  {
+    int ready = findReadyTask();
+
+    if (threads.size() == 0 && ready >= 0)
+      runTask(ready, 0);
+    else
+      SDL_CondWait(cond, mutex);
+  }
+  if (current >= 0)
+    tasks[current].waited += getTime() - start;
+  SDL_mutexV(mutex);
+}
+
+
+// see header
+void StartupTasks::end()
+{
+  double now = getTime() - t0;
+
+  SDL_mutexP(mutex);
+  if (current >= 0)
+  {
+    tasks[current].state    = TASK_DONE;
+    tasks[current].duration = now - tasks[current].start;
+    current = -1;
+  }
+  SDL_mutexV(mutex);
+
+  for (unsigned int i = 0; i < tasks.size(); i++)
+    wait(i);
+
+  SDL_mutexP(mutex);
+  fQuit = true;
+  SDL_CondBroadcast(cond);
+  SDL_mutexV(mutex);
+  for (unsigned int i = 0; i < threads.size(); i++)
+    SDL_WaitThread(threads[i], NULL);
+  threads.clear();
+
+  double total = getTime() - t0;
+
+  printf("Startup (%d worker threads):\n", nextThread - 1);
+  printf("  phase/task                      thread   start/ms  duration/ms\n");
+  for (unsigned int i = 0; i < tasks.size(); i++)
+  {
+    const T_Task& t = tasks[i];
+    char          thread[16];
+
+    if (t.thread == 0)
+      sprintf(thread, "main");
+    else
+      sprintf(thread, "%d", t.thread);
+
+    printf("  %-30s  %-6s  %9.1f  %11.1f", t.name.c_str(), thread, t.start, t.duration);
+    if (t.waited >= 0.05)
+      printf("  (%.1f waiting)", t.waited);
+    printf("\n");
+  }
+  printf("  total                                   %9.1f\n", total);
+
+  tasks.clear();
+  SDL_DestroyCond(cond);
+  SDL_DestroyMutex(mutex);
+  cond  = NULL;
+  mutex = NULL;
+}
+
+
+// see header
+void StartupTasks::frameDrawn()
+{
+  if (!fFirstFrame)
+  {
+    fFirstFrame = true;
+    printf("Time to first frame: %.1f ms\n", getTime() - t0);
+  }
+}
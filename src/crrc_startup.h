@@ -0,0 +1,155 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+/** \file crrc_startup.h
+ *
+ *  Startup tasks which run in parallel and the startup report.
+ */
+
+#ifndef CRRC_STARTUP_H
+#define CRRC_STARTUP_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+
+/** \brief Tasks which run in parallel during startup
+ *
+ *  main() runs its startup phases one after the other, because most of
+ *  them need the OpenGL context or change global state. Work which
+ *  doesn't (reading files, decoding samples, scanning the models) is
+ *  handed to a few worker threads and runs in the meantime:
+ *
+ *  - phase() marks the start of a phase of the main thread.
+ *  - add() queues a background task. It is started as soon as the task
+ *    it depends on has finished.
+ *  - wait() blocks until a task has finished, before the main thread
+ *    uses its result.
+ *  - end() waits for all tasks and prints the duration of each phase
+ *    and task.
+ *
+ *  Background tasks must only use code which may run in several
+ *  threads at the same time, like FileSysTools::getDataPath(),
+ *  XMLModelCache::load() or T_SoundSample::preload(), and must not
+ *  throw exceptions.
+ *
+ *  Configuration (see documentation/options.txt): startup.threads
+ */
+class StartupTasks
+{
+  public:
+    typedef void (*T_TaskFunc)(void* data);
+
+    /**
+     *  Start the clock of the report. The first phase starts now.
+     *
+     *  \param name name of the first phase
+     */
+    static void begin(const char* name);
+
+    /**
+     *  Start the worker threads.
+     *
+     *  \param nThreads number of threads, 0: one less than the number
+     *                  of processors (at most 4), negative: none.
+     *                  Without threads, the tasks run in the main
+     *                  thread when it waits for them.
+     */
+    static void startThreads(int nThreads);
+
+    /**
+     *  The previous phase of the main thread has ended, the next one
+     *  starts.
+     */
+    static void phase(const char* name);
+
+    /**
+     *  Queue a background task.
+     *
+     *  \param name  name in the report
+     *  \param func  function to call
+     *  \param data  passed to func
+     *  \param after task which has to be finished first, -1 if none
+     *  \return id of the task
+     */
+    static int add(const char* name, T_TaskFunc func, void* data, int after = -1);
+
+    /**
+     *  Wait until a task has finished.
+     */
+    static void wait(int task);
+
+    /**
+     *  End the last phase, wait for all tasks, stop the threads and
+     *  print the report.
+     */
+    static void end();
+
+    /**
+     *  Has to be called after a frame has been drawn. Prints the time
+     *  since begin() after the first one.
+     */
+    static void frameDrawn();
+
+  private:
+    enum
+    {
+      TASK_WAITING = 0,
+      TASK_RUNNING,
+      TASK_DONE
+    };
+
+    /**
+     *  A background task or a phase of the main thread
+     */
+    typedef struct
+    {
+      std::string name;
+      T_TaskFunc  func;       ///< NULL for phases of the main thread
+      void*       data;
+      int         after;      ///< task which has to be finished first, -1 if none
+      int         state;
+      int         thread;     ///< 0: main thread, 1...: worker threads
+      double      start;      ///< ms since begin()
+      double      duration;   ///< ms
+      double      waited;     ///< ms the main thread waited for tasks in this phase
+    } T_Task;
+
+    static double getTime();
+    static int    findReadyTask();
+    static void   runTask(int task, int thread);
+    static int    workerThread(void* data);
+
+    static std::vector<T_Task>      tasks;     ///< protected by mutex
+    static std::vector<SDL_Thread*> threads;
+    static SDL_mutex* mutex;
+    static SDL_cond*  cond;
+    static bool       fQuit;                   ///< protected by mutex
+    static int        nextThread;              ///< protected by mutex
+    static int        current;                 ///< current phase of the main thread
+    static double     t0;                      ///< getTime() at begin()
+    static bool       fFirstFrame;
+};
+
+#endif
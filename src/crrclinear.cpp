@@ -0,0 +1,573 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+
+/** \file crrclinear.cpp
+ *
+ *  Command line tool which linearizes a model around trimmed glides.
+ *
+ *  Usage: crrclinear [options] <airplane.xml> <linear.m>
+ *
+ *  For every speed the model is trimmed like in crrcpolar (see
+ *  glidetrim.h). The state of the flight model is saved, then every
+ *  state and every input is moved a little to both sides and the
+ *  state derivative is evaluated; restoring the snapshot in between.
+ *  Central differences give the matrices of
+ *
+ *    d(dx)/dt = A dx + B du
+ *
+ *  with x = (u, v, w, p, q, r, phi, theta, psi) and
+ *  u = (elevator, aileron, rudder), which are written as an Octave
+ *  script. The eigenvalues of the longitudinal (u, w, q, theta) and
+ *  lateral (v, p, r, phi) parts tell the modes: phugoid and short
+ *  period, spiral, roll and dutch roll.
+ *
+ *  A trim takes much longer than the few dozen derivatives, so the
+ *  speeds are linearized in parallel, each with its own flight model.
+ */
+
+#include "mod_fdm/fdm.h"
+#include "mod_fdm/fdm_inputs.h"
+#include "mod_fdm/xmlmodelfile.h"
+#include "mod_cntrl/cntrl_airspeed/glidetrim.h"
+#include "mod_math/eigenvalues.h"
+#include "mod_misc/SimpleXMLTransfer.h"
+
+#include <SDL.h>
+#ifndef WIN32
+# include <unistd.h>   // sysconf
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex>
+#include <string>
+#include <vector>
+
+
+#define NX     FDMBase::NUM_STATES
+#define NU     3                  // elevator, aileron, rudder
+#define DX_REL 1e-4               // state step, relative to max(1, |x|)
+#define DU     1e-3               // input step
+
+
+/**
+ *  One trim point and its linear model, in SI units
+ */
+typedef struct
+{
+  double  v_set;      ///< speed setpoint in m/s
+  T_Glide glide;
+  double  u0[NU];     ///< trimmed inputs
+  double  x0[NX];     ///< trimmed state
+  double  res[NX];    ///< state derivative at the trimmed state
+  double  A[NX][NX];
+  double  B[NX][NU];
+  bool    fValid;
+} T_LinPoint;
+
+
+/**
+ *  The points and everything needed to fly them, shared by all threads
+ */
+typedef struct
+{
+  std::string             file;        ///< airplane description
+  SimpleXMLTransfer*      cfg;         ///< simulation.flightModel.*
+  double                  v_trim;      ///< trimmed flight velocity in m/s
+  double                  flap;
+  std::vector<T_LinPoint> points;
+  unsigned int            next_point;  ///< next point to fly, protected by mutex
+  SDL_mutex*              mutex;       ///< also protects loading the airplane
+} T_LinJob;
+
+
+static const char* stateNames[NX] = { "u", "v", "w", "p", "q", "r", "phi", "theta", "psi" };
+static const char* inputNames[NU] = { "elevator", "aileron", "rudder" };
+
+
+/**
+ *  Number of processors available, used as default number of threads
+ */
+static int getNumberOfProcessors()
+{
+#ifdef WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return ((int)info.dwNumberOfProcessors);
+#else
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return ((n > 0) ? (int)n : 1);
+#endif
+}
+
+
+static float* input(TSimInputs* inputs, int i)
+{
+  switch (i)
+  {
+    case 0:
+      return(&inputs->elevator);
+    case 1:
+      return(&inputs->aileron);
+    default:
+      return(&inputs->rudder);
+  }
+}
+
+
+/**
+ *  State derivative at x for the inputs
+ */
+static void derivative(FDMBase* fdm, const double* x, TSimInputs* inputs, double* x_dot)
+{
+  fdm->setState(x);
+  fdm->getStateDerivative(inputs, x_dot);
+}
+
+
+/**
+ *  Trim the model at one speed and linearize it.
+ */
+static void linearizePoint(T_LinJob* job, T_LinPoint* p)
+{
+  SimpleXMLTransfer* model = NULL;
+  ModFDMInterface    fdm;
+  GlideEnv           env(p->v_set, job->flap);
+
+  p->fValid = false;
+
+  // The flight model adds its own values to the description, so every
+  // point needs a fresh copy.
+  SDL_LockMutex(job->mutex);
+  try
+  {
+    model = new SimpleXMLTransfer(job->file);
+    XMLModelFile::ListOptions(model);
+    fdm.loadAirplane(model, &env, job->cfg);
+    fdm.initAirplaneState(p->v_set / job->v_trim, 0.0, 0.0, 0.0, 0.0, -GLIDE_START_HEIGHT);
+  }
+  catch (XMLException& e)
+  {
+    SDL_UnlockMutex(job->mutex);
+    fprintf(stderr, "%s\n", e.what());
+    delete model;
+    return;
+  }
+  SDL_UnlockMutex(job->mutex);
+
+  if (fdm.fdm->hasState() &&
+      glide(&fdm, &env, job->cfg->getDouble("simulation.flightModel.dt", 0.002777), &p->glide))
+  {
+    TSimInputs u0;
+    TSimInputs u;
+    double     x0[NX];
+    double     x[NX];
+    double     f_plus[NX];
+    double     f_minus[NX];
+
+    u0.CopyFrom(env.getInputs());
+    fdm.fdm->getState(x0);
+
+    for (int j=0; j<NX; j++)
+    {
+      double h = DX_REL * ((fabs(x0[j]) > 1) ? fabs(x0[j]) : 1);
+
+      memcpy(x, x0, sizeof(x));
+      x[j] = x0[j] + h;
+      derivative(fdm.fdm, x, &u0, f_plus);
+      x[j] = x0[j] - h;
+      derivative(fdm.fdm, x, &u0, f_minus);
+      for (int i=0; i<NX; i++)
+        p->A[i][j] = (f_plus[i] - f_minus[i]) / (2 * h);
+    }
+
+    for (int j=0; j<NU; j++)
+    {
+      u.CopyFrom(&u0);
+      *input(&u, j) = *input(&u0, j) + DU;
+      derivative(fdm.fdm, x0, &u, f_plus);
+      *input(&u, j) = *input(&u0, j) - DU;
+      derivative(fdm.fdm, x0, &u, f_minus);
+      for (int i=0; i<NX; i++)
+        p->B[i][j] = (f_plus[i] - f_minus[i]) / (2 * DU);
+      p->u0[j] = *input(&u0, j);
+    }
+
+    derivative(fdm.fdm, x0, &u0, p->res);
+
+    // ft -> m
+    for (int i=0; i<NX; i++)
+    {
+      bool fVel_i = (i <= FDMBase::STATE_W);
+
+      p->x0[i] = x0[i];
+      if (fVel_i)
+      {
+        p->x0[i]  *= 0.3048;
+        p->res[i] *= 0.3048;
+        for (int j=0; j<NU; j++)
+          p->B[i][j] *= 0.3048;
+      }
+      for (int j=0; j<NX; j++)
+      {
+        bool fVel_j = (j <= FDMBase::STATE_W);
+
+        if (fVel_i && !fVel_j)
+          p->A[i][j] *= 0.3048;
+        else if (fVel_j && !fVel_i)
+          p->A[i][j] /= 0.3048;
+      }
+    }
+    p->fValid = true;
+  }
+
+  fdm.Clean();
+  delete model;
+}
+
+
+/**
+ *  Worker thread: takes one point after the other until all are done.
+ */
+static int linearThread(void* data)
+{
+  T_LinJob* job = (T_LinJob*)data;
+
+  while (true)
+  {
+    SDL_LockMutex(job->mutex);
+    unsigned int i = job->next_point++;
+    SDL_UnlockMutex(job->mutex);
+
+    if (i >= job->points.size())
+      break;
+
+    linearizePoint(job, &job->points[i]);
+  }
+
+  return 0;
+}
+
+
+/**
+ *  Eigenvalues of the part of A which belongs to the four states idx
+ */
+static void subsystemEigenvalues(T_LinPoint* p, const int* idx, std::complex<double>* lambda)
+{
+  double a[16];
+
+  for (int i=0; i<4; i++)
+    for (int j=0; j<4; j++)
+      a[i*4+j] = p->A[idx[i]][idx[j]];
+  CRRCMath::eigenvalues(4, a, lambda);
+}
+
+
+/**
+ *  One line describing an oscillation (complex pair) or an aperiodic
+ *  mode (real eigenvalue)
+ */
+static void printMode(FILE* fp, const char* name, std::complex<double> lambda)
+{
+  double re = lambda.real();
+  double im = fabs(lambda.imag());
+
+  if (im > 0)
+  {
+    double wn = abs(lambda);
+    fprintf(fp, "%%   %-12s %9.4f +-%8.4fi  omega_n %7.3f rad/s, zeta %6.3f, period %7.2f s\n",
+            name, re, im, wn, -re / wn, 2 * M_PI / im);
+  }
+  else if (re < 0)
+    fprintf(fp, "%%   %-12s %9.4f            time constant %7.2f s\n", name, re, -1 / re);
+  else if (re > 0)
+    fprintf(fp, "%%   %-12s %9.4f            time to double %7.2f s\n", name, re, log(2.0) / re);
+  else
+    fprintf(fp, "%%   %-12s %9.4f\n", name, re);
+}
+
+
+/**
+ *  Longitudinal modes: the slower pair is the phugoid, the faster one
+ *  the short period. Lateral modes: a complex pair is the dutch roll,
+ *  of the real eigenvalues the slower one is the spiral and the faster
+ *  one the roll mode.
+ */
+static void printModes(FILE* fp, T_LinPoint* p)
+{
+  const int            lon[4] = { FDMBase::STATE_U, FDMBase::STATE_W, FDMBase::STATE_Q, FDMBase::STATE_THETA };
+  const int            lat[4] = { FDMBase::STATE_V, FDMBase::STATE_P, FDMBase::STATE_R, FDMBase::STATE_PHI };
+  std::complex<double> lambda[4];
+
+  subsystemEigenvalues(p, lon, lambda);
+  if (lambda[0].imag() != 0)
+    printMode(fp, "phugoid", lambda[0]);
+  else
+  {
+    printMode(fp, "phugoid", lambda[0]);
+    printMode(fp, "phugoid", lambda[1]);
+  }
+  if (lambda[2].imag() != 0)
+    printMode(fp, "short period", lambda[2]);
+  else
+  {
+    printMode(fp, "short period", lambda[2]);
+    printMode(fp, "short period", lambda[3]);
+  }
+
+  subsystemEigenvalues(p, lat, lambda);
+  std::vector<std::complex<double> > real;
+  bool                               fDutchRoll = false;
+
+  for (int i=0; i<4; i++)
+  {
+    if (lambda[i].imag() == 0)
+      real.push_back(lambda[i]);
+    else if (lambda[i].imag() > 0)
+    {
+      printMode(fp, "dutch roll", lambda[i]);
+      fDutchRoll = true;
+    }
+  }
+  if (fDutchRoll && real.size() == 2)
+  {
+    printMode(fp, "spiral", real[0]);
+    printMode(fp, "roll", real[1]);
+  }
+  else
+  {
+    for (unsigned int i=0; i<real.size(); i++)
+      printMode(fp, "lateral", real[i]);
+  }
+}
+
+
+/**
+ *  A matrix in Octave syntax
+ */
+static void printMatrix(FILE* fp, const char* name, int n, const double* a, int m)
+{
+  fprintf(fp, "%s = [\n", name);
+  for (int i=0; i<n; i++)
+  {
+    for (int j=0; j<m; j++)
+      fprintf(fp, " %13.6g", a[i*m+j]);
+    fprintf(fp, (i < n-1) ? "\n" : " ];\n");
+  }
+}
+
+
+static void usage(const char* name)
+{
+  fprintf(stderr, "Usage: %s [options] <airplane.xml> <linear.m>\n", name);
+  fprintf(stderr, "  Linearizes a model around trimmed glides and writes the state space\n");
+  fprintf(stderr, "  matrices and modes as an Octave script.\n");
+  fprintf(stderr, "  -v <speed>[,<speed>...]  speeds in m/s (default: 1, 1.5 and 2 times the\n");
+  fprintf(stderr, "                           trimmed flight velocity)\n");
+  fprintf(stderr, "  -f <flap>                flap input, 0..1 (default: 0)\n");
+  fprintf(stderr, "  -c <file>                configuration file (simulation.flightModel.*)\n");
+  fprintf(stderr, "  -j <threads>             number of threads (default: number of processors)\n");
+}
+
+
+int main(int argc, char** argv)
+{
+  T_LinJob            job;
+  SimpleXMLTransfer*  cfg      = NULL;
+  std::string         speeds   = "";
+  int                 nThreads = 0;
+  int                 arg;
+  bool                fHasState;
+  std::vector<double> v;
+
+  job.flap = 0;
+
+  for (arg = 1; arg < argc - 2 && argv[arg][0] == '-'; arg += 2)
+  {
+    if (strcmp(argv[arg], "-v") == 0)
+      speeds = argv[arg + 1];
+    else if (strcmp(argv[arg], "-f") == 0)
+      job.flap = atof(argv[arg + 1]);
+    else if (strcmp(argv[arg], "-c") == 0)
+      cfg = new SimpleXMLTransfer(argv[arg + 1]);
+    else if (strcmp(argv[arg], "-j") == 0)
+      nThreads = atoi(argv[arg + 1]);
+    else
+      break;
+  }
+
+  if (argc - arg != 2)
+  {
+    usage(argv[0]);
+    return (1);
+  }
+
+  std::string outfile = argv[arg + 1];
+
+  if (cfg == NULL)
+    cfg = new SimpleXMLTransfer();
+  cfg->setAttributeOverwrite("airplane.verbosity", "0");
+
+  job.file = argv[arg];
+  job.cfg  = cfg;
+
+  // trimmed flight velocity, for the default speeds
+  try
+  {
+    SimpleXMLTransfer model(job.file);
+    GlideEnv          env(1, 0);
+    ModFDMInterface   fdm;
+
+    XMLModelFile::ListOptions(&model);
+    fdm.loadAirplane(&model, &env, cfg);
+    job.v_trim = fdm.fdm->getTrimmedFlightVelocity() * 0.3048;
+    fHasState  = fdm.fdm->hasState();
+    fdm.Clean();
+  }
+  catch (XMLException& e)
+  {
+    fprintf(stderr, "%s\n", e.what());
+    return (1);
+  }
+
+  if (!fHasState)
+  {
+    fprintf(stderr, "The flight model of %s can't be linearized\n", job.file.c_str());
+    return (1);
+  }
+
+  if (speeds == "")
+  {
+    if (job.v_trim <= 0)
+    {
+      fprintf(stderr, "%s has no trimmed flight velocity, please use -v\n", job.file.c_str());
+      return (1);
+    }
+    v.push_back(job.v_trim);
+    v.push_back(1.5 * job.v_trim);
+    v.push_back(2.0 * job.v_trim);
+  }
+  for (const char* s = speeds.c_str(); *s; )
+  {
+    char*  end;
+    double f = strtod(s, &end);
+
+    if (end == s || f <= 0)
+    {
+      usage(argv[0]);
+      return (1);
+    }
+    v.push_back(f);
+    s = (*end == ',') ? end + 1 : end;
+  }
+
+  for (unsigned int i = 0; i < v.size(); i++)
+  {
+    T_LinPoint p;
+
+    p.v_set  = v[i];
+    p.fValid = false;
+    job.points.push_back(p);
+  }
+
+  if (nThreads < 1)
+    nThreads = getNumberOfProcessors();
+
+  job.next_point = 0;
+  job.mutex      = SDL_CreateMutex();
+
+  std::vector<SDL_Thread*> threads;
+  for (int i = 1; i < nThreads; i++)
+  {
+    SDL_Thread* thread = SDL_CreateThread(linearThread, &job);
+    if (thread != NULL)
+      threads.push_back(thread);
+  }
+  // this thread takes part, too
+  linearThread(&job);
+  for (unsigned int i = 0; i < threads.size(); i++)
+    SDL_WaitThread(threads[i], NULL);
+
+  SDL_DestroyMutex(job.mutex);
+
+  FILE* fp     = fopen(outfile.c_str(), "w");
+  int   nValid = 0;
+
+  if (fp == NULL)
+  {
+    fprintf(stderr, "Unable to write %s\n", outfile.c_str());
+    return (1);
+  }
+
+  fprintf(fp, "%% %s, flap %g\n", job.file.c_str(), job.flap);
+  fprintf(fp, "%% x = [u v w] (m/s, body axes), [p q r] (rad/s), [phi theta psi] (rad)\n");
+  fprintf(fp, "%% u = [elevator aileron rudder]\n");
+  for (unsigned int n = 0; n < job.points.size(); n++)
+  {
+    T_LinPoint* p = &job.points[n];
+
+    fprintf(fp, "\n%% speed %.3f m/s", p->v_set);
+    if (!p->fValid)
+    {
+      fprintf(fp, ": no steady glide\n");
+      continue;
+    }
+    nValid++;
+
+    double res = 0;
+    for (int i=0; i<NX; i++)
+      if (fabs(p->res[i]) > res)
+        res = fabs(p->res[i]);
+
+    fprintf(fp, ", sink %.4f m/s, alpha %.3f deg, largest derivative at trim %.2g\n",
+            p->glide.sink, p->glide.alpha, res);
+    fprintf(fp, "%%");
+    for (int i=0; i<NX; i++)
+      fprintf(fp, " %s %.5g", stateNames[i], p->x0[i]);
+    for (int i=0; i<NU; i++)
+      fprintf(fp, " %s %.5g", inputNames[i], p->u0[i]);
+    fprintf(fp, "\n");
+    printModes(fp, p);
+    printMatrix(fp, "A", NX, &p->A[0][0], NX);
+    printMatrix(fp, "B", NX, &p->B[0][0], NU);
+    fprintf(fp, "lin{%d} = struct('v', %.3f, 'A', A, 'B', B);\n", nValid, p->v_set);
+  }
+
+  bool ok = (ferror(fp) == 0);
+  if (fclose(fp) != 0)
+    ok = false;
+  if (!ok)
+  {
+    fprintf(stderr, "Unable to write %s\n", outfile.c_str());
+    return (1);
+  }
+
+  printf("%s: %d of %lu points linearized, written to %s\n", job.file.c_str(),
+         nValid, (unsigned long)job.points.size(), outfile.c_str());
+
+  delete cfg;
+
+  return (0);
+}
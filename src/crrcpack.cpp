@@ -0,0 +1,144 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file crrcpack.cpp
+ *
+ *  Command line tool which puts the data files of CRRCsim
+ *  into a data pack (see mod_misc/datapack.h).
+ *
+ *  Usage: crrcpack [-z] <pack> <directory> [subdirectories...]
+ *
+ *  All files in the given subdirectories of <directory> (models,
+ *  objects, textures, sounds and scenery by default) are added
+ *  to <pack>. With -z, files are compressed if this makes them
+ *  noticeably smaller. Put the pack into a directory of the search
+ *  path to use it.
+ */
+
+#include "mod_misc/datapack.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+/**
+ *  Add all files in <code>root</code>/<code>dir</code> and its
+ *  subdirectories to <code>items</code>, relative to <code>root</code>.
+ *  Hidden files and the automake files are left out.
+ */
+static void addFiles(const std::string& root, const std::string& dir,
+                     std::vector<std::string>& items)
+{
+  DIR*           d = opendir((root + "/" + dir).c_str());
+  struct dirent* ent;
+
+  if (d == NULL)
+  {
+    fprintf(stderr, "Unable to open directory %s/%s\n", root.c_str(), dir.c_str());
+    return;
+  }
+
+  while ((ent = readdir(d)) != NULL)
+  {
+    std::string name = ent->d_name;
+    std::string item = dir + "/" + name;
+    struct stat st;
+
+    if (name[0] == '.'
+        || name == "Makefile" || name == "Makefile.am" || name == "Makefile.in")
+      continue;
+
+    if (stat((root + "/" + item).c_str(), &st) != 0)
+      continue;
+
+    if (S_ISDIR(st.st_mode))
+      addFiles(root, item, items);
+    else if (S_ISREG(st.st_mode))
+      items.push_back(item);
+  }
+  closedir(d);
+}
+
+
+int main(int argc, char** argv)
+{
+  bool                     fCompress = false;
+  int                      arg       = 1;
+  std::vector<std::string> dirs;
+  std::vector<std::string> items;
+
+  if (arg < argc && strcmp(argv[arg], "-z") == 0)
+  {
+    fCompress = true;
+    arg++;
+  }
+
+  if (argc - arg < 2)
+  {
+    fprintf(stderr, "Usage: %s [-z] <pack> <directory> [subdirectories...]\n", argv[0]);
+    fprintf(stderr, "  Puts the files in the subdirectories of <directory> into <pack>.\n");
+    fprintf(stderr, "  Default subdirectories: models objects textures sounds scenery\n");
+    fprintf(stderr, "  -z  compress files\n");
+    return (1);
+  }
+
+  std::string pack = argv[arg++];
+  std::string root = argv[arg++];
+
+  for (; arg < argc; arg++)
+    dirs.push_back(argv[arg]);
+
+  if (dirs.size() == 0)
+  {
+    dirs.push_back("models");
+    dirs.push_back("objects");
+    dirs.push_back("textures");
+    dirs.push_back("sounds");
+    dirs.push_back("scenery");
+  }
+
+  for (unsigned int i = 0; i < dirs.size(); i++)
+    addFiles(root, dirs[i], items);
+
+  if (items.size() == 0)
+  {
+    fprintf(stderr, "No files found in %s\n", root.c_str());
+    return (1);
+  }
+
+  std::string err = DataPack::create(pack, root, items, fCompress);
+  if (err != "")
+  {
+    fprintf(stderr, "%s\n", err.c_str());
+    return (1);
+  }
+
+  DataPack result(pack);
+  printf("Wrote %u files to %s\n", result.getCount(), pack.c_str());
+
+  return (0);
+}
@@ -0,0 +1,355 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+/** \file crrcpolar.cpp
+ *
+ *  Command line tool which calculates the glide polar of a model.
+ *
+ *  Usage: crrcpolar [options] <airplane.xml> <polar.csv>
+ *
+ *  For every speed and flap setting the flight model flies without
+ *  power and without wind while Cntrl_Airspeed holds the speed with
+ *  the elevator (see glidetrim.h). Once speed and elevator have settled, speed, sink
+ *  rate, glide ratio, angle of attack and elevator are measured and
+ *  written as one line of a CSV table. The points are independent of
+ *  each other and are flown in parallel. Points at which the model
+ *  cannot glide steadily (too slow, or too fast for the elevator)
+ *  are left out.
+ */
+
+#include "mod_fdm/fdm.h"
+#include "mod_fdm/fdm_env.h"
+#include "mod_fdm/fdm_inputs.h"
+#include "mod_fdm/xmlmodelfile.h"
+#include "mod_cntrl/cntrl_airspeed/glidetrim.h"
+#include "mod_misc/SimpleXMLTransfer.h"
+
+#include <SDL.h>
+#ifndef WIN32
+# include <unistd.h>   // sysconf
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+
+/**
+ *  One point of the polar
+ */
+typedef struct
+{
+  double flap;       ///< flap input
+  double v_set;      ///< speed setpoint in m/s
+  double speed;      ///< airspeed in m/s
+  double sink;       ///< sink rate in m/s
+  double ratio;      ///< glide ratio
+  double alpha;      ///< angle of attack in degrees
+  double elevator;   ///< elevator input
+  bool   fSettled;
+} T_Point;
+
+
+/**
+ *  The points and everything needed to fly them, shared by all threads
+ */
+typedef struct
+{
+  std::string          file;        ///< airplane description
+  SimpleXMLTransfer*   cfg;         ///< simulation.flightModel.*
+  double               v_trim;      ///< trimmed flight velocity in m/s
+  std::vector<T_Point> points;
+  unsigned int         next_point;  ///< next point to fly, protected by mutex
+  SDL_mutex*           mutex;       ///< also protects loading the airplane
+} T_PolarJob;
+
+
+/**
+ *  Number of processors available, used as default number of threads
+ */
+static int getNumberOfProcessors()
+{
+#ifdef WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return ((int)info.dwNumberOfProcessors);
+#else
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return ((n > 0) ? (int)n : 1);
+#endif
+}
+
+
+/**
+ *  Fly at one speed and flap setting until speed and elevator
+ *  have settled, then measure.
+ */
+static void flyPoint(T_PolarJob* job, T_Point* p)
+{
+  SimpleXMLTransfer* model = NULL;
+  ModFDMInterface    fdm;
+  GlideEnv           env(p->v_set, p->flap);
+  T_Glide            g;
+
+  p->fSettled = false;
+
+  // The flight model adds its own values to the description, so every
+  // point needs a fresh copy.
+  SDL_LockMutex(job->mutex);
+  try
+  {
+    model = new SimpleXMLTransfer(job->file);
+    XMLModelFile::ListOptions(model);
+    fdm.loadAirplane(model, &env, job->cfg);
+    fdm.initAirplaneState(p->v_set / job->v_trim, 0.0, 0.0, 0.0, 0.0, -GLIDE_START_HEIGHT);
+  }
+  catch (XMLException& e)
+  {
+    SDL_UnlockMutex(job->mutex);
+    fprintf(stderr, "%s\n", e.what());
+    delete model;
+    return;
+  }
+  SDL_UnlockMutex(job->mutex);
+
+  if (glide(&fdm, &env, job->cfg->getDouble("simulation.flightModel.dt", 0.002777), &g))
+  {
+    p->speed    = g.speed;
+    p->sink     = g.sink;
+    p->ratio    = g.ratio;
+    p->alpha    = g.alpha;
+    p->elevator = g.elevator;
+    p->fSettled = true;
+  }
+
+  fdm.Clean();
+  delete model;
+}
+
+
+/**
+ *  Worker thread: takes one point after the other until all are done.
+ */
+static int polarThread(void* data)
+{
+  T_PolarJob* job = (T_PolarJob*)data;
+
+  while (true)
+  {
+    SDL_LockMutex(job->mutex);
+    unsigned int i = job->next_point++;
+    SDL_UnlockMutex(job->mutex);
+
+    if (i >= job->points.size())
+      break;
+
+    flyPoint(job, &job->points[i]);
+  }
+
+  return 0;
+}
+
+
+static void usage(const char* name)
+{
+  fprintf(stderr, "Usage: %s [options] <airplane.xml> <polar.csv>\n", name);
+  fprintf(stderr, "  Calculates the glide polar of a model and writes it as a CSV table.\n");
+  fprintf(stderr, "  -v <min>:<max>:<step>  speeds in m/s (default: 0.7 to 2.5 times the\n");
+  fprintf(stderr, "                         trimmed flight velocity in 30 steps)\n");
+  fprintf(stderr, "  -f <flap>[,<flap>...]  flap inputs, 0..1 (default: 0)\n");
+  fprintf(stderr, "  -c <file>              configuration file (simulation.flightModel.*)\n");
+  fprintf(stderr, "  -j <threads>           number of threads (default: number of processors)\n");
+}
+
+
+int main(int argc, char** argv)
+{
+  T_PolarJob          job;
+  SimpleXMLTransfer*  cfg      = NULL;
+  std::string         speeds   = "";
+  std::string         flaps    = "0";
+  int                 nThreads = 0;
+  int                 arg;
+  std::vector<double> flap;
+
+  for (arg = 1; arg < argc - 2 && argv[arg][0] == '-'; arg += 2)
+  {
+    if (strcmp(argv[arg], "-v") == 0)
+      speeds = argv[arg + 1];
+    else if (strcmp(argv[arg], "-f") == 0)
+      flaps = argv[arg + 1];
+    else if (strcmp(argv[arg], "-c") == 0)
+      cfg = new SimpleXMLTransfer(argv[arg + 1]);
+    else if (strcmp(argv[arg], "-j") == 0)
+      nThreads = atoi(argv[arg + 1]);
+    else
+      break;
+  }
+
+  if (argc - arg != 2)
+  {
+    usage(argv[0]);
+    return (1);
+  }
+
+  std::string outfile = argv[arg + 1];
+
+  if (cfg == NULL)
+    cfg = new SimpleXMLTransfer();
+  cfg->setAttributeOverwrite("airplane.verbosity", "0");
+
+  job.file = argv[arg];
+  job.cfg  = cfg;
+
+  // trimmed flight velocity, for the default speeds
+  try
+  {
+    SimpleXMLTransfer model(job.file);
+    GlideEnv          env(1, 0);
+    ModFDMInterface   fdm;
+
+    XMLModelFile::ListOptions(&model);
+    fdm.loadAirplane(&model, &env, cfg);
+    job.v_trim = fdm.fdm->getTrimmedFlightVelocity() * 0.3048;
+    fdm.Clean();
+  }
+  catch (XMLException& e)
+  {
+    fprintf(stderr, "%s\n", e.what());
+    return (1);
+  }
+
+  double v_min  = 0.7 * job.v_trim;
+  double v_max  = 2.5 * job.v_trim;
+  double v_step = (v_max - v_min) / 30;
+
+  if (speeds != "" &&
+      sscanf(speeds.c_str(), "%lf:%lf:%lf", &v_min, &v_max, &v_step) != 3)
+  {
+    usage(argv[0]);
+    return (1);
+  }
+  if (speeds == "" && job.v_trim <= 0)
+  {
+    fprintf(stderr, "%s has no trimmed flight velocity, please use -v\n", job.file.c_str());
+    return (1);
+  }
+  if (v_min <= 0 || v_step <= 0 || v_max < v_min)
+  {
+    fprintf(stderr, "Invalid speeds: %s\n", speeds.c_str());
+    return (1);
+  }
+
+  for (const char* s = flaps.c_str(); *s; )
+  {
+    char*  end;
+    double f = strtod(s, &end);
+
+    if (end == s)
+    {
+      usage(argv[0]);
+      return (1);
+    }
+    flap.push_back(f);
+    s = (*end == ',') ? end + 1 : end;
+  }
+
+  for (unsigned int i = 0; i < flap.size(); i++)
+  {
+    for (int n = 0; v_min + n * v_step <= v_max + 1e-6 * v_step; n++)
+    {
+      T_Point p;
+
+      p.flap     = flap[i];
+      p.v_set    = v_min + n * v_step;
+      p.fSettled = false;
+      job.points.push_back(p);
+    }
+  }
+
+  if (nThreads < 1)
+    nThreads = getNumberOfProcessors();
+
+  job.next_point = 0;
+  job.mutex      = SDL_CreateMutex();
+
+  Uint32 t0 = SDL_GetTicks();
+
+  std::vector<SDL_Thread*> threads;
+  for (int i = 1; i < nThreads; i++)
+  {
+    SDL_Thread* thread = SDL_CreateThread(polarThread, &job);
+    if (thread != NULL)
+      threads.push_back(thread);
+  }
+  // this thread takes part, too
+  polarThread(&job);
+  for (unsigned int i = 0; i < threads.size(); i++)
+    SDL_WaitThread(threads[i], NULL);
+
+  Uint32 t1 = SDL_GetTicks();
+
+  SDL_DestroyMutex(job.mutex);
+
+  FILE*  fp       = fopen(outfile.c_str(), "w");
+  int    nSettled = 0;
+
+  if (fp == NULL)
+  {
+    fprintf(stderr, "Unable to write %s\n", outfile.c_str());
+    return (1);
+  }
+
+  // points which did not settle are left out
+  fprintf(fp, "flap,speed_m_s,sink_m_s,glide_ratio,alpha_deg,elevator\n");
+  for (unsigned int i = 0; i < job.points.size(); i++)
+  {
+    T_Point* p = &job.points[i];
+
+    if (p->fSettled)
+    {
+      fprintf(fp, "%g,%.3f,%.4f,%.2f,%.3f,%.4f\n",
+              p->flap, p->speed, p->sink, p->ratio, p->alpha, p->elevator);
+      nSettled++;
+    }
+  }
+
+  bool ok = (ferror(fp) == 0);
+  if (fclose(fp) != 0)
+    ok = false;
+  if (!ok)
+  {
+    fprintf(stderr, "Unable to write %s\n", outfile.c_str());
+    return (1);
+  }
+
+  printf("%s: %d of %lu points in %.2f s, written to %s\n", job.file.c_str(),
+         nSettled, (unsigned long)job.points.size(), 0.001 * (t1 - t0),
+         outfile.c_str());
+
+  delete cfg;
+
+  return (0);
+}
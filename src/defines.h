@@ -73,6 +73,11 @@
 #define KEY_THROTTLE_LESS SDLK_PAGEDOWN
 //#define KEY_THROTTLE_LESS SDLK_a
 
+/**
+ * Key to start/stop recording (see ScreenCapture)
+ */
+#define KEY_CAPTURE SDLK_F12
+
 
 /**
  * Define to >0 to test joystick configuration without having a joystick
@@ -44,7 +44,7 @@ GlConsole*        Global::console = NULL;
 TSimInputs        Global::inputs;
 float             Global::dt;
 int               Global::nFPS;
-std::string       Global::verboseString;
+TextBuffer        Global::verboseString;
 TestModeData      Global::testmode;
 T_TX_Interface*   Global::TXInterface; 
 TInputDev         Global::inputDev;
@@ -33,6 +33,7 @@
 
 #include <string>
 #include "mod_fdm/fdm_inputs.h"
+#include "mod_misc/textbuffer.h"
 #include "mod_inputdev/inputdev.h"
 #include "mouse_kbd.h"
 
@@ -82,7 +83,7 @@ class Global
     static T_GameHandler*   gameHandler;    ///< The active game mode.
     static TSimInputs       inputs;         ///< Control input values.
     static float            dt;             ///< time interval of integration of EOMs
-    static std::string      verboseString;  ///< Informational line of text
+    static TextBuffer       verboseString;  ///< Informational line of text
     static TestModeData     testmode;       ///< Test mode data structure
     static GlConsole*       console;        ///< The console
     static int              nFPS;           ///< average video update rate (FPS)
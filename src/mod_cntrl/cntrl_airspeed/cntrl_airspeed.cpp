@@ -0,0 +1,121 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "cntrl_airspeed.h"
+
+#include <iostream>
+
+Cntrl_Airspeed::Cntrl_Airspeed(SimpleXMLTransfer* cfg)
+{
+  v            = cfg->getDouble("v");
+  kp           = cfg->getDouble("kp");
+  ki           = cfg->getDouble("ki");
+  kd           = cfg->attributeAsDouble("kd",               0.0);
+  scale        = cfg->attributeAsDouble("scale",            0.0); // m/s
+  dTCntrl      = cfg->attributeAsDouble("TCntrl",       18.6E-3); // s
+  dIntLim      = cfg->attributeAsDouble("IntLim",           0.5);
+  Reset();
+
+  std::string logfilename = cfg->attribute("logfile", "");  
+  if (logfilename.length())
+  {
+    fLog = true;
+    outlog.open(logfilename.c_str());
+    if (!outlog)
+      std::cerr << "unable to open log file " << logfilename << "\n";
+    outlog << "#T " << dTCntrl << " s 2\n";
+    outlog << "#N soll ist integrator ausgang\n";
+    outlog << "#M 100 100 5 5\n";
+    outlog << "#U m/s m/s 1 1\n";
+  }
+  else
+    fLog = false;
+}
+
+Cntrl_Airspeed::~Cntrl_Airspeed() 
+{
+  if (fLog)
+    outlog.close();
+}
+
+void Cntrl_Airspeed::Reset()
+{
+  dInt           = 0;
+  fInit          = false;
+  dLastOut       = 0;
+  dTCntrlCnt     = 0;
+}
+
+void Cntrl_Airspeed::Calc(double      dt, 
+                          FDMBase*    fdm,
+                          TSimInputs* pInputsFromUser,
+                          TSimInputs* pInputsToFDM)
+{
+  // --- calculate controller ---------------------------------------
+  double res;
+  dTCntrlCnt -= dt;
+  if (dTCntrlCnt < 0)
+  {
+    dTCntrlCnt += dTCntrl;
+    // calc setpoint
+    double setp = v + pInputsFromUser->elevator*scale;
+    double dV   = fdm->getVRelAirmass()*0.3048;
+    
+    if (!fInit)
+    {
+      fInit = true;
+      dVOld = dV;
+    }
+    
+    // PID-controller, relative to the setpoint
+    const double max  = 0.5;
+    double       err  = (setp - dV)/setp;
+    double       diff = (dV - dVOld)/(dTCntrl*setp);
+    dVOld = dV;
+    
+    res  = err*kp - diff*kd + dInt;
+    if (res > max)
+      res = max;
+    else if (res < -max)
+      res = -max;
+    else
+    {
+      dInt += err*ki*dTCntrl;
+      if (dInt > dIntLim)
+        dInt = dIntLim;
+      else if (dInt < -dIntLim)
+        dInt = -dIntLim;
+    }
+    
+    dLastOut = res;
+    if (fLog)
+    {
+      outlog << setp << " " << dV << " " << dInt << " "
+        << (pInputsToFDM->elevator+res) << "\n";
+    }
+  }
+  else
+    res = dLastOut;
+  
+  // --- apply output of controller ---------------------------------
+  pInputsToFDM->elevator += res;
+  Limit(pInputsToFDM->elevator);
+}
@@ -0,0 +1,80 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef CNTRL_AIRSPEED_H
+# define CNTRL_AIRSPEED_H
+
+#include "../controller.h"
+
+#include <fstream>
+
+/**
+ * This PID-controller alters elevator input to fly at a certain airspeed.
+ * The setpoint is v (m/s) plus elevator stick input times scale, so
+ * you may want to use InitInputs before this controller. The derivative
+ * part works on the airspeed only, like Cntrl_Phugoid, and damps the
+ * phugoid. Throttle is left to the pilot.
+ * 
+ * The gains refer to the airspeed error relative to the setpoint, so
+ * the same values work for slow and fast models:
+ * 
+ *   <Airspeed v="12" kp="0.5" ki="0.2" kd="1.5" />
+ * 
+ * glidetrim.h uses it to trim the models.
+ */
+class Cntrl_Airspeed : public Controller
+{
+public:
+  
+  Cntrl_Airspeed(SimpleXMLTransfer* cfg);
+  
+  virtual void Reset();
+  
+  virtual void Calc(double      dt, 
+                    FDMBase*    fdm,
+                    TSimInputs* pInputsFromUser,
+                    TSimInputs* pInputsToFDM);
+
+  virtual ~Cntrl_Airspeed();
+  
+  /**
+   * Output of the integral part, which is the elevator needed to
+   * hold the airspeed once the controller has settled.
+   */
+  double getIntegrator() { return(dInt); };
+  
+private:
+  
+  double v, kp, ki, kd, scale, dTCntrl, dIntLim;
+  double dTCntrlCnt;
+  double dInt;
+  
+  double dVOld; // velocity in m/s
+    
+  bool   fInit;
+  double dLastOut;
+  
+  bool   fLog;
+  
+  std::ofstream outlog;
+};
+
+#endif
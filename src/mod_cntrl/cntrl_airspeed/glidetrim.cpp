@@ -0,0 +1,145 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+#include "glidetrim.h"
+
+#include "../../mod_misc/SimpleXMLTransfer.h"
+#include "../../mod_misc/lib_conversions.h"
+
+#include <math.h>
+
+
+#define FRAME_RATE   60        // samples per second
+#define T_BLOCK      2.0       // s, length of a measurement
+#define T_MAX        120.0     // s, give up if not settled by then
+#define V_TOLERANCE  0.005     // relative deviation from the speed setpoint
+#define EL_TOLERANCE 0.001     // change of elevator between two measurements
+#define K_PHI        0.5       // aileron per radian of bank angle
+
+
+GlideEnv::GlideEnv(double v_set, double flap) : v_set(v_set)
+{
+  SimpleXMLTransfer cfg;
+
+  cfg.setName("Airspeed");
+  cfg.setAttribute("v",  doubleToString(v_set));
+  cfg.setAttribute("kp", "0.5");
+  cfg.setAttribute("ki", "0.2");
+  cfg.setAttribute("kd", "1.5");
+  cntrl = new Cntrl_Airspeed(&cfg);
+
+  inputs.throttle = 0;
+  inputs.flap     = flap;
+  outputs.CopyFrom(&inputs);
+}
+
+
+GlideEnv::~GlideEnv()
+{
+  delete cntrl;
+}
+
+
+int GlideEnv::CalculateWind(double  X_cg,      double  Y_cg,     double  Z_cg,
+                            double& Vel_north, double& Vel_east, double& Vel_down)
+{
+  Vel_north = Vel_east = Vel_down = 0;
+  return(0);
+}
+
+
+void GlideEnv::ControllerCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser, TSimInputs* pInputsToFDM)
+{
+  pInputsToFDM->CopyFrom(&inputs);
+  cntrl->Calc(dt, fdm, &inputs, pInputsToFDM);
+  // keep the wings level
+  pInputsToFDM->aileron = -K_PHI * fdm->getPhi();
+  Controller::Limit(pInputsToFDM->aileron);
+  outputs.CopyFrom(pInputsToFDM);
+}
+
+
+bool glide(ModFDMInterface* fdm, GlideEnv* env, double dt, T_Glide* result)
+{
+  TSimInputs inputs;
+  double     v_set     = env->getSpeed();
+  int        multiloop = (int)(1.0 / (FRAME_RATE * dt) + 0.5);
+  int        nBlock    = (int)(T_BLOCK * FRAME_RATE);
+  double     t         = 0;
+  double     el_last   = 1000;
+  bool       fSteady   = false;
+
+  if (multiloop < 1)
+    multiloop = 1;
+
+  while (t < T_MAX)
+  {
+    CRRCMath::Vector3 pos0   = fdm->fdm->getPos();
+    double            v_dev  = 0;
+    double            v_sum  = 0;
+    double            el_sum = 0;
+    double            th_sum = 0;
+    double            phi    = 0;
+
+    for (int n=0; n<nBlock; n++)
+    {
+      fdm->update(&inputs, dt, multiloop);
+
+      double v = fdm->fdm->getVRelAirmass() * 0.3048;
+
+      if (fabs(v - v_set) > v_dev * v_set)
+        v_dev = fabs(v - v_set) / v_set;
+      if (fabs(fdm->fdm->getPhi()) > phi)
+        phi = fabs(fdm->fdm->getPhi());
+      v_sum  += v;
+      el_sum += env->getInputs()->elevator;
+      th_sum += fdm->fdm->getTheta();
+    }
+    t += nBlock * multiloop * dt;
+
+    CRRCMath::Vector3 dist = fdm->fdm->getPos() - pos0;
+    double            time = nBlock * multiloop * dt;
+    double            el   = el_sum / nBlock;
+    double            hor  = sqrt(dist.r[0]*dist.r[0] + dist.r[1]*dist.r[1]);
+
+    // the airplane crashed or lost control
+    if (!(v_dev < 0.5) || phi > 0.5 || -fdm->fdm->getPos().r[2] < fdm->fdm->getZLow())
+      return(false);
+
+    bool fSettled = (v_dev < V_TOLERANCE && fabs(el - el_last) < EL_TOLERANCE);
+
+    // measure the second of two settled blocks
+    if (fSettled && fSteady)
+    {
+      result->speed    = v_sum / nBlock;
+      result->sink     = dist.r[2] * 0.3048 / time;
+      result->ratio    = hor / dist.r[2];
+      result->alpha    = (th_sum / nBlock + atan2(dist.r[2], hor)) * 180 / M_PI;
+      result->elevator = el;
+      return(true);
+    }
+    fSteady = fSettled;
+    el_last = el;
+  }
+
+  return(false);
+}
@@ -0,0 +1,115 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file glidetrim.h
+ *
+ *  Trimmed glides without power and without wind, used by the
+ *  command line tools crrcpolar and crrclinear.
+ */
+
+#ifndef GLIDETRIM_H
+# define GLIDETRIM_H
+
+#include "cntrl_airspeed.h"
+#include "../../mod_fdm/fdm.h"
+#include "../../mod_fdm/fdm_env.h"
+#include "../../mod_fdm/fdm_inputs.h"
+
+/**
+ * No wind, flat ground at height 0, air density of the standard
+ * atmosphere at sea level. The controller callback holds the speed
+ * with Cntrl_Airspeed and keeps the wings level with the ailerons,
+ * throttle is zero.
+ */
+class GlideEnv : public FDMEnviroment
+{
+  public:
+    /**
+     * @param v_set  speed setpoint in m/s
+     * @param flap   flap input
+     */
+    GlideEnv(double v_set, double flap);
+    
+    virtual ~GlideEnv();
+
+    float GetSceneryHeight(float x_north, float y_east) { return(0); };
+
+    int CalculateWind(double  X_cg,      double  Y_cg,     double  Z_cg,
+                      double& Vel_north, double& Vel_east, double& Vel_down);
+
+    double GetG(double altitude) { return(32.174); };
+
+    double GetRho(double altitude) { return(0.0023769); };
+
+    void ControllerCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser, TSimInputs* pInputsToFDM);
+
+    /**
+     * Speed setpoint in m/s
+     */
+    double getSpeed() { return(v_set); };
+    
+    /**
+     * Inputs of the latest time step
+     */
+    TSimInputs* getInputs() { return(&outputs); };
+
+  private:
+    double          v_set;
+    Cntrl_Airspeed* cntrl;
+    TSimInputs      inputs;
+    TSimInputs      outputs;
+};
+
+
+/**
+ * Result of glide()
+ */
+typedef struct
+{
+  double speed;      ///< airspeed in m/s
+  double sink;       ///< sink rate in m/s
+  double ratio;      ///< glide ratio
+  double alpha;      ///< angle of attack in degrees
+  double elevator;   ///< mean elevator input
+} T_Glide;
+
+
+/**
+ * Height at which glide() should start, ft
+ */
+#define GLIDE_START_HEIGHT 5000.0
+
+/**
+ * Flies until speed and elevator have settled, then measures for
+ * two seconds. The airplane has to be loaded with env and put into
+ * the air at the speed setpoint, for example at GLIDE_START_HEIGHT.
+ * 
+ * If the model settled, true is returned, the flight model is left
+ * in the trimmed state and env->getInputs() holds the trimmed inputs.
+ * It returns false if the model stalls, crashes or has not settled
+ * after two minutes.
+ * 
+ * @param dt  time step of the flight model
+ */
+bool glide(ModFDMInterface* fdm, GlideEnv* env, double dt, T_Glide* result);
+
+#endif
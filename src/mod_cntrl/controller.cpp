@@ -24,6 +24,7 @@
 #include "cntrl_initinputs/cntrl_initinputs.h"
 #include "cntrl_rateofclimb/cntrl_rateofclimb.h"
 #include "cntrl_phugoid/cntrl_phugoid.h"
+#include "cntrl_airspeed/cntrl_airspeed.h"
 #include "cntrl_setuserinput/cntrl_setuserinput.h"
 
 
@@ -52,6 +53,8 @@ void Controller::LoadList(SimpleXMLTransfer*       cfg,
         cntrl = new Cntrl_RateOfClimb(cntrldescr);
       else if (name.compare("Phugoid") == 0)
         cntrl = new Cntrl_Phugoid(cntrldescr);
+      else if (name.compare("Airspeed") == 0)
+        cntrl = new Cntrl_Airspeed(cntrldescr);
              
       if (cntrl)
         controllers.push_back(cntrl);
@@ -0,0 +1,174 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+/** \file alloc_test.cpp
+ *
+ *  Counts the heap allocations of the flight model while flying (see
+ *  crrc_alloccount.h, this program has to be built with
+ *  COUNT_ALLOCATIONS). Every airplane flies the test maneuver for
+ *  T_WARMUP seconds, then T_FLIGHT seconds are counted with MULTILOOP
+ *  steps per frame, like SimStateHandler does it at 60 frames per
+ *  second. The ground is flat, so most airplanes land in that time.
+ *
+ *  Usage: alloc_test [airplane.xml ...]   (default: all of models/)
+ *
+ *  It is meant to be started in the top directory of the source tree.
+ *  Returns 0 if no frame allocated anything, 1 if one did and 2 if an
+ *  airplane can't be read.
+ */
+#include "testflight.h"
+#include "../crrc_alloccount.h"
+
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+#ifndef COUNT_ALLOCATIONS
+# error alloc_test needs COUNT_ALLOCATIONS
+#endif
+
+#define DT              0.002777
+#define MULTILOOP       6      // steps of DT per frame, 60 frames per second
+#define T_WARMUP        1.0    // s, not counted
+#define T_FLIGHT        30.0   // s
+
+#define MODEL_DIR       "models"
+
+
+static void listXMLFiles(const std::string& dirname, std::vector<std::string>& files)
+{
+  DIR*           dir = opendir(dirname.c_str());
+  struct dirent* ent;
+
+  if (dir == NULL)
+    return;
+
+  while ((ent = readdir(dir)) != NULL)
+  {
+    std::string name = ent->d_name;
+
+    if (name.size() > 4 && name.substr(name.size() - 4) == ".xml")
+      files.push_back(dirname + "/" + name);
+  }
+  closedir(dir);
+
+  for (unsigned int i=1; i<files.size(); i++)
+    for (unsigned int j=i; j>0 && files[j] < files[j-1]; j--)
+      files[j].swap(files[j-1]);
+}
+
+
+/**
+ * Returns the number of frames which allocated something, the total
+ * number of allocations is stored in *pnAllocs.
+ */
+static int fly(const char* file, int nFrames, unsigned long* pnAllocs)
+{
+  SimpleXMLTransfer model(file);
+  SimpleXMLTransfer cfg;
+  TestEnv           env;
+  ModFDMInterface   fdm;
+  TSimInputs        inputs;
+  int               nSteps = (int)(T_WARMUP / DT);
+  int               nBad   = 0;
+
+  cfg.setAttribute("airplane.verbosity", "0");
+
+  XMLModelFile::ListOptions(&model);
+  fdm.loadAirplane(&model, &env, &cfg);
+  fdm.initAirplaneState(1.0, 0.0, 0.5, 0.0, 0.0, -300.0);
+
+  for (int n=0; n<nSteps; n++)
+  {
+    setInputs(&inputs, (n + 0.5) * DT);
+    fdm.update(&inputs, DT, 1);
+  }
+
+  *pnAllocs = 0;
+  for (int frame=0; frame<nFrames; frame++)
+  {
+    unsigned long nBefore = AllocCount::getCount();
+
+    setInputs(&inputs, (nSteps + 0.5 * MULTILOOP) * DT);
+    fdm.update(&inputs, DT, MULTILOOP);
+    nSteps += MULTILOOP;
+
+    unsigned long nAllocs = AllocCount::getCount() - nBefore;
+    if (nAllocs > 0)
+    {
+      nBad++;
+      *pnAllocs += nAllocs;
+    }
+  }
+
+  return(nBad);
+}
+
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> files;
+  std::string              output;
+  int                      nFrames = (int)(T_FLIGHT * 60);
+  int                      result  = 0;
+
+  for (int arg = 1; arg < argc; arg++)
+    files.push_back(argv[arg]);
+  if (files.size() == 0)
+    listXMLFiles(MODEL_DIR, files);
+  if (files.size() == 0)
+  {
+    fprintf(stderr, "No airplanes found, please start in the top directory\n");
+    return(2);
+  }
+
+  for (unsigned int f=0; f<files.size(); f++)
+  {
+    char buf[512];
+
+    try
+    {
+      unsigned long nAllocs;
+      int           nBad = fly(files[f].c_str(), nFrames, &nAllocs);
+
+      snprintf(buf, sizeof(buf), "%-28s %lu allocations in %d of %d frames%s\n",
+               files[f].c_str(), nAllocs, nBad, nFrames, (nBad > 0) ? " *" : "");
+      output += buf;
+      if (nBad > 0 && result == 0)
+        result = 1;
+    }
+    catch (XMLException e)
+    {
+      fprintf(stderr, "%s: %s\n", files[f].c_str(), e.what());
+      result = 2;
+    }
+  }
+
+  // Loading the airplanes writes to stdout, so the results are printed at the end.
+  printf("%s", output.c_str());
+  if (result == 1)
+    printf("FAILED\n");
+  else if (result == 0)
+    printf("OK\n");
+  return(result);
+}
@@ -22,8 +22,10 @@
 #include "fdm.h"
 
 #include <iostream>
+#include <math.h>
 
 #include "../mod_math/CVector.h"
+#include "../mod_misc/SimpleXMLTransfer.h"
 
 #include "../mod_fdm_config.h"
 #if (MOD_FDM_USE_002 != 0)
@@ -44,7 +46,7 @@
 #include "xmlmodelfile.h"
 
 ModFDMInterface::ModFDMInterface()
- : launch_presets(NULL)
+ : launch_presets(NULL), dt_airborne(0)
 {
   fdm = (FDMBase*)0;
 }
@@ -61,7 +63,54 @@ void ModFDMInterface::update(TSimInputs* inputs,
                              double      dt,
                              int         multiloop)
 {
-  fdm->update(inputs, dt, multiloop);
+  double t_left;
+
+  if (dt_airborne <= dt || multiloop <= 0 || fdm->env == NULL)
+  {
+    fdm->update(inputs, dt, multiloop);
+    return;
+  }
+
+  // Split the time into equal steps, so the airplane moves smoothly from
+  // frame to frame. The integrators take care of step size changes.
+  t_left = dt*multiloop;
+  while (t_left > 0)
+  {
+    double h_max = isNearGround(dt_airborne) ? dt : dt_airborne;
+    int    n     = (int)ceil(t_left/h_max - 1e-6);
+    double h;
+
+    if (n <= 1)
+    {
+      h      = t_left;
+      t_left = 0;
+    }
+    else
+    {
+      h       = t_left/n;
+      t_left -= h;
+    }
+    fdm->update(inputs, h, 1);
+  }
+}
+
+bool ModFDMInterface::isNearGround(double dt)
+{
+  CRRCMath::Vector3 pos   = fdm->getPos();
+  double            reach = fdm->getAircraftSize();
+  double            speed = fdm->getVel().length();
+  double            height;
+
+  if (reach < fdm->getZLow())
+    reach = fdm->getZLow();
+  // not every FDM knows its velocity relative to the ground
+  if (speed < fdm->getVRelAirmass())
+    speed = fdm->getVRelAirmass();
+
+  height = -pos.r[2] - fdm->env->GetSceneryHeight(pos.r[0], pos.r[1]);
+
+  // Twice the reach covers slopes of up to 45 degrees below the airplane.
+  return(height < 2*reach + 2*speed*dt);
 }
 
 void ModFDMInterface::initAirplaneState(double dRelVel,
@@ -87,6 +136,7 @@ void ModFDMInterface::initAirplaneState(double dRelVel,
 
 void ModFDMInterface::Clean()
 {
+  dt_airborne = 0;
   if (fdm != (FDMBase*)0)
   {
     delete fdm;
@@ -113,7 +163,10 @@ void ModFDMInterface::loadAirplane(const char* filename,
                                    SimpleXMLTransfer* cfg)
 {
   std::string notloadstring = "";
+  bool        fVerbose      = (cfg->getInt("airplane.verbosity", 5) > 0);
   Clean();
+
+  dt_airborne = cfg->getDouble("simulation.flightModel.dt_airborne", 0);
   
   // todo: find out the type of model to be used by extension or by some value in 'cfg'?
 
@@ -125,7 +178,8 @@ void ModFDMInterface::loadAirplane(const char* filename,
     try
     {
       fdm = new CRRC_AirplaneSim_DisplayMode(filename, cfg);
-      std::cout << "Using CRRC_AirplaneSim_DisplayMode: " << filename << "\n";
+      if (fVerbose)
+        std::cout << "Using CRRC_AirplaneSim_DisplayMode: " << filename << "\n";
     }
     catch (XMLException e)
     {
@@ -141,7 +195,8 @@ void ModFDMInterface::loadAirplane(const char* filename,
     try
     {
       fdm = new CRRC_AirplaneSim_Heli01(filename, myEnv, cfg);
-      std::cout << "Using CRRC_AirplaneSim_Heli01: " << filename << "\n";
+      if (fVerbose)
+        std::cout << "Using CRRC_AirplaneSim_Heli01: " << filename << "\n";
     }
     catch (XMLException e)
     {
@@ -157,7 +212,8 @@ void ModFDMInterface::loadAirplane(const char* filename,
     try
     {
       fdm = new CRRC_AirplaneSim_Larcsim(filename, myEnv, cfg);
-      std::cout << "Using CRRC_AirplaneSim_Larcsim: " << filename << "\n";
+      if (fVerbose)
+        std::cout << "Using CRRC_AirplaneSim_Larcsim: " << filename << "\n";
     }
     catch (XMLException e)
     {
@@ -172,8 +228,9 @@ void ModFDMInterface::loadAirplane(const char* filename,
   {
     try
     {
-      fdm = new CRRC_AirplaneSim_002(filename, myEnv);
-      std::cout << "Using CRRC_AirplaneSim_002: " << filename << "\n";
+      fdm = new CRRC_AirplaneSim_002(filename, myEnv, cfg);
+      if (fVerbose)
+        std::cout << "Using CRRC_AirplaneSim_002: " << filename << "\n";
     }
     catch (XMLException e)
     {
@@ -201,7 +258,10 @@ void ModFDMInterface::loadAirplane(SimpleXMLTransfer* xml,
                                    SimpleXMLTransfer* cfg)
 {
   std::string notloadstring = "";
+  bool        fVerbose      = (cfg->getInt("airplane.verbosity", 5) > 0);
   Clean();
+
+  dt_airborne = cfg->getDouble("simulation.flightModel.dt_airborne", 0);
   
     
   // todo: find out the type of model to be used by some value in 'xml' or 'cfg'?
@@ -214,7 +274,8 @@ void ModFDMInterface::loadAirplane(SimpleXMLTransfer* xml,
     try
     {
       fdm = new CRRC_AirplaneSim_DisplayMode(xml, cfg);
-      std::cout << "Using CRRC_AirplaneSim_DisplayMode\n";
+      if (fVerbose)
+        std::cout << "Using CRRC_AirplaneSim_DisplayMode\n";
     }
     catch (XMLException e)
     {
@@ -230,7 +291,8 @@ void ModFDMInterface::loadAirplane(SimpleXMLTransfer* xml,
     try
     {
       fdm = new CRRC_AirplaneSim_Heli01(xml, myEnv, cfg);
-      std::cout << "Using CRRC_AirplaneSim_Heli01\n";
+      if (fVerbose)
+        std::cout << "Using CRRC_AirplaneSim_Heli01\n";
     }
     catch (XMLException e)
     {
@@ -246,7 +308,8 @@ void ModFDMInterface::loadAirplane(SimpleXMLTransfer* xml,
     try
     {
       fdm = new CRRC_AirplaneSim_Larcsim(xml, myEnv, cfg);
-      std::cout << "Using CRRC_AirplaneSim_Larcsim\n";
+      if (fVerbose)
+        std::cout << "Using CRRC_AirplaneSim_Larcsim\n";
     }
     catch (XMLException e)
     {
@@ -261,8 +324,9 @@ void ModFDMInterface::loadAirplane(SimpleXMLTransfer* xml,
   {
     try
     {
-      fdm = new CRRC_AirplaneSim_002(xml, myEnv);
-      std::cout << "Using CRRC_AirplaneSim_002\n";
+      fdm = new CRRC_AirplaneSim_002(xml, myEnv, cfg);
+      if (fVerbose)
+        std::cout << "Using CRRC_AirplaneSim_002\n";
     }
     catch (XMLException e)
     {
@@ -306,3 +370,14 @@ FDMBase::~FDMBase()
   logfile.close();
 #endif
 }
+
+void FDMBase::eulerRates(const double* x, double* x_dot)
+{
+  double sin_phi = sin(x[STATE_PHI]);
+  double cos_phi = cos(x[STATE_PHI]);
+  double q_r     = x[STATE_Q]*sin_phi + x[STATE_R]*cos_phi;
+
+  x_dot[STATE_PHI]   = x[STATE_P] + q_r*tan(x[STATE_THETA]);
+  x_dot[STATE_THETA] = x[STATE_Q]*cos_phi - x[STATE_R]*sin_phi;
+  x_dot[STATE_PSI]   = q_r/cos(x[STATE_THETA]);
+}
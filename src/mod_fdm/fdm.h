@@ -117,6 +117,42 @@ class FDMBase
     */
    virtual void registerAnimations(std::vector<CRRCAnimation*> const& anims) {}
    
+   /// @name Linearization (see crrclinear.cpp)
+   //@{
+   
+   /**
+    * Rigid body state: velocity relative to the ground in body axes
+    * (u, v, w in ft/s), body rates (p, q, r in rad/s) and Euler angles
+    * (phi, theta, psi in rad).
+    */
+   enum { STATE_U, STATE_V, STATE_W, STATE_P, STATE_Q, STATE_R,
+          STATE_PHI, STATE_THETA, STATE_PSI, NUM_STATES };
+   
+   /**
+    * true if the flight model supports getState(), setState() and
+    * getStateDerivative()
+    */
+   virtual bool hasState() { return(false); };
+   
+   /**
+    * Snapshot of the state, NUM_STATES values
+    */
+   virtual void getState(double* x) {};
+   
+   /**
+    * Set the state, for example to restore a snapshot. The position, the
+    * engine and the past values of the integrator are left as they are.
+    */
+   virtual void setState(const double* x) {};
+   
+   /**
+    * Time derivative of the state for these inputs. The forces of the
+    * engine are held at their last value.
+    */
+   virtual void getStateDerivative(TSimInputs* inputs, double* x_dot) {};
+   
+   //@}
+   
   private:
    
    virtual void update(TSimInputs* inputs,
@@ -145,6 +181,12 @@ class FDMBase
    */
   TSimInputs myInputs;
   
+  /**
+   * Derivative of the Euler angles of state x for its body rates,
+   * written to x_dot[STATE_PHI..STATE_PSI]
+   */
+  static void eulerRates(const double* x, double* x_dot);
+  
 #if FDM_LOG != 0
    std::ofstream logfile;
    
@@ -273,7 +315,12 @@ class ModFDMInterface
                           double R_Z = 0.0);
    
    /**
-    * Update timestep.
+    * Update timestep: advance the simulation by multiloop*dt.
+    * 
+    * If simulation.flightModel.dt_airborne is larger than dt, this time
+    * is split into as few steps of at most dt_airborne as possible while
+    * the airplane is far from the ground (see isNearGround()). Near the
+    * ground, where the gear springs are stiff, steps of dt are used.
     */
    void update(TSimInputs* inputs,
                double      dt,
@@ -290,10 +337,24 @@ class ModFDMInterface
    FDMBase* fdm;
    
   private:
+   /**
+    * Could any point of the airplane touch the ground within the next
+    * step of length dt? The terrain height below the CG, the largest
+    * distance of a hardpoint from the CG (getZLow(), getAircraftSize())
+    * and the distance travelled in two steps are taken into account.
+    */
+   bool isNearGround(double dt);
+
    /**
     * Pointer to airplane-specific launch presets
     */
    SimpleXMLTransfer* launch_presets;
+
+   /**
+    * Longest time step far from the ground [s], from
+    * simulation.flightModel.dt_airborne. 0: always use dt.
+    */
+   double dt_airborne;
 };
 
 #endif
@@ -27,6 +27,7 @@
 
 #include "../../mod_misc/ls_constants.h"
 #include "../../mod_misc/lib_conversions.h"
+#include "../../mod_misc/SimpleXMLTransfer.h"
 #include "../xmlmodelfile.h"
 
 
@@ -107,6 +108,7 @@ void CRRC_AirplaneSim_002::initAirplaneState(double dRelVel,
 #else
   eom.setGravity(env->GetG(-eom.pos.val.r[2]));
 #endif
+  eom.setIntegrator(integrator, rk45_tolerance);
   
   v_V_local_airmass = CRRCMath::Vector3(); // local velocity of steady airmass   [ft/s]
   
@@ -215,7 +217,8 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
     env->ControllerCallback(dt, this, inputs, &myInputs);
     
 #if (EOM_TEST != 2)
-    aero( dt, &myInputs);
+    if (integrator == CRRCMath::INTEGRATOR_AB2)
+      aero( dt, &myInputs);
 #endif
 
 #if FDM_LOG_AERO_OUT != 0
@@ -235,9 +238,9 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
       v_F_engine *= N_TO_LBF;
       v_M_engine *= NM_TO_LBFFT;
     }
+#if (EOM_TEST == 2)
     gear(&myInputs);
 
-#if (EOM_TEST == 2)
     CRRCMath::Vector3 v_F, v_M_cg;
     
     switch ((nLogCnt>>5) % 6)
@@ -295,13 +298,16 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
     eom.step(dt, v_F, v_M_cg);
     eom.conv.updateEuler();
 #else
-    eom.step(dt, 
-             v_F_aero + v_F_engine + v_F_gear,
-             v_M_aero + v_M_engine + v_M_gear);
+    // The adaptive scheme can't cope with the discontinuities of
+    // ground friction, use RK4 while there is ground contact.
+    if (integrator == CRRCMath::INTEGRATOR_RK45 && v_F_gear.length() != 0)
+      eom.setIntegrator(CRRCMath::INTEGRATOR_RK4, rk45_tolerance);
+    else
+      eom.setIntegrator(integrator, rk45_tolerance);
     
-    // Update the position they are interested in outside of this fdm. I have to
-    // do it inside of the loop because gear() also needs it.
-    eom.conv.updateEuler();
+    // Calls forces() as needed. Afterwards the position they are interested
+    // in outside of this fdm is up to date; gear() also needs it.
+    eom.step(dt, this);
 #endif
     
 //    eom.conv.convTest1();
@@ -388,8 +394,11 @@ void CRRC_AirplaneSim_002::update(TSimInputs* inputs,
 }
 
 
-CRRC_AirplaneSim_002::CRRC_AirplaneSim_002(const char* filename, FDMEnviroment* myEnv) : FDMBase("fdm_002.dat", myEnv)
+CRRC_AirplaneSim_002::CRRC_AirplaneSim_002(const char* filename, FDMEnviroment* myEnv, SimpleXMLTransfer* cfg) : FDMBase("fdm_002.dat", myEnv)
 {
+  integrator     = CRRCMath::integratorByName(cfg->getString("simulation.flightModel.integrator", "ab2"));
+  rk45_tolerance = cfg->getDouble("simulation.flightModel.tolerance", 1e-6);
+  
   // Previously there has been code to load an old-style .air-file. 
   // This has been removed as CRRCSim includes an automatic converter.
   SimpleXMLTransfer* fileinmemory = new SimpleXMLTransfer(filename);
@@ -399,8 +408,11 @@ CRRC_AirplaneSim_002::CRRC_AirplaneSim_002(const char* filename, FDMEnviroment*
   delete fileinmemory;
 }
 
-CRRC_AirplaneSim_002::CRRC_AirplaneSim_002(SimpleXMLTransfer* xml, FDMEnviroment* myEnv) : FDMBase("fdm_larcsim.dat", myEnv)
+CRRC_AirplaneSim_002::CRRC_AirplaneSim_002(SimpleXMLTransfer* xml, FDMEnviroment* myEnv, SimpleXMLTransfer* cfg) : FDMBase("fdm_larcsim.dat", myEnv)
 {
+  integrator     = CRRCMath::integratorByName(cfg->getString("simulation.flightModel.integrator", "ab2"));
+  rk45_tolerance = cfg->getDouble("simulation.flightModel.tolerance", 1e-6);
+  
   LoadFromXML(xml);
 }
 
@@ -627,6 +639,18 @@ void CRRC_AirplaneSim_002::gear(TSimInputs* inputs)
 }
 
 
+void CRRC_AirplaneSim_002::forces(CRRCMath::Vector3& FBody,
+                                  CRRCMath::Vector3& MBody)
+{
+  if (integrator != CRRCMath::INTEGRATOR_AB2)
+    aero(0, &myInputs); // aero() doesn't use dt
+  gear(&myInputs);
+  
+  FBody = v_F_aero + v_F_engine + v_F_gear;
+  MBody = v_M_aero + v_M_engine + v_M_gear;
+}
+
+
 /**
         X       Aerodynamic force, lbs, in X-axis (+ forward)
         Y       Aerodynamic force, lbs, in Y-axis (+ right)
@@ -924,3 +948,44 @@ double CRRC_AirplaneSim_002::getPropFreq()
 {
   return(power->getPropFreq());
 };
+
+
+void CRRC_AirplaneSim_002::getState(double* x)
+{
+  for (int i=0; i<3; i++)
+  {
+    x[STATE_U+i]   = eom.vel.val.r[i];
+    x[STATE_P+i]   = eom.angvel.val.r[i];
+    x[STATE_PHI+i] = eom.conv.euler.r[i];
+  }
+}
+
+
+void CRRC_AirplaneSim_002::setState(const double* x)
+{
+  eom.vel.val    = CRRCMath::Vector3(x[STATE_U], x[STATE_V], x[STATE_W]);
+  eom.angvel.val = CRRCMath::Vector3(x[STATE_P], x[STATE_Q], x[STATE_R]);
+  eom.conv.init(CRRCMath::Vector3(x[STATE_PHI], x[STATE_THETA], x[STATE_PSI]));
+}
+
+
+void CRRC_AirplaneSim_002::getStateDerivative(TSimInputs* inputs, double* x_dot)
+{
+  double            x[NUM_STATES];
+  CRRCMath::Vector3 accel_body;
+  CRRCMath::Vector3 angaccel_body;
+
+  aero(0, inputs); // aero() doesn't use dt
+  gear(inputs);
+  eom.getAccel(v_F_aero + v_F_engine + v_F_gear,
+               v_M_aero + v_M_engine + v_M_gear,
+               accel_body, angaccel_body);
+
+  for (int i=0; i<3; i++)
+  {
+    x_dot[STATE_U+i] = accel_body.r[i];
+    x_dot[STATE_P+i] = angaccel_body.r[i];
+  }
+  getState(x);
+  eulerRates(x, x_dot);
+}
@@ -41,7 +41,7 @@
  * We don't need more for usual model airplane use.
  *
  */  
-class CRRC_AirplaneSim_002 : public FDMBase
+class CRRC_AirplaneSim_002 : public FDMBase, private EOM_6DOF::ForceModel
 {
    friend class ModFDMInterface;
   public:
@@ -88,6 +88,14 @@ class CRRC_AirplaneSim_002 : public FDMBase
     */
    virtual double getZLow() { return(wheelsys.getZLow()); };
 
+   /// @name Linearization, see FDMBase
+   //@{
+   virtual bool hasState() { return(true); };
+   virtual void getState(double* x);
+   virtual void setState(const double* x);
+   virtual void getStateDerivative(TSimInputs* inputs, double* x_dot);
+   //@}
+
   private:
    
    void LoadFromXML(SimpleXMLTransfer* xml);
@@ -109,12 +117,12 @@ class CRRC_AirplaneSim_002 : public FDMBase
    /**
     * read from file
     */
-   CRRC_AirplaneSim_002(const char* filename, FDMEnviroment* myEnv);
+   CRRC_AirplaneSim_002(const char* filename, FDMEnviroment* myEnv, SimpleXMLTransfer* cfg);
 
    /**
     * read from xml description
     */
-   CRRC_AirplaneSim_002(SimpleXMLTransfer* xml, FDMEnviroment* myEnv);
+   CRRC_AirplaneSim_002(SimpleXMLTransfer* xml, FDMEnviroment* myEnv, SimpleXMLTransfer* cfg);
    
    virtual ~CRRC_AirplaneSim_002();
 
@@ -200,6 +208,12 @@ class CRRC_AirplaneSim_002 : public FDMBase
    void aero_init();
    void aero(SCALAR dt, TSimInputs* inputs);
 
+   /**
+    * aero() and gear() for the current state of eom, used by the
+    * Runge-Kutta integrators. The engine is stepped once per time step.
+    */
+   void forces(CRRCMath::Vector3& FBody, CRRCMath::Vector3& MBody);
+
   private:
    
    /// @name written by constructor
@@ -210,6 +224,16 @@ class CRRC_AirplaneSim_002 : public FDMBase
     */
    Power::Power* power;
    
+   /**
+    * CRRCMath::INTEGRATOR_*, from simulation.flightModel.integrator
+    */
+   int integrator;
+   
+   /**
+    * error tolerance for CRRCMath::INTEGRATOR_RK45
+    */
+   double rk45_tolerance;
+   
    /**
     * Velocity in trimmed flight; dead air.
     */
@@ -489,6 +489,7 @@ void CRRC_AirplaneSim_Heli01::ls_step_init()
   latitude_dot_past = longitude_dot_past = radius_dot_past  = 0;
   v_R_omega_dot_body_past = CRRCMath::Vector3();
   e_dot_0_past = e_dot_1_past = e_dot_2_past = e_dot_3_past = 0;
+  dt_past = 0;
 
   /* Initialize geocentric position from geodetic latitude and altitude */
 
@@ -533,7 +534,7 @@ void CRRC_AirplaneSim_Heli01::ls_step_init()
 
 void CRRC_AirplaneSim_Heli01::ls_step( SCALAR dt )   
 {
-  SCALAR        dth;
+  SCALAR        dth, r;
   SCALAR        epsilon, inv_eps;
   SCALAR        e_dot_0, e_dot_1, e_dot_2, e_dot_3;
   SCALAR        cos_Lat_geocentric, inv_Radius_to_vehicle;
@@ -552,12 +553,19 @@ void CRRC_AirplaneSim_Heli01::ls_step( SCALAR dt )
 
   dth = 0.5*dt;
 
+/* Ratio to the last step size; the extrapolation of the
+   Adams-Bashford steps takes changes into account (r = 1
+   gives the usual coefficients 3 and -1) */
+
+  r       = (dt_past > 0) ? dt/dt_past : 1;
+  dt_past = dt;
+
 /*  L I N E A R   V E L O C I T I E S   */
 
 /* Integrate linear accelerations to get velocities */
 /*    Using predictive Adams-Bashford algorithm     */
 
-  v_V_local += (v_V_dot_local*3 - v_V_dot_past)*dth;
+  v_V_local += (v_V_dot_local*(2+r) - v_V_dot_past*r)*dth;
     
 /* record past states */
 
@@ -590,7 +598,7 @@ void CRRC_AirplaneSim_Heli01::ls_step( SCALAR dt )
 
 /* Integrate rotational accelerations to get velocities */
 
-  v_R_omega_body = v_R_omega_body + (v_R_omega_dot_body*3 - v_R_omega_dot_body_past)*dth;
+  v_R_omega_body = v_R_omega_body + (v_R_omega_dot_body*(2+r) - v_R_omega_dot_body_past*r)*dth;
     
   // sanity check: v_R_omega_body.length() * dt < pi/2
   {
@@ -290,6 +290,12 @@ class CRRC_AirplaneSim_Heli01 : public FDMBase
    SCALAR	e_0, e_1, e_2, e_3;
    SCALAR	e_dot_0_past, e_dot_1_past, e_dot_2_past, e_dot_3_past;
    int	step_inited;
+
+   /**
+    * Size of the last time step, 0 before the first one [s].
+    * ModFDMInterface changes the step size in flight.
+    */
+   double dt_past;
    
    
    /**
@@ -167,22 +167,34 @@ void CRRC_AirplaneSim_Larcsim::update(TSimInputs* inputs,
     logVal(m_V_atmo_rwy);
 #endif
             
-    ls_step( dt );
-    ls_aux();
+    if (integrator == CRRCMath::INTEGRATOR_AB2)
+    {
+      ls_step( dt );
+      ls_aux();
 
-    env->ControllerCallback(dt, this, inputs, &myInputs);
+      env->ControllerCallback(dt, this, inputs, &myInputs);
     
-    aero( &myInputs );
+      aero( &myInputs );
+      engine( dt, &myInputs );
+      gear( &myInputs );
+
+      ls_accel();
+    }
+    else
+    {
+      // The state is the one the last step ended with. Inputs and
+      // engine forces are held for the step, aero() and gear() are
+      // evaluated by derivative().
+      env->ControllerCallback(dt, this, inputs, &myInputs);
+      engine( dt, &myInputs );
+
+      ls_step_rk( dt );
+    }
     
 #if FDM_LOG_AERO_OUT != 0
     logVal(v_F_aero);
     logVal(v_M_aero);
 #endif
-    
-    engine( dt, &myInputs );
-    gear( &myInputs );
-
-    ls_accel();
   }
 }
 
@@ -193,6 +205,9 @@ CRRC_AirplaneSim_Larcsim::CRRC_AirplaneSim_Larcsim(const char* filename, FDMEnvi
   // This has been removed as CRRCSim includes an automatic converter.
   SimpleXMLTransfer* fileinmemory = new SimpleXMLTransfer(filename);
 
+  fFlatEarth     = (cfg->getInt("simulation.flightModel.flat_earth", 0) != 0);
+  integrator     = CRRCMath::integratorByName(cfg->getString("simulation.flightModel.integrator", "ab2"));
+  rk45_tolerance = cfg->getDouble("simulation.flightModel.tolerance", 1e-6);
   LoadFromXML(fileinmemory, cfg->getInt("airplane.verbosity", 5));
   
   delete fileinmemory;
@@ -201,6 +216,9 @@ CRRC_AirplaneSim_Larcsim::CRRC_AirplaneSim_Larcsim(const char* filename, FDMEnvi
 
 CRRC_AirplaneSim_Larcsim::CRRC_AirplaneSim_Larcsim(SimpleXMLTransfer* xml, FDMEnviroment* myEnv, SimpleXMLTransfer* cfg) : FDMBase("fdm_larcsim.dat", myEnv)
 {
+  fFlatEarth     = (cfg->getInt("simulation.flightModel.flat_earth", 0) != 0);
+  integrator     = CRRCMath::integratorByName(cfg->getString("simulation.flightModel.integrator", "ab2"));
+  rk45_tolerance = cfg->getDouble("simulation.flightModel.tolerance", 1e-6);
   LoadFromXML(xml, cfg->getInt("airplane.verbosity", 5));
 }
 
@@ -284,12 +302,12 @@ void CRRC_AirplaneSim_Larcsim::LoadFromXML(SimpleXMLTransfer* xml, int nVerbosit
   Cn_dr = i->getDouble("Cn_dr");
   Cn_da = i->getDouble("Cn_da");
     
-  flaps_drag = i->getDouble("aero.flaps.drag", 0);
-  flaps_lift = i->getDouble("aero.flaps.lift", 0);
-  flaps_off  = i->getDouble("aero.flaps.off",  0);
+  flaps_drag = xml->getDouble("aero.flaps.drag", 0);
+  flaps_lift = xml->getDouble("aero.flaps.lift", 0);
+  flaps_off  = xml->getDouble("aero.flaps.off",  0);
   
-  spoiler_drag = i->getDouble("aero.spoiler.drag", 0);
-  spoiler_lift = i->getDouble("aero.spoiler.lift", 0);
+  spoiler_drag = xml->getDouble("aero.spoiler.drag", 0);
+  spoiler_lift = xml->getDouble("aero.spoiler.lift", 0);
   
   {
     double to_slug;
@@ -335,9 +353,12 @@ void CRRC_AirplaneSim_Larcsim::LoadFromXML(SimpleXMLTransfer* xml, int nVerbosit
     if (cl < 0.2)
     {
       cl = 0.2;
-      printf("airplane: Cm_a=%f   Alpha_0=%f  Cm_0=%f\n", Cm_a, Alpha_0, Cm_0);
-      printf("airplane: CL_a=%f               CL_0=%f\n", CL_a,          CL_0);
-      printf("airplane: alpha=%f  C_L=%f\n", alpha, cl);
+      if (nVerbosity > 0)
+      {
+        printf("airplane: Cm_a=%f   Alpha_0=%f  Cm_0=%f\n", Cm_a, Alpha_0, Cm_0);
+        printf("airplane: CL_a=%f               CL_0=%f\n", CL_a,          CL_0);
+        printf("airplane: alpha=%f  C_L=%f\n", alpha, cl);
+      }
     }
     
     // v = sqrt(m * g * 2 / (F * CL * rho))
@@ -688,23 +709,31 @@ void CRRC_AirplaneSim_Larcsim::ls_step_init()
   latitude_dot_past = longitude_dot_past = radius_dot_past  = 0;
   v_R_omega_dot_body_past = CRRCMath::Vector3();
   e_dot_0_past = e_dot_1_past = e_dot_2_past = e_dot_3_past = 0;
+  dt_past = 0;
+  rk45_h = 1.0; // limited to the time step by integrateRK45()
 
-  /* Initialize geocentric position from geodetic latitude and altitude */
+  if (fFlatEarth)
+  {
+    /* Runway coordinates are integrated directly. Latitude and longitude
+       are only derived from them for getLat()/getLon(). */
+    v_V_local_past = CRRCMath::Vector3();
+    ls_geod_to_geoc( 0, 0, &Sea_level_radius, &Lat_geocentric);
+    v_P_CG_Rwy = CRRCMath::Vector3(Sea_level_radius * Latitude,
+                                   Sea_level_radius * Longitude,
+                                   -Altitude);
+  }
+  else
+  {
+    /* Initialize geocentric position from geodetic latitude and altitude */
 
-  ls_geod_to_geoc( Latitude, Altitude, &Sea_level_radius, &Lat_geocentric);
-  Lon_geocentric = Longitude;
-  Radius_to_vehicle = Altitude + Sea_level_radius;
+    ls_geod_to_geoc( Latitude, Altitude, &Sea_level_radius, &Lat_geocentric);
+    Lon_geocentric = Longitude;
+    Radius_to_vehicle = Altitude + Sea_level_radius;
+  }
 
   /* Initialize quaternions and transformation matrix from Euler angles */
 
-  e_0 = cos(Psi*0.5)*cos(Theta*0.5)*cos(Phi*0.5)
-    + sin(Psi*0.5)*sin(Theta*0.5)*sin(Phi*0.5);
-  e_1 = cos(Psi*0.5)*cos(Theta*0.5)*sin(Phi*0.5)
-    - sin(Psi*0.5)*sin(Theta*0.5)*cos(Phi*0.5);
-  e_2 = cos(Psi*0.5)*sin(Theta*0.5)*cos(Phi*0.5)
-    + sin(Psi*0.5)*cos(Theta*0.5)*sin(Phi*0.5);
-  e_3 = -cos(Psi*0.5)*sin(Theta*0.5)*sin(Phi*0.5)
-    + sin(Psi*0.5)*cos(Theta*0.5)*cos(Phi*0.5);
+  ls_euler_to_quat();
   LocalToBody.v[0][0] = e_0*e_0 + e_1*e_1 - e_2*e_2 - e_3*e_3;
   LocalToBody.v[0][1] = 2*(e_1*e_2 + e_0*e_3);
   LocalToBody.v[0][2] = 2*(e_1*e_3 - e_0*e_2);
@@ -748,7 +777,7 @@ void CRRC_AirplaneSim_Larcsim::ls_step_init()
  */
 void CRRC_AirplaneSim_Larcsim::ls_step( SCALAR dt )   
 {
-  SCALAR        dth;
+  SCALAR        dth, r;
   SCALAR        epsilon, inv_eps;
   SCALAR        e_dot_0, e_dot_1, e_dot_2, e_dot_3;
   SCALAR        cos_Lat_geocentric, inv_Radius_to_vehicle;
@@ -767,12 +796,19 @@ void CRRC_AirplaneSim_Larcsim::ls_step( SCALAR dt )
 
   dth = 0.5*dt;
 
+/* Ratio to the last step size; the extrapolation of the
+   Adams-Bashford steps takes changes into account (r = 1
+   gives the usual coefficients 3 and -1) */
+
+  r       = (dt_past > 0) ? dt/dt_past : 1;
+  dt_past = dt;
+
 /*  L I N E A R   V E L O C I T I E S   */
 
 /* Integrate linear accelerations to get velocities */
 /*    Using predictive Adams-Bashford algorithm     */
 
-  v_V_local += (v_V_dot_local*3 - v_V_dot_past)*dth;
+  v_V_local += (v_V_dot_local*(2+r) - v_V_dot_past*r)*dth;
 
 /* record past states */
 
@@ -780,32 +816,43 @@ void CRRC_AirplaneSim_Larcsim::ls_step( SCALAR dt )
 
 /* Calculate trajectory rate (geocentric coordinates) */
 
-  inv_Radius_to_vehicle = 1.0/Radius_to_vehicle;
-  cos_Lat_geocentric = cos(Lat_geocentric);
-
-  if ( cos_Lat_geocentric != 0)
+  if (!fFlatEarth)
   {
-    Longitude_dot = v_V_local.r[1]/(Radius_to_vehicle*cos_Lat_geocentric);
+    inv_Radius_to_vehicle = 1.0/Radius_to_vehicle;
+    cos_Lat_geocentric = cos(Lat_geocentric);
+
+    if ( cos_Lat_geocentric != 0)
+    {
+      Longitude_dot = v_V_local.r[1]/(Radius_to_vehicle*cos_Lat_geocentric);
+    }
+    else
+    {
+      // This is just to stop some compilers from complaining about a
+      // non-initialized Longitude_dot. It's not mathematically correct
+      // (Longitude_dot will move towards +inf if the cosine gets 0),
+      // but it also should be irrelevant and at least it's better than
+      // relying on something that isn't initialized.
+      Longitude_dot = 0;
+      fprintf(stderr, "Error: Longitude_dot --> +inf!\n");
+    }
+
+    Latitude_dot = v_V_local.r[0]*inv_Radius_to_vehicle;
+    Radius_dot   = -v_V_local.r[2];
   }
   else
   {
-    // This is just to stop some compilers from complaining about a
-    // non-initialized Longitude_dot. It's not mathematically correct
-    // (Longitude_dot will move towards +inf if the cosine gets 0),
-    // but it also should be irrelevant and at least it's better than
-    // relying on something that isn't initialized.
-    Longitude_dot = 0;
-    fprintf(stderr, "Error: Longitude_dot --> +inf!\n");
+    // not used on a flat earth, but some compilers can't tell
+    inv_Radius_to_vehicle = 0;
+    Latitude_dot          = 0;
+    Longitude_dot         = 0;
+    Radius_dot            = 0;
   }
 
-  Latitude_dot = v_V_local.r[0]*inv_Radius_to_vehicle;
-  Radius_dot   = -v_V_local.r[2];
-
 /*  A N G U L A R   V E L O C I T I E S   A N D   P O S I T I O N S  */
 
 /* Integrate rotational accelerations to get velocities */
 
-  v_R_omega_body = v_R_omega_body + (v_R_omega_dot_body*3 - v_R_omega_dot_body_past)*dth;
+  v_R_omega_body = v_R_omega_body + (v_R_omega_dot_body*(2+r) - v_R_omega_dot_body_past*r)*dth;
   
   // sanity check: v_R_omega_body.length() * dt < pi/2
   {
@@ -820,17 +867,25 @@ void CRRC_AirplaneSim_Larcsim::ls_step( SCALAR dt )
   
   v_R_omega_dot_body_past = v_R_omega_dot_body;
 
-/* Calculate local axis frame rates due to travel over curved earth */
+  if (fFlatEarth)
+  {
+    /* The local axis frame doesn't rotate on a flat earth */
+    v_R_omega_total = v_R_omega_body;
+  }
+  else
+  {
+    /* Calculate local axis frame rates due to travel over curved earth */
 
-  v_R_omega_local.r[0] =  v_V_local.r[1]*inv_Radius_to_vehicle;
-  v_R_omega_local.r[1] = -v_V_local.r[0]*inv_Radius_to_vehicle;
-  v_R_omega_local.r[2] = -v_V_local.r[1]*tan(Lat_geocentric)*inv_Radius_to_vehicle;
+    v_R_omega_local.r[0] =  v_V_local.r[1]*inv_Radius_to_vehicle;
+    v_R_omega_local.r[1] = -v_V_local.r[0]*inv_Radius_to_vehicle;
+    v_R_omega_local.r[2] = -v_V_local.r[1]*tan(Lat_geocentric)*inv_Radius_to_vehicle;
 
-  /* Transform local axis frame rates to body axis rates */
-  v_R_local_in_body = LocalToBody * v_R_omega_local;
+    /* Transform local axis frame rates to body axis rates */
+    v_R_local_in_body = LocalToBody * v_R_omega_local;
 
-  /* Calculate total angular rates in body axis */
-  v_R_omega_total = v_R_omega_body - v_R_local_in_body;
+    /* Calculate total angular rates in body axis */
+    v_R_omega_total = v_R_omega_body - v_R_local_in_body;
+  }
 
 /* Transform to quaternion rates (see Appendix E in [2]) */
 
@@ -863,8 +918,40 @@ void CRRC_AirplaneSim_Larcsim::ls_step( SCALAR dt )
   e_dot_2_past = e_dot_2;
   e_dot_3_past = e_dot_3;
 
-/* Update local to body transformation matrix */
+/* Update local to body transformation matrix and Euler angles */
+
+  ls_attitude();
 
+/*  L I N E A R   P O S I T I O N S   */
+
+/* Trapezoidal acceleration for position */
+
+  if (fFlatEarth)
+  {
+    v_P_CG_Rwy    += (v_V_local + v_V_local_past)*dth;
+    v_V_local_past = v_V_local;
+  }
+  else
+  {
+    Lat_geocentric       = Lat_geocentric    + dth*(Latitude_dot  + latitude_dot_past );
+    Lon_geocentric       = Lon_geocentric    + dth*(Longitude_dot + longitude_dot_past);
+    Radius_to_vehicle    = Radius_to_vehicle + dth*(Radius_dot    + radius_dot_past );
+
+    /* Save past values */
+
+    latitude_dot_past  = Latitude_dot;
+    longitude_dot_past = Longitude_dot;
+    radius_dot_past    = Radius_dot;
+  }
+
+/* end of ls_step */
+}
+
+/**
+ * Local to body transformation matrix and Euler angles from the quaternion.
+ */
+void CRRC_AirplaneSim_Larcsim::ls_attitude()
+{
   LocalToBody.v[0][0] = e_0*e_0 + e_1*e_1 - e_2*e_2 - e_3*e_3;
   LocalToBody.v[0][1] = 2*(e_1*e_2 + e_0*e_3);
   LocalToBody.v[0][2] = 2*(e_1*e_3 - e_0*e_2);
@@ -892,22 +979,183 @@ void CRRC_AirplaneSim_Larcsim::ls_step( SCALAR dt )
 /* Resolve Psi to 0 - 359.9999 */
 
   if (Psi < 0 ) Psi = Psi + 2*M_PI;
+}
 
-/*  L I N E A R   P O S I T I O N S   */
 
-/* Trapezoidal acceleration for position */
+void CRRC_AirplaneSim_Larcsim::ls_euler_to_quat()
+{
+  e_0 = cos(Psi*0.5)*cos(Theta*0.5)*cos(Phi*0.5)
+    + sin(Psi*0.5)*sin(Theta*0.5)*sin(Phi*0.5);
+  e_1 = cos(Psi*0.5)*cos(Theta*0.5)*sin(Phi*0.5)
+    - sin(Psi*0.5)*sin(Theta*0.5)*cos(Phi*0.5);
+  e_2 = cos(Psi*0.5)*sin(Theta*0.5)*cos(Phi*0.5)
+    + sin(Psi*0.5)*cos(Theta*0.5)*sin(Phi*0.5);
+  e_3 = -cos(Psi*0.5)*sin(Theta*0.5)*sin(Phi*0.5)
+    + sin(Psi*0.5)*cos(Theta*0.5)*cos(Phi*0.5);
+}
 
-  Lat_geocentric       = Lat_geocentric    + dth*(Latitude_dot  + latitude_dot_past );
-  Lon_geocentric       = Lon_geocentric    + dth*(Longitude_dot + longitude_dot_past);
-  Radius_to_vehicle    = Radius_to_vehicle + dth*(Radius_dot    + radius_dot_past );
 
-/* Save past values */
+/**
+ * Integrates one time step with CRRCMath::stepRK4() or
+ * CRRCMath::integrateRK45() instead of the Adams-Bashforth scheme of
+ * ls_step(). Forces and moments are evaluated at the intermediate
+ * states, too, so the step can be a lot longer for the same accuracy.
+ *
+ * The step size control of RK45 is only used in the air: friction
+ * on the ground switches with the direction of movement, so the error
+ * estimate would always ask for the shortest step. As long as the
+ * gear touched the ground at the last evaluation, RK4 is used.
+ */
+void CRRC_AirplaneSim_Larcsim::ls_step_rk( SCALAR dt )
+{
+  T_State y;
 
-  latitude_dot_past  = Latitude_dot;
-  longitude_dot_past = Longitude_dot;
-  radius_dot_past    = Radius_dot;
+  ls_get_state(y);
+  
+  if (integrator == CRRCMath::INTEGRATOR_RK45 && v_F_gear.length() == 0)
+    CRRCMath::integrateRK45(*this, y, dt, rk45_h, rk45_tolerance, 0.01*dt);
+  else
+    CRRCMath::stepRK4(*this, y, dt);
 
-/* end of ls_step */
+  ls_set_state(y);
+  
+  // sanity check: v_R_omega_body.length() * dt < pi/2, see ls_step()
+  {
+    double vRo_max = 0.5*M_PI / dt;
+    double vRo_len = v_R_omega_body.length();
+    
+    if (vRo_len > vRo_max)
+      v_R_omega_body *= vRo_max/vRo_len;
+  }
+
+  // Forces, moments and accelerations are left from the last evaluation
+  // within the step. Everything else belongs to the new state.
+  ls_aux();
+}
+
+
+void CRRC_AirplaneSim_Larcsim::ls_get_state(T_State& y)
+{
+  for (int i=0; i<3; i++)
+  {
+    y[i]   = v_V_local.r[i];
+    y[3+i] = v_R_omega_body.r[i];
+  }
+  y[6] = e_0;
+  y[7] = e_1;
+  y[8] = e_2;
+  y[9] = e_3;
+
+  if (fFlatEarth)
+  {
+    for (int i=0; i<3; i++)
+      y[10+i] = v_P_CG_Rwy.r[i];
+  }
+  else
+  {
+    y[10] = Lat_geocentric;
+    y[11] = Lon_geocentric;
+    y[12] = Radius_to_vehicle;
+  }
+}
+
+
+/**
+ * The quaternion is scaled to unity length, the matrix and the
+ * Euler angles are updated.
+ */
+void CRRC_AirplaneSim_Larcsim::ls_set_state(const T_State& y)
+{
+  SCALAR inv_eps = 1/sqrt(y[6]*y[6] + y[7]*y[7] + y[8]*y[8] + y[9]*y[9]);
+
+  for (int i=0; i<3; i++)
+  {
+    v_V_local.r[i]      = y[i];
+    v_R_omega_body.r[i] = y[3+i];
+  }
+  e_0 = inv_eps*y[6];
+  e_1 = inv_eps*y[7];
+  e_2 = inv_eps*y[8];
+  e_3 = inv_eps*y[9];
+
+  if (fFlatEarth)
+  {
+    for (int i=0; i<3; i++)
+      v_P_CG_Rwy.r[i] = y[10+i];
+  }
+  else
+  {
+    Lat_geocentric    = y[10];
+    Lon_geocentric    = y[11];
+    Radius_to_vehicle = y[12];
+  }
+
+  ls_attitude();
+}
+
+
+// see header
+void CRRC_AirplaneSim_Larcsim::derivative(const T_State& y, T_State& dydt)
+{
+  CRRCMath::Vector3 v_R_omega_total;
+  
+  ls_set_state(y);
+  ls_aux();
+  aero( &myInputs );
+  gear( &myInputs );
+  ls_accel();
+
+  for (int i=0; i<3; i++)
+  {
+    dydt[i]   = v_V_dot_local.r[i];
+    dydt[3+i] = v_R_omega_dot_body.r[i];
+  }
+
+  if (fFlatEarth)
+  {
+    v_R_omega_total = v_R_omega_body;
+    
+    for (int i=0; i<3; i++)
+      dydt[10+i] = v_V_local.r[i];
+  }
+  else
+  {
+    // see ls_step()
+    SCALAR            inv_Radius_to_vehicle = 1.0/Radius_to_vehicle;
+    SCALAR            cos_Lat_geocentric    = cos(Lat_geocentric);
+    CRRCMath::Vector3 v_R_omega_local;
+
+    v_R_omega_local.r[0] =  v_V_local.r[1]*inv_Radius_to_vehicle;
+    v_R_omega_local.r[1] = -v_V_local.r[0]*inv_Radius_to_vehicle;
+    v_R_omega_local.r[2] = -v_V_local.r[1]*tan(Lat_geocentric)*inv_Radius_to_vehicle;
+
+    v_R_omega_total = v_R_omega_body - LocalToBody * v_R_omega_local;
+
+    dydt[10] = v_V_local.r[0]*inv_Radius_to_vehicle;
+    dydt[11] = (cos_Lat_geocentric != 0) ? v_V_local.r[1]*inv_Radius_to_vehicle/cos_Lat_geocentric : 0;
+    dydt[12] = -v_V_local.r[2];
+  }
+
+  dydt[6] = 0.5*( -v_R_omega_total.r[0]*e_1 - v_R_omega_total.r[1]*e_2 - v_R_omega_total.r[2]*e_3 );
+  dydt[7] = 0.5*(  v_R_omega_total.r[0]*e_0 - v_R_omega_total.r[1]*e_3 + v_R_omega_total.r[2]*e_2 );
+  dydt[8] = 0.5*(  v_R_omega_total.r[0]*e_3 + v_R_omega_total.r[1]*e_0 - v_R_omega_total.r[2]*e_1 );
+  dydt[9] = 0.5*( -v_R_omega_total.r[0]*e_2 + v_R_omega_total.r[1]*e_1 + v_R_omega_total.r[2]*e_0 );
+}
+
+
+// see header
+double CRRC_AirplaneSim_Larcsim::errorNorm(const T_State& err, const T_State& y, double tol)
+{
+  double e = 0;
+  
+  for (int i=0; i<10; i++)
+  {
+    double ei = fabs(err[i]) / (tol * (1 + fabs(y[i])));
+    
+    if (ei > e)
+      e = ei;
+  }
+  return(e);
 }
 
 
@@ -923,9 +1171,18 @@ void CRRC_AirplaneSim_Larcsim::ls_aux()
   
   /* update geodetic position */
 
-  ls_geoc_to_geod( Lat_geocentric, Radius_to_vehicle,
-                   &Latitude, &Altitude, &Sea_level_radius );
-  Longitude = Lon_geocentric;
+  if (fFlatEarth)
+  {
+    Latitude  = v_P_CG_Rwy.r[0] / Sea_level_radius;
+    Longitude = v_P_CG_Rwy.r[1] / Sea_level_radius;
+    Altitude  = -v_P_CG_Rwy.r[2];
+  }
+  else
+  {
+    ls_geoc_to_geod( Lat_geocentric, Radius_to_vehicle,
+                     &Latitude, &Altitude, &Sea_level_radius );
+    Longitude = Lon_geocentric;
+  }
 
   /* Form relative velocity vector */
 
@@ -966,9 +1223,12 @@ void CRRC_AirplaneSim_Larcsim::ls_aux()
   
 /* Determine location in runway coordinates */
 
-  v_P_CG_Rwy.r[0] = Sea_level_radius * Latitude;
-  v_P_CG_Rwy.r[1] = Sea_level_radius * Longitude;
-  v_P_CG_Rwy.r[2] = Sea_level_radius - Radius_to_vehicle;
+  if (!fFlatEarth)
+  {
+    v_P_CG_Rwy.r[0] = Sea_level_radius * Latitude;
+    v_P_CG_Rwy.r[1] = Sea_level_radius * Longitude;
+    v_P_CG_Rwy.r[2] = Sea_level_radius - Radius_to_vehicle;
+  }
   
 /* end of ls_aux */
 
@@ -1050,17 +1310,29 @@ void CRRC_AirplaneSim_Larcsim::ls_accel()
   
   /* Calculate linear accelerations */
 
-  tan_Lat_geocentric = tan(Lat_geocentric);
   inv_Mass    = 1/Mass;
-  inv_Radius  = 1/Radius_to_vehicle;
-  
-  v_V_dot_local.r[0] = inv_Mass*v_F_local.r[0] + inv_Radius*(v_V_local.r[0]*v_V_local.r[2] - v_V_local.r[1]*v_V_local.r[1] *tan_Lat_geocentric);
-  v_V_dot_local.r[1] = inv_Mass*v_F_local.r[1] + inv_Radius*(v_V_local.r[1]*v_V_local.r[2]  + v_V_local.r[0]*v_V_local.r[1]*tan_Lat_geocentric);
+
+  if (fFlatEarth)
+  {
+    v_V_dot_local = v_F_local*inv_Mass;
+#if EOM_TEST == 0
+    v_V_dot_local.r[2] += Gravity;
+#endif
+  }
+  else
+  {
+    tan_Lat_geocentric = tan(Lat_geocentric);
+    inv_Radius  = 1/Radius_to_vehicle;
+    
+    v_V_dot_local.r[0] = inv_Mass*v_F_local.r[0] + inv_Radius*(v_V_local.r[0]*v_V_local.r[2] - v_V_local.r[1]*v_V_local.r[1] *tan_Lat_geocentric);
+    v_V_dot_local.r[1] = inv_Mass*v_F_local.r[1] + inv_Radius*(v_V_local.r[1]*v_V_local.r[2]  + v_V_local.r[0]*v_V_local.r[1]*tan_Lat_geocentric);
 #if EOM_TEST != 0
-  v_V_dot_local.r[2] = inv_Mass*v_F_local.r[2]           - inv_Radius*(v_V_local.r[0]*v_V_local.r[0] + v_V_local.r[1]*v_V_local.r[1]);
+    v_V_dot_local.r[2] = inv_Mass*v_F_local.r[2]           - inv_Radius*(v_V_local.r[0]*v_V_local.r[0] + v_V_local.r[1]*v_V_local.r[1]);
 #else
-  v_V_dot_local.r[2] = inv_Mass*v_F_local.r[2] + Gravity - inv_Radius*(v_V_local.r[0]*v_V_local.r[0] + v_V_local.r[1]*v_V_local.r[1]);
+    v_V_dot_local.r[2] = inv_Mass*v_F_local.r[2] + Gravity - inv_Radius*(v_V_local.r[0]*v_V_local.r[0] + v_V_local.r[1]*v_V_local.r[1]);
 #endif
+  }
+
   /* Invert the symmetric inertia matrix */
 
   ixz2 = I_xz*I_xz;
@@ -1098,4 +1370,57 @@ void CRRC_AirplaneSim_Larcsim::registerAnimations(std::vector<CRRCAnimation*> co
 }
 
 
+void CRRC_AirplaneSim_Larcsim::getState(double* x)
+{
+  CRRCMath::Vector3 v_V_body = LocalToBody * v_V_local;
+
+  for (int i=0; i<3; i++)
+  {
+    x[STATE_U+i] = v_V_body.r[i];
+    x[STATE_P+i] = v_R_omega_body.r[i];
+  }
+  x[STATE_PHI]   = Phi;
+  x[STATE_THETA] = Theta;
+  x[STATE_PSI]   = Psi;
+}
+
+
+void CRRC_AirplaneSim_Larcsim::setState(const double* x)
+{
+  Phi   = x[STATE_PHI];
+  Theta = x[STATE_THETA];
+  Psi   = x[STATE_PSI];
+  ls_euler_to_quat();
+  ls_attitude();
+
+  v_V_local      = LocalToBody.trans() * CRRCMath::Vector3(x[STATE_U], x[STATE_V], x[STATE_W]);
+  v_R_omega_body = CRRCMath::Vector3(x[STATE_P], x[STATE_Q], x[STATE_R]);
+
+  ls_aux();
+}
 
+
+/**
+ * The rotation of the local frame on a round earth is neglected.
+ */
+void CRRC_AirplaneSim_Larcsim::getStateDerivative(TSimInputs* inputs, double* x_dot)
+{
+  double            x[NUM_STATES];
+  CRRCMath::Vector3 v_V_body = LocalToBody * v_V_local;
+  CRRCMath::Vector3 v_V_dot_body;
+
+  aero( inputs );
+  gear( inputs );
+  ls_accel();
+
+  // derivative of LocalToBody * v_V_local
+  v_V_dot_body = LocalToBody * v_V_dot_local + v_V_body * v_R_omega_body;
+
+  for (int i=0; i<3; i++)
+  {
+    x_dot[STATE_U+i] = v_V_dot_body.r[i];
+    x_dot[STATE_P+i] = v_R_omega_dot_body.r[i];
+  }
+  getState(x);
+  eulerRates(x, x_dot);
+}
@@ -34,6 +34,7 @@
 # include "../fdm.h"
 # include "../../mod_math/vector3.h"
 # include "../../mod_math/matrix33.h"
+# include "../../mod_math/rungekutta.h"
 # include "../power/power.h"
 # include "../gear01/gear.h"
 
@@ -70,7 +71,7 @@
  * @author Bruce Jackson
  * @author Jens Wilhelm Wulf
  */
-class CRRC_AirplaneSim_Larcsim : public FDMBase
+class CRRC_AirplaneSim_Larcsim : public FDMBase, private CRRCMath::ODESystem<13>
 {
    friend class ModFDMInterface;
    friend class CRRC_AirplaneSim_DisplayMode;
@@ -136,6 +137,14 @@ class CRRC_AirplaneSim_Larcsim : public FDMBase
     */
    void registerAnimations(std::vector<CRRCAnimation*> const& anims);
 
+   /// @name Linearization, see FDMBase
+   //@{
+   virtual bool hasState() { return(true); };
+   virtual void getState(double* x);
+   virtual void setState(const double* x);
+   virtual void getStateDerivative(TSimInputs* inputs, double* x_dot);
+   //@}
+
   private:
 
    void LoadFromXML(SimpleXMLTransfer* xml, int nVerbosity);
@@ -257,6 +266,41 @@ class CRRC_AirplaneSim_Larcsim : public FDMBase
    void ls_step_init();
    void ls_step( SCALAR dt);
    void ls_accel();
+   void ls_attitude();
+
+   /**
+    * Quaternion from Phi, Theta and Psi
+    */
+   void ls_euler_to_quat();
+
+   /// @name Runge-Kutta integration
+   //@{
+
+   /**
+    * velocity (3), body rates (3), quaternion (4), position (3).
+    * The position is geocentric latitude, longitude and radius or,
+    * on a flat earth, runway coordinates.
+    */
+   typedef CRRCMath::StateVector<13> T_State;
+
+   void ls_step_rk( SCALAR dt);
+   void ls_get_state(T_State& y);
+   void ls_set_state(const T_State& y);
+
+   /**
+    * Sets the state, evaluates aero() and gear() for it and returns
+    * the derivative. The engine is only stepped once per time step.
+    */
+   void derivative(const T_State& y, T_State& dydt);
+
+   /**
+    * Like the default, but without the position: the geocentric
+    * coordinates are angles and any position error comes from the
+    * velocity anyway.
+    */
+   double errorNorm(const T_State& err, const T_State& y, double tol);
+
+   //@}
    
   private:   
 
@@ -273,6 +317,25 @@ class CRRC_AirplaneSim_Larcsim : public FDMBase
     */
    float trimmedFlightVelocity;
    
+   /**
+    * Integrate runway coordinates directly instead of geocentric
+    * latitude/longitude/radius (simulation.flightModel.flat_earth).
+    * The curvature terms are far below anything noticeable at model
+    * flying distances.
+    */
+   bool fFlatEarth;
+
+   /**
+    * CRRCMath::INTEGRATOR_AB2 (the original LaRCSim scheme),
+    * INTEGRATOR_RK4 or INTEGRATOR_RK45 (simulation.flightModel.integrator)
+    */
+   int integrator;
+
+   /**
+    * Error tolerance of INTEGRATOR_RK45 (simulation.flightModel.tolerance)
+    */
+   double rk45_tolerance;
+   
    //@}
    
    /// @name written by init, update
@@ -334,6 +397,11 @@ class CRRC_AirplaneSim_Larcsim : public FDMBase
    //@{
    SCALAR	latitude_dot_past, longitude_dot_past, radius_dot_past;
 
+   /**
+    * north, east, down; flat earth only
+    */
+   CRRCMath::Vector3 v_V_local_past;
+
    /**
     * P, Q, R
     */
@@ -347,6 +415,17 @@ class CRRC_AirplaneSim_Larcsim : public FDMBase
    SCALAR	e_0, e_1, e_2, e_3;
    SCALAR	e_dot_0_past, e_dot_1_past, e_dot_2_past, e_dot_3_past;
    int	step_inited;
+
+   /**
+    * Size of the last time step, 0 before the first one [s].
+    * ModFDMInterface changes the step size in flight.
+    */
+   double dt_past;
+
+   /**
+    * Step size INTEGRATOR_RK45 proposes for the next time step [s]
+    */
+   double rk45_h;
    
    
    /**
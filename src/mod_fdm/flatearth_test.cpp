@@ -0,0 +1,132 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file flatearth_test.cpp
+ *
+ *  Flies the same maneuver with CRRC_AirplaneSim_Larcsim on the round
+ *  and on the flat earth (simulation.flightModel.flat_earth) and
+ *  compares the trajectories.
+ *
+ *  Usage: flatearth_test [airplane.xml]
+ *
+ *  Returns 0 if position and attitude agree within the tolerances,
+ *  1 if they don't and 2 if the airplane can't be loaded.
+ */
+#include "testflight.h"
+
+/**
+ * The geodetic conversion on the round earth alone makes the position
+ * jitter by about 0.1 ft.
+ */
+#define POS_TOLERANCE   0.5    // ft
+#define ANGLE_TOLERANCE 0.001  // rad
+
+/**
+ * On the round earth, the runway north coordinate is calculated from the
+ * geodetic latitude, which grows faster than the geocentric one by this
+ * factor (WGS84, at the equator). The flat earth integrates the velocity
+ * directly, so its north coordinate is shorter by this factor.
+ */
+#define NORTH_SCALE     (1.0/(1.0 - 0.00669438))
+
+/**
+ * Fly the maneuver from testflight.h at the default time step.
+ */
+static double fly(const char* file, bool fFlatEarth, T_Sample* samples, int nSamples)
+{
+  SimpleXMLTransfer cfg;
+
+  cfg.setAttribute("simulation.flightModel.flat_earth", fFlatEarth ? "1" : "0");
+
+  return(fly(file, &cfg, 0.002777, samples, nSamples));
+}
+
+
+int main(int argc, char** argv)
+{
+  const int  nSamples = 20 * 60;
+  T_Sample*  round    = new T_Sample[nSamples];
+  T_Sample*  flat     = new T_Sample[nSamples];
+  int        nCompare = 0;
+  double     pos_max  = 0;
+  double     ang_max  = 0;
+  double     t_round, t_flat;
+
+  try
+  {
+    const char* file = (argc > 1) ? argv[1] : "models/allegro.xml";
+
+    t_round = fly(file, false, round, nSamples);
+    t_flat  = fly(file, true,  flat,  nSamples);
+  }
+  catch (XMLException e)
+  {
+    fprintf(stderr, "%s\n", e.what());
+    return(2);
+  }
+
+  for (int n=0; n<nSamples; n++)
+  {
+    CRRCMath::Vector3 pos = flat[n].pos;
+    double            d;
+
+    if (-round[n].pos.r[2] < MIN_HEIGHT || -flat[n].pos.r[2] < MIN_HEIGHT)
+      break;
+    nCompare++;
+
+    pos.r[0] *= NORTH_SCALE;
+    d = (round[n].pos - pos).length();
+
+    if (d > pos_max)
+      pos_max = d;
+
+    d = angleDiff(round[n].phi, flat[n].phi);
+    if (d > ang_max)
+      ang_max = d;
+    d = angleDiff(round[n].theta, flat[n].theta);
+    if (d > ang_max)
+      ang_max = d;
+    d = angleDiff(round[n].psi, flat[n].psi);
+    if (d > ang_max)
+      ang_max = d;
+  }
+
+  printf("final position (round): %10.3f %10.3f %10.3f ft\n",
+         round[nSamples-1].pos.r[0], round[nSamples-1].pos.r[1], round[nSamples-1].pos.r[2]);
+  printf("final position (flat):  %10.3f %10.3f %10.3f ft\n",
+         flat[nSamples-1].pos.r[0], flat[nSamples-1].pos.r[1], flat[nSamples-1].pos.r[2]);
+  printf("compared %.1f s of flight\n", nCompare / 60.0);
+  printf("max. position difference: %g ft (tolerance %g)\n", pos_max, POS_TOLERANCE);
+  printf("max. angle difference:    %g rad (tolerance %g)\n", ang_max, ANGLE_TOLERANCE);
+  printf("time (round): %.1f ms, time (flat): %.1f ms\n", t_round, t_flat);
+
+  delete[] round;
+  delete[] flat;
+
+  if (pos_max > POS_TOLERANCE || ang_max > ANGLE_TOLERANCE)
+  {
+    printf("FAILED\n");
+    return(1);
+  }
+  printf("OK\n");
+  return(0);
+}
@@ -0,0 +1,634 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+
+/** \file golden_test.cpp
+ *
+ *  Flies every airplane through the same scripted inputs in the wind
+ *  of every scenery and compares the trajectories with the golden
+ *  files written by an earlier run, so a refactoring which changes the
+ *  behaviour makes the test fail. The time needed per step of the
+ *  flight model is compared, too.
+ *
+ *  Usage: golden_test [options] [airplane.xml ...]
+ *
+ *    -u          write the golden files instead of comparing
+ *    -g <dir>    directory of the golden files (default: src/mod_fdm/golden)
+ *    -p <ft>     position tolerance (default: POS_TOLERANCE)
+ *    -a <rad>    angle tolerance (default: ANGLE_TOLERANCE)
+ *    -s <factor> allowed slowdown (default: SPEED_TOLERANCE), 0: only
+ *                report the time
+ *
+ *  Without airplanes, all of models/ are flown. It is meant to be
+ *  started in the top directory of the source tree, where models/ and
+ *  scenery/ are.
+ *
+ *  Only the wind of a scenery (default.wind) is used; terrain, slope
+ *  lift and thermals belong to the graphical part of CRRCsim. The
+ *  ground is flat at 0 ft, so every flight ends on the gear.
+ *
+ *  The time per step depends on machine, compiler and options. It is
+ *  stored with the golden files relative to a fixed amount of floating
+ *  point work and only compared if the golden files have been written
+ *  by the same compiler with the same optimization. Even then it varies
+ *  with the load of the machine, so the median of N_RUNS runs is used
+ *  and the default factor is generous. On a busy machine, turn the
+ *  check off with -s 0. Before changing a flight model for speed, write
+ *  the golden files with -u, then compare after each change.
+ *
+ *  Returns 0 if all airplanes agree with their golden files within the
+ *  tolerances, 1 if not and 2 if an airplane or a golden file can't be
+ *  read.
+ */
+#include "testflight.h"
+#include "../mod_misc/filesystools.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <dirent.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define POS_TOLERANCE   1.0    // ft
+#define ANGLE_TOLERANCE 0.02   // rad
+#define SPEED_TOLERANCE 2.0    // allowed relative increase of the time per step, 0: not checked
+
+#define DT              0.002777
+#define MULTILOOP       6      // steps of DT per frame, 60 frames per second
+#define T_FLIGHT        40     // s
+#define T_SAMPLE        0.5    // s
+#define N_SAMPLES       ((int)(T_FLIGHT / T_SAMPLE))
+#define N_RUNS          5      // the median counts
+
+#define LAUNCH_HEIGHT   30.0   // ft
+#define T_POWER         5.0    // s
+
+#define GOLDEN_DIR      "src/mod_fdm/golden"
+#define SCENERY_DIR     "scenery"
+#define MODEL_DIR       "models"
+
+#ifdef __VERSION__
+# define BUILD_COMPILER __VERSION__
+#else
+# define BUILD_COMPILER "unknown compiler"
+#endif
+#ifdef __OPTIMIZE__
+# define BUILD_OPT      "optimized"
+#else
+# define BUILD_OPT      "not optimized"
+#endif
+
+
+/**
+ * The wind of a scenery: direction of air travel (where it comes from)
+ * in degrees and velocity in ft/s, like T_Wind.
+ */
+typedef struct
+{
+  std::string name;
+  double      direction;
+  double      velocity;
+} T_Scenery;
+
+
+/**
+ * TestEnv with the constant wind of a scenery
+ */
+class GoldenEnv : public TestEnv
+{
+  public:
+    GoldenEnv(const T_Scenery* scenery)
+    {
+      vel_north = -scenery->velocity * cos(M_PI * scenery->direction / 180);
+      vel_east  = -scenery->velocity * sin(M_PI * scenery->direction / 180);
+    };
+
+    int CalculateWind(double  X_cg,      double  Y_cg,     double  Z_cg,
+                      double& Vel_north, double& Vel_east, double& Vel_down)
+    {
+      Vel_north = vel_north;
+      Vel_east  = vel_east;
+      Vel_down  = 0;
+      return(0);
+    };
+
+  private:
+    double vel_north;
+    double vel_east;
+};
+
+
+/**
+ * Trajectories of one airplane, one per scenery, and the time per
+ * step relative to calibrate().
+ */
+typedef struct
+{
+  std::vector<std::string> sceneries;
+  std::vector<T_Sample>    samples;    ///< N_SAMPLES per scenery
+  std::string              build;
+  double                   step_ns;    ///< only known after flyAll()
+  double                   step_rel;
+} T_Golden;
+
+
+/**
+ * Processor time used so far. Unlike getTimeMs(), it doesn't count
+ * the time other processes run in between.
+ */
+static double getCPUTimeMs()
+{
+  return(1000.0 * clock() / CLOCKS_PER_SEC);
+}
+
+
+/**
+ * xml files in a directory, sorted by name
+ */
+static void listXMLFiles(const std::string& dirname, std::vector<std::string>& files)
+{
+  DIR*           dir = opendir(dirname.c_str());
+  struct dirent* ent;
+
+  if (dir == NULL)
+    return;
+
+  while ((ent = readdir(dir)) != NULL)
+  {
+    std::string name = ent->d_name;
+
+    if (name.size() > 4 && name.substr(name.size() - 4) == ".xml")
+      files.push_back(dirname + "/" + name);
+  }
+  closedir(dir);
+
+  for (unsigned int i=1; i<files.size(); i++)
+    for (unsigned int j=i; j>0 && files[j] < files[j-1]; j--)
+      files[j].swap(files[j-1]);
+}
+
+
+static std::string baseName(const std::string& path)
+{
+  std::string::size_type slash = path.rfind('/');
+  std::string            name  = (slash == std::string::npos) ? path : path.substr(slash + 1);
+
+  if (name.size() > 4 && name.substr(name.size() - 4) == ".xml")
+    name.erase(name.size() - 4);
+  return(name);
+}
+
+
+/**
+ * Keeps the compiler from optimizing calibrate() away
+ */
+volatile double calibrationResult;
+
+
+/**
+ * Median of some times, sorts them
+ */
+static double median(std::vector<double>& times)
+{
+  std::sort(times.begin(), times.end());
+  return(times[times.size() / 2]);
+}
+
+
+/**
+ * Time for a fixed amount of floating point work in ns, the median
+ * of N_RUNS runs. The time per step is stored relative to this.
+ */
+static double calibrate()
+{
+  const int           n = 1000000;
+  std::vector<double> times;
+  CRRCMath::Matrix33  m(0.36, 0.48, -0.8, -0.8, 0.6, 0, 0.48, 0.64, 0.6);
+
+  for (int run=0; run<N_RUNS; run++)
+  {
+    CRRCMath::Vector3 v(1, 2, 3);
+    double            t0 = getCPUTimeMs();
+
+    for (int i=0; i<n; i++)
+    {
+      v = m * v;
+      v.r[0] += 1e-6 * sin(v.r[1]) * sqrt(fabs(v.r[2]) + 1);
+    }
+    calibrationResult = v.r[0];
+
+    times.push_back((getCPUTimeMs() - t0) * 1e6 / n);
+  }
+  return(median(times));
+}
+
+
+/**
+ * Take off with some power, pull, climb and turn from one side to the
+ * other, then glide with the throttle closed until the flight ends on
+ * the ground.
+ */
+static void setGoldenInputs(TSimInputs* inputs, double t)
+{
+  inputs->throttle = (t < T_POWER) ? 0.7 : 0;
+  inputs->elevator = (t > 1 && t < 2) ? -0.1 : 0.02;
+  inputs->aileron  = 0.1 * sin(0.5 * t);
+  inputs->rudder   = 0.5 * inputs->aileron;
+}
+
+
+/**
+ * Fly an airplane in the wind of a scenery, launched into the wind.
+ *
+ * \return  time per step in ns
+ */
+static double fly(const char* file, const T_Scenery* scenery, T_Sample* samples)
+{
+  // The FDM adds its own values to the description, so every run
+  // needs a fresh copy.
+  SimpleXMLTransfer model(file);
+  SimpleXMLTransfer cfg;
+  GoldenEnv         env(scenery);
+  ModFDMInterface   fdm;
+  TSimInputs        inputs;
+  const int         nFrames = (int)(T_FLIGHT * 60 + 0.5);
+  const int         nSample = (int)(T_SAMPLE * 60 + 0.5);
+  double            t0;
+
+  cfg.setAttribute("airplane.verbosity", "0");
+
+  XMLModelFile::ListOptions(&model);
+  fdm.loadAirplane(&model, &env, &cfg);
+  fdm.initAirplaneState(1.0, 0.0, M_PI * scenery->direction / 180, 0.0, 0.0, -LAUNCH_HEIGHT);
+
+  t0 = getCPUTimeMs();
+  for (int n=0; n<nFrames; n++)
+  {
+    setGoldenInputs(&inputs, n / 60.0);
+    fdm.update(&inputs, DT, MULTILOOP);
+
+    if ((n + 1) % nSample == 0)
+    {
+      T_Sample* s = &samples[(n + 1) / nSample - 1];
+
+      s->t     = (n + 1) / 60.0;
+      s->pos   = fdm.fdm->getPos();
+      s->phi   = fdm.fdm->getPhi();
+      s->theta = fdm.fdm->getTheta();
+      s->psi   = fdm.fdm->getPsi();
+    }
+  }
+
+  return((getCPUTimeMs() - t0) * 1e6 / (nFrames * MULTILOOP));
+}
+
+
+/**
+ * Fly an airplane in all sceneries N_RUNS times. The trajectories of
+ * the first run and the median time per step are kept.
+ */
+static void flyAll(const char* file, const std::vector<T_Scenery>& sceneries,
+                   T_Golden* result)
+{
+  std::vector<T_Sample> samples(N_SAMPLES);
+  std::vector<double>   times;
+  double                step_ns;
+  double                calibration;
+
+  result->sceneries.clear();
+  result->samples.clear();
+  for (unsigned int s=0; s<sceneries.size(); s++)
+    result->sceneries.push_back(sceneries[s].name);
+
+  for (int run=0; run<N_RUNS; run++)
+  {
+    double time = 0;
+
+    for (unsigned int s=0; s<sceneries.size(); s++)
+    {
+      time += fly(file, &sceneries[s], &samples[0]);
+      if (run == 0)
+        result->samples.insert(result->samples.end(), samples.begin(), samples.end());
+    }
+    times.push_back(time / sceneries.size());
+  }
+  step_ns = median(times);
+
+  // right afterwards, so both see the same load of the machine
+  calibration = calibrate();
+
+  result->build    = std::string(BUILD_COMPILER) + ", " + BUILD_OPT;
+  result->step_ns  = step_ns;
+  result->step_rel = step_ns / calibration;
+}
+
+
+/**
+ * Default wind of a scenery, the same defaults as Scenery uses
+ */
+static void readScenery(const std::string& file, T_Scenery* scenery)
+{
+  SimpleXMLTransfer  xml(file);
+  SimpleXMLTransfer* tag = xml.getChild("default.wind", true);
+
+  scenery->name      = baseName(file);
+  scenery->velocity  = tag->attributeAsDouble("velocity", 7.0);
+  scenery->direction = tag->attributeAsDouble("direction", 270.0);
+}
+
+
+static bool writeGolden(const std::string& file, const char* model, const T_Golden* g)
+{
+  FILE* fp = fopen(file.c_str(), "w");
+
+  if (fp == NULL)
+    return(false);
+
+  fprintf(fp, "# golden trajectories of %s, written by golden_test -u\n", model);
+  fprintf(fp, "build %s\n", g->build.c_str());
+  fprintf(fp, "# time per step relative to a fixed amount of floating point work\n");
+  fprintf(fp, "step %.4f\n", g->step_rel);
+  for (unsigned int s=0; s<g->sceneries.size(); s++)
+  {
+    fprintf(fp, "scenery %s\n", g->sceneries[s].c_str());
+    fprintf(fp, "# t x y z phi theta psi\n");
+    for (int n=0; n<N_SAMPLES; n++)
+    {
+      const T_Sample* p = &g->samples[s * N_SAMPLES + n];
+
+      fprintf(fp, "%.2f %.4f %.4f %.4f %.6f %.6f %.6f\n", p->t,
+              p->pos.r[0], p->pos.r[1], p->pos.r[2], p->phi, p->theta, p->psi);
+    }
+  }
+
+  bool ok = (ferror(fp) == 0);
+  if (fclose(fp) != 0)
+    ok = false;
+  return(ok);
+}
+
+
+static bool readGolden(const std::string& file, T_Golden* g)
+{
+  FILE* fp = fopen(file.c_str(), "r");
+  char  line[512];
+
+  if (fp == NULL)
+    return(false);
+
+  g->sceneries.clear();
+  g->samples.clear();
+  g->build    = "";
+  g->step_rel = 0;
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+  {
+    T_Sample s;
+    char*    end = line + strlen(line);
+
+    while (end > line && (end[-1] == '\n' || end[-1] == '\r'))
+      *--end = 0;
+
+    if (line[0] == '#' || line[0] == 0)
+      continue;
+    else if (strncmp(line, "build ", 6) == 0)
+      g->build = line + 6;
+    else if (strncmp(line, "step ", 5) == 0)
+      g->step_rel = atof(line + 5);
+    else if (strncmp(line, "scenery ", 8) == 0)
+      g->sceneries.push_back(line + 8);
+    else if (sscanf(line, "%lf %lf %lf %lf %lf %lf %lf", &s.t,
+                    &s.pos.r[0], &s.pos.r[1], &s.pos.r[2],
+                    &s.phi, &s.theta, &s.psi) == 7)
+      g->samples.push_back(s);
+  }
+  fclose(fp);
+
+  return(g->samples.size() == g->sceneries.size() * N_SAMPLES);
+}
+
+
+static void usage(const char* name)
+{
+  fprintf(stderr, "Usage: %s [options] [airplane.xml ...]\n", name);
+  fprintf(stderr, "  -u          write the golden files instead of comparing\n");
+  fprintf(stderr, "  -g <dir>    directory of the golden files (default: %s)\n", GOLDEN_DIR);
+  fprintf(stderr, "  -p <ft>     position tolerance (default: %g)\n", POS_TOLERANCE);
+  fprintf(stderr, "  -a <rad>    angle tolerance (default: %g)\n", ANGLE_TOLERANCE);
+  fprintf(stderr, "  -s <factor> allowed slowdown (default: %g), 0: only report the time\n", SPEED_TOLERANCE);
+}
+
+
+int main(int argc, char** argv)
+{
+  bool                     fUpdate   = false;
+  std::string              goldendir = GOLDEN_DIR;
+  double                   pos_tol   = POS_TOLERANCE;
+  double                   ang_tol   = ANGLE_TOLERANCE;
+  double                   speed_tol = SPEED_TOLERANCE;
+  int                      result    = 0;
+  int                      arg;
+  std::vector<std::string> files;
+  std::vector<std::string> sceneryfiles;
+  std::vector<T_Scenery>   sceneries;
+  std::string              output;
+
+  for (arg = 1; arg < argc && argv[arg][0] == '-'; arg++)
+  {
+    if (strcmp(argv[arg], "-u") == 0)
+      fUpdate = true;
+    else if (arg + 1 < argc && strcmp(argv[arg], "-g") == 0)
+      goldendir = argv[++arg];
+    else if (arg + 1 < argc && strcmp(argv[arg], "-p") == 0)
+      pos_tol = atof(argv[++arg]);
+    else if (arg + 1 < argc && strcmp(argv[arg], "-a") == 0)
+      ang_tol = atof(argv[++arg]);
+    else if (arg + 1 < argc && strcmp(argv[arg], "-s") == 0)
+      speed_tol = atof(argv[++arg]);
+    else
+    {
+      usage(argv[0]);
+      return(2);
+    }
+  }
+
+  for (; arg < argc; arg++)
+    files.push_back(argv[arg]);
+  if (files.size() == 0)
+    listXMLFiles(MODEL_DIR, files);
+
+  listXMLFiles(SCENERY_DIR, sceneryfiles);
+  for (unsigned int i=0; i<sceneryfiles.size(); i++)
+  {
+    T_Scenery scenery;
+
+    try
+    {
+      readScenery(sceneryfiles[i], &scenery);
+      sceneries.push_back(scenery);
+    }
+    catch (XMLException e)
+    {
+      fprintf(stderr, "%s: %s\n", sceneryfiles[i].c_str(), e.what());
+      result = 2;
+    }
+  }
+  if (files.size() == 0 || sceneries.size() == 0)
+  {
+    fprintf(stderr, "No airplanes or sceneries found, please start in the top directory\n");
+    return(2);
+  }
+
+  if (fUpdate)
+    FileSysTools::makeSurePathExists(goldendir);
+
+  for (unsigned int f=0; f<files.size(); f++)
+  {
+    const char* file   = files[f].c_str();
+    std::string golden = goldendir + "/" + baseName(files[f]) + ".txt";
+    T_Golden    test;
+    T_Golden    ref;
+    char        buf[512];
+
+    try
+    {
+      flyAll(file, sceneries, &test);
+    }
+    catch (XMLException e)
+    {
+      fprintf(stderr, "%s: %s\n", file, e.what());
+      result = 2;
+      continue;
+    }
+
+    if (fUpdate)
+    {
+      if (!writeGolden(golden, file, &test))
+      {
+        fprintf(stderr, "Unable to write %s\n", golden.c_str());
+        result = 2;
+      }
+      snprintf(buf, sizeof(buf), "%s: %.0f ns per step, written to %s\n",
+               file, test.step_ns, golden.c_str());
+      output += buf;
+      continue;
+    }
+
+    if (!readGolden(golden, &ref))
+    {
+      fprintf(stderr, "%s: unable to read %s\n", file, golden.c_str());
+      result = 2;
+      continue;
+    }
+
+    snprintf(buf, sizeof(buf), "%s\n", file);
+    output += buf;
+
+    // behaviour, for each scenery of the golden file
+    for (unsigned int r=0; r<ref.sceneries.size(); r++)
+    {
+      unsigned int s = 0;
+
+      while (s < test.sceneries.size() && test.sceneries[s] != ref.sceneries[r])
+        s++;
+      if (s == test.sceneries.size())
+      {
+        snprintf(buf, sizeof(buf), "  %-16s not found\n", ref.sceneries[r].c_str());
+        output += buf;
+        if (result == 0)
+          result = 1;
+        continue;
+      }
+
+      double pos_max = 0;
+      double ang_max = 0;
+
+      for (int n=0; n<N_SAMPLES; n++)
+      {
+        const T_Sample* a = &ref.samples[r * N_SAMPLES + n];
+        const T_Sample* b = &test.samples[s * N_SAMPLES + n];
+        double          d = (a->pos - b->pos).length();
+
+        if (!(d <= pos_max))
+          pos_max = d;
+        d = angleDiff(a->phi, b->phi);
+        if (!(d <= ang_max))
+          ang_max = d;
+        d = angleDiff(a->theta, b->theta);
+        if (!(d <= ang_max))
+          ang_max = d;
+        d = angleDiff(a->psi, b->psi);
+        if (!(d <= ang_max))
+          ang_max = d;
+      }
+
+      bool fOK = (pos_max <= pos_tol && ang_max <= ang_tol);
+
+      snprintf(buf, sizeof(buf), "  %-16s max. pos. diff %10.4g ft, max. angle diff %10.4g rad%s\n",
+               ref.sceneries[r].c_str(), pos_max, ang_max, fOK ? "" : " *");
+      output += buf;
+      if (!fOK && result == 0)
+        result = 1;
+    }
+
+    // speed, only if the golden file is from the same build
+    double ratio = test.step_rel / ref.step_rel;
+
+    if (speed_tol <= 0 || ref.build != test.build)
+    {
+      snprintf(buf, sizeof(buf), "  %.0f ns per step (%.2f times the golden file, %s)\n",
+               test.step_ns, ratio,
+               (speed_tol <= 0) ? "not checked" : "written by another build, not checked");
+      output += buf;
+    }
+    else
+    {
+      bool fOK = (ratio <= speed_tol);
+
+      snprintf(buf, sizeof(buf), "  %.0f ns per step, %.2f times the golden file%s\n",
+               test.step_ns, ratio, fOK ? "" : " *");
+      output += buf;
+      if (!fOK && result == 0)
+        result = 1;
+    }
+  }
+
+  // The loading FDM writes to stdout, so the results are printed
+  // when all flights are done.
+  printf("%s", output.c_str());
+  if (!fUpdate)
+  {
+    if (speed_tol > 0)
+      printf("tolerances: %g ft, %g rad, %g times the time per step (* = exceeded)\n",
+             pos_tol, ang_tol, speed_tol);
+    else
+      printf("tolerances: %g ft, %g rad (* = exceeded)\n", pos_tol, ang_tol);
+    if (result == 1)
+      printf("FAILED\n");
+    else if (result == 0)
+      printf("OK\n");
+  }
+  return(result);
+}
@@ -0,0 +1,188 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+/** \file integrator_test.cpp
+ *
+ *  Flies the maneuver from testflight.h with every integrator
+ *  (simulation.flightModel.integrator) at a range of time steps and
+ *  compares the trajectories to a reference flown with a very short
+ *  time step. Prints the largest time step per integrator for which
+ *  the flight model is stable and the one for which position and
+ *  attitude stay within the tolerances.
+ *
+ *  Usage: integrator_test [airplane.xml ...]
+ *
+ *  Returns 0 if every integrator is stable at the default time step,
+ *  1 if not and 2 if an airplane can't be loaded.
+ */
+#include "testflight.h"
+
+#define POS_TOLERANCE   1.0    // ft
+#define ANGLE_TOLERANCE 0.01   // rad
+
+/**
+ * Time steps to try, as steps per second. The default time step
+ * is about 1/360 s.
+ */
+static const int rates[]  = { 720, 480, 360, 240, 180, 120, 60, 40, 30, 20, 15, 10 };
+static const int nRates   = sizeof(rates)/sizeof(rates[0]);
+#define DEFAULT_RATE 360
+#define REFERENCE_RATE 1440
+
+static const char* integrators[] = { "ab2", "rk4", "rk45" };
+static const int   nIntegrators  = sizeof(integrators)/sizeof(integrators[0]);
+
+
+static double fly(const char* file, const char* integrator, int rate,
+                  T_Sample* samples, int nSamples)
+{
+  SimpleXMLTransfer cfg;
+
+  cfg.setAttribute("simulation.flightModel.flat_earth", "1");
+  cfg.setAttribute("simulation.flightModel.integrator", integrator);
+
+  return(fly(file, &cfg, 1.0 / rate, samples, nSamples));
+}
+
+
+/**
+ * Largest difference in position and attitude while the reference
+ * is in the air. With time steps longer than a frame only the samples
+ * taken at the same time are compared. NaN counts as infinitely large.
+ */
+static void compare(T_Sample* ref, T_Sample* test, int nSamples,
+                    double* pos_max, double* ang_max)
+{
+  *pos_max = *ang_max = 0;
+
+  for (int n=0; n<nSamples; n++)
+  {
+    double d;
+
+    if (-ref[n].pos.r[2] < MIN_HEIGHT)
+      break;
+    if (fabs(ref[n].t - test[n].t) > 1e-6)
+      continue;
+
+    d = (ref[n].pos - test[n].pos).length();
+    if (!(d <= *pos_max))
+      *pos_max = d;
+
+    d = angleDiff(ref[n].phi, test[n].phi);
+    if (!(d <= *ang_max))
+      *ang_max = d;
+    d = angleDiff(ref[n].theta, test[n].theta);
+    if (!(d <= *ang_max))
+      *ang_max = d;
+    d = angleDiff(ref[n].psi, test[n].psi);
+    if (!(d <= *ang_max))
+      *ang_max = d;
+  }
+  if (*pos_max != *pos_max)
+    *pos_max = HUGE_VAL;
+  if (*ang_max != *ang_max)
+    *ang_max = HUGE_VAL;
+}
+
+
+int main(int argc, char** argv)
+{
+  const int  nSamples = 20 * 60;
+  T_Sample*  ref      = new T_Sample[nSamples];
+  T_Sample*  test     = new T_Sample[nSamples];
+  int        nFiles   = (argc > 1) ? argc - 1 : 1;
+  int        result   = 0;
+
+  for (int f=0; f<nFiles; f++)
+  {
+    const char* file = (argc > 1) ? argv[f+1] : "models/allegro.xml";
+    double      pos_max[nIntegrators][nRates];
+    double      ang_max[nIntegrators][nRates];
+    double      time[nIntegrators][nRates];
+
+    try
+    {
+      fly(file, "rk4", REFERENCE_RATE, ref, nSamples);
+
+      for (int i=0; i<nIntegrators; i++)
+      {
+        for (int r=0; r<nRates; r++)
+        {
+          time[i][r] = fly(file, integrators[i], rates[r], test, nSamples);
+          compare(ref, test, nSamples, &pos_max[i][r], &ang_max[i][r]);
+        }
+      }
+    }
+    catch (XMLException e)
+    {
+      fprintf(stderr, "%s: %s\n", file, e.what());
+      result = 2;
+      continue;
+    }
+
+    // The loading FDM writes to stdout, so the results are printed
+    // when all flights are done.
+    printf("%s\n", file);
+    printf("  integrator  dt/s      max. pos. diff/ft  max. angle diff/rad  time/ms\n");
+    for (int i=0; i<nIntegrators; i++)
+    {
+      double dt_stable = 0;
+      double dt_tol    = 0;
+      bool   fUnstable = false;
+      bool   fOutside  = false;
+
+      for (int r=0; r<nRates; r++)
+      {
+        bool fStable = (pos_max[i][r] < HUGE_VAL);
+        bool fOK     = (pos_max[i][r] <= POS_TOLERANCE && ang_max[i][r] <= ANGLE_TOLERANCE);
+
+        printf("  %-10s  %.6f  %17g  %19g  %7.1f %s\n",
+               integrators[i], 1.0 / rates[r],
+               pos_max[i][r], ang_max[i][r], time[i][r], fOK ? "" : "*");
+
+        // the steps get longer, so the first failure is the limit
+        fUnstable |= !fStable;
+        fOutside  |= !fOK;
+        if (!fUnstable)
+          dt_stable = 1.0 / rates[r];
+        if (!fOutside)
+          dt_tol = 1.0 / rates[r];
+
+        if (!fStable && rates[r] == DEFAULT_RATE)
+          result = 1;
+      }
+      printf("  %-10s  largest time step: stable %.6f s, within the tolerances %.6f s\n\n",
+             integrators[i], dt_stable, dt_tol);
+    }
+  }
+  printf("tolerances: %g ft, %g rad (* = exceeded)\n", POS_TOLERANCE, ANGLE_TOLERANCE);
+
+  delete[] ref;
+  delete[] test;
+
+  if (result == 1)
+    printf("FAILED\n");
+  else if (result == 0)
+    printf("OK\n");
+  return(result);
+}
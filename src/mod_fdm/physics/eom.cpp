@@ -30,6 +30,10 @@
 
 EOM_6DOF::EOM_6DOF()
 {
+  integrator     = CRRCMath::INTEGRATOR_AB2;
+  rk45_tolerance = 1e-6;
+  rk45_h         = 1.0;
+  forceModel     = 0;
 }
 
 EOM_6DOF::EOM_6DOF(CRRCMath::Vector3  initPosEarth,
@@ -43,6 +47,11 @@ EOM_6DOF::EOM_6DOF(CRRCMath::Vector3  initPosEarth,
 
   dGravity = 9.81; // m/s^2
 
+  integrator     = CRRCMath::INTEGRATOR_AB2;
+  rk45_tolerance = 1e-6;
+  rk45_h         = 1.0; // limited to the time step by integrateRK45()
+  forceModel     = 0;
+
   if (inertia.det() == 0)
   {
     std::cout << "unable to calculate inertia_inv\n";
@@ -111,18 +120,11 @@ void EOM_6DOF::step(double             dT,
   
   
   
-  // Beschleunigungen addieren:
-  //  1. Erdbeschleunigung, umgerechnet ins krperfeste Koordinatensystem
-  //  2. Beschleunigung aus FBody
-  //  3. der Rotationsterm
-  accel_body = conv.body(CRRCMath::Vector3(0, 0, dGravity)) + (FBody*dMass_inv) + (vel.val*angvel.val);
+  getAccel(FBody, MBody, accel_body, angaccel_body);
 
   // integrate acceleration to velocity
   vel.step(dT, accel_body);
 
-  // Drehbeschleunigungen addieren:
-  angaccel_body = inertia_inv*( MBody - (angvel.val*(inertia*angvel.val)) );
-
   // integrate angular acceleration
   angvel.step(dT, angaccel_body);
 
@@ -136,3 +138,104 @@ void EOM_6DOF::step(double             dT,
 */
 }
 
+
+void EOM_6DOF::getAccel(CRRCMath::Vector3  FBody,
+                        CRRCMath::Vector3  MBody,
+                        CRRCMath::Vector3& accel_body,
+                        CRRCMath::Vector3& angaccel_body)
+{
+  // Beschleunigungen addieren:
+  //  1. Erdbeschleunigung, umgerechnet ins krperfeste Koordinatensystem
+  //  2. Beschleunigung aus FBody
+  //  3. der Rotationsterm
+  accel_body = conv.body(CRRCMath::Vector3(0, 0, dGravity)) + (FBody*dMass_inv) + (vel.val*angvel.val);
+
+  // Drehbeschleunigungen addieren:
+  angaccel_body = inertia_inv*( MBody - (angvel.val*(inertia*angvel.val)) );
+}
+
+
+void EOM_6DOF::setIntegrator(int iIntegrator, double tolerance)
+{
+  integrator     = iIntegrator;
+  rk45_tolerance = tolerance;
+}
+
+
+void EOM_6DOF::step(double      dT,
+                    ForceModel* model)
+{
+  if (integrator == CRRCMath::INTEGRATOR_AB2)
+  {
+    CRRCMath::Vector3 FBody;
+    CRRCMath::Vector3 MBody;
+
+    model->forces(FBody, MBody);
+    step(dT, FBody, MBody);
+  }
+  else
+  {
+    T_State y;
+
+    forceModel = model;
+    getState(y);
+
+    if (integrator == CRRCMath::INTEGRATOR_RK45)
+      CRRCMath::integrateRK45(*this, y, dT, rk45_h, rk45_tolerance, 0.01*dT);
+    else
+      CRRCMath::stepRK4(*this, y, dT);
+
+    setState(y);
+    forceModel = 0;
+  }
+  conv.updateEuler();
+}
+
+
+void EOM_6DOF::getState(T_State& y)
+{
+  for (int i=0; i<3; i++)
+  {
+    y[i]   = pos.val.r[i];
+    y[3+i] = vel.val.r[i];
+    y[6+i] = angvel.val.r[i];
+  }
+  conv.getComponents(&y[9]);
+}
+
+
+void EOM_6DOF::setState(const T_State& y)
+{
+  for (int i=0; i<3; i++)
+  {
+    pos.val.r[i]    = y[i];
+    vel.val.r[i]    = y[3+i];
+    angvel.val.r[i] = y[6+i];
+  }
+  conv.setComponents(&y[9]);
+}
+
+
+void EOM_6DOF::derivative(const T_State& y, T_State& dydt)
+{
+  CRRCMath::Vector3 FBody;
+  CRRCMath::Vector3 MBody;
+  CRRCMath::Vector3 velEarth;
+  CRRCMath::Vector3 accel_body;
+  CRRCMath::Vector3 angaccel_body;
+
+  setState(y);
+  conv.updateEuler();
+  forceModel->forces(FBody, MBody);
+
+  velEarth = conv.local(vel.val);
+  getAccel(FBody, MBody, accel_body, angaccel_body);
+
+  for (int i=0; i<3; i++)
+  {
+    dydt[i]   = velEarth.r[i];
+    dydt[3+i] = accel_body.r[i];
+    dydt[6+i] = angaccel_body.r[i];
+  }
+  CRRCMath::Quaternion_002::rates(&y[9], angvel.val, &dydt[9]);
+}
@@ -24,6 +24,7 @@
 #include "../../mod_math/matrix33.h"
 #include "../../mod_math/quaternion.h"
 #include "../../mod_math/intgr.h"
+#include "../../mod_math/rungekutta.h"
 
 
 // jwtodo: Welches Integrationsverfahren ist zu benutzen?
@@ -38,9 +39,27 @@
  * 
  * @author Jens Wilhelm Wulf
  */
-class EOM_6DOF
+class EOM_6DOF : private CRRCMath::ODESystem<13>
 {
   public:
+
+   /**
+    * Computes forces and moments for the current state of the
+    * equations of motion. The Runge-Kutta schemes need them at
+    * intermediate states within a step, too.
+    */
+   class ForceModel
+   {
+     public:
+      virtual ~ForceModel() {};
+
+      /**
+       * @param FBody    forces, body frame
+       * @param MBody    moments about the body axes
+       */
+      virtual void forces(CRRCMath::Vector3& FBody,
+                          CRRCMath::Vector3& MBody) = 0;
+   };
       
    /**
     * @param initPosEarth Position in erdfesten Koordinaten
@@ -72,8 +91,38 @@ class EOM_6DOF
              CRRCMath::Vector3 FBody,
              CRRCMath::Vector3 MBody);
 
+   /**
+    * Select the integration scheme used by step(dT, model):
+    * CRRCMath::INTEGRATOR_AB2 (default), _RK4 or _RK45.
+    * 
+    * @param tolerance error tolerance for CRRCMath::INTEGRATOR_RK45
+    */
+   void setIntegrator(int iIntegrator, double tolerance);
+
+   /**
+    * Simulation step using the scheme chosen by setIntegrator().
+    * pos, vel, angvel and conv are set to the intermediate states
+    * when model->forces() is called; afterwards they hold the state
+    * at the end of the step and conv.euler is up to date.
+    */
+   void step(double      dT,
+             ForceModel* model);
+
    void print(std::string name);
 
+   /**
+    * Accelerations for the current state, as used by step().
+    * 
+    * @param FBody          forces, body frame
+    * @param MBody          moments about the body axes
+    * @param accel_body     derivative of vel
+    * @param angaccel_body  derivative of angvel
+    */
+   void getAccel(CRRCMath::Vector3  FBody,
+                 CRRCMath::Vector3  MBody,
+                 CRRCMath::Vector3& accel_body,
+                 CRRCMath::Vector3& angaccel_body);
+
   public:
    
    /**
@@ -95,6 +144,31 @@ class EOM_6DOF
    
   private:
 
+   /**
+    * pos (3), vel (3), angvel (3), quaternion (4)
+    */
+   typedef CRRCMath::StateVector<13> T_State;
+
+   void getState(T_State& y);
+   void setState(const T_State& y);
+   void derivative(const T_State& y, T_State& dydt);
+
+   /**
+    * CRRCMath::INTEGRATOR_*
+    */
+   int integrator;
+
+   /**
+    * error tolerance and step size proposal for CRRCMath::INTEGRATOR_RK45
+    */
+   double rk45_tolerance;
+   double rk45_h;
+
+   /**
+    * only valid during step(dT, model)
+    */
+   ForceModel* forceModel;
+
    /**
     * 
     */
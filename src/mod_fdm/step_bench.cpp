@@ -0,0 +1,311 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+/** \file step_bench.cpp
+ *
+ *  Times the parts of a flight model step which do most of the vector
+ *  and matrix math: the derivative of the LaRCSim model (aero(), gear()
+ *  and ls_accel()), WheelSystem::update() alone (all hard points), a
+ *  whole step of ModFDMInterface::update() and EOM_6DOF::step(). Only
+ *  public interfaces are used. Each part is called N_CALLS times in a
+ *  row (N_STEPS for the whole step), N_RUNS times; the median time per
+ *  call is printed.
+ *
+ *  Usage: step_bench [airplane.xml ...]   (default: DEFAULT_MODEL)
+ *
+ *  It is meant to be started in the top directory of the source tree.
+ *  The numbers depend on machine, compiler and options, so compare
+ *  them before and after a change with the same build. Nothing is
+ *  checked, see golden_test.cpp for the behaviour.
+ */
+#include "testflight.h"
+#include "physics/eom.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define DEFAULT_MODEL   "models/allegro.xml"
+
+#define DT              0.002777
+#define T_WARMUP        2.0    // s of the test maneuver before timing
+#define N_CALLS         20000
+#define N_STEPS         1000   // whole steps per run, the airplane keeps flying
+#define N_RUNS          9      // the median counts
+
+
+/**
+ * Something to time, see median()
+ */
+class Bench
+{
+  public:
+    virtual ~Bench() {};
+
+    /**
+     * Called before each run of calls.
+     */
+    virtual void reset() {};
+
+    virtual void call() = 0;
+};
+
+
+/**
+ * Median time per call in ns of N_RUNS runs of nCalls calls
+ */
+static double median(Bench* bench, int nCalls = N_CALLS)
+{
+  std::vector<double> times;
+
+  for (int run=0; run<N_RUNS; run++)
+  {
+    bench->reset();
+
+    double t0 = getTimeMs();
+    for (int n=0; n<nCalls; n++)
+      bench->call();
+    times.push_back((getTimeMs() - t0) * 1e6 / nCalls);
+  }
+
+  std::sort(times.begin(), times.end());
+  return(times[N_RUNS / 2]);
+}
+
+
+/**
+ * Start the test maneuver and fly its first T_WARMUP seconds.
+ */
+static void warmup(ModFDMInterface* fdm, TSimInputs* inputs)
+{
+  int nSteps = (int)(T_WARMUP / DT);
+
+  fdm->initAirplaneState(1.0, 0.0, 0.5, 0.0, 0.0, -300.0);
+  for (int n=0; n<nSteps; n++)
+  {
+    setInputs(inputs, (n + 0.5) * DT);
+    fdm->update(inputs, DT, 1);
+  }
+}
+
+
+/**
+ * FDMBase::getStateDerivative(), which evaluates the forces at the
+ * current state without moving the airplane.
+ */
+class DerivativeBench : public Bench
+{
+  public:
+    DerivativeBench(FDMBase* fdm, TSimInputs* inputs)
+      : fdm(fdm), inputs(inputs)
+    {
+    };
+
+    void call()
+    {
+      fdm->getStateDerivative(inputs, x_dot);
+    };
+
+  private:
+    FDMBase*    fdm;
+    TSimInputs* inputs;
+    double      x_dot[FDMBase::NUM_STATES];
+};
+
+
+/**
+ * A WheelSystem of its own, updated at the state of the flight model
+ * like CRRC_AirplaneSim_Larcsim::gear() does it.
+ */
+class WheelBench : public Bench
+{
+  public:
+    WheelBench(SimpleXMLTransfer* model, FDMBase* fdm, FDMEnviroment* env, TSimInputs* inputs)
+      : env(env), inputs(inputs)
+    {
+      double sf = sin(fdm->getPhi()),   cf = cos(fdm->getPhi());
+      double st = sin(fdm->getTheta()), ct = cos(fdm->getTheta());
+      double sp = sin(fdm->getPsi()),   cp = cos(fdm->getPsi());
+
+      wheels.init(model, fdm->getWingspan());
+      LocalToBody = CRRCMath::Matrix33(ct*cp,            ct*sp,            -st,
+                                       sf*st*cp - cf*sp, sf*st*sp + cf*cp, sf*ct,
+                                       cf*st*cp + sf*sp, cf*st*sp - sf*cp, cf*ct);
+      pos   = fdm->getPos();
+      omega = fdm->getPQR();
+      vel   = fdm->getVel();
+      psi   = fdm->getPsi();
+    };
+
+    void call()
+    {
+      wheels.update(inputs, env, LocalToBody, pos, omega, vel, psi);
+    };
+
+  private:
+    WheelSystem        wheels;
+    FDMEnviroment*     env;
+    TSimInputs*        inputs;
+    CRRCMath::Matrix33 LocalToBody;
+    CRRCMath::Vector3  pos;
+    CRRCMath::Vector3  omega;
+    CRRCMath::Vector3  vel;
+    double             psi;
+};
+
+
+/**
+ * ModFDMInterface::update() with one step, like the simulation calls
+ * it. Each run starts again at the end of the warmup.
+ */
+class UpdateBench : public Bench
+{
+  public:
+    UpdateBench(ModFDMInterface* fdm, TSimInputs* inputs)
+      : fdm(fdm), inputs(inputs)
+    {
+    };
+
+    void reset()
+    {
+      warmup(fdm, inputs);
+    };
+
+    void call()
+    {
+      fdm->update(inputs, DT, 1);
+    };
+
+  private:
+    ModFDMInterface* fdm;
+    TSimInputs*      inputs;
+};
+
+
+/**
+ * EOM_6DOF::step() with constant forces, like CRRC_AirplaneSim_002
+ * uses it (SI units).
+ */
+class EOMBench : public Bench
+{
+  public:
+    EOMBench()
+      : start(CRRCMath::Vector3(0, 0, 100),
+              CRRCMath::Vector3(0, 0.05, 0),
+              CRRCMath::Vector3(10, 0, 0),
+              1.0,
+              CRRCMath::Matrix33(0.05, 0, 0, 0, 0.05, 0, 0, 0, 0.09)),
+        F(1, 0, 9.81), M(0.01, 0.02, 0)
+    {
+    };
+
+    void reset()
+    {
+      eom = start;
+    };
+
+    void call()
+    {
+      eom.step(DT, F, M);
+    };
+
+  private:
+    EOM_6DOF          start;
+    EOM_6DOF          eom;
+    CRRCMath::Vector3 F;
+    CRRCMath::Vector3 M;
+};
+
+
+/**
+ * Fly the first T_WARMUP seconds of the test maneuver, then time the
+ * parts of a step at the state reached.
+ */
+static void bench(const char* file, std::string& output)
+{
+  SimpleXMLTransfer model(file);
+  SimpleXMLTransfer cfg;
+  TestEnv           env;
+  ModFDMInterface   fdm;
+  TSimInputs        inputs;
+
+  cfg.setAttribute("airplane.verbosity", "0");
+
+  XMLModelFile::ListOptions(&model);
+  fdm.loadAirplane(&model, &env, &cfg);
+
+  if (dynamic_cast<CRRC_AirplaneSim_Larcsim*>(fdm.fdm) == 0)
+    throw XMLException("not a LaRCSim airplane");
+
+  warmup(&fdm, &inputs);
+
+  DerivativeBench derivative(fdm.fdm, &inputs);
+  WheelBench      wheels(&model, fdm.fdm, &env, &inputs);
+  UpdateBench     update(&fdm, &inputs);
+
+  double t_derivative = median(&derivative);
+  double t_wheels     = median(&wheels);
+  double t_update     = median(&update, N_STEPS);
+  char   buf[512];
+
+  snprintf(buf, sizeof(buf),
+           "%s\n"
+           "  derivative      %8.1f ns (aero, gear, ls_accel)\n"
+           "  Wheel::update   %8.1f ns (all hard points)\n"
+           "  update          %8.1f ns (one whole step)\n",
+           file, t_derivative, t_wheels, t_update);
+  output += buf;
+}
+
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> files;
+  std::string              output;
+  int                      result = 0;
+  EOMBench                 eom;
+
+  for (int arg = 1; arg < argc; arg++)
+    files.push_back(argv[arg]);
+  if (files.size() == 0)
+    files.push_back(DEFAULT_MODEL);
+
+  for (unsigned int f=0; f<files.size(); f++)
+  {
+    try
+    {
+      bench(files[f].c_str(), output);
+    }
+    catch (XMLException e)
+    {
+      fprintf(stderr, "%s: %s\n", files[f].c_str(), e.what());
+      result = 2;
+    }
+  }
+
+  // Loading the airplanes writes to stdout, so the results are printed at the end.
+  printf("%s", output.c_str());
+  printf("EOM_6DOF::step    %8.1f ns\n", median(&eom));
+  printf("median of %d runs of %d calls (%d for update)\n", N_RUNS, N_CALLS, N_STEPS);
+  return(result);
+}
@@ -0,0 +1,218 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+/** \file substep_test.cpp
+ *
+ *  Flies each airplane with a fixed time step and with a longer time
+ *  step away from the ground (simulation.flightModel.dt_airborne), the
+ *  way SimStateHandler calls ModFDMInterface::update() at 60 frames
+ *  per second:
+ *
+ *  - a glide from 300 ft, to measure the speed gain in the air
+ *  - the same glide from low height into a landing, to see that the
+ *    switch to the short time step near the ground keeps the trajectory
+ *    and the energy of the airplane
+ *
+ *  Usage: substep_test [airplane.xml ...]
+ *
+ *  Returns 0 if the flights agree within the tolerances,
+ *  1 if not and 2 if an airplane can't be loaded.
+ */
+#include "testflight.h"
+
+#define POS_TOLERANCE    2.0    // ft, after up to 30 s of flight
+#define ENERGY_TOLERANCE 0.01   // relative to the energy at the start
+
+#define DT               (1.0/360)
+#define DT_AIRBORNE      (1.0/120)
+#define MULTILOOP        6      // steps of DT per frame
+
+#define GLIDE_HEIGHT     300.0  // ft
+#define LANDING_HEIGHT   30.0   // ft
+
+
+/**
+ * Fly nFrames frames at 60 frames per second.
+ *
+ * \param height    start height [ft]
+ * \param energy    specific energy (g*h + v^2/2) per frame [ft^2/s^2]
+ * \param touchdown number of frames before the airplane gets close
+ *                  enough to the ground to touch it
+ * \return          time needed by the flight model until then in ms
+ */
+static double fly(const char* file, double dt_airborne, double height,
+                  T_Sample* samples, double* energy, int nFrames,
+                  int* touchdown)
+{
+  SimpleXMLTransfer model(file);
+  SimpleXMLTransfer cfg;
+  TestEnv           env;
+  ModFDMInterface   fdm;
+  TSimInputs        inputs;
+  char              buf[32];
+  double            t0;
+  double            time;
+
+  snprintf(buf, sizeof(buf), "%g", dt_airborne);
+  cfg.setAttribute("airplane.verbosity", "0");
+  cfg.setAttribute("simulation.flightModel.dt_airborne", buf);
+
+  XMLModelFile::ListOptions(&model);
+  fdm.loadAirplane(&model, &env, &cfg);
+  if (dynamic_cast<CRRC_AirplaneSim_Larcsim*>(fdm.fdm) == 0)
+    throw XMLException("not a LaRCSim airplane");
+  fdm.initAirplaneState(1.0, 0.0, 0.5, 0.0, 0.0, -height);
+
+  *touchdown = nFrames;
+  t0   = getTimeMs();
+  time = 0;
+  for (int n=0; n<nFrames; n++)
+  {
+    CRRCMath::Vector3 v;
+
+    // gentle turns without power
+    inputs.throttle = 0;
+    inputs.elevator = 0.02;
+    inputs.aileron  = 0.02 * sin(0.4 * n * MULTILOOP * DT);
+    inputs.rudder   = 0.5 * inputs.aileron;
+
+    fdm.update(&inputs, DT, MULTILOOP);
+
+    v                = fdm.fdm->getVel();
+    samples[n].t     = (n + 1) * MULTILOOP * DT;
+    samples[n].pos   = fdm.fdm->getPos();
+    samples[n].phi   = fdm.fdm->getPhi();
+    samples[n].theta = fdm.fdm->getTheta();
+    samples[n].psi   = fdm.fdm->getPsi();
+    energy[n]        = -env.GetG(0) * samples[n].pos.r[2] + 0.5 * v.length() * v.length();
+
+    if (*touchdown == nFrames && -samples[n].pos.r[2] < fdm.fdm->getZLow() + 1.0)
+    {
+      *touchdown = n;
+      time       = getTimeMs() - t0;
+    }
+  }
+  if (*touchdown == nFrames)
+    time = getTimeMs() - t0;
+
+  return(time);
+}
+
+
+/**
+ * Largest difference in position and energy (relative to the energy at
+ * the start) until one of the airplanes may touch the ground.
+ */
+static void compare(T_Sample* ref, double* e_ref, int td_ref,
+                    T_Sample* test, double* e_test, int td_test,
+                    double* pos_max, double* e_max)
+{
+  *pos_max = *e_max = 0;
+
+  for (int n=0; n<td_ref && n<td_test; n++)
+  {
+    double d = (ref[n].pos - test[n].pos).length();
+
+    if (!(d <= *pos_max))
+      *pos_max = d;
+    d = fabs(e_ref[n] - e_test[n]) / e_ref[0];
+    if (!(d <= *e_max))
+      *e_max = d;
+  }
+}
+
+
+int main(int argc, char** argv)
+{
+  const int   nFrames = 30 * 60;
+  T_Sample*   ref     = new T_Sample[nFrames];
+  T_Sample*   test    = new T_Sample[nFrames];
+  double*     e_ref   = new double[nFrames];
+  double*     e_test  = new double[nFrames];
+  int         nFiles  = (argc > 1) ? argc - 1 : 1;
+  int         result  = 0;
+  std::string output;
+
+  for (int f=0; f<nFiles; f++)
+  {
+    const char* file = (argc > 1) ? argv[f+1] : "models/allegro.xml";
+    double      time_ref, time_test, t_air, speed;
+    double      pos_glide, e_glide, pos_land, e_land, pos_end;
+    int         td_ref, td_test;
+    char        buf[512];
+
+    try
+    {
+      time_ref  = fly(file, 0,           GLIDE_HEIGHT, ref,  e_ref,  nFrames, &td_ref);
+      time_test = fly(file, DT_AIRBORNE, GLIDE_HEIGHT, test, e_test, nFrames, &td_test);
+      compare(ref, e_ref, td_ref, test, e_test, td_test, &pos_glide, &e_glide);
+      // time per frame in the air
+      t_air = td_ref / 60.0;
+      speed = (time_ref / td_ref) / (time_test / td_test);
+
+      fly(file, 0,           LANDING_HEIGHT, ref,  e_ref,  nFrames, &td_ref);
+      fly(file, DT_AIRBORNE, LANDING_HEIGHT, test, e_test, nFrames, &td_test);
+      compare(ref, e_ref, td_ref, test, e_test, td_test, &pos_land, &e_land);
+      pos_end = (ref[nFrames-1].pos - test[nFrames-1].pos).length();
+    }
+    catch (XMLException e)
+    {
+      fprintf(stderr, "%s: %s\n", file, e.what());
+      result = 2;
+      continue;
+    }
+
+    bool fGlideOK = (pos_glide <= POS_TOLERANCE && e_glide <= ENERGY_TOLERANCE);
+    bool fLandOK  = (pos_land  <= POS_TOLERANCE && e_land  <= ENERGY_TOLERANCE);
+
+    snprintf(buf, sizeof(buf),
+             "%s\n"
+             "  glide:   %.1f s in the air, %.1f times faster with substeps\n"
+             "           max. pos. diff %g ft, max. energy diff %g%s\n"
+             "  landing: max. pos. diff %g ft, max. energy diff %g until touchdown%s\n"
+             "           final positions differ by %g ft\n",
+             file, t_air, speed,
+             pos_glide, e_glide, fGlideOK ? "" : " *",
+             pos_land, e_land, fLandOK ? "" : " *", pos_end);
+    output += buf;
+
+    if (!(fGlideOK && fLandOK) && result == 0)
+      result = 1;
+  }
+
+  // The loading FDM writes to stdout, so the results are printed
+  // when all flights are done.
+  printf("%s", output.c_str());
+  printf("tolerances: %g ft, %g of the energy (* = exceeded)\n", POS_TOLERANCE, ENERGY_TOLERANCE);
+
+  delete[] ref;
+  delete[] test;
+  delete[] e_ref;
+  delete[] e_test;
+
+  if (result == 1)
+    printf("FAILED\n");
+  else if (result == 0)
+    printf("OK\n");
+  return(result);
+}
@@ -0,0 +1,178 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+
+/** \file testflight.h
+ *
+ *  Environment and maneuver shared by the flight model tests
+ *  (flatearth_test.cpp, integrator_test.cpp, substep_test.cpp,
+ *  golden_test.cpp) and step_bench.cpp.
+ *  Only to be included by the test programs.
+ */
+#ifndef TESTFLIGHT_H
+#define TESTFLIGHT_H
+
+#include <stdio.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "fdm.h"
+#include "fdm_inputs.h"
+#include "fdm_larcsim/fdm_larcsim.h"
+#include "xmlmodelfile.h"
+#include "../mod_misc/SimpleXMLTransfer.h"
+
+/**
+ * Ground contact amplifies any small difference, so comparisons
+ * end when one of the airplanes gets lower than this.
+ */
+#define MIN_HEIGHT      10.0   // ft
+
+
+/**
+ * No wind, flat ground at 0 ft, standard sea level air.
+ */
+class TestEnv : public FDMEnviroment
+{
+  public:
+    float GetSceneryHeight(float x_north, float y_east)
+    {
+      return(0);
+    };
+
+    int CalculateWind(double  X_cg,      double  Y_cg,     double  Z_cg,
+                      double& Vel_north, double& Vel_east, double& Vel_down)
+    {
+      Vel_north = Vel_east = Vel_down = 0;
+      return(0);
+    };
+
+    double GetG(double altitude)
+    {
+      return(32.174);
+    };
+
+    double GetRho(double altitude)
+    {
+      return(0.0023769);
+    };
+
+    void ControllerCallback(double dt, FDMBase* fdm, TSimInputs* pInputsFromUser, TSimInputs* pInputsToFDM)
+    {
+      pInputsToFDM->CopyFrom(pInputsFromUser);
+    };
+};
+
+
+typedef struct
+{
+  double            t;     ///< time of the flight model's state
+  CRRCMath::Vector3 pos;
+  double            phi, theta, psi;
+} T_Sample;
+
+
+static inline double getTimeMs()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (1000.0 * tv.tv_sec + 0.001 * tv.tv_usec);
+}
+
+
+/**
+ * Launch at 300 ft with some throttle, pull the elevator for a second
+ * and roll from one turn into the other. The inputs are smooth, so
+ * they don't hide the error of the integrator.
+ */
+static inline void setInputs(TSimInputs* inputs, double t)
+{
+  double d = sin(M_PI * (t - 1));
+
+  inputs->throttle = 0.5;
+  inputs->elevator = (t > 1 && t < 2) ? 0.1 * d * d : 0;
+  inputs->aileron  = 0.05 * sin(0.4 * t);
+  inputs->rudder   = 0.5 * inputs->aileron;
+}
+
+
+/**
+ * Fly the maneuver. One sample is taken every 1/60 s. Like
+ * SimStateHandler, the flight model does as many steps of dt as fit
+ * into the time since the last step, which may be none if dt is longer
+ * than 1/60 s. The inputs are those of the middle of each step.
+ *
+ * \param file  airplane description
+ * \param cfg   configuration (simulation.flightModel.*)
+ * \param dt    time step
+ * \return      time needed by the flight model in ms
+ */
+static inline double fly(const char* file, SimpleXMLTransfer* cfg, double dt,
+                         T_Sample* samples, int nSamples)
+{
+  // The FDM adds its own values to the description, so every run
+  // needs a fresh copy.
+  SimpleXMLTransfer model(file);
+  TestEnv           env;
+  ModFDMInterface   fdm;
+  TSimInputs        inputs;
+  int               nSteps = 0;
+  double            t0;
+
+  cfg->setAttributeOverwrite("airplane.verbosity", "0");
+
+  XMLModelFile::ListOptions(&model);
+  fdm.loadAirplane(&model, &env, cfg);
+  if (dynamic_cast<CRRC_AirplaneSim_Larcsim*>(fdm.fdm) == 0)
+    throw XMLException("not a LaRCSim airplane");
+  fdm.initAirplaneState(1.0, 0.0, 0.5, 0.0, 0.0, -300.0);
+
+  t0 = getTimeMs();
+  for (int n=0; n<nSamples; n++)
+  {
+    int nFrameEnd = (int)((n + 1) / (60.0 * dt) + 1e-6);
+
+    for (; nSteps < nFrameEnd; nSteps++)
+    {
+      setInputs(&inputs, (nSteps + 0.5) * dt);
+      fdm.update(&inputs, dt, 1);
+    }
+
+    samples[n].t     = nSteps * dt;
+    samples[n].pos   = fdm.fdm->getPos();
+    samples[n].phi   = fdm.fdm->getPhi();
+    samples[n].theta = fdm.fdm->getTheta();
+    samples[n].psi   = fdm.fdm->getPsi();
+  }
+
+  return(getTimeMs() - t0);
+}
+
+
+static inline double angleDiff(double a, double b)
+{
+  double d = fmod(fabs(a - b), 2*M_PI);
+
+  return((d > M_PI) ? 2*M_PI - d : d);
+}
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "xmlmodelcache.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <map>
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+namespace XMLModelCache
+{
+  /**
+   * Compiled form of a file and what it was made from
+   */
+  typedef struct
+  {
+    unsigned int size;
+    unsigned int mtime;
+    std::string  data;
+  } T_Entry;
+
+  typedef std::map<std::string, T_Entry> T_EntryMap;
+
+  /// compiled files of this session, by path, protected by T_EntryLock
+  static T_EntryMap entries;
+
+
+  /**
+   * Protects entries, files may be loaded by the startup threads (see
+   * crrc_startup.h). Locked while an object of this class exists.
+   * Not an SDL mutex, the standalone tools use mod_fdm without SDL.
+   */
+  class T_EntryLock
+  {
+    public:
+#ifdef WIN32
+      T_EntryLock()  { EnterCriticalSection(&mutex.cs); };
+      ~T_EntryLock() { LeaveCriticalSection(&mutex.cs); };
+
+    private:
+      /**
+       * Initialized during static initialization: the first file is
+       * usually loaded by a startup thread, not by the main thread.
+       */
+      static struct T_Mutex
+      {
+        T_Mutex() { InitializeCriticalSection(&cs); };
+        CRITICAL_SECTION cs;
+      } mutex;
+#else
+      T_EntryLock()  { pthread_mutex_lock(&mutex); };
+      ~T_EntryLock() { pthread_mutex_unlock(&mutex); };
+
+    private:
+      static pthread_mutex_t mutex;
+#endif
+  };
+
+#ifdef WIN32
+  T_EntryLock::T_Mutex T_EntryLock::mutex;
+#else
+  pthread_mutex_t T_EntryLock::mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+  // see header
+  SimpleXMLTransfer* load(std::string filename, bool fUseCache)
+  {
+    struct stat st;
+
+    if (fUseCache == false || stat(filename.c_str(), &st) != 0)
+      return (new SimpleXMLTransfer(filename));
+
+    std::string        descr = "file: " + filename;
+    SimpleXMLTransfer* xml;
+    T_Entry            entry;
+
+    entry.size  = (unsigned int)st.st_size;
+    entry.mtime = (unsigned int)st.st_mtime;
+
+    xml = (SimpleXMLTransfer*) 0;
+    {
+      T_EntryLock          lock;
+      T_EntryMap::iterator it = entries.find(filename);
+
+      if (it != entries.end() &&
+          it->second.size == entry.size && it->second.mtime == entry.mtime)
+      {
+        xml = SimpleXMLTransfer::fromBinary(it->second.data.data(),
+                                            it->second.data.length(), descr);
+      }
+    }
+    if (xml != (SimpleXMLTransfer*) 0)
+      return (xml);
+
+    xml        = new SimpleXMLTransfer(filename);
+    entry.data = xml->toBinary();
+    {
+      T_EntryLock lock;
+
+      entries[filename] = entry;
+    }
+
+    return (xml);
+  }
+};
@@ -0,0 +1,51 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef XMLMODELCACHE_H
+# define XMLMODELCACHE_H
+
+# include <string>
+# include "../mod_misc/SimpleXMLTransfer.h"
+
+/**
+ * Loading of airplane files with a cache of their compiled form.
+ *
+ * An airplane file is parsed once per session and kept in memory in the
+ * binary form of SimpleXMLTransfer::toBinary(). As long as size and
+ * modification time of the file don't change, it is read from there, so
+ * switching back to an airplane doesn't parse the XML file again.
+ *
+ * Configuration (see documentation/options.txt): airplane.fUse_cache
+ */
+namespace XMLModelCache
+{
+  /**
+   * Returns the document read from <code>filename</code> (to be deleted
+   * by the caller). Throws XMLException like the constructor of
+   * SimpleXMLTransfer if the file can't be read.
+   *
+   * \param filename  path to the file
+   * \param fUseCache false: always parse the file
+   */
+  SimpleXMLTransfer* load(std::string filename, bool fUseCache);
+};
+
+#endif
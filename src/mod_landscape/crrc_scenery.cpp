@@ -36,12 +36,16 @@
 #include <crrc_config.h>
 
 #include "crrc_scenery.h"
+#include "tiledscenery.h"
+#include "scenerylod.h"
+#include "instancedobject.h"
 #include "../crrc_main.h"
 #include "../ImageLoaderTGA.h"
 #include "../mod_misc/SimpleXMLTransfer.h"
 #include "../config.h"
 #include "../mod_misc/filesystools.h"
 #include "../crrc_graphics.h"
+#include "../TextureManager.h"
 #include "../crrc_system.h"
 #include <string>
 #include <iostream>
@@ -129,6 +133,10 @@ Scenery* loadScenery(const char *fname)
     {
       new_scenery = new ModelBasedScenery(xml);
     }
+    else if (type == "tiled")
+    {
+      new_scenery = new TiledScenery(xml);
+    }
     else // "not specified" or other unknown type
     {
     }
@@ -432,7 +440,7 @@ CVector Scenery::getStartPosition(int num)
  *  locations CAPE_COD and DAVIS.
  */
 BuiltinScenery::BuiltinScenery(SimpleXMLTransfer *xml, bool boIsNullRenderer)
-    : Scenery(xml), use_textures(1), quadric(NULL)
+    : Scenery(xml), use_textures(1), quadric(NULL), list(0), num_lists(0)
 {
   if (!boIsNullRenderer)
   {
@@ -451,7 +459,7 @@ BuiltinScenery::BuiltinScenery(SimpleXMLTransfer *xml, bool boIsNullRenderer)
  *  \todo Make it work properly or delete it.
  */
 BuiltinScenery::BuiltinScenery(const char *mapfile)
-    : Scenery(NULL), use_textures(1)
+    : Scenery(NULL), use_textures(1), quadric(NULL), list(0), num_lists(0)
 {
   int x;
   int z;
@@ -545,9 +553,9 @@ BuiltinScenery::BuiltinScenery(const char *mapfile)
  */
 BuiltinScenery::~BuiltinScenery()
 {
-  if (glIsList(list))
+  if (num_lists > 0 && glIsList(list))
   {
-    glDeleteLists(list, 1);
+    glDeleteLists(list, num_lists);
   }
 
   if (quadric != NULL)
@@ -660,6 +668,7 @@ void BuiltinScenery::compile_display_list()
   GLfloat no_shininess[]={0.0};
 
   list = glGenLists(1);
+  num_lists = 1;
   glNewList(list, GL_COMPILE);
   glPolygonMode(GL_FRONT, GL_LINES);
 
@@ -841,63 +850,16 @@ BuiltinSceneryDavis::BuiltinSceneryDavis(SimpleXMLTransfer *xml)
 {
   std::cout << "Initializing scenery DAVIS from ";
   std::cout << xml->getSourceDescr() << std::endl;
+  groundTexture = grassTexture = grassSideTexture = grassTopTexture = 0;
+  pineTexture = decidTexture = easternViewTexture = netreesTexture = 0;
+  dirtTexture = outhouseTexture = freqTexture = 0;
   if (use_textures)
   {
-    int use_mipmaps = cfgfile->getInt("video.textures.fUse_mipmaps", 1);
     read_textures(xml);
-    groundTexture = make_texture( ground_texture, GL_RGBA, GL_ALPHA,
-                                  ground_texture_width,
-                                  ground_texture_height, use_mipmaps);
-    free(ground_texture);
-    grassTexture = make_texture(grass_texture, GL_RGBA, GL_RGBA,
-                                grass_texture_width,
-                                grass_texture_height, use_mipmaps);
-    free(grass_texture);
-    grassSideTexture = make_texture(grass_side_texture,
-                                    GL_RGBA, GL_RGBA,
-                                    grass_side_texture_width,
-                                    grass_side_texture_height,
-                                    use_mipmaps);
-    free(grass_side_texture);
-    grassTopTexture = make_texture( grass_top_texture,
-                                    GL_RGBA, GL_RGBA,
-                                    grass_top_texture_width,
-                                    grass_top_texture_height,
-                                    use_mipmaps);
-    free(grass_top_texture);
-    easternViewTexture = make_texture(eastern_view_texture,
-                                      GL_RGBA, GL_RGBA,
-                                      eastern_view_texture_width,
-                                      eastern_view_texture_height,
-                                      false);
-    free(eastern_view_texture);
-    netreesTexture = make_texture(netrees_texture, GL_RGBA, GL_RGBA,
-                                  netrees_texture_width,
-                                  netrees_texture_height,
-                                  false);
-    free(netrees_texture);
-    dirtTexture = make_texture( dirt_texture, GL_RGBA, GL_RGBA,
-                                dirt_texture_width,
-                                dirt_texture_height, false);
-    free(dirt_texture);
-    outhouseTexture = make_texture( outhouse_texture,
-                                    GL_RGBA, GL_RGBA,
-                                    outhouse_texture_width,
-                                    outhouse_texture_height,
-                                    false);
-    free(outhouse_texture);
-    freqTexture = make_texture( freq_texture, GL_RGBA, GL_RGBA,
-                                freq_texture_width,
-                                freq_texture_height, false);
-    free(freq_texture);
-    pineTexture = make_texture( pine_texture, GL_RGBA, GL_RGBA,
-                                pine_texture_width,
-                                pine_texture_height, false);
-    free(pine_texture);
-    decidTexture = make_texture(decid_texture, GL_RGBA, GL_RGBA,
-                                decid_texture_width,
-                                decid_texture_height, false);
-    free(decid_texture);
+  }
+  if (cfgfile->getInt("video.enabled", 1))
+  {
+    compile_geometry();
   }
 }
 
@@ -915,106 +877,84 @@ void BuiltinSceneryDavis::read_textures(SimpleXMLTransfer *xml)
 {
   SimpleXMLTransfer* tex;
   int err = 0;
+  bool use_mipmaps = (cfgfile->getInt("video.textures.fUse_mipmaps", 1) != 0);
 
   try
   {
     tex = xml->getChild("scene.textures");
 
-    grass_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("grass.file")).c_str(),
-                                &grass_texture_width,
-                                &grass_texture_height);
-    if (grass_texture == NULL)
+    grassTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("grass.file")), use_mipmaps);
+    if (grassTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "grass.file");
       err++;
     }
 
-    grass_side_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("grasss.file")).c_str(),
-                                     &grass_side_texture_width,
-                                     &grass_side_texture_height);
-    if (grass_side_texture == NULL)
+    grassSideTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("grasss.file")), use_mipmaps);
+    if (grassSideTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "grasss.file");
       err++;
     }
 
-    grass_top_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("grasst.file")).c_str(),
-                                    &grass_top_texture_width,
-                                    &grass_top_texture_height);
-    if (grass_top_texture == NULL)
+    grassTopTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("grasst.file")), use_mipmaps);
+    if (grassTopTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "grasst.file");
       err++;
     }
 
-    pine_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("pine.file")).c_str(),
-                               &pine_texture_width,
-                               &pine_texture_height);
-    if (pine_texture == NULL)
+    pineTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("pine.file")), false);
+    if (pineTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "pine.file");
       err++;
     }
 
-    decid_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("decid.file")).c_str(),
-                                &decid_texture_width,
-                                &decid_texture_height);
-    if (decid_texture == NULL)
+    decidTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("decid.file")), false);
+    if (decidTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "decid.file");
       err++;
     }
 
-    eastern_view_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("eastern.file")).c_str(),
-                                       &eastern_view_texture_width,
-                                       &eastern_view_texture_height);
-    if (eastern_view_texture == NULL)
+    easternViewTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("eastern.file")), false);
+    if (easternViewTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "eastern.file");
       err++;
     }
 
-    netrees_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("netrees.file")).c_str(),
-                                  &netrees_texture_width,
-                                  &netrees_texture_height);
-    if (netrees_texture == NULL)
+    netreesTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("netrees.file")), false);
+    if (netreesTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "netrees.file");
       err++;
     }
 
-    dirt_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("dirt.file")).c_str(),
-                               &dirt_texture_width,
-                               &dirt_texture_height);
-    if (dirt_texture == NULL)
+    dirtTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("dirt.file")), false);
+    if (dirtTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "dirt.file");
       err++;
     }
 
-    outhouse_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("outhouse.file")).c_str(),
-                                   &outhouse_texture_width,
-                                   &outhouse_texture_height);
-    if (outhouse_texture == NULL)
+    outhouseTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("outhouse.file")), false);
+    if (outhouseTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "outhouse.file");
       err++;
     }
 
-    freq_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("freq.file")).c_str(),
-                               &freq_texture_width,
-                               &freq_texture_height);
-    if (freq_texture == NULL)
+    freqTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("freq.file")), false);
+    if (freqTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "freq.file");
       err++;
     }
-    ground_texture_width  = 256;
-    ground_texture_height = 256;
-    ground_texture=read_bwimage(FileSysTools::getDataPath(tex->getString("ground.file")).c_str(),
-                                &ground_texture_width,
-                                &ground_texture_height);
-    if (ground_texture == NULL)
+
+    groundTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("ground.file")), use_mipmaps);
+    if (groundTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "ground.file");
       err++;
@@ -1050,28 +990,17 @@ void BuiltinSceneryDavis::read_textures(SimpleXMLTransfer *xml)
  */
 void BuiltinSceneryDavis::clear_textures()
 {
-  if (glIsTexture(groundTexture))
-    glDeleteTextures(1, &groundTexture);
-  if (glIsTexture(grassTexture))
-    glDeleteTextures(1, &grassTexture);
-  if (glIsTexture(grassSideTexture))
-    glDeleteTextures(1, &grassSideTexture);
-  if (glIsTexture(grassTopTexture))
-    glDeleteTextures(1, &grassTopTexture);
-  if (glIsTexture(pineTexture))
-    glDeleteTextures(1, &pineTexture);
-  if (glIsTexture(decidTexture))
-    glDeleteTextures(1, &decidTexture);
-  if (glIsTexture(easternViewTexture))
-    glDeleteTextures(1, &easternViewTexture);
-  if (glIsTexture(netreesTexture))
-    glDeleteTextures(1, &netreesTexture);
-  if (glIsTexture(dirtTexture))
-    glDeleteTextures(1, &dirtTexture);
-  if (glIsTexture(outhouseTexture))
-    glDeleteTextures(1, &outhouseTexture);
-  if (glIsTexture(freqTexture))
-    glDeleteTextures(1, &freqTexture);
+  TextureManager::releaseTexture(grassTexture);
+  TextureManager::releaseTexture(grassSideTexture);
+  TextureManager::releaseTexture(grassTopTexture);
+  TextureManager::releaseTexture(pineTexture);
+  TextureManager::releaseTexture(decidTexture);
+  TextureManager::releaseTexture(easternViewTexture);
+  TextureManager::releaseTexture(netreesTexture);
+  TextureManager::releaseTexture(dirtTexture);
+  TextureManager::releaseTexture(outhouseTexture);
+  TextureManager::releaseTexture(freqTexture);
+  TextureManager::releaseTexture(groundTexture);
 }
 
 
@@ -1119,6 +1048,40 @@ void BuiltinSceneryDavis::getWindComponents(double X_cg,double  Y_cg,double  Z_c
  *  This method should be called once per frame.
  */
 void BuiltinSceneryDavis::draw(double current_time)
+{
+  if (num_lists == 0)
+  {
+    compile_geometry();
+  }
+
+  setup_drawing_state();
+  glCallList(list);
+  restore_drawing_state();
+}
+
+
+/** \brief Compile the static geometry into a display list.
+ *
+ *  Nothing in the Davis field is animated, so the complete
+ *  scenery (including texture and material changes) is
+ *  recorded once and replayed in every frame.
+ */
+void BuiltinSceneryDavis::compile_geometry()
+{
+  list = glGenLists(1);
+  num_lists = 1;
+  glNewList(list, GL_COMPILE);
+  draw_geometry();
+  glEndList();
+}
+
+
+/** \brief Issue the OpenGL commands for the Davis field.
+ *
+ *  Only used while compiling the display list. Expects the
+ *  state set up by setup_drawing_state().
+ */
+void BuiltinSceneryDavis::draw_geometry()
 {
   GLfloat no_mat[]={0.0,0.0,0.0,0.0};
   GLfloat mat_ground[]={.878, .859, .745, 1};
@@ -1138,8 +1101,6 @@ void BuiltinSceneryDavis::draw(double current_time)
   //GLfloat fogColor[4]={0.6,0.6,0.6,1.0};
   GLfloat no_shininess[]={0.0};
 
-  setup_drawing_state();
-
   if (!use_textures)
   {
     glMaterialfv(GL_FRONT,GL_AMBIENT,mat_ground); // Draw parking lot
@@ -1926,9 +1887,7 @@ void BuiltinSceneryDavis::draw(double current_time)
     glEnable(GL_LIGHTING);
     glEnable(GL_LIGHT0);
   }
-
-  restore_drawing_state();
-} // end BuiltinSceneryDavis::draw()
+} // end BuiltinSceneryDavis::draw_geometry()
 
 
 /****************************************************************************/
@@ -1939,46 +1898,16 @@ BuiltinSceneryCapeCod::BuiltinSceneryCapeCod(SimpleXMLTransfer *xml)
 {
   std::cout << "Initializing scenery CAPE_COD from ";
   std::cout << xml->getSourceDescr() << std::endl;
+  water_texture_height = 1;
+  waterTexture = beachsandTexture = scrubTexture = scrubedgeTexture = 0;
+  southTexture = hilledgeTexture = wavesTexture = sandTexture = 0;
   if (use_textures)
   {
-    int use_mipmaps = cfgfile->getInt("video.textures.fUse_mipmaps", 1);
     read_textures(xml);
-    waterTexture = make_texture(water_texture, GL_RGBA, GL_RGBA,
-                                water_texture_width,
-                                water_texture_height, use_mipmaps);
-    free(water_texture);
-    beachsandTexture = make_texture(beachsand_texture,
-                                    GL_RGBA, GL_RGBA,
-                                    beachsand_texture_width,
-                                    beachsand_texture_height,
-                                    use_mipmaps);
-    free(beachsand_texture);
-    scrubTexture = make_texture(scrub_texture, GL_RGBA, GL_RGBA,
-                                scrub_texture_width,
-                                scrub_texture_height, use_mipmaps);
-    free(scrub_texture);
-    scrubedgeTexture = make_texture(scrubedge_texture, GL_RGBA, GL_RGBA,
-                                    scrubedge_texture_width,
-                                    scrubedge_texture_height, use_mipmaps);
-    free(scrubedge_texture);
-    southTexture = make_texture(south_texture, GL_RGBA, GL_RGBA,
-                                south_texture_width,
-                                south_texture_height, use_mipmaps);
-    free(south_texture);
-    hilledgeTexture = make_texture( hilledge_texture,
-                                    GL_RGBA, GL_RGBA,
-                                    hilledge_texture_width,
-                                    hilledge_texture_height,
-                                    use_mipmaps);
-    free(hilledge_texture);
-    wavesTexture = make_texture(waves_texture, GL_RGBA, GL_RGBA,
-                                waves_texture_width,
-                                waves_texture_height, use_mipmaps);
-    free(waves_texture);
-    sandTexture = make_texture( sand_texture, GL_RGBA, GL_RGBA,
-                                sand_texture_width,
-                                sand_texture_height, use_mipmaps);
-    free(sand_texture);
+  }
+  if (cfgfile->getInt("video.enabled", 1))
+  {
+    compile_geometry();
   }
 }
 /***************************/
@@ -2113,6 +2042,56 @@ float BuiltinSceneryCapeCod::getHeightAndPlane(float x_north, float y_east, floa
  *  This method should be called once per frame.
  */
 void BuiltinSceneryCapeCod::draw(double current_time)
+{
+  if (num_lists == 0)
+  {
+    compile_geometry();
+  }
+
+  setup_drawing_state();
+
+  if (!use_textures)
+  {
+    glCallList(list);
+  }
+  else
+  {
+    // The water and the waves are animated by moving
+    // their textures through the texture matrix.
+    float shift = -1*(fmod(current_time/500,(double)water_texture_height))/water_texture_height;
+
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glTranslatef(0, -shift, 0);
+    glMatrixMode(GL_MODELVIEW);
+    glCallList(list);         // ocean
+
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+    glCallList(list+1);       // beach, southern horizon
+
+    glMatrixMode(GL_TEXTURE);
+    glTranslatef(0, -5*shift, 0);
+    glMatrixMode(GL_MODELVIEW);
+    glCallList(list+2);       // waves
+
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+    glCallList(list+3);       // hill
+  }
+
+  restore_drawing_state();
+}
+
+
+/** \brief Compile the static geometry into display lists.
+ *
+ *  The textured version is split into four lists so that
+ *  draw() can animate the water and the waves in between.
+ */
+void BuiltinSceneryCapeCod::compile_geometry()
 {
   static GLfloat no_mat[]={0.0,0.0,0.0,0.0};
   static GLfloat mat_water[]={.502, 0.650,0.792, 1};
@@ -2121,12 +2100,13 @@ void BuiltinSceneryCapeCod::draw(double current_time)
   static GLfloat mat_scrub[]={.325, 0.349,0.239, 1};
   static GLfloat mat_waves[]={.925, 0.925,0.925, 1};
   static GLfloat no_shininess[]={0.0};
-  float shift;
-
-  setup_drawing_state();
 
   if (!use_textures)
   {
+    list = glGenLists(1);
+    num_lists = 1;
+    glNewList(list, GL_COMPILE);
+
     glMaterialfv(GL_FRONT,GL_AMBIENT,mat_water); // Draw ocean
     glMaterialfv(GL_FRONT,GL_DIFFUSE,mat_water);
     glMaterialfv(GL_FRONT,GL_SPECULAR,no_mat);
@@ -2206,10 +2186,14 @@ void BuiltinSceneryCapeCod::draw(double current_time)
     glNormal3f(0,1,0);
     glVertex3f(-10000.0,3.5,200.0);
     glEnd();
+
+    glEndList();
   }
   else
   {
-    shift = -1*(fmod(current_time/500,(double)water_texture_height))/water_texture_height;
+    list = glGenLists(4);
+    num_lists = 4;
+    glNewList(list, GL_COMPILE);
 
     glDisable(GL_LIGHTING);
     glDisable(GL_LIGHT0);
@@ -2227,19 +2211,22 @@ void BuiltinSceneryCapeCod::draw(double current_time)
 
     glBegin(GL_QUADS);
     glNormal3f(0,1,0);
-    glTexCoord2f(-40,-shift);
+    glTexCoord2f(-40,0);
     glVertex3f(-150.0,-0.1,-10000.0);
     glNormal3f(0,1,0);
-    glTexCoord2f(40,-shift);
+    glTexCoord2f(40,0);
     glVertex3f(-150.0,-0.1,10000.0);
     glNormal3f(0,1,0);
-    glTexCoord2f(40,40-shift);
+    glTexCoord2f(40,40);
     glVertex3f(-10000.0,-0.1,10000.0);
     glNormal3f(0,1,0);
-    glTexCoord2f(-40,40-shift);
+    glTexCoord2f(-40,40);
     glVertex3f(-10000.0,-0.1,-10000.0);
     glEnd();
 
+    glEndList();
+    glNewList(list+1, GL_COMPILE);
+
     glMaterialfv(GL_FRONT,GL_AMBIENT,mat_sand); // Draw beach lot
     glMaterialfv(GL_FRONT,GL_DIFFUSE,mat_sand);
     glColor4f(0,0,0,1.0);
@@ -2312,25 +2299,31 @@ void BuiltinSceneryCapeCod::draw(double current_time)
     glVertex3f(430.0,117.1,-2500.0);
     glEnd();
 
+    glEndList();
+    glNewList(list+2, GL_COMPILE);
+
     glMaterialfv(GL_FRONT,GL_AMBIENT,mat_waves); // Draw beach lot
     glMaterialfv(GL_FRONT,GL_DIFFUSE,mat_waves);
     glColor4f(0,0,0,1.0);
     glBindTexture(GL_TEXTURE_2D,wavesTexture);
     glBegin(GL_QUADS);
     glNormal3f(0,1,0);
-    glTexCoord2f(0,0+-5*shift);
+    glTexCoord2f(0,0);
     glVertex3f(-144.0,3.5,-10000.0);
     glNormal3f(0,1,0);
-    glTexCoord2f(20,0+-5*shift);
+    glTexCoord2f(20,0);
     glVertex3f(-144.0,3.5,10000.0);
     glNormal3f(0,1,0);
-    glTexCoord2f(20,1+-5*shift);
+    glTexCoord2f(20,1);
     glVertex3f(-200.0,3.5,10000.0);
     glNormal3f(0,1,0);
-    glTexCoord2f(0,1+-5*shift);
+    glTexCoord2f(0,1);
     glVertex3f(-200.0,3.5,-10000.0);
     glEnd();
 
+    glEndList();
+    glNewList(list+3, GL_COMPILE);
+
 
     glMaterialfv(GL_FRONT,GL_AMBIENT,mat_sand); // Hillside
     glMaterialfv(GL_FRONT,GL_DIFFUSE,mat_sand);
@@ -2412,88 +2405,78 @@ void BuiltinSceneryCapeCod::draw(double current_time)
     glDisable(GL_BLEND);
     glEnable(GL_LIGHTING);
     glEnable(GL_LIGHT0);
-  }
 
-  restore_drawing_state();
-} // end draw()
+    glEndList();
+  }
+} // end compile_geometry()
 
 
 void BuiltinSceneryCapeCod::read_textures(SimpleXMLTransfer *xml)
 {
   SimpleXMLTransfer* tex;
   int err = 0;
+  bool use_mipmaps = (cfgfile->getInt("video.textures.fUse_mipmaps", 1) != 0);
 
   try
   {
     tex = xml->getChild("scene.textures");
 
-    water_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("water.file")).c_str(),
-                                &water_texture_width,
-                                &water_texture_height);
-    if (water_texture == NULL)
+    waterTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("water.file")), use_mipmaps);
+    if (waterTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "water.file");
       err++;
     }
+    else
+    {
+      glBindTexture(GL_TEXTURE_2D, waterTexture);
+      glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &water_texture_height);
+    }
 
-    beachsand_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("beachsand.file")).c_str(),
-                                    &beachsand_texture_width,
-                                    &beachsand_texture_height);
-    if (beachsand_texture == NULL)
+    beachsandTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("beachsand.file")), use_mipmaps);
+    if (beachsandTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "beachsand.file");
       err++;
     }
 
-    scrub_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("scrub.file")).c_str(),
-                                &scrub_texture_width,
-                                &scrub_texture_height);
-    if (scrub_texture == NULL)
+    scrubTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("scrub.file")), use_mipmaps);
+    if (scrubTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "scrub.file");
       err++;
     }
 
-    scrubedge_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("scrubedge.file")).c_str(),
-                                    &scrubedge_texture_width,
-                                    &scrubedge_texture_height);
-    if (scrubedge_texture == NULL)
+    scrubedgeTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("scrubedge.file")), use_mipmaps);
+    if (scrubedgeTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "scrubedge.file");
       err++;
     }
 
-    south_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("south.file")).c_str(),
-                                &south_texture_width,
-                                &south_texture_height);
-    if (south_texture == NULL)
+    southTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("south.file")), use_mipmaps);
+    if (southTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "south.file");
       err++;
     }
 
-    hilledge_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("hilledge.file")).c_str(),
-                                   &hilledge_texture_width,
-                                   &hilledge_texture_height);
-    if (hilledge_texture == NULL)
+    hilledgeTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("hilledge.file")), use_mipmaps);
+    if (hilledgeTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "hilledge.file");
       err++;
     }
 
-    waves_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("waves.file")).c_str(),
-                                &waves_texture_width,
-                                &waves_texture_height);
-    if (waves_texture == NULL)
+    wavesTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("waves.file")), use_mipmaps);
+    if (wavesTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "waves.file");
       err++;
     }
 
-    sand_texture=read_rgbimage(FileSysTools::getDataPath(tex->getString("sand.file")).c_str(),
-                               &sand_texture_width,
-                               &sand_texture_height);
-    if (sand_texture == NULL)
+    sandTexture = TextureManager::getTexture(FileSysTools::getDataPath(tex->getString("sand.file")), use_mipmaps);
+    if (sandTexture == 0)
     {
       fprintf(stderr, "Can't open %s\n", "sand.file");
       err++;
@@ -2530,22 +2513,14 @@ void BuiltinSceneryCapeCod::read_textures(SimpleXMLTransfer *xml)
  */
 void BuiltinSceneryCapeCod::clear_textures()
 {
-  if (glIsTexture(waterTexture))
-    glDeleteTextures(1, &waterTexture);
-  if (glIsTexture(beachsandTexture))
-    glDeleteTextures(1, &beachsandTexture);
-  if (glIsTexture(scrubTexture))
-    glDeleteTextures(1, &scrubTexture);
-  if (glIsTexture(scrubedgeTexture))
-    glDeleteTextures(1, &scrubedgeTexture);
-  if (glIsTexture(southTexture))
-    glDeleteTextures(1, &southTexture);
-  if (glIsTexture(hilledgeTexture))
-    glDeleteTextures(1, &hilledgeTexture);
-  if (glIsTexture(wavesTexture))
-    glDeleteTextures(1, &wavesTexture);
-  if (glIsTexture(sandTexture))
-    glDeleteTextures(1, &sandTexture);
+  TextureManager::releaseTexture(waterTexture);
+  TextureManager::releaseTexture(beachsandTexture);
+  TextureManager::releaseTexture(scrubTexture);
+  TextureManager::releaseTexture(scrubedgeTexture);
+  TextureManager::releaseTexture(southTexture);
+  TextureManager::releaseTexture(hilledgeTexture);
+  TextureManager::releaseTexture(wavesTexture);
+  TextureManager::releaseTexture(sandTexture);
 }
 
 
@@ -2606,6 +2581,7 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml)
 {
   ssgEntity *model = NULL;
   SimpleXMLTransfer *scene = xml->getChild("scene", true);
+  int min_instances = cfgfile->getInt("video.instancing.min_instances", 8);
   getHeight_mode = scene->attributeAsInt("getHeight_mode", 2);
   //std::cout << "----getHeight_mode : " <<  getHeight_mode <<std::endl;
   if ( getHeight_mode==2)
@@ -2658,8 +2634,24 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml)
       }
       std::cout << std::endl;
       model = ssgLoad(of.c_str());
+      if (model != NULL && !is_terrain && kid->attributeAsInt("lod", 1) != 0)
+      {
+        // terrain always needs full detail for collision detection
+        model = SceneryLOD::makeLOD(model, of, kid->attributeAsDouble("lod_distance", 0.0));
+      }
       if (model != NULL)
       {
+        // Objects which are placed many times are culled and
+        // drawn as a batch. The terrain needs the normal
+        // scene graph for collision detection.
+        InstancedObject *group = NULL;
+        if (!is_terrain && min_instances > 0
+            && kid->getChildCount() >= min_instances)
+        {
+          group = new InstancedObject(model);
+          group->clrTraversalMaskBits(SSGTRAV_HOT | SSGTRAV_LOS);
+        }
+
         // now parse the instances and place the model in the SceneGraph
         for (int cur_instance = 0; cur_instance < kid->getChildCount(); cur_instance++)
         {
@@ -2676,6 +2668,11 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml)
 
             std::cout << "  Placing instance at " << coord.xyz[SG_X] << ";" << coord.xyz[SG_Y] << ";" << coord.xyz[SG_Z];
             std::cout << ", orientation " << coord.hpr[0] << ";" << coord.hpr[1] << ";" << coord.hpr[2] << std::endl;
+            if (group != NULL)
+            {
+              group->addInstance(&coord);
+              continue;
+            }
             ssgTransform *trans = new ssgTransform();
             trans->setTransform(&coord);
             if (!is_terrain)
@@ -2686,6 +2683,10 @@ ModelBasedScenery::ModelBasedScenery(SimpleXMLTransfer *xml)
             trans->addKid(model);
           }
         }
+        if (group != NULL)
+        {
+          initial_trans->addKid(group);
+        }
       }
     }
   }
@@ -2897,7 +2898,33 @@ void ModelBasedScenery::getWindComponents(double X,double  Y,double  Z,
 /******/
 void ModelBasedScenery::tiling_terrain(ssgEntity * e, sgMat4 xform)
 {
-  if ( e -> isAKindOf ( ssgTypeBranch() ) )
+  InstancedObject *group = dynamic_cast<InstancedObject*>(e);
+  if ( group != NULL )
+  {
+    // the instances are not kids of the group
+    for ( int i = 0 ; i < group->getNumInstances() ; i++ )
+    {
+      sgMat4 inst, xform1;
+      group->getInstanceTransform(i, inst);
+      sgCopyMat4(xform1, xform);
+      sgPreMultMat4(xform1, inst);
+      tiling_terrain(group->getModel(), xform1);
+    }
+  }
+  else if ( e -> isAKindOf ( ssgTypeRangeSelector() ) )
+  {
+    // Levels of detail (SceneryLOD::makeLOD()): only the full detail
+    // version of the object, the coarse meshes would put wrong
+    // heights into the grid.
+    ssgBranch *br = (ssgBranch *) e ;
+    if ( br -> getNumKids () > 0 )
+    {
+      sgMat4 xform1;
+      sgCopyMat4(xform1, xform);
+      tiling_terrain ( br -> getKid ( 0 ), xform1) ;
+    }
+  }
+  else if ( e -> isAKindOf ( ssgTypeBranch() ) )
   {
     ssgBranch *br = (ssgBranch *) e ;
     if ( e -> isA ( ssgTypeTransform() ) )
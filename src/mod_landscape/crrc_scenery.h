@@ -255,6 +255,9 @@ protected:
     int use_textures;
     GLUquadricObj *quadric; ///\todo remove dependencies to GLUT
 
+    unsigned int list;      ///< first display list holding the static geometry
+    int num_lists;          ///< number of consecutive display lists starting at list
+
     void setup_drawing_state();
     void restore_drawing_state();
     
@@ -262,8 +265,6 @@ protected:
     void calculate_normals();
     void compile_display_list();
   
-    unsigned int list;
-  
     float size_x;
     float size_z;
     float offset_x;
@@ -326,41 +327,10 @@ class BuiltinSceneryDavis : public BuiltinScenery
   private:
     void read_textures(SimpleXMLTransfer *xml);
     void clear_textures();
+    void compile_geometry();
+    void draw_geometry();
     int location;
 
-    unsigned char *ground_texture;
-    int ground_texture_width;
-    int ground_texture_height;
-    unsigned char *grass_texture;
-    int grass_texture_width;
-    int grass_texture_height;
-    unsigned char *grass_side_texture;
-    int grass_side_texture_width;
-    int grass_side_texture_height;
-    unsigned char *grass_top_texture;
-    int grass_top_texture_width;
-    int grass_top_texture_height;
-    unsigned char *eastern_view_texture;
-    int eastern_view_texture_width;
-    int eastern_view_texture_height;
-    unsigned char *netrees_texture;
-    int netrees_texture_width;
-    int netrees_texture_height;
-    unsigned char *dirt_texture;
-    int dirt_texture_width;
-    int dirt_texture_height;
-    unsigned char *outhouse_texture;
-    int outhouse_texture_width;
-    int outhouse_texture_height;
-    unsigned char *freq_texture;
-    int freq_texture_width;
-    int freq_texture_height;
-    unsigned char *pine_texture;
-    int pine_texture_width;
-    int pine_texture_height;
-    unsigned char *decid_texture;
-    int decid_texture_width;
-    int decid_texture_height;
     GLuint groundTexture;          // GL ground texture handle
     GLuint grassTexture;          // GL grass texture handle
     GLuint grassSideTexture;          // GL grass Side texture handle
@@ -423,31 +393,9 @@ class BuiltinSceneryCapeCod : public BuiltinScenery
     int location;
     void read_textures(SimpleXMLTransfer *xml);
     void clear_textures();
+    void compile_geometry();
 
-    unsigned char *water_texture;
-    int water_texture_width;
-    int water_texture_height;
-    unsigned char *beachsand_texture;
-    int beachsand_texture_width;
-    int beachsand_texture_height;
-    unsigned char *scrub_texture;
-    int scrub_texture_width;
-    int scrub_texture_height;
-    unsigned char *scrubedge_texture;
-    int scrubedge_texture_width;
-    int scrubedge_texture_height;
-    unsigned char *south_texture;
-    int south_texture_width;
-    int south_texture_height;
-    unsigned char *hilledge_texture;
-    int hilledge_texture_width;
-    int hilledge_texture_height;
-    unsigned char *waves_texture;
-    int waves_texture_width;
-    int waves_texture_height;
-    unsigned char *sand_texture;
-    int sand_texture_width;
-    int sand_texture_height;
+    int water_texture_height;   ///< needed to animate the water texture
     GLuint waterTexture;
     GLuint beachsandTexture;
     GLuint scrubTexture;
@@ -574,7 +522,7 @@ class ModelBasedScenery : public Scenery
       float  *x_wind_velocity, float  *y_wind_velocity, float  *z_wind_velocity);
     /**/
   
-  private:
+  protected:
     int   location;   ///< location id
     ssgRoot       *SceneGraph;
     ssgTransform  *initial_trans;
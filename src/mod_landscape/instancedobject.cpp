@@ -0,0 +1,184 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file instancedobject.cpp
+ *
+ *  Implementation of class InstancedObject.
+ */
+
+#include "instancedobject.h"
+#include <algorithm>
+
+
+/**
+ *  Order of leaves for drawing: leaves with the same state
+ *  end up next to each other.
+ */
+static bool compareState(const InstancedObject::T_Part& a, const InstancedObject::T_Part& b)
+{
+  return a.leaf->getState() < b.leaf->getState();
+}
+
+
+InstancedObject::InstancedObject(ssgEntity* model_)
+  : model(model_)
+{
+  model->ref();
+
+  sgMat4 ident;
+  sgMakeIdentMat4(ident);
+  if (!collectParts(model, ident))
+  {
+    parts.clear();
+  }
+  std::stable_sort(parts.begin(), parts.end(), compareState);
+}
+
+
+InstancedObject::~InstancedObject()
+{
+  ssgDeRefDelete(model);
+}
+
+
+// see header
+void InstancedObject::addInstance(sgCoord* coord)
+{
+  T_Instance inst;
+
+  sgMakeCoordMat4(inst.xform, coord);
+  inst.sphere = *model->getBSphere();
+  inst.sphere.orthoXform(inst.xform);
+  instances.push_back(inst);
+
+  dirtyBSphere();
+}
+
+
+// see header
+void InstancedObject::getInstanceTransform(int i, sgMat4 xform)
+{
+  sgCopyMat4(xform, instances[i].xform);
+}
+
+
+// see header
+void InstancedObject::recalcBSphere()
+{
+  bsphere.empty();
+  for (unsigned int i = 0; i < instances.size(); i++)
+  {
+    bsphere.extend(&instances[i].sphere);
+  }
+  bsphere_is_invalid = FALSE;
+}
+
+
+// see header
+void InstancedObject::cull(sgFrustum* f, sgMat4 m, int test_needed)
+{
+  if ((getTraversalMask() & SSGTRAV_CULL) == 0 || instances.size() == 0)
+    return;
+
+  if (test_needed)
+  {
+    sgSphere s = *getBSphere();
+    s.orthoXform(m);
+    if (f->contains(&s) == SG_OUTSIDE)
+      return;
+  }
+
+  // find the visible instances
+  visible.clear();
+  for (unsigned int i = 0; i < instances.size(); i++)
+  {
+    sgSphere s = instances[i].sphere;
+    s.orthoXform(m);
+    if (f->contains(&s) != SG_OUTSIDE)
+      visible.push_back(i);
+  }
+
+  if (parts.size() > 0)
+  {
+    // leaf by leaf, so that SSG can keep the state
+    for (unsigned int p = 0; p < parts.size(); p++)
+    {
+      for (unsigned int v = 0; v < visible.size(); v++)
+      {
+        sgMat4 tmp;
+        sgCopyMat4(tmp, m);
+        sgPreMultMat4(tmp, instances[visible[v]].xform);
+        sgPreMultMat4(tmp, parts[p].xform);
+        parts[p].leaf->cull(f, tmp, FALSE);
+      }
+    }
+  }
+  else
+  {
+    for (unsigned int v = 0; v < visible.size(); v++)
+    {
+      sgMat4 tmp;
+      sgCopyMat4(tmp, m);
+      sgPreMultMat4(tmp, instances[visible[v]].xform);
+      model->cull(f, tmp, FALSE);
+    }
+  }
+}
+
+
+/**
+ *  Flatten the model into a list of leaves. Returns false if the
+ *  model contains nodes which select their kids at cull time.
+ */
+bool InstancedObject::collectParts(ssgEntity* e, sgMat4 xform)
+{
+  if (e->isA(ssgTypeBranch()) || e->isA(ssgTypeTransform()))
+  {
+    ssgBranch* br = (ssgBranch*)e;
+    sgMat4     kid_xform;
+
+    sgCopyMat4(kid_xform, xform);
+    if (e->isA(ssgTypeTransform()))
+    {
+      sgMat4 local;
+      ((ssgTransform*)e)->getTransform(local);
+      sgPreMultMat4(kid_xform, local);
+    }
+    for (int i = 0; i < br->getNumKids(); i++)
+    {
+      if (!collectParts(br->getKid(i), kid_xform))
+        return false;
+    }
+    return true;
+  }
+  else if (e->isAKindOf(ssgTypeLeaf()))
+  {
+    T_Part part;
+    part.leaf = (ssgLeaf*)e;
+    sgCopyMat4(part.xform, xform);
+    parts.push_back(part);
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file instancedobject.h
+ *
+ *  Batched drawing of scenery objects which are placed many times.
+ */
+
+#ifndef INSTANCEDOBJECT_H
+#define INSTANCEDOBJECT_H
+
+#include <plib/ssg.h>
+#include <vector>
+
+
+/** \brief All instances of one scenery object
+ *
+ *  Replaces one ssgTransform per instance. The transformation and
+ *  bounding sphere of every instance are kept in one array, and
+ *  culling is a single loop over this array.
+ *
+ *  If the model only consists of branches, transforms and leaves,
+ *  the visible instances are handed to SSG leaf by leaf, so that all
+ *  instances of a leaf are drawn one after the other with the same
+ *  state. Other models (for example with levels of detail, see
+ *  SceneryLOD) are culled as a whole for each visible instance.
+ *
+ *  The model is not a kid of this node. Intersection tests (HOT,
+ *  LOS) do not see the instances; ModelBasedScenery::tiling_terrain()
+ *  uses getModel() and getInstanceTransform() instead.
+ */
+class InstancedObject : public ssgBranch
+{
+  public:
+    /**
+     *  \param model the model shared by all instances
+     */
+    InstancedObject(ssgEntity* model);
+
+    ~InstancedObject();
+
+    /**
+     *  Add an instance.
+     *
+     *  \param coord position and orientation relative to the parent
+     */
+    void addInstance(sgCoord* coord);
+
+    int getNumInstances() { return instances.size(); };
+
+    /**
+     *  Get the transformation of an instance
+     */
+    void getInstanceTransform(int i, sgMat4 xform);
+
+    ssgEntity* getModel() { return model; };
+
+    /**
+     *  Cull all instances and add the visible ones to the draw list.
+     */
+    virtual void cull(sgFrustum* f, sgMat4 m, int test_needed);
+
+    /**
+     *  The bounding sphere contains all instances.
+     */
+    virtual void recalcBSphere();
+
+    /**
+     *  A leaf of the model with its transformation inside the model
+     */
+    typedef struct
+    {
+      ssgLeaf* leaf;
+      sgMat4   xform;
+    } T_Part;
+
+  private:
+    typedef struct
+    {
+      sgMat4   xform;    ///< model to parent coordinates
+      sgSphere sphere;   ///< bounding sphere in parent coordinates
+    } T_Instance;
+
+    bool collectParts(ssgEntity* e, sgMat4 xform);
+
+    ssgEntity*               model;
+    std::vector<T_Instance>  instances;
+    std::vector<T_Part>      parts;      ///< empty if the model has to be culled as a whole
+    std::vector<int>         visible;    ///< scratch list for cull()
+};
+
+#endif
@@ -0,0 +1,553 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file scenerylod.cpp
+ *
+ *  Implementation of class SceneryLOD.
+ */
+
+#include <crrc_config.h>
+
+#include "scenerylod.h"
+#include "../crrc_main.h"
+#include "../mod_misc/SimpleXMLTransfer.h"
+#include "../mod_misc/filesystools.h"
+#include <plib/ssg.h>
+#include <sys/stat.h>
+#include <math.h>
+#include <map>
+#include <iostream>
+
+#define LODCACHE_MAGIC    0x4352444C    ///< "CRDL"
+#define LODCACHE_VERSION  1
+#define LODCACHE_HDR_LEN  6
+
+/// range of the coarsest level if video.lod.max_distance is not set
+#define LOD_UNLIMITED     1.0e10f
+
+/// grid cell size of the first simplified level, relative to the object radius
+#define LOD_FIRST_CELL    (1.0f/16)
+
+
+/** \brief Accumulates all vertices which are merged into one
+ */
+typedef struct
+{
+  int   index;    ///< index in the simplified mesh
+  int   count;
+  sgVec3 pos;
+  sgVec3 normal;
+  sgVec2 texcoord;
+  sgVec4 colour;
+} T_Cluster;
+
+typedef std::pair<int, std::pair<int, int> > T_CellKey;
+
+
+// see header
+ssgEntity* SceneryLOD::makeLOD(ssgEntity* model, const std::string& file, float distance)
+{
+  int   num_levels   = cfgfile->getInt("video.lod.levels", 3);
+  float max_distance = cfgfile->getDouble("video.lod.max_distance", 0.0);
+  bool  fUseCache    = (cfgfile->getInt("video.lod.fUse_cache", 1) != 0);
+
+  if (distance <= 0)
+    distance = cfgfile->getDouble("video.lod.distance", 300.0);
+
+  if (num_levels > 4)
+    num_levels = 4;
+  if (model == NULL || num_levels < 2 || distance <= 0)
+    return model;
+
+  std::vector<ssgLeaf*> leaves;
+  if (!collectLeaves(model, leaves) || leaves.size() == 0)
+    return model;
+
+  // simplified levels, level 0 (the model itself) is not stored
+  std::vector<T_Level> levels;
+  std::string cachefile;
+
+  if (fUseCache && FileSysTools::getHomePath() != "")
+  {
+    cachefile = getCacheFileName(file, num_levels);
+    loadFromCache(cachefile, file, leaves.size(), levels);
+  }
+
+  if (levels.size() != (unsigned int)(num_levels - 1))
+  {
+    levels.clear();
+    levels.resize(num_levels - 1);
+
+    float cell = model->getBSphere()->getRadius() * LOD_FIRST_CELL;
+    for (int n = 0; n < num_levels - 1; n++)
+    {
+      levels[n].resize(leaves.size());
+      for (unsigned int i = 0; i < leaves.size(); i++)
+      {
+        simplify(leaves[i], cell, levels[n][i]);
+      }
+      cell *= 2;
+    }
+
+    if (cachefile != "")
+      writeToCache(cachefile, file, levels);
+  }
+
+  ssgRangeSelector* sel = new ssgRangeSelector();
+  std::vector<float> ranges;
+
+  sel->addKid(model);
+  ranges.push_back(0);
+  ranges.push_back(distance);
+
+  for (int n = 0; n < num_levels - 1; n++)
+  {
+    unsigned int leaf_num = 0;
+    ssgEntity*   e        = buildLevel(model, levels[n], &leaf_num);
+    if (e == NULL)
+      e = new ssgBranch();
+    sel->addKid(e);
+    distance *= 2;
+    ranges.push_back(distance);
+  }
+
+  // Nothing is drawn beyond max_distance. If it is below the start of
+  // the last level, the coarser levels are clamped away (an empty range
+  // is never selected).
+  if (max_distance > 0)
+  {
+    static bool fWarned = false;
+
+    if (max_distance <= ranges[ranges.size()-2] && !fWarned)
+    {
+      fprintf(stderr, "video.lod.max_distance (%g ft) is below the start of the last "
+              "level of detail (%g ft), the coarser levels are not used.\n",
+              max_distance, ranges[ranges.size()-2]);
+      fWarned = true;
+    }
+    for (unsigned int i = 1; i < ranges.size(); i++)
+    {
+      if (ranges[i] > max_distance)
+        ranges[i] = max_distance;
+    }
+  }
+  else
+    ranges[ranges.size()-1] = LOD_UNLIMITED;
+  sel->setRanges(&ranges[0], ranges.size());
+
+  return sel;
+}
+
+
+/**
+ *  Get all leaves below e in traversal order. Returns false if the
+ *  graph contains something which can not be rebuilt by buildLevel()
+ *  (like selectors), in which case no LOD is used for this model.
+ */
+bool SceneryLOD::collectLeaves(ssgEntity* e, std::vector<ssgLeaf*>& leaves)
+{
+  if (e->isA(ssgTypeBranch()) || e->isA(ssgTypeTransform()))
+  {
+    ssgBranch* br = (ssgBranch*)e;
+    for (int i = 0; i < br->getNumKids(); i++)
+    {
+      if (!collectLeaves(br->getKid(i), leaves))
+        return false;
+    }
+    return true;
+  }
+  else if (e->isAKindOf(ssgTypeLeaf()))
+  {
+    leaves.push_back((ssgLeaf*)e);
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
+/**
+ *  Vertex clustering on one leaf.
+ */
+void SceneryLOD::simplify(ssgLeaf* leaf, float cell, T_Mesh& mesh)
+{
+  std::map<T_CellKey, T_Cluster> clusters;
+  std::vector<int> remap(leaf->getNumVertices());
+  std::vector<T_Cluster*> order;
+
+  bool fNormals   = (leaf->getNumNormals()   > 0);
+  bool fTexCoords = (leaf->getNumTexCoords() > 0);
+  int  nColours   = leaf->getNumColours();
+
+  // merge vertices
+  for (int i = 0; i < leaf->getNumVertices(); i++)
+  {
+    float*    v = leaf->getVertex(i);
+    T_CellKey key((int)floor(v[0]/cell),
+                  std::make_pair((int)floor(v[1]/cell), (int)floor(v[2]/cell)));
+
+    std::map<T_CellKey, T_Cluster>::iterator it = clusters.find(key);
+    T_Cluster* c;
+    if (it == clusters.end())
+    {
+      c = &clusters[key];
+      c->index = order.size();
+      c->count = 0;
+      sgZeroVec3(c->pos);
+      sgZeroVec3(c->normal);
+      sgZeroVec2(c->texcoord);
+      sgZeroVec4(c->colour);
+      order.push_back(c);
+    }
+    else
+    {
+      c = &it->second;
+    }
+
+    c->count++;
+    sgAddVec3(c->pos, v);
+    if (fNormals)
+      sgAddVec3(c->normal, leaf->getNormal(i));
+    if (fTexCoords)
+      sgAddVec2(c->texcoord, leaf->getTexCoord(i));
+    if (nColours > 1)
+      sgAddVec4(c->colour, leaf->getColour(i));
+    remap[i] = c->index;
+  }
+
+  mesh.vertices.clear();
+  mesh.normals.clear();
+  mesh.texcoords.clear();
+  mesh.colours.clear();
+  mesh.indices.clear();
+
+  // keep the triangles which did not collapse
+  for (int i = 0; i < leaf->getNumTriangles(); i++)
+  {
+    short a, b, c;
+    leaf->getTriangle(i, &a, &b, &c);
+    int ra = remap[a];
+    int rb = remap[b];
+    int rc = remap[c];
+    if (ra != rb && rb != rc && ra != rc)
+    {
+      mesh.indices.push_back(ra);
+      mesh.indices.push_back(rb);
+      mesh.indices.push_back(rc);
+    }
+  }
+
+  if (mesh.indices.size() == 0)
+    return;
+
+  for (unsigned int i = 0; i < order.size(); i++)
+  {
+    T_Cluster* c = order[i];
+    float      s = 1.0f / c->count;
+
+    sgScaleVec3(c->pos, s);
+    mesh.vertices.push_back(c->pos[0]);
+    mesh.vertices.push_back(c->pos[1]);
+    mesh.vertices.push_back(c->pos[2]);
+    if (fNormals)
+    {
+      if (sgLengthVec3(c->normal) > 0)
+        sgNormaliseVec3(c->normal);
+      mesh.normals.push_back(c->normal[0]);
+      mesh.normals.push_back(c->normal[1]);
+      mesh.normals.push_back(c->normal[2]);
+    }
+    if (fTexCoords)
+    {
+      sgScaleVec2(c->texcoord, s);
+      mesh.texcoords.push_back(c->texcoord[0]);
+      mesh.texcoords.push_back(c->texcoord[1]);
+    }
+    if (nColours > 1)
+    {
+      sgScaleVec4(c->colour, s);
+      for (int k = 0; k < 4; k++)
+        mesh.colours.push_back(c->colour[k]);
+    }
+  }
+
+  // a single colour for the whole leaf
+  if (nColours == 1)
+  {
+    float* col = leaf->getColour(0);
+    for (int k = 0; k < 4; k++)
+      mesh.colours.push_back(col[k]);
+  }
+}
+
+
+/**
+ *  Rebuild the structure of the original model with the simplified
+ *  leaves. Returns NULL if nothing is left.
+ */
+ssgEntity* SceneryLOD::buildLevel(ssgEntity* e, const T_Level& level, unsigned int* leaf_num)
+{
+  if (e->isAKindOf(ssgTypeBranch()))
+  {
+    ssgBranch* src = (ssgBranch*)e;
+    ssgBranch* dst;
+
+    if (e->isA(ssgTypeTransform()))
+    {
+      sgMat4 m;
+      ((ssgTransform*)e)->getTransform(m);
+      ssgTransform* t = new ssgTransform();
+      t->setTransform(m);
+      dst = t;
+    }
+    else
+    {
+      dst = new ssgBranch();
+    }
+
+    for (int i = 0; i < src->getNumKids(); i++)
+    {
+      ssgEntity* kid = buildLevel(src->getKid(i), level, leaf_num);
+      if (kid != NULL)
+        dst->addKid(kid);
+    }
+
+    if (dst->getNumKids() == 0)
+    {
+      delete dst;
+      return NULL;
+    }
+    return dst;
+  }
+  else
+  {
+    ssgLeaf*      leaf = (ssgLeaf*)e;
+    const T_Mesh& mesh = level[(*leaf_num)++];
+
+    if (mesh.indices.size() == 0)
+      return NULL;
+
+    unsigned int      nv = mesh.vertices.size() / 3;
+    ssgVertexArray*   vl = new ssgVertexArray(nv);
+    ssgNormalArray*   nl = NULL;
+    ssgTexCoordArray* tl = NULL;
+    ssgColourArray*   cl = NULL;
+    ssgIndexArray*    il = new ssgIndexArray(mesh.indices.size());
+
+    for (unsigned int i = 0; i < nv; i++)
+      vl->add(&mesh.vertices[3*i]);
+    if (mesh.normals.size() > 0)
+    {
+      nl = new ssgNormalArray(nv);
+      for (unsigned int i = 0; i < mesh.normals.size() / 3; i++)
+        nl->add(&mesh.normals[3*i]);
+    }
+    if (mesh.texcoords.size() > 0)
+    {
+      tl = new ssgTexCoordArray(nv);
+      for (unsigned int i = 0; i < mesh.texcoords.size() / 2; i++)
+        tl->add(&mesh.texcoords[2*i]);
+    }
+    if (mesh.colours.size() > 0)
+    {
+      cl = new ssgColourArray(mesh.colours.size() / 4);
+      for (unsigned int i = 0; i < mesh.colours.size() / 4; i++)
+        cl->add(&mesh.colours[4*i]);
+    }
+    for (unsigned int i = 0; i < mesh.indices.size(); i++)
+      il->add(mesh.indices[i]);
+
+    ssgVtxArray* va = new ssgVtxArray(GL_TRIANGLES, vl, nl, tl, cl, il);
+    va->setState(leaf->getState());
+    va->setCullFace(leaf->getCullFace());
+    return va;
+  }
+}
+
+
+std::string SceneryLOD::getCacheFileName(const std::string& file, int levels)
+{
+  // FNV-1a hash of the full path
+  unsigned int hash = 2166136261u;
+  for (std::string::size_type i = 0; i < file.length(); i++)
+  {
+    hash ^= (unsigned char)file[i];
+    hash *= 16777619u;
+  }
+
+  char buf[32];
+  sprintf(buf, "%08x_%d.lod", hash, levels);
+
+  return FileSysTools::getHomePath() + "/cache/lod/" + buf;
+}
+
+
+bool SceneryLOD::loadFromCache(const std::string& cachefile, const std::string& file,
+                               unsigned int num_leaves, std::vector<T_Level>& levels)
+{
+  struct stat st;
+  if (stat(file.c_str(), &st) != 0)
+    return false;
+
+  FILE* fp = fopen(cachefile.c_str(), "rb");
+  if (fp == NULL)
+    return false;
+
+  fseek(fp, 0, SEEK_END);
+  long file_size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  unsigned int hdr[LODCACHE_HDR_LEN];
+  if (fread(hdr, sizeof(hdr), 1, fp) != 1
+      || hdr[0] != LODCACHE_MAGIC
+      || hdr[1] != LODCACHE_VERSION
+      || hdr[2] != (unsigned int)st.st_size
+      || hdr[3] != (unsigned int)st.st_mtime
+      || hdr[4] > 4
+      || hdr[5] != num_leaves)
+  {
+    fclose(fp);
+    return false;
+  }
+
+  levels.resize(hdr[4]);
+  for (unsigned int n = 0; n < levels.size(); n++)
+  {
+    levels[n].resize(num_leaves);
+    for (unsigned int i = 0; i < num_leaves; i++)
+    {
+      if (!readMesh(fp, levels[n][i], file_size))
+      {
+        fprintf(stderr, "Ignoring damaged LOD cache file %s\n", cachefile.c_str());
+        levels.clear();
+        fclose(fp);
+        return false;
+      }
+    }
+  }
+  fclose(fp);
+  return true;
+}
+
+
+void SceneryLOD::writeToCache(const std::string& cachefile, const std::string& file,
+                              const std::vector<T_Level>& levels)
+{
+  struct stat st;
+  if (stat(file.c_str(), &st) != 0 || levels.size() == 0)
+    return;
+
+  FileSysTools::makeSurePathExists(FileSysTools::getHomePath() + "/cache/lod/");
+  FILE* fp = fopen(cachefile.c_str(), "wb");
+  if (fp == NULL)
+    return;
+
+  unsigned int hdr[LODCACHE_HDR_LEN];
+  hdr[0] = LODCACHE_MAGIC;
+  hdr[1] = LODCACHE_VERSION;
+  hdr[2] = (unsigned int)st.st_size;
+  hdr[3] = (unsigned int)st.st_mtime;
+  hdr[4] = levels.size();
+  hdr[5] = levels[0].size();
+
+  bool ok = (fwrite(hdr, sizeof(hdr), 1, fp) == 1);
+  for (unsigned int n = 0; ok && n < levels.size(); n++)
+  {
+    for (unsigned int i = 0; ok && i < levels[n].size(); i++)
+      ok = writeMesh(fp, levels[n][i]);
+  }
+  fclose(fp);
+
+  if (!ok)
+  {
+    fprintf(stderr, "Unable to write LOD cache file %s\n", cachefile.c_str());
+    remove(cachefile.c_str());
+  }
+}
+
+
+/**
+ *  A mesh is stored as five counts followed by the arrays. The counts
+ *  and the indices are checked, so a damaged file can neither make
+ *  us allocate huge arrays nor build a leaf which indexes vertices
+ *  it doesn't have.
+ */
+bool SceneryLOD::readMesh(FILE* fp, T_Mesh& mesh, long file_size)
+{
+  unsigned int len[5];
+  if (fread(len, sizeof(len), 1, fp) != 1)
+    return false;
+
+  unsigned int nv = len[0] / 3;
+  if (len[0] % 3 != 0
+      || nv > 32768
+      || (len[1] != 0 && len[1] != len[0])
+      || (len[2] != 0 && len[2] != 2*nv)
+      || (len[3] != 0 && len[3] != 4 && len[3] != 4*nv)
+      || len[4] % 3 != 0)
+    return false;
+
+  // Everything has to be in the rest of the file.
+  double needed = (double)sizeof(float) * ((double)len[0] + len[1] + len[2] + len[3])
+                + (double)sizeof(short) * len[4];
+  if (needed > (double)(file_size - ftell(fp)))
+    return false;
+
+  mesh.vertices.resize(len[0]);
+  mesh.normals.resize(len[1]);
+  mesh.texcoords.resize(len[2]);
+  mesh.colours.resize(len[3]);
+  mesh.indices.resize(len[4]);
+
+  if (!((len[0] == 0 || fread(&mesh.vertices[0],  sizeof(float), len[0], fp) == len[0])
+        && (len[1] == 0 || fread(&mesh.normals[0],   sizeof(float), len[1], fp) == len[1])
+        && (len[2] == 0 || fread(&mesh.texcoords[0], sizeof(float), len[2], fp) == len[2])
+        && (len[3] == 0 || fread(&mesh.colours[0],   sizeof(float), len[3], fp) == len[3])
+        && (len[4] == 0 || fread(&mesh.indices[0],   sizeof(short), len[4], fp) == len[4])))
+    return false;
+
+  for (unsigned int i = 0; i < len[4]; i++)
+  {
+    if (mesh.indices[i] < 0 || (unsigned int)mesh.indices[i] >= nv)
+      return false;
+  }
+  return true;
+}
+
+
+bool SceneryLOD::writeMesh(FILE* fp, const T_Mesh& mesh)
+{
+  unsigned int len[5];
+  len[0] = mesh.vertices.size();
+  len[1] = mesh.normals.size();
+  len[2] = mesh.texcoords.size();
+  len[3] = mesh.colours.size();
+  len[4] = mesh.indices.size();
+
+  return (fwrite(len, sizeof(len), 1, fp) == 1)
+      && (len[0] == 0 || fwrite(&mesh.vertices[0],  sizeof(float), len[0], fp) == len[0])
+      && (len[1] == 0 || fwrite(&mesh.normals[0],   sizeof(float), len[1], fp) == len[1])
+      && (len[2] == 0 || fwrite(&mesh.texcoords[0], sizeof(float), len[2], fp) == len[2])
+      && (len[3] == 0 || fwrite(&mesh.colours[0],   sizeof(float), len[3], fp) == len[3])
+      && (len[4] == 0 || fwrite(&mesh.indices[0],   sizeof(short), len[4], fp) == len[4]);
+}
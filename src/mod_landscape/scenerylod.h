@@ -0,0 +1,102 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file scenerylod.h
+ *
+ *  Automatic generation of simplified versions (levels of detail)
+ *  for the objects of model based sceneries.
+ */
+
+#ifndef SCENERYLOD_H
+#define SCENERYLOD_H
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+class ssgEntity;
+class ssgLeaf;
+
+
+/** \brief Levels of detail for scenery objects
+ *
+ *  An object is simplified by vertex clustering: all vertices of a
+ *  leaf which fall into the same cell of a regular grid are merged,
+ *  triangles which collapse are dropped. Every level uses a grid
+ *  twice as coarse as the one before.
+ *
+ *  The original model and the simplified versions are put below an
+ *  ssgRangeSelector, so the level is chosen by the distance to the
+ *  camera. Kid 0 is the original model; collision detection must only
+ *  use this one (see ModelBasedScenery::tiling_terrain()). The
+ *  simplified meshes can be stored in the user's CRRCsim directory, so
+ *  they only have to be computed once.
+ *
+ *  Configuration (see documentation/options.txt):
+ *  video.lod.levels, video.lod.distance, video.lod.max_distance,
+ *  video.lod.fUse_cache
+ */
+class SceneryLOD
+{
+  public:
+    /**
+     *  Build the levels of detail for a model.
+     *
+     *  \param model     the model as returned by ssgLoad()
+     *  \param file      full path of the model file (used for the cache)
+     *  \param distance  distance at which the first simplified level is
+     *                   used; values <= 0 select the configured default
+     *  \return an ssgRangeSelector containing the model and its levels
+     *          of detail, or the model itself if LOD is disabled or
+     *          not possible for this model
+     */
+    static ssgEntity* makeLOD(ssgEntity* model, const std::string& file,
+                              float distance = 0);
+
+  private:
+    /**
+     *  One simplified leaf
+     */
+    typedef struct
+    {
+      std::vector<float> vertices;   ///< 3 per vertex
+      std::vector<float> normals;    ///< 3 per vertex, or none
+      std::vector<float> texcoords;  ///< 2 per vertex, or none
+      std::vector<float> colours;    ///< 4 per vertex, 4 for all, or none
+      std::vector<short> indices;    ///< 3 per triangle
+    } T_Mesh;
+
+    typedef std::vector<T_Mesh> T_Level;   ///< one mesh per leaf
+
+    static bool collectLeaves(ssgEntity* e, std::vector<ssgLeaf*>& leaves);
+    static void simplify(ssgLeaf* leaf, float cell, T_Mesh& mesh);
+    static ssgEntity* buildLevel(ssgEntity* e, const T_Level& level, unsigned int* leaf_num);
+
+    static std::string getCacheFileName(const std::string& file, int levels);
+    static bool loadFromCache(const std::string& cachefile, const std::string& file,
+                              unsigned int num_leaves, std::vector<T_Level>& levels);
+    static void writeToCache(const std::string& cachefile, const std::string& file,
+                             const std::vector<T_Level>& levels);
+    static bool readMesh(FILE* fp, T_Mesh& mesh, long file_size);
+    static bool writeMesh(FILE* fp, const T_Mesh& mesh);
+};
+
+#endif
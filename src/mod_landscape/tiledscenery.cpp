@@ -0,0 +1,585 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file tiledscenery.cpp
+ *
+ *  Implementation of class TiledScenery.
+ */
+
+#include <crrc_config.h>
+
+#include "tiledscenery.h"
+#include "../global.h"
+#include "../aircraft.h"
+#include "../crrc_main.h"
+#include "../mod_misc/filesystools.h"
+#include <plib/ssg.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+
+#define DEEPEST_HELL  -9999.0
+
+/// maximum number of collision cells along one edge of a tile
+#define MAX_CELLS_PER_TILE  256
+
+// defined in crrc_scenery.cpp
+int on_triangle(float x, float y, float *p1,float *p2,float *p3);
+
+
+TiledScenery::TiledScenery(SimpleXMLTransfer *xml)
+  : ModelBasedScenery(xml), cols(0), rows(0),
+    thread(NULL), mutex(NULL), cond(NULL), fQuit(false)
+{
+  SimpleXMLTransfer *tag = xml->getChild("scene.tiles", true);
+
+  tile_size        = tag->attributeAsDouble("size", 500.0);
+  origin_x         = tag->attributeAsDouble("x", 0.0);
+  origin_y         = tag->attributeAsDouble("y", 0.0);
+  load_radius      = tag->attributeAsDouble("load_radius", 2*tile_size);
+  unload_radius    = tag->attributeAsDouble("unload_radius", 1.25*load_radius);
+  collision_radius = tag->attributeAsDouble("collision_radius", 200.0);
+  max_resident     = tag->attributeAsInt("max_resident", 64);
+  loads_per_frame  = tag->attributeAsInt("loads_per_frame", 1);
+
+  if (tile_size <= 0)
+    tile_size = 500.0;
+  if (unload_radius < load_radius)
+    unload_radius = load_radius;
+  if (loads_per_frame < 1)
+    loads_per_frame = 1;
+
+  cells_per_tile = (int)ceil(tile_size / SIZE_CELL_GRID_PLANES);
+  if (cells_per_tile < 1)
+    cells_per_tile = 1;
+  if (cells_per_tile > MAX_CELLS_PER_TILE)
+    cells_per_tile = MAX_CELLS_PER_TILE;
+
+  // size of the grid
+  for (int i = 0; i < tag->getChildCount(); i++)
+  {
+    SimpleXMLTransfer *kid = tag->getChildAt(i);
+    if (kid->getName() == "tile")
+    {
+      int col = kid->attributeAsInt("col", -1);
+      int row = kid->attributeAsInt("row", -1);
+      if (col >= cols)
+        cols = col + 1;
+      if (row >= rows)
+        rows = row + 1;
+    }
+  }
+  tiles.resize(cols * rows, NULL);
+
+  for (int i = 0; i < tag->getChildCount(); i++)
+  {
+    SimpleXMLTransfer *kid = tag->getChildAt(i);
+    if (kid->getName() != "tile")
+      continue;
+
+    int col = kid->attributeAsInt("col", -1);
+    int row = kid->attributeAsInt("row", -1);
+    std::string filename = kid->attribute("filename", "");
+    if (col < 0 || row < 0 || filename.length() == 0)
+    {
+      fprintf(stderr, "Ignoring invalid tile %d/%d (\"%s\")\n",
+              col, row, filename.c_str());
+      continue;
+    }
+    if (tiles[row*cols + col] != NULL)
+    {
+      fprintf(stderr, "Tile %d/%d defined twice, using the first one\n", col, row);
+      continue;
+    }
+
+    // same directory layout as for the objects of ModelBasedScenery
+    T_Tile* tile  = new T_Tile;
+    tile->file    = FileSysTools::getDataPath("objects/" + filename);
+    tile->texpath = tile->file.substr(0, tile->file.length()-filename.length()-1-7) + "textures";
+    tile->state   = TILE_UNLOADED;
+    tile->node    = NULL;
+    tiles[row*cols + col] = tile;
+  }
+
+  std::cout << "Tiled terrain: " << cols << "x" << rows << " tiles of "
+            << tile_size << " ft" << std::endl;
+
+  mutex  = SDL_CreateMutex();
+  cond   = SDL_CreateCond();
+  thread = SDL_CreateThread(prefetchThread, this);
+  if (thread == NULL)
+  {
+    fprintf(stderr, "Unable to create tile prefetch thread: %s\n", SDL_GetError());
+  }
+}
+
+
+TiledScenery::~TiledScenery()
+{
+  if (thread != NULL)
+  {
+    SDL_LockMutex(mutex);
+    fQuit = true;
+    SDL_CondSignal(cond);
+    SDL_UnlockMutex(mutex);
+    SDL_WaitThread(thread, NULL);
+  }
+  SDL_DestroyCond(cond);
+  SDL_DestroyMutex(mutex);
+
+  // the scene graph nodes are deleted along with the
+  // scene graph in ~ModelBasedScenery()
+  for (unsigned int i = 0; i < tiles.size(); i++)
+  {
+    delete tiles[i];
+  }
+}
+
+
+void TiledScenery::draw(double current_time)
+{
+  CRRCMath::Vector3 pos = Global::aircraft->getPos();
+
+  update(pos.r[0], pos.r[1], -player_pos->z, player_pos->x);
+  ModelBasedScenery::draw(current_time);
+}
+
+
+float TiledScenery::getHeight(float x_north, float y_east)
+{
+  return getHeightAndPlane(x_north, y_east, NULL);
+}
+
+
+float TiledScenery::getHeightAndPlane(float x_north, float y_east, float tplane[4])
+{
+  float obj_plane[4];
+  float obj_hot = ModelBasedScenery::getHeightAndPlane(x_north, y_east, obj_plane);
+
+  int col = (int)floor((y_east - origin_x) / tile_size);
+  int row = (int)floor((x_north - origin_y) / tile_size);
+  T_Tile* tile = getTile(col, row);
+
+  // Usually update() has already loaded all tiles near the aircraft.
+  // A height query must not load render data, so for any other
+  // location only the objects are used. The tile is handed to the
+  // prefetch thread; update() loads it if it is still in range.
+  if (tile != NULL && tile->state == TILE_UNLOADED)
+  {
+    SDL_LockMutex(mutex);
+    tile->state = TILE_QUEUED;
+    queue.push_back(row*cols + col);
+    SDL_CondSignal(cond);
+    SDL_UnlockMutex(mutex);
+  }
+
+  bool  found;
+  float tile_plane[4];
+  float tile_hot = getTileHeight(x_north, y_east, tile_plane, &found);
+
+  if (found && tile_hot >= obj_hot)
+  {
+    if (tplane)
+      sgCopyVec4(tplane, tile_plane);
+    return tile_hot;
+  }
+  else
+  {
+    if (tplane)
+      sgCopyVec4(tplane, obj_plane);
+    return obj_hot;
+  }
+}
+
+
+TiledScenery::T_Tile* TiledScenery::getTile(int col, int row)
+{
+  if (col < 0 || col >= cols || row < 0 || row >= rows)
+    return NULL;
+  else
+    return tiles[row*cols + col];
+}
+
+
+float TiledScenery::tileDistance(int col, int row, float north, float east)
+{
+  float x0 = origin_x + col*tile_size;
+  float y0 = origin_y + row*tile_size;
+  float dx = 0;
+  float dy = 0;
+
+  if (east < x0)
+    dx = x0 - east;
+  else if (east > x0 + tile_size)
+    dx = east - (x0 + tile_size);
+
+  if (north < y0)
+    dy = y0 - north;
+  else if (north > y0 + tile_size)
+    dy = north - (y0 + tile_size);
+
+  return sqrt(dx*dx + dy*dy);
+}
+
+
+void TiledScenery::update(float ac_north, float ac_east, float cam_north, float cam_east)
+{
+  std::vector<int> unload;
+  std::vector<int> urgent;
+  std::vector< std::pair<float, int> > prefetched;
+  std::vector< std::pair<float, int> > wanted;
+
+  SDL_LockMutex(mutex);
+
+  // resident tiles which are out of range
+  for (std::list<int>::iterator it = resident.begin(); it != resident.end(); it++)
+  {
+    int   col = *it % cols;
+    int   row = *it / cols;
+    float d   = std::min(tileDistance(col, row, ac_north, ac_east),
+                         tileDistance(col, row, cam_north, cam_east));
+    if (d > unload_radius)
+      unload.push_back(*it);
+  }
+
+  // Only look at the part of the grid around the aircraft and the
+  // pilot, so the effort does not depend on the size of the scenery.
+  int col_min = (int)floor((std::min(ac_east,  cam_east)  - unload_radius - origin_x) / tile_size);
+  int col_max = (int)floor((std::max(ac_east,  cam_east)  + unload_radius - origin_x) / tile_size);
+  int row_min = (int)floor((std::min(ac_north, cam_north) - unload_radius - origin_y) / tile_size);
+  int row_max = (int)floor((std::max(ac_north, cam_north) + unload_radius - origin_y) / tile_size);
+  col_min = std::max(col_min, 0);
+  row_min = std::max(row_min, 0);
+  col_max = std::min(col_max, cols-1);
+  row_max = std::min(row_max, rows-1);
+
+  for (int row = row_min; row <= row_max; row++)
+  {
+    for (int col = col_min; col <= col_max; col++)
+    {
+      T_Tile* tile = getTile(col, row);
+      if (tile == NULL || tile->state == TILE_RESIDENT)
+        continue;
+
+      float d_ac = tileDistance(col, row, ac_north, ac_east);
+      float d    = std::min(d_ac, tileDistance(col, row, cam_north, cam_east));
+      int   idx  = row*cols + col;
+
+      if (d_ac <= collision_radius)
+      {
+        urgent.push_back(idx);
+      }
+      else if (d <= load_radius)
+      {
+        if (tile->state == TILE_PREFETCHED)
+          prefetched.push_back(std::make_pair(d, idx));
+        else if (tile->state == TILE_UNLOADED)
+          wanted.push_back(std::make_pair(d, idx));
+      }
+      else if (d > unload_radius && tile->state != TILE_UNLOADED)
+      {
+        // went out of range before it has been loaded;
+        // the prefetch thread skips it
+        tile->state = TILE_UNLOADED;
+      }
+    }
+  }
+
+  // hand new tiles to the prefetch thread, nearest first
+  if (wanted.size() > 0)
+  {
+    std::sort(wanted.begin(), wanted.end());
+    for (unsigned int i = 0; i < wanted.size(); i++)
+    {
+      tiles[wanted[i].second]->state = TILE_QUEUED;
+      queue.push_back(wanted[i].second);
+    }
+    SDL_CondSignal(cond);
+  }
+
+  SDL_UnlockMutex(mutex);
+
+  for (unsigned int i = 0; i < unload.size(); i++)
+  {
+    unloadTile(unload[i] % cols, unload[i] / cols);
+  }
+
+  // The flight model needs these right now.
+  for (unsigned int i = 0; i < urgent.size(); i++)
+  {
+    loadTile(urgent[i] % cols, urgent[i] / cols);
+  }
+
+  // Everything else is spread over several frames.
+  std::sort(prefetched.begin(), prefetched.end());
+  for (unsigned int i = 0; i < prefetched.size() && (int)i < loads_per_frame; i++)
+  {
+    loadTile(prefetched[i].second % cols, prefetched[i].second / cols);
+  }
+
+  // limit memory usage: drop the tiles which are farthest away
+  while ((int)resident.size() > max_resident)
+  {
+    int   far_idx  = -1;
+    float far_dist = collision_radius;
+    for (std::list<int>::iterator it = resident.begin(); it != resident.end(); it++)
+    {
+      int   col = *it % cols;
+      int   row = *it / cols;
+      float d   = std::min(tileDistance(col, row, ac_north, ac_east),
+                           tileDistance(col, row, cam_north, cam_east));
+      if (d > far_dist)
+      {
+        far_dist = d;
+        far_idx  = *it;
+      }
+    }
+    if (far_idx < 0)
+      break;
+    unloadTile(far_idx % cols, far_idx / cols);
+  }
+}
+
+
+void TiledScenery::loadTile(int col, int row)
+{
+  T_Tile* tile = getTile(col, row);
+
+  if (tile == NULL || tile->state == TILE_RESIDENT)
+    return;
+
+  std::cout << "Loading terrain tile " << col << "/" << row
+            << " \"" << tile->file << "\"" << std::endl;
+
+  ssgTexturePath(tile->texpath.c_str());
+  ssgEntity* model = ssgLoad(tile->file.c_str());
+
+  tile->cells.clear();
+  tile->cells.resize(cells_per_tile * cells_per_tile);
+  tile->node = new ssgTransform();
+  // collision detection uses the tile's own cells, keep them
+  // out of ModelBasedScenery's queries
+  tile->node->clrTraversalMaskBits(SSGTRAV_HOT | SSGTRAV_LOS);
+  if (model != NULL)
+  {
+    tile->node->addKid(model);
+
+    sgMat4 xform;
+    initial_trans->getTransform(xform);
+    collectTriangles(tile, col, row, model, xform);
+  }
+  else
+  {
+    fprintf(stderr, "Unable to load terrain tile %s\n", tile->file.c_str());
+  }
+  initial_trans->addKid(tile->node);
+
+  SDL_LockMutex(mutex);
+  tile->state = TILE_RESIDENT;
+  SDL_UnlockMutex(mutex);
+  resident.push_back(row*cols + col);
+}
+
+
+void TiledScenery::unloadTile(int col, int row)
+{
+  T_Tile* tile = getTile(col, row);
+
+  if (tile == NULL || tile->state != TILE_RESIDENT)
+    return;
+
+  // deletes the node and the model if nobody else uses it
+  initial_trans->removeKid(tile->node);
+  tile->node = NULL;
+  std::vector< std::vector<float> >().swap(tile->cells);
+
+  SDL_LockMutex(mutex);
+  tile->state = TILE_UNLOADED;
+  SDL_UnlockMutex(mutex);
+  resident.remove(row*cols + col);
+}
+
+
+void TiledScenery::collectTriangles(T_Tile* tile, int col, int row,
+                                    ssgEntity* e, sgMat4 xform)
+{
+  if (e->isAKindOf(ssgTypeBranch()))
+  {
+    ssgBranch* br = (ssgBranch*)e;
+    sgMat4     kid_xform;
+
+    sgCopyMat4(kid_xform, xform);
+    if (e->isA(ssgTypeTransform()))
+    {
+      sgMat4 local;
+      ((ssgTransform*)e)->getTransform(local);
+      sgPreMultMat4(kid_xform, local);
+    }
+    for (int i = 0; i < br->getNumKids(); i++)
+      collectTriangles(tile, col, row, br->getKid(i), kid_xform);
+  }
+  else if (e->isAKindOf(ssgTypeLeaf()))
+  {
+    ssgLeaf* leaf      = (ssgLeaf*)e;
+    int      nt        = leaf->getNumTriangles();
+    float    cell_size = tile_size / cells_per_tile;
+    float    x0        = origin_x + col*tile_size;
+    float    y0        = origin_y + row*tile_size;
+
+    for (int i = 0; i < nt; i++)
+    {
+      short  iv1, iv2, iv3;
+      sgVec3 v[3];
+      leaf->getTriangle(i, &iv1, &iv2, &iv3);
+      sgXformPnt3(v[0], leaf->getVertex(iv1), xform);
+      sgXformPnt3(v[1], leaf->getVertex(iv2), xform);
+      sgXformPnt3(v[2], leaf->getVertex(iv3), xform);
+
+      // v is east, up, south
+      float e_min = std::min(v[0][0], std::min(v[1][0], v[2][0]));
+      float e_max = std::max(v[0][0], std::max(v[1][0], v[2][0]));
+      float n_min = -std::max(v[0][2], std::max(v[1][2], v[2][2]));
+      float n_max = -std::min(v[0][2], std::min(v[1][2], v[2][2]));
+
+      int i1 = (int)floor((e_min - x0) / cell_size);
+      int i2 = (int)floor((e_max - x0) / cell_size);
+      int j1 = (int)floor((n_min - y0) / cell_size);
+      int j2 = (int)floor((n_max - y0) / cell_size);
+      if (i2 < 0 || j2 < 0 || i1 >= cells_per_tile || j1 >= cells_per_tile)
+        continue;
+      i1 = std::max(i1, 0);
+      j1 = std::max(j1, 0);
+      i2 = std::min(i2, cells_per_tile-1);
+      j2 = std::min(j2, cells_per_tile-1);
+
+      for (int j = j1; j <= j2; j++)
+      {
+        for (int ii = i1; ii <= i2; ii++)
+        {
+          std::vector<float>& cell = tile->cells[j*cells_per_tile + ii];
+          for (int k = 0; k < 3; k++)
+          {
+            cell.push_back(v[k][0]);
+            cell.push_back(v[k][1]);
+            cell.push_back(v[k][2]);
+          }
+        }
+      }
+    }
+  }
+}
+
+
+float TiledScenery::getTileHeight(float x_north, float y_east, float tplane[4], bool* found)
+{
+  int col = (int)floor((y_east - origin_x) / tile_size);
+  int row = (int)floor((x_north - origin_y) / tile_size);
+  T_Tile* tile = getTile(col, row);
+  float hot = DEEPEST_HELL;
+
+  *found = false;
+  if (tile == NULL || tile->state != TILE_RESIDENT)
+    return hot;
+
+  float cell_size = tile_size / cells_per_tile;
+  int   i = (int)floor((y_east  - origin_x - col*tile_size) / cell_size);
+  int   j = (int)floor((x_north - origin_y - row*tile_size) / cell_size);
+  i = std::max(0, std::min(i, cells_per_tile-1));
+  j = std::max(0, std::min(j, cells_per_tile-1));
+
+  std::vector<float>& cell = tile->cells[j*cells_per_tile + i];
+  for (unsigned int n = 0; n + 9 <= cell.size(); n += 9)
+  {
+    float* p1 = &cell[n];
+    float* p2 = &cell[n+3];
+    float* p3 = &cell[n+6];
+    if (on_triangle(-x_north, y_east, p1, p2, p3))
+    {
+      sgVec4 plane;
+      sgMakePlane(plane, p1, p2, p3);
+      if (plane[1] == 0)
+        continue;
+      float h = -(-plane[2]*x_north + plane[0]*y_east + plane[3]) / plane[1];
+      if (h > hot)
+      {
+        hot    = h;
+        *found = true;
+        sgCopyVec4(tplane, plane);
+      }
+    }
+  }
+
+  if (*found)
+  {
+    if (tplane[1] < 0)
+      sgNegateVec4(tplane, tplane);
+  }
+  else
+  {
+    tplane[0] = 0.0;
+    tplane[1] = 1.0;
+    tplane[2] = 0.0;
+    tplane[3] = -hot;
+  }
+  return hot;
+}
+
+
+int TiledScenery::prefetchThread(void* data)
+{
+  TiledScenery* ts = (TiledScenery*)data;
+  std::vector<char> buffer(65536);
+
+  SDL_LockMutex(ts->mutex);
+  while (!ts->fQuit)
+  {
+    if (ts->queue.empty())
+    {
+      SDL_CondWait(ts->cond, ts->mutex);
+      continue;
+    }
+
+    int idx = ts->queue.front();
+    ts->queue.pop_front();
+    if (ts->tiles[idx]->state != TILE_QUEUED)
+      continue;
+    std::string file = ts->tiles[idx]->file;
+
+    // Read the file once so that ssgLoad() finds it in the
+    // operating system's cache.
+    SDL_UnlockMutex(ts->mutex);
+    FILE* fp = fopen(file.c_str(), "rb");
+    if (fp != NULL)
+    {
+      while (fread(&buffer[0], 1, buffer.size(), fp) == buffer.size())
+        ;
+      fclose(fp);
+    }
+    SDL_LockMutex(ts->mutex);
+
+    if (ts->tiles[idx]->state == TILE_QUEUED)
+      ts->tiles[idx]->state = TILE_PREFETCHED;
+  }
+  SDL_UnlockMutex(ts->mutex);
+
+  return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+/** \file tiledscenery.h
+ *
+ *  A model based scenery whose terrain is split into a grid of
+ *  tiles which are paged in and out around the aircraft and the
+ *  pilot. See documentation/tiled_scenery.txt for the file format.
+ */
+
+#ifndef TILEDSCENERY_H
+#define TILEDSCENERY_H
+
+#include "crrc_scenery.h"
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+
+
+/** \brief Scenery with paged terrain tiles
+ *
+ *  Everything below <scene> which is understood by ModelBasedScenery
+ *  (<object> tags) is loaded at startup and stays resident. The
+ *  terrain tiles listed in <scene><tiles> are only loaded while they
+ *  are within the load radius of the aircraft or the pilot:
+ *
+ *  - A background thread reads the files of tiles which are about to
+ *    come into range, so that the main thread does not have to wait
+ *    for the disk when it loads them.
+ *  - The main thread turns at most a fixed number of prefetched tiles
+ *    into scene graph nodes per frame. Tiles within the collision
+ *    radius of the aircraft are loaded immediately, as the flight
+ *    model needs their height data.
+ *  - Tiles which are out of range are removed again, and the number
+ *    of resident tiles is limited.
+ *
+ *  plib's loaders and texture upload are not thread safe (and the
+ *  latter needs the OpenGL context), so ssgLoad() is always called
+ *  from the main thread.
+ */
+class TiledScenery : public ModelBasedScenery
+{
+  public:
+    /**
+     *  The constructor
+     *
+     *  \param xml scenery description
+     */
+    TiledScenery(SimpleXMLTransfer *xml);
+
+    /**
+     *  The destructor. Stops the prefetch thread.
+     */
+    ~TiledScenery();
+
+    /**
+     *  Update the set of resident tiles and draw the scenery
+     */
+    void draw(double current_time);
+
+    /**
+     *  Get the height at a distinct point.
+     *  \param x_north x coordinate
+     *  \param y_east  y coordinate
+     *  \return terrain height at this point in ft
+     */
+    float getHeight(float x_north, float y_east);
+
+    /**
+     *  get height and plane equation at x|y
+     *  \param x_north x coordinate
+     *  \param y_east  y coordinate
+     *  \param tplane this is where the plane equation will be stored
+     *  \return terrain height at this point in ft
+     */
+    float getHeightAndPlane(float x_north, float y_east, float tplane[4]);
+
+  private:
+    /**
+     *  Life cycle of a tile
+     */
+    enum
+    {
+      TILE_UNLOADED = 0,  ///< nothing in memory
+      TILE_QUEUED,        ///< waiting for the prefetch thread
+      TILE_PREFETCHED,    ///< file has been read, ready to be loaded
+      TILE_RESIDENT       ///< part of the scene graph
+    };
+
+    typedef struct
+    {
+      std::string   file;     ///< full path of the model file
+      std::string   texpath;  ///< texture path for this model
+      int           state;    ///< TILE_*
+      ssgTransform* node;     ///< scene graph node while resident
+      /**
+       *  Collision triangles while resident, 9 floats (three
+       *  vertices in scene graph coordinates) per triangle. One entry
+       *  per cell of size SIZE_CELL_GRID_PLANES.
+       */
+      std::vector< std::vector<float> > cells;
+    } T_Tile;
+
+    /**
+     *  Get tile by grid position or NULL if there is none.
+     */
+    T_Tile* getTile(int col, int row);
+
+    /**
+     *  Find the tiles to be loaded or removed. Called once per frame.
+     *
+     *  \param ac_north  aircraft position
+     *  \param ac_east   aircraft position
+     *  \param cam_north pilot position
+     *  \param cam_east  pilot position
+     */
+    void update(float ac_north, float ac_east, float cam_north, float cam_east);
+
+    /**
+     *  Distance from a point to the area covered by a tile
+     */
+    float tileDistance(int col, int row, float north, float east);
+
+    /**
+     *  Load the model of a tile and add it to the scene graph.
+     *  Must only be called from the main thread.
+     */
+    void loadTile(int col, int row);
+
+    /**
+     *  Remove a tile from the scene graph.
+     */
+    void unloadTile(int col, int row);
+
+    /**
+     *  Sort the triangles of a freshly loaded tile into its
+     *  collision cells.
+     */
+    void collectTriangles(T_Tile* tile, int col, int row, ssgEntity* e, sgMat4 xform);
+
+    /**
+     *  Height query on resident tiles only.
+     */
+    float getTileHeight(float x_north, float y_east, float tplane[4], bool* found);
+
+    /**
+     *  Prefetch thread entry point
+     */
+    static int prefetchThread(void* data);
+
+    std::vector<T_Tile*> tiles;   ///< cols x rows, NULL where no tile is defined
+    int   cols;
+    int   rows;
+    float tile_size;              ///< edge length of a tile in ft
+    float origin_x;               ///< west edge of column 0
+    float origin_y;               ///< south edge of row 0
+    float load_radius;
+    float unload_radius;
+    float collision_radius;
+    int   max_resident;
+    int   loads_per_frame;
+    int   cells_per_tile;
+
+    std::list<int>    resident;   ///< indices of resident tiles
+    std::deque<int>   queue;      ///< tiles waiting for the prefetch thread
+    SDL_Thread*       thread;
+    SDL_mutex*        mutex;      ///< protects queue, tile states and fQuit
+    SDL_cond*         cond;
+    bool              fQuit;
+};
+
+#endif
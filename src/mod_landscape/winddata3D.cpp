@@ -39,6 +39,14 @@
 
 #include  "crrc_scenery.h"
 #if WINDDATA3D == 1
+#ifndef TEST_WINDDATA
+#include <SDL.h>
+
+/// locate() walks the triangulation using a random number generator
+/// stored inside of it, so it must not be called from several threads
+/// at once (see windfield_dump.cpp).
+static SDL_mutex* locate_mutex = NULL;
+#endif
 #ifdef TEST_WINDDATA
 //main program for test only
 WindData *wind_data=NULL;
@@ -79,6 +87,10 @@ int ModelBasedScenery::init_wind_data(const char* filename)
 #endif
 {
   wind_data = new WindData;
+#ifndef TEST_WINDDATA
+  if (locate_mutex == NULL)
+    locate_mutex = SDL_CreateMutex();
+#endif
   Vertex_handle v;
   FILE *input = fopen(filename,"r");
   float north, east, up, v_north, v_east, v_up;
@@ -153,12 +165,15 @@ int find_wind_data(float n,float e,float u, float *vx, float *vy, float * vz)
 int ModelBasedScenery::find_wind_data(float n,float e,float u, float *vx, float *vy, float * vz)
 #endif
 {
-  static Cell_handle mem_cell_handle=NULL;
   Cell_handle c;
   Point p0 = Point(n,e,u);
-  if (mem_cell_handle==NULL) c = wind_data->locate(p0,mem_cell_handle);
-  else c = wind_data->locate(p0);
-  mem_cell_handle = c;
+#ifndef TEST_WINDDATA
+  SDL_LockMutex(locate_mutex);
+  c = wind_data->locate(p0);
+  SDL_UnlockMutex(locate_mutex);
+#else
+  c = wind_data->locate(p0);
+#endif
   if (wind_data->is_infinite (c)) return false;
   Vertex_handle va = c->vertex(0);
   Vertex_handle vb = c->vertex(1);
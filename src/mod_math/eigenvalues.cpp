@@ -0,0 +1,144 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+#include "eigenvalues.h"
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+typedef std::complex<double> T_Complex;
+
+
+static bool smallerAbs(const T_Complex& a, const T_Complex& b)
+{
+  if (abs(a) != abs(b))
+    return(abs(a) < abs(b));
+  else
+    return(a.imag() < b.imag());
+}
+
+
+void CRRCMath::eigenvalues(int n, const double* a, std::complex<double>* lambda)
+{
+  std::vector<double> m(n*n, 0.0);
+  std::vector<double> am(n*n);
+  std::vector<double> c(n+1);
+
+  // characteristic polynomial c[n]*x^n + ... + c[0], Faddeev-LeVerrier:
+  // M_k = A*M_(k-1) + c[n-k+1]*I, c[n-k] = -tr(A*M_k)/k
+  c[n] = 1;
+  for (int k=1; k<=n; k++)
+  {
+    for (int i=0; i<n; i++)
+    {
+      for (int j=0; j<n; j++)
+      {
+        double s = 0;
+        for (int l=0; l<n; l++)
+          s += a[i*n+l] * m[l*n+j];
+        am[i*n+j] = s;
+      }
+    }
+    for (int i=0; i<n*n; i++)
+      m[i] = am[i];
+    for (int i=0; i<n; i++)
+      m[i*n+i] += c[n-k+1];
+
+    double tr = 0;
+    for (int i=0; i<n; i++)
+      for (int l=0; l<n; l++)
+        tr += a[i*n+l] * m[l*n+i];
+    c[n-k] = -tr / k;
+  }
+
+  // all roots at once, Durand-Kerner
+  double radius = 0;
+  for (int i=0; i<n; i++)
+    radius = std::max(radius, fabs(c[i]));
+  radius = 1 + radius;
+
+  T_Complex w(0.4, 0.9);
+  T_Complex z = 1;
+  for (int i=0; i<n; i++)
+  {
+    lambda[i] = radius * z;
+    z *= w;
+  }
+
+  for (int iter=0; iter<1000; iter++)
+  {
+    double change = 0;
+
+    for (int i=0; i<n; i++)
+    {
+      T_Complex p   = c[n];
+      T_Complex den = 1;
+
+      for (int k=n-1; k>=0; k--)
+        p = p * lambda[i] + c[k];
+      for (int j=0; j<n; j++)
+        if (j != i)
+          den *= lambda[i] - lambda[j];
+
+      if (abs(den) > 0)
+      {
+        T_Complex d = p / den;
+        lambda[i] -= d;
+        change = std::max(change, abs(d));
+      }
+    }
+    if (change <= 1e-14 * radius)
+      break;
+  }
+
+  // make pairs exact conjugates, roots close to the real axis real
+  for (int i=0; i<n; i++)
+  {
+    if (fabs(lambda[i].imag()) <= 1e-9 * std::max(1.0, abs(lambda[i])))
+      lambda[i] = lambda[i].real();
+  }
+  for (int i=0; i<n; i++)
+  {
+    if (lambda[i].imag() > 0)
+    {
+      int    best = -1;
+      double dist = 0;
+      for (int j=0; j<n; j++)
+      {
+        if (lambda[j].imag() < 0 && (best < 0 || abs(lambda[j] - conj(lambda[i])) < dist))
+        {
+          best = j;
+          dist = abs(lambda[j] - conj(lambda[i]));
+        }
+      }
+      if (best >= 0)
+      {
+        T_Complex mean = 0.5 * (lambda[i] + conj(lambda[best]));
+        lambda[i]    = mean;
+        lambda[best] = conj(mean);
+      }
+    }
+  }
+
+  std::sort(lambda, lambda + n, smallerAbs);
+}
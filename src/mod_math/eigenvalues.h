@@ -0,0 +1,44 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+#ifndef EIGENVALUES_H
+# define EIGENVALUES_H
+
+#include <complex>
+
+namespace CRRCMath
+{
+  /**
+   * Eigenvalues of a small real matrix, as the roots of its
+   * characteristic polynomial (Faddeev-LeVerrier, then
+   * Durand-Kerner). Good enough for the four by four systems of
+   * flight dynamics, not meant for large matrices.
+   * 
+   * @param n       size of the matrix
+   * @param a       n x n matrix, row by row
+   * @param lambda  n eigenvalues, conjugate pairs are exact
+   *                conjugates, sorted by ascending absolute value
+   */
+  void eigenvalues(int n, const double* a, std::complex<double>* lambda);
+};
+
+#endif
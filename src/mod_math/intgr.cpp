@@ -34,12 +34,16 @@ namespace CRRCMath
   {
      AblAlt = AblStartwert;
      val    = Startwert;
+     dTAlt  = 0;
   }
 
   template<class C> void Integrationsverfahren<C>::step(double dT, C AblNeu)
   {
-     val    = val + (AblNeu*3 - AblAlt)*0.5*dT;
+     double r = (dTAlt > 0) ? dT/dTAlt : 1;
+
+     val    = val + (AblNeu*(2+r) - AblAlt*r)*0.5*dT;
      AblAlt = AblNeu;
+     dTAlt  = dT;
   }
 
   template<class C> void IntegrationsverfahrenB<C>::init(C Startwert, C AblStartwert)
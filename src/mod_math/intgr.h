@@ -69,12 +69,23 @@ namespace CRRCMath
        y(x_{i+1}) = y(x_i) + \frac{h}{2} \, (3\, f_i - f_{i-1})
      \f]
    *
+   * If the step size changes from \f$h_{i-1} = x_i - x_{i-1}\f$ to \f$h\f$,
+   * the slope is \f$(f_i - f_{i-1})/h_{i-1}\f$ and with \f$r = h/h_{i-1}\f$
+   * 
+   * \f[
+       y(x_{i+1}) = y(x_i) + \frac{h}{2} \, ((2+r)\, f_i - r\, f_{i-1})
+     \f]
+   * 
+   * which is the same as above for \f$r = 1\f$.
+   *
    * @author Jens Wilhelm Wulf
    */
   template<class C> class Integrationsverfahren /*{{{*/
   {
     public:
      
+     Integrationsverfahren() : dTAlt(0) {};
+
      /**
       * virtual base class should have a virtual dtor
       */
@@ -97,6 +108,11 @@ namespace CRRCMath
 
     private:
      C AblAlt;
+
+     /**
+      * step size of the last step, 0 before the first one
+      */
+     double dTAlt;
   };
 
   /**
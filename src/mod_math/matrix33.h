@@ -26,78 +26,168 @@
 namespace CRRCMath
 {
   /**
-   * A 3x3 matrix of double values.
+   * A 3x3 matrix. Like TVector3, everything is inline and the loops
+   * are written out. Use Matrix33 (double) or Matrix33f (float).
    *
    * @author Jens Wilhelm Wulf
    */
-  class Matrix33 /*{{{*/
+  template <typename T> class TMatrix33 /*{{{*/
   {
     public:
-     double v[3][3];
+     T v[3][3];
 
     public:
 
-     Matrix33();
-
-     Matrix33(double i00, double i01, double i02,
-              double i10, double i11, double i12,
-              double i20, double i21, double i22);
-
-     Matrix33(const Matrix33& mb);
+     TMatrix33()
+     {
+       v[0][0] = v[0][1] = v[0][2] = 0;
+       v[1][0] = v[1][1] = v[1][2] = 0;
+       v[2][0] = v[2][1] = v[2][2] = 0;
+     }
+
+     TMatrix33(T i00, T i01, T i02,
+               T i10, T i11, T i12,
+               T i20, T i21, T i22)
+     {
+       v[0][0] = i00;
+       v[0][1] = i01;
+       v[0][2] = i02;
+       v[1][0] = i10;
+       v[1][1] = i11;
+       v[1][2] = i12;
+       v[2][0] = i20;
+       v[2][1] = i21;
+       v[2][2] = i22;
+     }
+
+     TMatrix33(const TMatrix33& mb)
+     {
+       *this = mb;
+     }
 
      /**
       * returns determinant of matrix
       */
-     double det() const;
+     T det() const
+     {
+       return (
+               v[0][0]*v[1][1]*v[2][2] + v[0][1]*v[1][2]*v[2][0]
+               + v[0][2]*v[1][0]*v[2][1] - v[0][2]*v[1][1]*v[2][0]
+               - v[0][1]*v[1][0]*v[2][2] - v[1][2]*v[2][1]*v[0][0]
+               );
+     }
 
      /**
       * returns inverse matrix: does not check whether this is
       * possible (det() != 0)!
       */
-     Matrix33 inv() const;
+     TMatrix33 inv() const
+     {
+       // Compute the inverse of a general matrix using Cramers rule.
+       // I guess googling for cramers rule gives tons of references
+       // for this. :)
+       T rdet = 1/det();
+
+       return TMatrix33( rdet*(v[1][1]*v[2][2]-v[1][2]*v[2][1]),
+                         rdet*(v[0][2]*v[2][1]-v[0][1]*v[2][2]),
+                         rdet*(v[0][1]*v[1][2]-v[0][2]*v[1][1]),
+                         rdet*(v[1][2]*v[2][0]-v[1][0]*v[2][2]),
+                         rdet*(v[0][0]*v[2][2]-v[0][2]*v[2][0]),
+                         rdet*(v[0][2]*v[1][0]-v[0][0]*v[1][2]),
+                         rdet*(v[1][0]*v[2][1]-v[1][1]*v[2][0]),
+                         rdet*(v[0][1]*v[2][0]-v[0][0]*v[2][1]),
+                         rdet*(v[0][0]*v[1][1]-v[0][1]*v[1][0]) );
+     }
 
      /**
       * Operator: Zuweisung
       */
-     Matrix33& operator=(const Matrix33& b);
+     TMatrix33& operator=(const TMatrix33& b)
+     {
+       v[0][0] = b.v[0][0];
+       v[0][1] = b.v[0][1];
+       v[0][2] = b.v[0][2];
+       v[1][0] = b.v[1][0];
+       v[1][1] = b.v[1][1];
+       v[1][2] = b.v[1][2];
+       v[2][0] = b.v[2][0];
+       v[2][1] = b.v[2][1];
+       v[2][2] = b.v[2][2];
+       return *this;
+     }
 
      /**
       * Operator: Multiplikation mit Vector3
       */
-     Vector3 operator*(const Vector3& b) const;
+     TVector3<T> operator*(const TVector3<T>& b) const
+     {
+       return TVector3<T>( v[0][0]*b.r[0] + v[0][1]*b.r[1] + v[0][2]*b.r[2],
+                           v[1][0]*b.r[0] + v[1][1]*b.r[1] + v[1][2]*b.r[2],
+                           v[2][0]*b.r[0] + v[2][1]*b.r[1] + v[2][2]*b.r[2] );
+     }
 
      /**
       * Operation: Erst die transponierte bilden, dann Multiplikation mit Vector3.
       *            Ist wahrscheinlich schneller als <tt>matrix.trans() * vector3</tt>.
       */
-     Vector3 multrans(const Vector3& b) const;
+     TVector3<T> multrans(const TVector3<T>& b) const
+     {
+       return TVector3<T>( v[0][0]*b.r[0] + v[1][0]*b.r[1] + v[2][0]*b.r[2],
+                           v[0][1]*b.r[0] + v[1][1]*b.r[1] + v[2][1]*b.r[2],
+                           v[0][2]*b.r[0] + v[1][2]*b.r[1] + v[2][2]*b.r[2] );
+     }
 
      /**
       * Operator: Multiplikation mit Matrix33
       */
-     Matrix33 operator*(const Matrix33& b) const;
+     TMatrix33 operator*(const TMatrix33& b) const
+     {
+       TMatrix33 tmp;
+
+       for (int m=0; m<3; m++)
+       {
+         tmp.v[m][0] = v[m][0]*b.v[0][0] + v[m][1]*b.v[1][0] + v[m][2]*b.v[2][0];
+         tmp.v[m][1] = v[m][0]*b.v[0][1] + v[m][1]*b.v[1][1] + v[m][2]*b.v[2][1];
+         tmp.v[m][2] = v[m][0]*b.v[0][2] + v[m][1]*b.v[1][2] + v[m][2]*b.v[2][2];
+       }
+
+       return tmp;
+     }
 
      /**
       * Operator: Subtraktion
       */
-     Matrix33 operator-(const Matrix33& b) const;
+     TMatrix33 operator-(const TMatrix33& b) const
+     {
+       return TMatrix33( v[0][0]-b.v[0][0], v[0][1]-b.v[0][1], v[0][2]-b.v[0][2],
+                         v[1][0]-b.v[1][0], v[1][1]-b.v[1][1], v[1][2]-b.v[1][2],
+                         v[2][0]-b.v[2][0], v[2][1]-b.v[2][1], v[2][2]-b.v[2][2] );
+     }
 
      /**
       * transponierte Matrix
       */
-     Matrix33 trans() const;
+     TMatrix33 trans() const
+     {
+       return(TMatrix33(v[0][0], v[1][0], v[2][0],
+                        v[0][1], v[1][1], v[2][1],
+                        v[0][2], v[1][2], v[2][2]));
+     }
 
      /**
-      *
+      * prints the matrix to std::cout (see matrix33.cpp)
       */
-     void print();
+     void print() const;
 
      /**
-      *
+      * prints the matrix to std::cout in one line
       */
-     void printLine();
+     void printLine() const;
 
   };
 /*}}}*/
+
+  typedef TMatrix33<double> Matrix33;
+  typedef TMatrix33<float>  Matrix33f;
 }
 #endif
@@ -193,16 +193,16 @@ void CRRCMath::Quaternion_002::step(double            dT,
 {
 //  std::cout << "length_A= " << length() << "\n";
 
-  // Gleichung (2.13) aus [1]:
-  double ep0 = 0.5 * (                   +omega.r[2]*e1.val -omega.r[1]*e2.val +omega.r[0]*e3.val);
-  double ep1 = 0.5 * (-omega.r[2]*e0.val                    +omega.r[0]*e2.val +omega.r[1]*e3.val);
-  double ep2 = 0.5 * (+omega.r[1]*e0.val -omega.r[0]*e1.val                    +omega.r[2]*e3.val);
-  double ep3 = 0.5 * (-omega.r[0]*e0.val -omega.r[1]*e1.val -omega.r[2]*e2.val                   );
+  double e[4];
+  double ep[4];
+
+  getComponents(e);
+  rates(e, omega, ep);
 
-  e0.step(dT, ep0);
-  e1.step(dT, ep1);
-  e2.step(dT, ep2);
-  e3.step(dT, ep3);
+  e0.step(dT, ep[0]);
+  e1.step(dT, ep[1]);
+  e2.step(dT, ep[2]);
+  e3.step(dT, ep[3]);
 
   // Lnge wird erzwungen:
   double inv_eps = 1/length();
@@ -217,6 +217,37 @@ void CRRCMath::Quaternion_002::step(double            dT,
   update_mat();
 }
 
+void CRRCMath::Quaternion_002::rates(const double*     e,
+                                     CRRCMath::Vector3 omega,
+                                     double*           e_dot)
+{
+  // Gleichung (2.13) aus [1]:
+  e_dot[0] = 0.5 * (                +omega.r[2]*e[1] -omega.r[1]*e[2] +omega.r[0]*e[3]);
+  e_dot[1] = 0.5 * (-omega.r[2]*e[0]                 +omega.r[0]*e[2] +omega.r[1]*e[3]);
+  e_dot[2] = 0.5 * (+omega.r[1]*e[0] -omega.r[0]*e[1]                 +omega.r[2]*e[3]);
+  e_dot[3] = 0.5 * (-omega.r[0]*e[0] -omega.r[1]*e[1] -omega.r[2]*e[2]                );
+}
+
+void CRRCMath::Quaternion_002::getComponents(double* e)
+{
+  e[0] = e0.val;
+  e[1] = e1.val;
+  e[2] = e2.val;
+  e[3] = e3.val;
+}
+
+void CRRCMath::Quaternion_002::setComponents(const double* e)
+{
+  double inv_eps = 1/sqrt(e[0]*e[0] + e[1]*e[1] + e[2]*e[2] + e[3]*e[3]);
+
+  e0.val = inv_eps*e[0];
+  e1.val = inv_eps*e[1];
+  e2.val = inv_eps*e[2];
+  e3.val = inv_eps*e[3];
+
+  update_mat();
+}
+
 void CRRCMath::Quaternion_002::update_mat()
 {
   // Matrix nach Gleichung (2.8) aus [1]:
@@ -149,6 +149,25 @@ namespace CRRCMath
       */
      void convTest1();
 
+     /**
+      * For integrators which keep their own state (see EOM_6DOF):
+      * copies the four components to e.
+      */
+     void getComponents(double* e);
+
+     /**
+      * Sets the four components, scales them to unity length and
+      * updates the matrix. Call updateEuler() if you need the angles.
+      */
+     void setComponents(const double* e);
+
+     /**
+      * Calculates the derivative e_dot of the components e, see step().
+      *
+      * @param omega Angular velocity (p, q, r)
+      */
+     static void rates(const double* e, CRRCMath::Vector3 omega, double* e_dot);
+
     private:
 
      Matrix33 initFromEuler(CRRCMath::Vector3 eul);
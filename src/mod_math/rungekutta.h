@@ -0,0 +1,253 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file rungekutta.h
+ *
+ *  Runge-Kutta schemes for the equations of motion: the classic fourth
+ *  order method with a fixed step and the embedded 5(4) pair by Dormand
+ *  and Prince with step size control.
+ *
+ *  [1] J. R. Dormand, P. J. Prince, 'A family of embedded Runge-Kutta
+ *      formulae', J. Comp. Appl. Math. 6 (1980), pp. 19-26
+ */
+#ifndef RUNGEKUTTA_H
+# define RUNGEKUTTA_H
+
+# include <math.h>
+# include <string>
+
+namespace CRRCMath
+{
+
+  /**
+   * Integration schemes which can be selected for the flight models
+   * (simulation.flightModel.integrator).
+   */
+  enum
+  {
+    INTEGRATOR_AB2 = 0,   ///< Adams-Bashforth, second order (see intgr.h)
+    INTEGRATOR_RK4,       ///< classic Runge-Kutta, fourth order
+    INTEGRATOR_RK45       ///< Dormand-Prince 5(4) with step size control
+  };
+
+  /**
+   * Integration scheme for a name from the configuration:
+   * "ab2", "rk4" or "rk45". Anything else gives INTEGRATOR_AB2.
+   */
+  inline int integratorByName(const std::string& name)
+  {
+    if (name == "rk4")
+      return(INTEGRATOR_RK4);
+    else if (name == "rk45")
+      return(INTEGRATOR_RK45);
+    else
+      return(INTEGRATOR_AB2);
+  }
+
+
+  /**
+   * State of a system with N components.
+   */
+  template <int N> class StateVector
+  {
+    public:
+      StateVector()
+      {
+        for (int i=0; i<N; i++)
+          v[i] = 0;
+      };
+
+      double&       operator[](int i)       { return(v[i]); };
+      const double& operator[](int i) const { return(v[i]); };
+
+      StateVector operator+(const StateVector& b) const
+      {
+        StateVector r;
+        for (int i=0; i<N; i++)
+          r.v[i] = v[i] + b.v[i];
+        return(r);
+      };
+
+      StateVector operator*(double d) const
+      {
+        StateVector r;
+        for (int i=0; i<N; i++)
+          r.v[i] = v[i] * d;
+        return(r);
+      };
+
+      StateVector& operator+=(const StateVector& b)
+      {
+        for (int i=0; i<N; i++)
+          v[i] += b.v[i];
+        return(*this);
+      };
+
+      double v[N];
+  };
+
+
+  /**
+   * A system of ordinary differential equations y' = f(y). Forces and
+   * inputs are held constant during one step, so f doesn't depend on
+   * the time.
+   */
+  template <int N> class ODESystem
+  {
+    public:
+      virtual ~ODESystem() {};
+
+      /**
+       * Calculate the derivative dydt of the state y.
+       */
+      virtual void derivative(const StateVector<N>& y, StateVector<N>& dydt) = 0;
+
+      /**
+       * Size of the local error err of a step starting at y, relative to
+       * the tolerance tol. The step is accepted if this is not larger
+       * than one. By default every component may have an error of
+       * tol * (1 + |y_i|).
+       */
+      virtual double errorNorm(const StateVector<N>& err, const StateVector<N>& y, double tol)
+      {
+        double e = 0;
+
+        for (int i=0; i<N; i++)
+        {
+          double ei = fabs(err.v[i]) / (tol * (1 + fabs(y.v[i])));
+
+          if (ei > e)
+            e = ei;
+        }
+        return(e);
+      };
+  };
+
+
+  /**
+   * One step of the classic Runge-Kutta method of fourth order.
+   * Four evaluations of the derivative.
+   *
+   * \param sys  system
+   * \param y    state, is replaced by the state after the step
+   * \param h    step size
+   */
+  template <int N> void stepRK4(ODESystem<N>& sys, StateVector<N>& y, double h)
+  {
+    StateVector<N> k1, k2, k3, k4;
+
+    sys.derivative(y,              k1);
+    sys.derivative(y + k1*(0.5*h), k2);
+    sys.derivative(y + k2*(0.5*h), k3);
+    sys.derivative(y + k3*h,       k4);
+
+    y += (k1 + k2*2 + k3*2 + k4) * (h/6);
+  }
+
+
+  /**
+   * Integrate over an interval T with the Dormand-Prince 5(4) pair from [1].
+   * The interval is split into as many steps as the error control
+   * requires; the last derivative of a step is the first one of the next
+   * step, so a step needs six evaluations.
+   *
+   * \param sys   system
+   * \param y     state, is replaced by the state at the end of the interval
+   * \param T     length of the interval
+   * \param h     step size to start with, returns the step size proposed
+   *              for the next interval. Limited to h_min...T.
+   * \param tol   tolerance, see ODESystem::errorNorm()
+   * \param h_min steps this short (or the remainder of the interval, if it
+   *              is up to 10% longer) are accepted regardless of the error
+   * \return      number of evaluations of the derivative
+   */
+  template <int N> int integrateRK45(ODESystem<N>& sys, StateVector<N>& y,
+                                     double T, double& h, double tol, double h_min)
+  {
+    StateVector<N> k1, k2, k3, k4, k5, k6, k7;
+    StateVector<N> y_new, err;
+    double         t     = 0;
+    int            nEval = 1;
+
+    if (h > T)
+      h = T;
+    if (h < h_min)
+      h = h_min;
+
+    sys.derivative(y, k1);
+
+    while (t < T)
+    {
+      // don't leave a tiny remainder for another step
+      bool   fLast = (T - t < 1.1*h);
+      double hs    = fLast ? T - t : h;
+      double e, f;
+
+      sys.derivative(y + k1*(hs/5), k2);
+      sys.derivative(y + (k1*(3.0/40) + k2*(9.0/40))*hs, k3);
+      sys.derivative(y + (k1*(44.0/45) + k2*(-56.0/15) + k3*(32.0/9))*hs, k4);
+      sys.derivative(y + (k1*(19372.0/6561) + k2*(-25360.0/2187) + k3*(64448.0/6561)
+                          + k4*(-212.0/729))*hs, k5);
+      sys.derivative(y + (k1*(9017.0/3168) + k2*(-355.0/33) + k3*(46732.0/5247)
+                          + k4*(49.0/176) + k5*(-5103.0/18656))*hs, k6);
+      y_new = y + (k1*(35.0/384) + k3*(500.0/1113) + k4*(125.0/192)
+                   + k5*(-2187.0/6784) + k6*(11.0/84))*hs;
+      sys.derivative(y_new, k7);
+      nEval += 6;
+
+      // difference between the fifth and the fourth order solution
+      err = (k1*(71.0/57600) + k3*(-71.0/16695) + k4*(71.0/1920)
+             + k5*(-17253.0/339200) + k6*(22.0/525) + k7*(-1.0/40))*hs;
+      e   = sys.errorNorm(err, y, tol);
+
+      // new step size, the local error is O(h^5)
+      f = (e > 0) ? 0.9*pow(e, -0.2) : 5;
+      if (f > 5)
+        f = 5;
+      if (!(f >= 0.2)) // NaN, too
+        f = 0.2;
+
+      if (e <= 1 || h <= h_min)
+      {
+        t  = fLast ? T : t + hs;
+        y  = y_new;
+        k1 = k7;
+
+        // a shortened last step says nothing about the step size
+        if (!fLast || hs*f > h)
+          h = hs*f;
+      }
+      else
+        h = hs*f;
+
+      if (h > T)
+        h = T;
+      if (h < h_min)
+        h = h_min;
+    }
+
+    return(nEval);
+  }
+
+}
+
+#endif
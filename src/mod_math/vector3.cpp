@@ -20,22 +20,16 @@
 #include "vector3.h"
 
 #include <iostream>
-#include <math.h>
 
 namespace CRRCMath
 {
-
-  double Vector3::length()
+  // not inline, so the header doesn't need <iostream>
+  template <typename T> void TVector3<T>::print(std::string pre, std::string post) const
   {
-    return(sqrt(
-                r[0]*r[0] + r[1]*r[1] + r[2]*r[2]
-                ));
-  }
+    // restored below, other output must not become fixed point
+    std::ios_base::fmtflags flags = std::cout.flags();
 
-  void Vector3::print(std::string pre, std::string post)
-  {
     std::cout.setf(std::ios_base::fixed, std::ios_base::floatfield);
-    //  std::cout.precision(2);
     std::cout << pre << "(";
 
     std::cout.width(7);
@@ -46,5 +40,13 @@ namespace CRRCMath
 
     std::cout.width(7);
     std::cout << r[2] << ")" << post;
+
+    std::cout.flags(flags);
   }
+
+  // Everything else is inline. Instantiating both types here provides
+  // print() and makes sure every member compiles even if nobody uses it
+  // yet.
+  template class TVector3<double>;
+  template class TVector3<float>;
 };
@@ -27,33 +27,37 @@
 namespace CRRCMath
 {
   /**
-   * A vector with one column and three rows of double values.
+   * A vector with one column and three rows.
+   *
+   * Everything is defined inline, so the compiler can keep the rows in
+   * registers and vectorize the flight model loops. Use Vector3 (double)
+   * or Vector3f (float).
    *
    * @author Jens Wilhelm Wulf
    */
-  class Vector3
+  template <typename T> class TVector3
   {
     public:
      /**
       * Rows 0, 1 and 2.
       */
-     double r[3];
+     T r[3];
 
     public:
 
-     Vector3()
+     TVector3()
      {
        r[0] = r[1] = r[2] = 0;
      }
 
-     Vector3(const Vector3& v)
+     TVector3(const TVector3& v)
      {
        r[0] = v.r[0];
        r[1] = v.r[1];
        r[2] = v.r[2];
      }
 
-     Vector3(double i0, double i1, double i2)
+     TVector3(T i0, T i1, T i2)
      {
        r[0] = i0;
        r[1] = i1;
@@ -62,9 +66,8 @@ namespace CRRCMath
 
      /**
       * Operator: Zuweisung
-      * \todo operator= not first checking for assignment to this
       */
-     Vector3& operator=(const Vector3& b)
+     TVector3& operator=(const TVector3& b)
      {
        r[0] = b.r[0];
        r[1] = b.r[1];
@@ -76,45 +79,45 @@ namespace CRRCMath
       * Operator: Scalarprodukt
       * Wichtig: n*Vector3 geht nicht, es muss Vector3*n benutzt werden!
       */
-     Vector3 operator*(const double scalar) const
+     TVector3 operator*(const T scalar) const
      {
-       return Vector3(scalar*r[0], scalar*r[1], scalar*r[2]);
+       return TVector3(scalar*r[0], scalar*r[1], scalar*r[2]);
      }
 
      /**
       * Operator: Kreuzprodukt
       */
-     Vector3 operator*(const Vector3& V) const
+     TVector3 operator*(const TVector3& V) const
      {
-       return Vector3( r[1] * V.r[2] - r[2] * V.r[1],
-                       r[2] * V.r[0] - r[0] * V.r[2],
-                       r[0] * V.r[1] - r[1] * V.r[0] );
+       return TVector3( r[1] * V.r[2] - r[2] * V.r[1],
+                        r[2] * V.r[0] - r[0] * V.r[2],
+                        r[0] * V.r[1] - r[1] * V.r[0] );
      }
 
      /**
       * Operator: Summe
       */
-     Vector3 operator+(const Vector3& V) const
+     TVector3 operator+(const TVector3& V) const
      {
-       return Vector3( r[0] + V.r[0],
-                       r[1] + V.r[1],
-                       r[2] + V.r[2] );
+       return TVector3( r[0] + V.r[0],
+                        r[1] + V.r[1],
+                        r[2] + V.r[2] );
      }
 
      /**
       * Operator: Differenz
       */
-     Vector3 operator-(const Vector3& V) const
+     TVector3 operator-(const TVector3& V) const
      {
-       return Vector3( r[0] - V.r[0],
-                       r[1] - V.r[1],
-                       r[2] - V.r[2] );
+       return TVector3( r[0] - V.r[0],
+                        r[1] - V.r[1],
+                        r[2] - V.r[2] );
      }
 
      /**
       * Operator: Addition
       */
-     Vector3 operator+=(const Vector3& V)
+     TVector3& operator+=(const TVector3& V)
      {
        r[0] += V.r[0];
        r[1] += V.r[1];
@@ -123,10 +126,22 @@ namespace CRRCMath
        return *this;
      }
 
+     /**
+      * Operator: Subtraktion
+      */
+     TVector3& operator-=(const TVector3& V)
+     {
+       r[0] -= V.r[0];
+       r[1] -= V.r[1];
+       r[2] -= V.r[2];
+
+       return *this;
+     }
+
      /**
       * Operator: Multiplication
       */
-     Vector3 operator*=(const double scalar)
+     TVector3& operator*=(const T scalar)
      {
        r[0] *= scalar;
        r[1] *= scalar;
@@ -135,12 +150,29 @@ namespace CRRCMath
        return *this;
      }
 
+     /**
+      * Skalarprodukt
+      */
+     T dot(const TVector3& V) const
+     {
+       return(r[0]*V.r[0] + r[1]*V.r[1] + r[2]*V.r[2]);
+     }
+
      /**
       * returns length of vector
       */
-     double length();
+     T length() const
+     {
+       return(sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]));
+     }
 
-     void print(std::string pre, std::string post);
+     /**
+      * prints the rows to std::cout (see vector3.cpp)
+      */
+     void print(std::string pre, std::string post) const;
   };
+
+  typedef TVector3<double> Vector3;
+  typedef TVector3<float>  Vector3f;
 }
 #endif
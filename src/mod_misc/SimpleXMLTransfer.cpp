@@ -33,18 +33,300 @@
  */
 
 #include "SimpleXMLTransfer.h"
+#include "filesystools.h"
 #include "lib_conversions.h"
 #include <ctype.h>
 #include <iostream>
 #include <cstdlib>
+#include <new>
+#include <stdio.h>
+#include <string.h>
 
 // 1: ?
 // 2: show compare
 #define DEBUG 0
 
-#if DEBUG != 0
-# include <stdio.h>
-#endif
+
+/**
+ * Elements with at least this many children or attributes get
+ * an index for looking them up by name.
+ */
+#define INDEX_MIN_SIZE 16
+
+/**
+ * Size of the first block of an arena which does not hold a file.
+ * The following blocks are twice as big, up to ARENA_MAX_BLOCK.
+ */
+#define ARENA_MIN_BLOCK 1024
+#define ARENA_MAX_BLOCK (256 * 1024)
+
+/**
+ * Alignment of everything but strings in an arena.
+ */
+#define ARENA_ALIGN 8
+
+/**
+ * "CRXB" and the version of the format written by toBinary(). The
+ * magic also tells a file written on a machine with another byte order.
+ */
+#define BINARY_MAGIC     (0x43525842)
+#define BINARY_VERSION   (1)
+
+/**
+ * Damaged binary data must not make readBinary() recurse endlessly.
+ */
+#define BINARY_MAX_DEPTH (1000)
+
+/**
+ * Value of attributes which have not been set yet.
+ */
+static char emptyValue[1] = { 0 };
+
+
+/**
+ * In front of every element, no matter whether it has been
+ * created with new or in an arena.
+ */
+typedef struct
+{
+  SimpleXMLArena* release;   ///< unref() this after the element has been deleted
+  long            fArena;    ///< element lives in an arena, don't free() it
+} T_ElementHeader;
+
+
+/**
+ * FNV-1a, for interned names and the indexes.
+ */
+static unsigned int hashName(const char* p, unsigned int len)
+{
+  unsigned int hash = 2166136261U;
+
+  for (unsigned int n = 0; n < len; n++)
+  {
+    hash ^= (unsigned char)p[n];
+    hash *= 16777619U;
+  }
+  return (hash);
+}
+
+static bool equalName(const char* p, unsigned int len, const std::string& name)
+{
+  return (len == name.length() && memcmp(p, name.data(), len) == 0);
+}
+
+
+/** \brief Memory of one document.
+ *
+ * Memory is taken from big blocks and only given back all at once,
+ * when the last element referencing the arena is deleted. Names are
+ * interned: every distinct name is stored only once per arena.
+ *
+ * The root element of a document holds a reference, as does every
+ * element created with new. Elements living in an arena don't, unless
+ * they have been added to an element of another document
+ * (SimpleXMLTransfer::fOwnRef). As long as no element from outside has
+ * been added to any element in the arena (fMixed), the destructor of
+ * the root element doesn't have to look at its children at all.
+ */
+class SimpleXMLArena
+{
+  public:
+    /**
+     * The arena starts with one reference.
+     */
+    SimpleXMLArena(size_t firstBlock);
+
+    void ref()   { nRefs++; };
+    void unref() { if (--nRefs == 0) delete this; };
+
+    void* alloc(size_t size, size_t align = ARENA_ALIGN);
+
+    /**
+     * Returns a copy of <code>p</code>, terminated by a 0.
+     */
+    char* copy(const char* p, size_t len);
+
+    /**
+     * Returns the copy of <code>p</code> which is stored in this arena,
+     * terminated by a 0.
+     */
+    const char* intern(const char* p, unsigned int len);
+
+    SimpleXMLTransfer* newElement(const char* descr);
+
+    bool fMixed;   ///< an element from somewhere else has been added
+
+  private:
+    ~SimpleXMLArena();
+
+    typedef struct T_Block
+    {
+      struct T_Block* next;
+      size_t          size;
+      size_t          used;
+    } T_Block;
+
+    typedef struct
+    {
+      const char*  p;
+      unsigned int len;
+      unsigned int hash;
+    } T_Name;
+
+    T_Block* newBlock(size_t size);
+
+    T_Block*     blocks;      ///< memory is taken from the first one
+    size_t       nextSize;
+    int          nRefs;
+    T_Name*      names;       ///< hash table of the interned names
+    unsigned int nNamesSize;  ///< power of 2
+    unsigned int nNames;
+};
+
+/**
+ * The data of a block starts this far behind T_Block.
+ */
+#define ARENA_BLOCK_HEADER ((sizeof(SimpleXMLArena::T_Block) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+SimpleXMLArena::SimpleXMLArena(size_t firstBlock)
+  : fMixed(false),
+    blocks((T_Block*) 0),
+    nextSize(firstBlock),
+    nRefs(1),
+    names((T_Name*) 0),
+    nNamesSize(0),
+    nNames(0)
+{
+}
+
+SimpleXMLArena::~SimpleXMLArena()
+{
+  while (blocks != (T_Block*) 0)
+  {
+    T_Block* next = blocks->next;
+
+    free(blocks);
+    blocks = next;
+  }
+}
+
+SimpleXMLArena::T_Block* SimpleXMLArena::newBlock(size_t size)
+{
+  T_Block* block = (T_Block*)malloc(ARENA_BLOCK_HEADER + size);
+
+  if (block == (T_Block*) 0)
+    throw std::bad_alloc();
+
+  block->next = (T_Block*) 0;
+  block->size = size;
+  block->used = 0;
+  return (block);
+}
+
+void* SimpleXMLArena::alloc(size_t size, size_t align)
+{
+  T_Block* block = blocks;
+
+  if (block != (T_Block*) 0)
+  {
+    size_t pos = (block->used + align - 1) & ~(align - 1);
+
+    if (pos + size <= block->size)
+    {
+      block->used = pos + size;
+      return ((char*)block + ARENA_BLOCK_HEADER + pos);
+    }
+  }
+
+  if (size > nextSize / 4)
+  {
+    // Big things (like the file) get a block of their own, the
+    // current block is still used for everything else.
+    block       = newBlock(size);
+    block->used = size;
+    if (blocks != (T_Block*) 0)
+    {
+      block->next  = blocks->next;
+      blocks->next = block;
+    }
+    else
+      blocks = block;
+  }
+  else
+  {
+    block       = newBlock(nextSize);
+    block->used = size;
+    block->next = blocks;
+    blocks      = block;
+    if (nextSize < ARENA_MAX_BLOCK)
+      nextSize *= 2;
+  }
+
+  return ((char*)block + ARENA_BLOCK_HEADER);
+}
+
+char* SimpleXMLArena::copy(const char* p, size_t len)
+{
+  char* s = (char*)alloc(len + 1, 1);
+
+  memcpy(s, p, len);
+  s[len] = 0;
+  return (s);
+}
+
+const char* SimpleXMLArena::intern(const char* p, unsigned int len)
+{
+  unsigned int hash = hashName(p, len);
+  unsigned int n;
+
+  if (2 * (nNames + 1) > nNamesSize)
+  {
+    unsigned int size = (nNamesSize == 0) ? 64 : 2 * nNamesSize;
+    T_Name*      tmp  = (T_Name*)alloc(size * sizeof(T_Name));
+
+    memset(tmp, 0, size * sizeof(T_Name));
+    for (unsigned int i = 0; i < nNamesSize; i++)
+    {
+      if (names[i].p != (const char*) 0)
+      {
+        n = names[i].hash & (size - 1);
+        while (tmp[n].p != (const char*) 0)
+          n = (n + 1) & (size - 1);
+        tmp[n] = names[i];
+      }
+    }
+    names      = tmp;
+    nNamesSize = size;
+  }
+
+  n = hash & (nNamesSize - 1);
+  while (names[n].p != (const char*) 0)
+  {
+    if (names[n].hash == hash && names[n].len == len &&
+        memcmp(names[n].p, p, len) == 0)
+      return (names[n].p);
+    n = (n + 1) & (nNamesSize - 1);
+  }
+
+  names[n].p    = copy(p, len);
+  names[n].len  = len;
+  names[n].hash = hash;
+  nNames++;
+
+  return (names[n].p);
+}
+
+SimpleXMLTransfer* SimpleXMLArena::newElement(const char* descr)
+{
+  T_ElementHeader* header;
+
+  header = (T_ElementHeader*)alloc(sizeof(T_ElementHeader) + sizeof(SimpleXMLTransfer));
+  header->release = (SimpleXMLArena*) 0;
+  header->fArena  = 1;
+
+  return (::new (header + 1) SimpleXMLTransfer(this, descr));
+}
+
 
 XMLException::XMLException(std::string message)
 {
@@ -56,363 +338,715 @@ const char *XMLException::what()
   return (myMessage.c_str());
 }
 
+void* SimpleXMLTransfer::operator new(size_t size)
+{
+  T_ElementHeader* header = (T_ElementHeader*)malloc(sizeof(T_ElementHeader) + size);
+
+  if (header == (T_ElementHeader*) 0)
+    throw std::bad_alloc();
+
+  header->release = (SimpleXMLArena*) 0;
+  header->fArena  = 0;
+  return (header + 1);
+}
+
+void SimpleXMLTransfer::operator delete(void* ptr)
+{
+  if (ptr != (void*) 0)
+  {
+    T_ElementHeader* header = (T_ElementHeader*)ptr - 1;
+
+    if (header->fArena == 0)
+      free(header);
+    else if (header->release != (SimpleXMLArena*) 0)
+      header->release->unref();
+  }
+}
+
 /**
  * Element ohne Daten erstellen.
  */
 SimpleXMLTransfer::SimpleXMLTransfer()
 {
-  myName      = "data";
-  content     = (std::string *) 0;
-  sourcedescr = "default constructor";
+  init("default constructor");
+  myName.p   = "data";
+  myName.len = 4;
 }
 
-SimpleXMLTransfer::SimpleXMLTransfer(std::istream & in, int data)
+SimpleXMLTransfer::SimpleXMLTransfer(SimpleXMLArena* home, const char* descr)
 {
-  content     = (std::string *) 0;
-  sourcedescr = "istream";
-  readStream(in, data);
+  init(descr);
+  arena    = home;
+  fInArena = true;
 }
 
 /**
  * Aus einer Datei lesen. <code>source</code> ist der Pfad zur Datei.
- * Wenn sie mit <code>file://</code> beginnt, wird eine lokale Datei gelesen, ansonsten
- * wird ein Netzwerkzugriff versucht.
- * Wenn der Name mit <code>.gz</code> endet, wird angenommen, dass die Datei mit GnuZip
- * gepackt ist.
+ * The whole file is read into the arena in one go and parsed there.
  */
 SimpleXMLTransfer::SimpleXMLTransfer(std::string source)
 {
-  std::ifstream in;
+  init("");
 
-  content = (std::string*) 0;
+  FILE* fp = fopen(source.c_str(), "r");
 
-  in.open(source.c_str());
-  sourcedescr = "file: " + source;
-
-  if (!in)
+  if (fp == NULL)
   {
-    throw XMLException("Error opening " + source);
+    // in a data pack?
+    std::string             item;
+    FileSysTools::Archive*  pack = FileSysTools::findArchive(source, item);
+    const char*             data;
+    unsigned long           size;
+
+    if (pack == NULL || (data = pack->open(item, size)) == NULL)
+      throw XMLException("Error opening " + source);
+
+    std::string descr = "file: " + source;
+
+    arena = new SimpleXMLArena((size > ARENA_MIN_BLOCK) ? size : ARENA_MIN_BLOCK);
+
+    // The parser works in place, so this needs a copy.
+    char* buffer = arena->copy(data, size);
+    pack->close(data);
+
+    sourcedescr.p   = arena->copy(descr.data(), descr.length());
+    sourcedescr.len = descr.length();
+
+    readSource(buffer, size);
   }
   else
   {
-    readStream(in, -2);
-    in.close();
+    std::string descr = "file: " + source;
+    char*       buffer;
+    long        size;
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 0)
+      size = 0;
+
+    arena = new SimpleXMLArena((size > ARENA_MIN_BLOCK) ? size : ARENA_MIN_BLOCK);
+
+    // In text mode, fewer characters than the size of the file
+    // may be read (CR/LF on Windows).
+    buffer = (char*)arena->alloc(size + 1, 1);
+    size   = fread(buffer, 1, size, fp);
+    fclose(fp);
+
+    sourcedescr.p   = arena->copy(descr.data(), descr.length());
+    sourcedescr.len = descr.length();
+
+    readSource(buffer, size);
+  }
+}
+
+SimpleXMLTransfer::SimpleXMLTransfer(std::istream& in)
+{
+  init("stream");
+
+  std::string buffer;
+  char        chunk[4096];
+
+  do
+  {
+    in.read(chunk, sizeof(chunk));
+    buffer.append(chunk, in.gcount());
+  } while (in);
+
+  arena = new SimpleXMLArena((buffer.length() > ARENA_MIN_BLOCK) ? buffer.length() : ARENA_MIN_BLOCK);
+  readSource(arena->copy(buffer.data(), buffer.length()), buffer.length());
+}
+
+SimpleXMLTransfer::SimpleXMLTransfer(SimpleXMLTransfer* source)
+{
+  init("copy constructor");
+  copyFrom(source);
+}
+
+SimpleXMLTransfer::~SimpleXMLTransfer()
+{
+  changed();
+
+  if (arena != (SimpleXMLArena*) 0)
+  {
+    // Elements from the arena are only visited to find those
+    // which have been added from somewhere else.
+    if (arena->fMixed)
+    {
+      for (int n = nChildren - 1; n >= 0; n--)
+        delete children[n];
+    }
+
+    if (fInArena == false)
+      arena->unref();
+    else if (fOwnRef)
+      ((T_ElementHeader*)this - 1)->release = arena;   // see operator delete
+  }
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::init(const char* descr)
+{
+  arena           = (SimpleXMLArena*) 0;
+  fInArena        = false;
+  fOwnRef         = false;
+  myName.p        = "";
+  myName.len      = 0;
+  sourcedescr.p   = descr;
+  sourcedescr.len = strlen(descr);
+  content         = (char*) 0;
+  nContentLen     = 0;
+  children        = (SimpleXMLTransfer**) 0;
+  nChildren       = 0;
+  nChildrenMax    = 0;
+  attrs           = (T_Attribute*) 0;
+  nAttrs          = 0;
+  nAttrsMax       = 0;
+  comments        = (T_Comment*) 0;
+  nComments       = 0;
+  nCommentsMax    = 0;
+  childIndex      = (int*) 0;
+  childIndexSize  = 0;
+  childIndexGen   = 0;
+  attrIndex       = (int*) 0;
+  attrIndexSize   = 0;
+  attrIndexGen    = 0;
+  nDocGeneration  = 0;
+  pGeneration     = &nDocGeneration;
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+SimpleXMLArena* SimpleXMLTransfer::getArena()
+{
+  if (arena == (SimpleXMLArena*) 0)
+    arena = new SimpleXMLArena(ARENA_MIN_BLOCK);
+
+  return (arena);
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+SimpleXMLTransfer* SimpleXMLTransfer::newChild(const std::string& name)
+{
+  SimpleXMLTransfer* child = getArena()->newElement("default constructor");
+
+  child->setName(name);
+  pushChild(child);
+  changed();
+
+  return (child);
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::copyFrom(SimpleXMLTransfer* source)
+{
+  setName(source->getName());
+
+  for (int n = 0; n < source->nAttrs; n++)
+  {
+    const T_Attribute& a = source->attrs[n];
+
+    setValue(newAttribute(a.name.p, a.name.len), a.val, a.len);
+  }
+
+  for (int n = 0; n < source->nChildren; n++)
+  {
+    SimpleXMLTransfer* child = getArena()->newElement(sourcedescr.p);
+
+    pushChild(child);
+    child->copyFrom(source->children[n]);
+  }
+  changed();
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::adoptChild(SimpleXMLTransfer* child)
+{
+  SimpleXMLArena* home = getArena();
+
+  if (child->arena != home || child->fInArena == false || child->fOwnRef)
+  {
+    home->fMixed = true;
+
+    if (child->fInArena && child->fOwnRef == false)
+    {
+      child->arena->ref();
+      child->fOwnRef = true;
+    }
+  }
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::pushChild(SimpleXMLTransfer* child)
+{
+  if (nChildren == nChildrenMax)
+  {
+    int                 nMax = (nChildrenMax < 4) ? 4 : 2 * nChildrenMax;
+    SimpleXMLTransfer** tmp;
+
+    tmp = (SimpleXMLTransfer**)getArena()->alloc(nMax * sizeof(SimpleXMLTransfer*));
+    if (nChildren > 0)
+      memcpy(tmp, children, nChildren * sizeof(SimpleXMLTransfer*));
+    children     = tmp;
+    nChildrenMax = nMax;
+  }
+  children[nChildren++] = child;
+  if (child->pGeneration != pGeneration)
+    child->setDocument(pGeneration);
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::eraseChild(int index)
+{
+  children[index]->detach();
+  memmove(children + index, children + index + 1,
+          (nChildren - index - 1) * sizeof(SimpleXMLTransfer*));
+  nChildren--;
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::setDocument(unsigned long* gen)
+{
+  // Indexes and paths which have been built with the old counter
+  // must not look valid with the new one.
+  if (*gen <= *pGeneration)
+    *gen = *pGeneration + 1;
+
+  pGeneration = gen;
+  for (int n = 0; n < nChildren; n++)
+    children[n]->setDocument(gen);
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::detach()
+{
+  setDocument(&nDocGeneration);
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+SimpleXMLTransfer::T_Attribute& SimpleXMLTransfer::newAttribute(const char*  name,
+                                                                unsigned int nameLen)
+{
+  SimpleXMLArena* home = getArena();
+
+  if (nAttrs == nAttrsMax)
+  {
+    int          nMax = (nAttrsMax < 4) ? 4 : 2 * nAttrsMax;
+    T_Attribute* tmp  = (T_Attribute*)home->alloc(nMax * sizeof(T_Attribute));
+
+    if (nAttrs > 0)
+      memcpy(tmp, attrs, nAttrs * sizeof(T_Attribute));
+    attrs     = tmp;
+    nAttrsMax = nMax;
+  }
+
+  T_Attribute& a = attrs[nAttrs];
+
+  a.name.p   = home->intern(name, nameLen);
+  a.name.len = nameLen;
+  a.val      = emptyValue;
+  a.len      = 0;
+  a.size     = 0;
+  nAttrs++;
+
+  return (a);
+}
+
+/**
+ * Nur zur internen Vewendung.
+ *
+ * The value is overwritten in place if it fits.
+ */
+void SimpleXMLTransfer::setValue(T_Attribute& attr, const char* val, unsigned int len)
+{
+  if (len + 1 > attr.size)
+  {
+    attr.val  = (char*)getArena()->alloc(len + 1, 1);
+    attr.size = len + 1;
+  }
+  memmove(attr.val, val, len);
+  attr.val[len] = 0;
+  attr.len      = len;
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::eraseAttribute(int index)
+{
+  memmove(attrs + index, attrs + index + 1,
+          (nAttrs - index - 1) * sizeof(T_Attribute));
+  nAttrs--;
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::pushComment(const char* text, unsigned int len, int nPos)
+{
+  if (nComments == nCommentsMax)
+  {
+    int        nMax = (nCommentsMax < 2) ? 2 : 2 * nCommentsMax;
+    T_Comment* tmp  = (T_Comment*)getArena()->alloc(nMax * sizeof(T_Comment));
+
+    if (nComments > 0)
+      memcpy(tmp, comments, nComments * sizeof(T_Comment));
+    comments     = tmp;
+    nCommentsMax = nMax;
+  }
+  comments[nComments].text.p   = text;
+  comments[nComments].text.len = len;
+  comments[nComments].pos      = nPos;
+  nComments++;
+}
+
+/**
+ * Nur zur internen Vewendung.
+ *
+ * Parses a document which has been read into the arena. The buffer
+ * is changed in the process: values are converted and terminated
+ * where they are.
+ */
+void SimpleXMLTransfer::readSource(char* buffer, unsigned int len)
+{
+  std::vector<SimpleXMLTransfer*> stack;
+  char*                           p = buffer;
+
+  buffer[len] = 0;
+
+  try
+  {
+    readBuffer(p, buffer + len, false, stack);
+  }
+  catch (...)
+  {
+    // The destructor won't be called, this frees all elements.
+    arena->unref();
+    throw;
+  }
+}
+
+/**
+ * Nur zur internen Vewendung.
+ *
+ * Parses one element from a buffer which holds the whole document.
+ * Names, values and text are scanned for their end and taken in
+ * one piece instead of character by character. If <code>fChild</code>
+ * is <code>true</code>, <code>p</code> points to the first character
+ * of the name (behind the '<'), otherwise anything up to the root
+ * element is skipped, except comments. Returns with <code>p</code>
+ * behind the end of the element.
+ *
+ * The children are collected on <code>stack</code> and copied to the
+ * arena when the element is complete.
+ */
+void SimpleXMLTransfer::readBuffer(char*&  p,
+                                   char*   end,
+                                   bool    fChild,
+                                   std::vector<SimpleXMLTransfer*>& stack)
+{
+  char* q;
+
+  if (fChild == false)
+  {
+    // Auf eine oeffnende Klammer warten, Inittag und Kommentare ueberspringen.
+    while (true)
+    {
+      q = (char*)memchr(p, '<', end - p);
+      if (q == NULL || q + 1 >= end)
+        throwNotClosed();
+      p = q + 1;
+
+      if (*p == '?')
+      {
+        q = (char*)memchr(p, '>', end - p);
+        if (q == NULL)
+          throwNotClosed();
+        p = q + 1;
+      }
+      else if (*p == '!')
+        readComment(++p, end, -1);
+      else
+        break;
+    }
+  }
+
+  // Den Namen einlesen. The first character is always part of it.
+  q = p + 1;
+  while (q < end && *q != '=' && *q != '/' && *q != '>' &&
+         *q != ' ' && *q != '\n' && *q != '\r' && *q != '\t')
+    q++;
+  myName.p   = arena->intern(p, q - p);
+  myName.len = q - p;
+  p = q;
+
+  if (p >= end)
+    throwNotClosed();
+  if (*p == '=')
+    throw XMLException("Found \'=\' without preceding attributename in " + getName());
+
+  if (*p++ != '>')
+  {
+    // Attribute
+    const char*  attributename = p;
+    unsigned int nNameLen      = 0;
+    int          nQuotes       = 0;
+
+    // make room for all attributes at once
+    for (q = p; q < end && (*q != '>' || (nQuotes & 1)); q++)
+      if (*q == '"')
+        nQuotes++;
+    if (nQuotes >= 2)
+    {
+      attrs     = (T_Attribute*)arena->alloc((nQuotes / 2) * sizeof(T_Attribute));
+      nAttrsMax = nQuotes / 2;
+    }
+
+    while (true)
+    {
+      if (p >= end)
+        throwNotClosed();
+
+      if (*p == '=')
+      {
+        if (nNameLen == 0)
+        {
+          // Es wurde versucht, einen Wert zuzuweisen, obwohl noch kein Attribut
+          // definiert wurde.
+          // Vielleicht wurde versucht, dem Element einen Wert zuzuweisen?
+          throw XMLException("Found \'=\' without preceding attributename in " + getName());
+        }
+
+        // the value starts behind the next quote
+        q = (char*)memchr(p, '"', end - p);
+        if (q == NULL)
+          throwNotClosed();
+        p = q + 1;
+        q = (char*)memchr(p, '"', end - p);
+        if (q == NULL)
+          throwNotClosed();
+
+        // The value stays where it is. Entities are rare, and the
+        // converted value is never longer than the original.
+        unsigned int nValLen = q - p;
+
+        if (memchr(p, '&', q - p) != NULL)
+        {
+          std::string val = convFromXML(std::string(p, q));
+
+          nValLen = val.length();
+          memcpy(p, val.data(), nValLen);
+        }
+
+        T_Attribute& a = newAttribute(attributename, nNameLen);
+
+        a.val  = p;
+        a.len  = nValLen;
+        a.size = q - p + 1;
+        p[nValLen] = 0;
+
+        nNameLen = 0;
+        p = q + 1;
+      }
+      else if (*p == '>')
+      {
+        if (p[-1] == '/')
+        {
+          // <element ... />
+          p++;
+          trimContent();
+          return;
+        }
+        p++;
+        break;
+      }
+      else if (isspace((unsigned char)*p) == false)
+      {
+        for (q = p; q < end && *q != '=' && *q != '>' && isspace((unsigned char)*q) == false; q++)
+          ;
+        attributename = p;
+        nNameLen      = q - p;
+        p = q;
+      }
+      else if (nNameLen > 0)
+      {
+        // Ich hatte bereits einen Namen eingelesen, jetzt kommt Whitespace.
+        // Also ist der Name beendet, es muss jetzt das Gleichheitszeichen
+        // und der Wert kommen.
+        while (p < end && isspace((unsigned char)*p))
+          p++;
+        if (p < end && *p != '=')
+        {
+          throw XMLException("Element " + getName() +
+                             ": expected \'=\', got \'" + *p +
+                             "\' after attribute " +
+                             std::string(attributename, nNameLen));
+        }
+      }
+      else
+        p++;
+    }
   }
-}
 
-SimpleXMLTransfer::SimpleXMLTransfer(std::istream& in)
-{
-  content = (std::string*) 0;
-  sourcedescr = "stream";
-  readStream(in, -2);
-}
+  // Inhalt, Kinder und Kommentare bis zum End-Tag
+  unsigned int nFirstChild = stack.size();
 
-SimpleXMLTransfer::SimpleXMLTransfer(SimpleXMLTransfer* source)
-{
-  content     = (std::string *) 0;
-  sourcedescr = "copy constructor";
+  while (true)
+  {
+    q = (char*)memchr(p, '<', end - p);
+    if (q == NULL)
+      q = end;
 
-  setName(source->getName());
+    if (content == (char*) 0)
+    {
+      while (p < q && isspace((unsigned char)*p))
+        p++;
+    }
+    if (p < q)
+      appendContent(p, q);
 
-  for (int n=0; n<source->getAttributeCount(); n++)
-    addAttribute(source->attributeName(n), source->attributeVal(n));
+    p = q + 1;
+    if (p >= end)
+      throwNotClosed();
 
-  for (int n=0; n<source->getChildCount(); n++)
-    addChild(new SimpleXMLTransfer(source->getChildAt(n)));
-}
+    if (*p == '/')
+    {
+      // Ich pruefe, ob auch mein Name wieder korrekt im End-Tag steht.
+      q = (char*)memchr(p, '>', end - p);
+      if (q == NULL)
+        throwNotClosed();
 
-SimpleXMLTransfer::~SimpleXMLTransfer()
-{
-  SimpleXMLTransfer *tmp;
+      if ((unsigned int)(q - p - 1) != myName.len ||
+          memcmp(p + 1, myName.p, myName.len) != 0)
+      {
+        throw XMLException("XML-Element " + getName()
+                           +
+                           " wurde nicht korrekt abgeschlossen: "
+                           + std::string(p + 1, q));
+      }
+      p = q + 1;
+      trimContent();
 
-  if (content != (std::string*) 0)
-    delete content;
+      nChildren = nChildrenMax = stack.size() - nFirstChild;
+      if (nChildren > 0)
+      {
+        children = (SimpleXMLTransfer**)arena->alloc(nChildren * sizeof(SimpleXMLTransfer*));
+        memcpy(children, &stack[nFirstChild], nChildren * sizeof(SimpleXMLTransfer*));
+        stack.resize(nFirstChild);
+      }
+      return;
+    }
+    else if (*p == '!')
+      readComment(++p, end, stack.size() - nFirstChild);
+    else
+    {
+      SimpleXMLTransfer* child = arena->newElement("istream");
 
-  while (children.size() > 0)
-  {
-    tmp = children[children.size() - 1];
-    delete tmp;
-    children.pop_back();
+      child->pGeneration = pGeneration;
+      child->readBuffer(p, end, true, stack);
+      stack.push_back(child);
+    }
   }
 }
 
 /**
  * Nur zur internen Vewendung.
+ *
+ * Reads a comment. <code>p</code> points behind "<!", the comment ends
+ * with "-->". The text is left in the buffer.
  */
-void SimpleXMLTransfer::readStream(std::istream & in, int data)
+void SimpleXMLTransfer::readComment(char*& p, char* end, int nPos)
 {
-  bool fLesen = true;
-  bool fGeschlossen = false;
-
-  std::string name;
-//  std::string value;
-  std::string myComment;
-  char c0 = ' ';
-  char c1 = ' ';
-  char c2 = ' ';
-  T_State nState;
-  T_State nStateAfterComment = STATE_IDLE;
-  std::string endTagName;
+  char* start = p;
+  char* q     = p;
 
-  std::string attributename;
-  std::string attributeval;
-
-  if (data != -2)
+  while (true)
   {
-    nState = STATE_READNAME;
-    myName = "";
-    myName.push_back((char) data);
+    q = (char*)memchr(q, '>', end - q);
+    if (q == NULL)
+      throwNotClosed();
+    if (q - start >= 2 && q[-1] == '-' && q[-2] == '-')
+      break;
+    q++;
   }
-  else
-    nState = STATE_IDLE;
-
-  while (fLesen)
-  {
-    data = in.get();
-
-    if (data < 0)
-      fLesen = false;
-    else
-    {
-      c0 = (char) data;
-      switch (nState)
-      {
-          // Auf eine ffnende Klammer warten.
-        case STATE_IDLE:
-          if (c0 == '<')
-            nState = STATE_START;
-          break;
-
-          //
-        case STATE_START:
-          if (c0 == '?')
-            nState = STATE_INITTAG;
-          else if (c0 == '!')
-          {
-            nStateAfterComment = STATE_IDLE;
-            nState = STATE_COMMENT;
-            myComment = "<!";
-          }
-          else
-          {
-            nState = STATE_READNAME;
-            myName = "";
-            myName.push_back(c0);
-          }
-          break;
-
-          // Das Ende vom Inittag abwarten.
-        case STATE_INITTAG:
-          if (c0 == '>')
-            nState = STATE_IDLE;
-          break;
-
-          // Das Ende vom Kommentar abwarten.
-        case STATE_COMMENT:
-          myComment.push_back(c0);
-          if (c0 == '>' && c1 == '-' && c2 == '-')
-          {
-            comment.push_back(myComment);
-            if (nStateAfterComment == STATE_IDLE)
-              commentPos.push_back(-1);
-            else
-              commentPos.push_back(children.size());
-            nState = nStateAfterComment;
-          }
-          break;
-
-          // Den Namen einlesen
-        case STATE_READNAME:
-          if (c0 == '=')
-          {
-            throw
-            XMLException
-            ("Found \'=\' without preceding attributename in " +
-             myName);
-          }
-          else
-            if ((c0 == '/' || c0 == ' ' || c0 == '\n' || c0 == '\r'
-                 || c0 == '\t') && myName.length() > 0)
-            {
-              nState = STATE_ATTR_NAME;
-              attributename = "";
-            }
-            else
-            {
-              if (c0 == '>')
-              {
-                nState = STATE_WAIT_CONT;
-              }
-              else
-                myName.push_back(c0);
-            }
-          break;
-
-        case STATE_ATTR_NAME:
-          if (c0 == '=')
-          {
-            if (attributename.length() == 0)
-            {
-              // Es wurde versucht, einen Wert zuzuweisen, obwohl noch kein Attribut
-              // definiert wurde.
-              // Vielleicht wurde versucht, dem Element einen Wert zuzuweisen?
-              throw
-              XMLException
-              ("Found \'=\' without preceding attributename in " +
-               myName);
-            }
-            nState = STATE_ATTR_VAL_START;
-          }
-          else
-          {
-            if (c0 == '>')
-            {
-              if (c1 == '/')
-              {
-                fGeschlossen = true;
-                fLesen = false;
-              }
-              else
-                nState = STATE_WAIT_CONT;
-            }
-            else
-            {
-              if (isspace(c0) == false)
-                attributename.push_back(c0);
-              else
-              {
-                if (attributename.length() > 0)
-                {
-                  // Ich hatte bereits einen Namen eingelesen, jetzt kommt Whitespace.
-                  // Also ist der Name beendet, es muss jetzt das Gleichheitszeichen
-                  // und der Wert kommen.
-                  nState = STATE_ATTR_VAL_WAIT_EQ;
-                }
-              }
-            }
-          }
-          break;
-
-        case STATE_ATTR_VAL_WAIT_EQ:
-          if (c0 == '=')
-            nState = STATE_ATTR_VAL_START;
-          else if (isspace(c0) == false)
-          {
-            throw XMLException("Element " + myName +
-                               ": expected \'=\', got \'" + c0 +
-                               "\' after attribute " + attributename);
-          }
-          break;
-
-        case STATE_ATTR_VAL_START:
-          if (c0 == '"')
-          {
-            attributeval = "";
-            nState = STATE_ATTR_VAL;
-          }
-          break;
-
-        case STATE_ATTR_VAL:
-          if (c0 == '"')
-          {
-            if (attributename.length() > 0)
-              addAttribute(attributename, convFromXML(attributeval));
-            attributeval = "";
-
-            nState = STATE_ATTR_NAME;
-            attributename = "";
-          }
-          else
-            attributeval.push_back(c0);
-          break;
-
-        case STATE_WAIT_CONT:
-          if (c0 == '<')
-            nState = STATE_CONT_START;
-          else
-          {
-            if (content == (std::string *) 0 && isspace(c0) == false)
-              content = new std::string();
-            if (content != (std::string *) 0)
-              content->push_back(c0);
-          }
-          break;
-
-        case STATE_CONT_START:
-          if (c0 == '/')
-            nState = STATE_ENDTAG;
-          else if (c0 == '!')
-          {
-            nStateAfterComment = STATE_WAIT_CONT;
-            nState = STATE_COMMENT;
-            myComment = "<!";
-          }
-          else
-          {
-            SimpleXMLTransfer *child =
-              new SimpleXMLTransfer(in, (int) c0);
-            addChild(child);
-            nState = STATE_WAIT_CONT;
-          }
-          break;
+  p = q + 1;
 
-          // Ich warte auf das Ende und berprfe, ob auch
-          // mein Name wieder korrekt im End-Tag steht.
-        case STATE_ENDTAG:
-          if (c0 == '>')
-          {
-            if (endTagName.compare(getName()) == 0)
-            {
-              fGeschlossen = true;
-              fLesen = false;
-            }
-            else
-            {
-              throw XMLException("XML-Element " + getName()
-                                 +
-                                 " wurde nicht korrekt abgeschlossen: "
-                                 + endTagName);
-            }
-          }
-          else
-            endTagName.push_back(c0);
-          break;
+  pushComment(start - 2, p - (start - 2), nPos);
+}
 
-        default:
-          break;
-      }
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::appendContent(const char* p, const char* end)
+{
+  unsigned int len = end - p;
+  char*        tmp = (char*)getArena()->alloc(nContentLen + len + 1, 1);
 
-      c2 = c1;
-      c1 = c0;
-    }
-  }
+  if (content != (char*) 0)
+    memcpy(tmp, content, nContentLen);
+  memcpy(tmp + nContentLen, p, len);
+  nContentLen     += len;
+  tmp[nContentLen] = 0;
+  content          = tmp;
+}
 
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::trimContent()
+{
 #if DEBUG == 1
-  if (content != (std::string *) 0)
-    printf("Content length=%i: %s", content->length(), content->c_str());
+  if (content != (char*) 0)
+    printf("Content length=%i: %s", nContentLen, content);
   else
     printf("No content\n");
 #endif
 
   // trailing whitespace vom content entfernen
-  if (content != (std::string *) 0)
-    while (content->length() > 0
-           && isspace(content->at(content->length() - 1)) == true)
-      content->replace(content->length() - 1, 1, "");
-
-  if (fGeschlossen == false)
+  if (content != (char*) 0)
   {
-    throw XMLException(sourcedescr + ": XML-Element wurde nicht abgeschlossen: " +
-                       getName());
+    while (nContentLen > 0
+           && isspace(content[nContentLen - 1]) == true)
+      nContentLen--;
+    content[nContentLen] = 0;
   }
 }
 
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::throwNotClosed()
+{
+  throw XMLException(getSourceDescr() + ": XML-Element wurde nicht abgeschlossen: " +
+                     getName());
+}
+
 /**
  * Liefert den Namen des Elements zurck.
  */
 std::string SimpleXMLTransfer::getName()
 {
-  return (myName);
+  return (std::string(myName.p, myName.len));
 }
 
 /**
@@ -420,8 +1054,8 @@ std::string SimpleXMLTransfer::getName()
  */
 std::string SimpleXMLTransfer::getContentString()
 {
-  if (content != (std::string *) 0)
-    return (*content);
+  if (content != (char*) 0)
+    return (std::string(content, nContentLen));
   else
     return ("");
 }
@@ -441,7 +1075,7 @@ SimpleXMLTransfer::attributeAsDouble(std::string attr, double defaultVal)
   }
   else
   {
-    return (convToDouble(attrVal[index]));
+    return (convToDouble(attrs[index].val));
   }
 }
 
@@ -451,13 +1085,13 @@ SimpleXMLTransfer::attributeAsDouble(std::string attr, double defaultVal)
  */
 double SimpleXMLTransfer::attributeAsDouble(unsigned int index)
 {
-  if (index > attrName.size())
+  if (index > (unsigned int)nAttrs)
   {
     throw XMLException("No such attribute in " + getName());
   }
   else
   {
-    return (convToDouble(attrVal[index]));
+    return (convToDouble(attrs[index].val));
   }
 }
 
@@ -475,7 +1109,7 @@ double SimpleXMLTransfer::attributeAsDouble(std::string attr)
   }
   else
   {
-    return (convToDouble(attrVal[index]));
+    return (convToDouble(attrs[index].val));
   }
 }
 
@@ -484,7 +1118,7 @@ double SimpleXMLTransfer::attributeAsDouble(std::string attr)
  */
 double SimpleXMLTransfer::getContentDouble()
 {
-  return (convToDouble(*content));
+  return (convToDouble((content != (char*) 0) ? content : ""));
 }
 
 /**
@@ -492,7 +1126,7 @@ double SimpleXMLTransfer::getContentDouble()
  */
 int SimpleXMLTransfer::getContentInt()
 {
-  return (convToInt(*content));
+  return (convToInt((content != (char*) 0) ? content : ""));
 }
 
 /**
@@ -698,12 +1332,7 @@ void SimpleXMLTransfer::setAttribute(std::string attribute, std::string value)
 
       index = item->indexOfChild(childName);
       if (index < 0)
-      {
-        SimpleXMLTransfer* tmp = new SimpleXMLTransfer();
-        tmp->setName(childName);
-        item->addChild(tmp);
-        item = tmp;
-      }
+        item = item->newChild(childName);
       else
         item = item->getChildAt(index);
     }
@@ -740,12 +1369,7 @@ void SimpleXMLTransfer::setAttributeOverwrite(std::string attribute, std::string
 
       index = item->indexOfChild(childName);
       if (index < 0)
-      {
-        SimpleXMLTransfer* tmp = new SimpleXMLTransfer();
-        tmp->setName(childName);
-        item->addChild(tmp);
-        item = tmp;
-      }
+        item = item->newChild(childName);
       else
         item = item->getChildAt(index);
     }
@@ -757,11 +1381,17 @@ void SimpleXMLTransfer::setAttributeOverwrite(std::string attribute, std::string
     int index = indexOfAttribute(attribute);
     if (index >= 0)
     {
-      attrName.erase(attrName.begin() + index);
-      attrVal.erase(attrVal.begin() + index);
+      // Move it to the end, like removing and adding it again.
+      // The memory of the value is used again.
+      T_Attribute a = attrs[index];
+
+      eraseAttribute(index);
+      attrs[nAttrs++] = a;
+      setValue(attrs[nAttrs - 1], value.data(), value.length());
+      changed();
     }
-
-    addAttribute(attribute, value);
+    else
+      addAttribute(attribute, value);
   }
 }
 
@@ -786,12 +1416,7 @@ void SimpleXMLTransfer::makeSureAttributeExists(std::string attribute, const cha
 
       index = item->indexOfChild(childName);
       if (index < 0)
-      {
-        SimpleXMLTransfer* tmp = new SimpleXMLTransfer();
-        tmp->setName(childName);
-        item->addChild(tmp);
-        item = tmp;
-      }
+        item = item->newChild(childName);
       else
         item = item->getChildAt(index);
     }
@@ -930,8 +1555,9 @@ SimpleXMLTransfer::addAttribute(std::string attributeName,
 {
   //       System.out.println("SimpleXMLTransfer.addAttribute(" + attributeName + ", " + attributeVal + ")");
   //
-  attrName.push_back(attributeName);
-  attrVal.push_back(attributeVal);
+  setValue(newAttribute(attributeName.data(), attributeName.length()),
+           attributeVal.data(), attributeVal.length());
+  changed();
 }
 
 /**
@@ -951,7 +1577,9 @@ SimpleXMLTransfer::addAttribute(std::string attributeName,
  */
 void SimpleXMLTransfer::addChild(SimpleXMLTransfer * child)
 {
-  children.push_back(child);
+  adoptChild(child);
+  pushChild(child);
+  changed();
 }
 
 void SimpleXMLTransfer::print()
@@ -982,9 +1610,9 @@ void SimpleXMLTransfer::print(std::ostream & out, int nIndent)
 {
   int nCMax = -1;
 
-  if (comment.size() > 0 && commentPos[0] == -1)
+  if (nComments > 0 && comments[0].pos == -1)
   {
-    print(out, nIndent, comment[0] + "\n");
+    print(out, nIndent, std::string(comments[0].text.p, comments[0].text.len) + "\n");
     nCMax = 0;
   }
 
@@ -995,16 +1623,16 @@ void SimpleXMLTransfer::print(std::ostream & out, int nIndent)
     print(out, nIndent, "<" + getName());
 
     // Attribute schreiben
-    if (attrName.size() > 0)
+    if (nAttrs > 0)
     {
       int nSpalte = nIndent * 2 + getName().length();
       std::string aVal;
       std::string aName;
 
-      for (unsigned int i = 0; i < attrName.size(); i++)
+      for (int i = 0; i < nAttrs; i++)
       {
-        aVal = convToXML(attrVal[i]);
-        aName = attrName[i];
+        aVal = convToXML(std::string(attrs[i].val, attrs[i].len));
+        aName.assign(attrs[i].name.p, attrs[i].name.len);
 
         if (nSpalte + aVal.length() + aName.length() > 80)
         {
@@ -1023,39 +1651,39 @@ void SimpleXMLTransfer::print(std::ostream & out, int nIndent)
       }
     }
 
-    if (content != (std::string *) 0 || children.size() > 0)
+    if (content != (char*) 0 || nChildren > 0)
     {
       out << ">";
 
       // Wenn ich irgendwelchen Inhalt habe, schreibe ich den vor den Kindern
       // und den Kommentaren.
-      if (content != (std::string *) 0)
+      if (content != (char*) 0)
       {
         out << getContentString();
       }
 
-      if (comment.size() > (unsigned int)(nCMax+1))
+      if (nComments > nCMax+1)
       {
-        if (commentPos[nCMax+1] == 0)
+        if (comments[nCMax+1].pos == 0)
         {
           nCMax++;
           out << "\n";
-          print(out, nIndent, comment[nCMax]);
+          print(out, nIndent, std::string(comments[nCMax].text.p, comments[nCMax].text.len));
         }
       }
 
       // Die Kinder sollen ihre Daten schreiben, falls es welche gibt.
-      if (children.size() > 0)
+      if (nChildren > 0)
       {
         out << "\n";
 
-        for (unsigned int i = 0; i < children.size(); i++)
+        for (int i = 0; i < nChildren; i++)
         {
           children[i]->print(out, nIndent + 1);
-          for (unsigned int m=0; m<comment.size(); m++)
+          for (int m=0; m<nComments; m++)
           {
-            if (commentPos[m] == (int)i+1)
-              print(out, nIndent, comment[m] + "\n");
+            if (comments[m].pos == i+1)
+              print(out, nIndent, std::string(comments[m].text.p, comments[m].text.len) + "\n");
           }
         }
 
@@ -1076,7 +1704,7 @@ void SimpleXMLTransfer::print(std::ostream & out, int nIndent)
  */
 SimpleXMLTransfer *SimpleXMLTransfer::getChildAt(int childIndex)
 {
-  if (children.size() == 0)
+  if (nChildren == 0)
     return ((SimpleXMLTransfer *) 0);
   return (children[childIndex]);
 }
@@ -1086,7 +1714,7 @@ SimpleXMLTransfer *SimpleXMLTransfer::getChildAt(int childIndex)
  */
 int SimpleXMLTransfer::getChildCount()
 {
-  return (children.size());
+  return (nChildren);
 }
 
 /**
@@ -1103,7 +1731,7 @@ int SimpleXMLTransfer::attributeAsInt(std::string attr)
   }
   else
   {
-    return (convToInt(attrVal[index]));
+    return (convToInt(attrs[index].val));
   }
 }
 
@@ -1121,7 +1749,7 @@ int SimpleXMLTransfer::attributeAsInt(std::string attr, int defaultVal)
   }
   else
   {
-    return (convToInt(attrVal[index]));
+    return (convToInt(attrs[index].val));
   }
 }
 
@@ -1139,7 +1767,7 @@ float SimpleXMLTransfer::attributeAsFloat(std::string attr)
   }
   else
   {
-    return (convToFloat(attrVal[index]));
+    return (convToFloat(attrs[index].val));
   }
 }
 
@@ -1155,7 +1783,7 @@ std::string SimpleXMLTransfer::attribute(std::string attr,
   if (index < 0)
     return (defaultVal);
   else
-    return (attrVal[index]);
+    return (std::string(attrs[index].val, attrs[index].len));
 }
 
 /**
@@ -1172,7 +1800,7 @@ std::string SimpleXMLTransfer::attribute(std::string attr)
   }
   else
   {
-    return (attrVal[index]);
+    return (std::string(attrs[index].val, attrs[index].len));
   }
 }
 
@@ -1180,19 +1808,26 @@ std::string SimpleXMLTransfer::attribute(std::string attr)
  * Liefert den Index des ersten Attributes mit dem Namen
  * <code>attr</code> zurck oder -1, wenn es keins gibt.
  */
-int SimpleXMLTransfer::indexOfAttribute(std::string attr) const
+int SimpleXMLTransfer::indexOfAttribute(const std::string& attr) const
 {
 #if DEBUG == 1
   printf("int SimpleXMLTransfer::indexOfAttribute(\"%s\")\n", attr.c_str());
 #endif
-  if (attrName.size() == 0)
-    return (-1);
-
   int index = -1;
 
-  for (unsigned int i = 0; i < attrName.size() && index == -1; i++)
-    if (attr.compare(attrName[i]) == 0)
-      index = i;
+  if (nAttrs >= INDEX_MIN_SIZE)
+  {
+    if (attrIndex == (int*) 0 || attrIndexGen != *pGeneration)
+      buildIndex(attrIndex, attrIndexSize, attrIndexGen, false);
+
+    index = findInIndex(attrIndex, attrIndexSize, attr, false);
+  }
+  else
+  {
+    for (int i = 0; i < nAttrs && index == -1; i++)
+      if (equalName(attrs[i].name.p, attrs[i].name.len, attr))
+        index = i;
+  }
 
 #if DEBUG == 1
   printf("int SimpleXMLTransfer::indexOfAttribute(\"%s\") = %i\n",
@@ -1201,22 +1836,87 @@ int SimpleXMLTransfer::indexOfAttribute(std::string attr) const
   return (index);
 }
 
-double SimpleXMLTransfer::convToDouble(std::string value)
+/**
+ * Nur zur internen Vewendung.
+ *
+ * Open addressing, an entry holds the index + 1 of the first child or
+ * attribute with a name. The table is reused if it is big enough.
+ */
+void SimpleXMLTransfer::buildIndex(int*&          index,
+                                   unsigned int&  size,
+                                   unsigned long& gen,
+                                   bool           fChildren) const
+{
+  int          n    = fChildren ? nChildren : nAttrs;
+  unsigned int need = 2 * INDEX_MIN_SIZE;
+
+  while (need < 2 * (unsigned int)n)
+    need *= 2;
+
+  if (size < need)
+  {
+    index = (int*)arena->alloc(need * sizeof(int));
+    size  = need;
+  }
+  memset(index, 0, size * sizeof(int));
+
+  for (int i = 0; i < n; i++)
+  {
+    const T_Str& name = nameAt(i, fChildren);
+    unsigned int h    = hashName(name.p, name.len) & (size - 1);
+
+    // keeps the first one of several with the same name
+    while (index[h] != 0)
+    {
+      const T_Str& other = nameAt(index[h] - 1, fChildren);
+
+      if (other.len == name.len && memcmp(other.p, name.p, name.len) == 0)
+        break;
+      h = (h + 1) & (size - 1);
+    }
+    if (index[h] == 0)
+      index[h] = i + 1;
+  }
+  gen = *pGeneration;
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+int SimpleXMLTransfer::findInIndex(const int*         index,
+                                   unsigned int       size,
+                                   const std::string& name,
+                                   bool               fChildren) const
+{
+  unsigned int h = hashName(name.data(), name.length()) & (size - 1);
+
+  while (index[h] != 0)
+  {
+    const T_Str& other = nameAt(index[h] - 1, fChildren);
+
+    if (equalName(other.p, other.len, name))
+      return (index[h] - 1);
+    h = (h + 1) & (size - 1);
+  }
+  return (-1);
+}
+
+double SimpleXMLTransfer::convToDouble(const char* value)
 {
   char*       ptr;
   double      tmp;
-  const char* inptr = value.c_str();
+  const char* inptr = value;
 
   tmp = strtod(inptr, &ptr);
   if (ptr == inptr || *ptr != '\0')
   {
-    value = "convToDouble: no number or trailing garbage in " + value;
-    throw XMLException(value.c_str());
+    throw XMLException("convToDouble: no number or trailing garbage in " +
+                       std::string(value));
   }
   return(tmp);
 }
 
-float SimpleXMLTransfer::convToFloat(std::string value)
+float SimpleXMLTransfer::convToFloat(const char* value)
 {
   return(convToDouble(value));
 }
@@ -1225,37 +1925,38 @@ float SimpleXMLTransfer::convToFloat(std::string value)
  * Mgliche Notation fr einen Integer-Wert: dezimal, hexadezimal mit
  * vorangestelltem '0x' oder binr mit vorangestelltem '0b'.
  */
-int SimpleXMLTransfer::convToInt(std::string value)
+int SimpleXMLTransfer::convToInt(const char* value)
 {
   long        nVal;
   char*       ptr;
   const char* inptr;
   int         base;
+  size_t      len = strlen(value);
 
-  if (value.find("0b") == 0 && value.length() > 2)
+  if (strncmp(value, "0b", 2) == 0 && len > 2)
   {
     // binre Darstellung
-    inptr = value.c_str()+2;
+    inptr = value+2;
     base  = 2;
   }
-  else if (value.length() > 1 && toupper(value[1]) == 'X')
+  else if (len > 1 && toupper(value[1]) == 'X')
   {
     // hexadezimale Darstellung
-    inptr = value.c_str()+2;
+    inptr = value+2;
     base  = 16;
   }
   else
   {
     // dezimale Darstellung
-    inptr = value.c_str();
+    inptr = value;
     base  = 10;
   }
 
   nVal = strtol(inptr, &ptr, base);
   if (ptr == inptr || *ptr != '\0')
   {
-    value = "convToInt: no number or trailing garbage in " + value;
-    throw XMLException(value.c_str());
+    throw XMLException("convToInt: no number or trailing garbage in " +
+                       std::string(value));
   }
   return(nVal);
 }
@@ -1272,61 +1973,51 @@ int SimpleXMLTransfer::convToInt(std::string value)
 SimpleXMLTransfer *SimpleXMLTransfer::getChild(std::string child, bool fCreate)
 {
   int                    index;
-  SimpleXMLTransfer*     tmp;
   std::string::size_type pos;
 
   pos = child.find('.');
 
   if (pos != std::string::npos)
   {
-    std::string parentName = "";
-    std::string childName = "";
-    SimpleXMLTransfer* item = this;
+    std::string            parentName = "";
+    std::string            childName  = "";
+    std::string::size_type start      = 0;
+    SimpleXMLTransfer*     item       = this;
 
-    do
+    // Walk along the path without cutting it into pieces. childName
+    // keeps its buffer, so there's no allocation for each item.
+    while (true)
     {
-      childName = child.substr(0, pos);
-      child     = child.substr(pos + 1);
-      pos       = child.find('.');
+      if (pos == std::string::npos)
+        childName.assign(child, start, std::string::npos);
+      else
+        childName.assign(child, start, pos - start);
 
       index = item->indexOfChild(childName);
       if (index < 0)
       {
         if (fCreate)
         {
-          tmp = new SimpleXMLTransfer();
-          tmp->setName(childName);
-          item->addChild(tmp);
-          index = item->indexOfChild(childName);
+          item->newChild(childName);
+          index = item->nChildren - 1;
         }
         else
           throw XMLException("No item named " + childName + " in " +
                              parentName);
       }
 
+      item = item->children[index];
+
+      if (pos == std::string::npos)
+        return (item);
+
       if (parentName.length() > 0)
         parentName.push_back('.');
       parentName.append(childName);
 
-      item = item->getChildAt(index);
-    }
-    while (pos != std::string::npos);
-
-    index = item->indexOfChild(child);
-    if (index < 0)
-    {
-      if (fCreate)
-      {
-        tmp = new SimpleXMLTransfer();
-        tmp->setName(child);
-        item->addChild(tmp);
-        return(tmp);
-      }
-      else
-        throw XMLException("No item named " + child + " in " + parentName);
+      start = pos + 1;
+      pos   = child.find('.', start);
     }
-
-    return (item->getChildAt(index));
   }
   else
   {
@@ -1336,10 +2027,7 @@ SimpleXMLTransfer *SimpleXMLTransfer::getChild(std::string child, bool fCreate)
     {
       if (fCreate)
       {
-        tmp = new SimpleXMLTransfer();
-        tmp->setName(child);
-        addChild(tmp);
-        return(tmp);
+        return(newChild(child));
       }
       else
         throw XMLException("No child named " + child + " in " + getName());
@@ -1355,40 +2043,45 @@ SimpleXMLTransfer *SimpleXMLTransfer::getChild(std::string child, bool fCreate)
  * Liefert den Index des ersten Kindes mit dem Namen
  * <code>child</code> zurck oder -1, wenn es keins gibt.
  */
-int SimpleXMLTransfer::indexOfChild(std::string child)
+int SimpleXMLTransfer::indexOfChild(const std::string& child)
 {
-  if (children.size() == 0)
-    return (-1);
-
   int index = -1;
-  int size  = children.size();
 
-  for (int i = 0; i < size && index == -1; i++)
-    if (child.compare(children[i]->getName()) == 0)
-      index = i;
+  if (nChildren >= INDEX_MIN_SIZE)
+  {
+    if (childIndex == (int*) 0 || childIndexGen != *pGeneration)
+      buildIndex(childIndex, childIndexSize, childIndexGen, true);
+
+    index = findInIndex(childIndex, childIndexSize, child, true);
+  }
+  else
+  {
+    for (int i = 0; i < nChildren && index == -1; i++)
+      if (equalName(children[i]->myName.p, children[i]->myName.len, child))
+        index = i;
+  }
 
   return (index);
 }
 
 int SimpleXMLTransfer::indexOfChild(std::string child, int nStartIdx)
 {
-  if (children.size() == 0)
+  if (nChildren == 0)
     return (-1);
 
-  if (nStartIdx < 0 || nStartIdx >= (int)(children.size()))
+  if (nStartIdx < 0 || nStartIdx >= nChildren)
     nStartIdx = 0;
 
   int index = -1;
-  int size  = children.size();
 
-  for (int i = nStartIdx; i < size && index == -1; i++)
-    if (child.compare(children[i]->getName()) == 0)
+  for (int i = nStartIdx; i < nChildren && index == -1; i++)
+    if (equalName(children[i]->myName.p, children[i]->myName.len, child))
       index = i;
 
   if (index < 0)
   {
     for (int i = 0; i < nStartIdx && index == -1; i++)
-      if (child.compare(children[i]->getName()) == 0)
+      if (equalName(children[i]->myName.p, children[i]->myName.len, child))
         index = i;
   }
 
@@ -1397,28 +2090,30 @@ int SimpleXMLTransfer::indexOfChild(std::string child, int nStartIdx)
 
 void SimpleXMLTransfer::removeChildAt(int nIndex)
 {
-  if (children.size() <= (unsigned int) nIndex)
+  if (nChildren <= nIndex || nIndex < 0)
     throw
     XMLException
     ("void SimpleXMLTransfer::removeChildAt(int nIndex): Index out of bounds in "
      + getName());
 
-  children.erase(children.begin() + nIndex);
+  eraseChild(nIndex);
+  changed();
 }
 
 void SimpleXMLTransfer::removeChild(SimpleXMLTransfer* XMLPtr)
 {
   bool fErr   = true;
 
-  if (children.size())
+  if (nChildren)
   {
-    for (unsigned int nIndex=0; nIndex<children.size(); nIndex++)
+    for (int nIndex=0; nIndex<nChildren; nIndex++)
     {
       if (children[nIndex] == XMLPtr)
       {
         fErr = false;
-        children.erase(children.begin() + nIndex);
-        nIndex = children.size() + 1;
+        eraseChild(nIndex);
+        nIndex = nChildren + 1;
+        changed();
       }
     }
   }
@@ -1434,15 +2129,20 @@ void SimpleXMLTransfer::replaceChild(SimpleXMLTransfer* XMLPtrOld,
 {
   bool fErr   = true;
 
-  if (children.size())
+  if (nChildren)
   {
-    for (unsigned int nIndex=0; nIndex<children.size(); nIndex++)
+    for (int nIndex=0; nIndex<nChildren; nIndex++)
     {
       if (children[nIndex] == XMLPtrOld)
       {
         fErr = false;
+        adoptChild(XMLPtrNew);
+        XMLPtrOld->detach();
         children[nIndex] = XMLPtrNew;
-        nIndex = children.size() + 1;
+        if (XMLPtrNew->pGeneration != pGeneration)
+          XMLPtrNew->setDocument(pGeneration);
+        nIndex = nChildren + 1;
+        changed();
       }
     }
   }
@@ -1458,7 +2158,9 @@ void SimpleXMLTransfer::replaceChild(SimpleXMLTransfer* XMLPtrOld,
  */
 void SimpleXMLTransfer::setName(std::string name)
 {
-  myName = name;
+  myName.p   = getArena()->intern(name.data(), name.length());
+  myName.len = name.length();
+  changed();
 }
 
 /**
@@ -1466,10 +2168,8 @@ void SimpleXMLTransfer::setName(std::string name)
  */
 void SimpleXMLTransfer::setContent(std::string newContent)
 {
-  if (content != (std::string *) 0)
-    delete content;
-
-  content = new std::string(newContent);
+  content     = getArena()->copy(newContent.data(), newContent.length());
+  nContentLen = newContent.length();
 }
 
 void SimpleXMLTransfer::sortChildrenString(std::string attributeName)
@@ -1481,7 +2181,8 @@ void SimpleXMLTransfer::sortChildrenString(std::string attributeName)
   std::string attr2;
   SimpleXMLTransfer *tmp;
 
-  size = children.size();
+  size = nChildren;
+  changed();
 
   while (fChanged)
   {
@@ -1531,7 +2232,8 @@ void SimpleXMLTransfer::sortChildrenDouble(std::string attributeName)
   double attr2;
   SimpleXMLTransfer *tmp;
 
-  size = children.size();
+  size = nChildren;
+  changed();
 
   while (fChanged)
   {
@@ -1579,8 +2281,8 @@ void SimpleXMLTransfer::delAttribute(std::string attribute)
     throw XMLException("Attribute named " + attribute +
                        " does not exist in " + getName());
 
-  attrName.erase(attrName.begin() + n);
-  attrVal.erase(attrVal.begin() + n);
+  eraseAttribute(n);
+  changed();
 }
 
 bool SimpleXMLTransfer::equals(SimpleXMLTransfer* item)
@@ -1615,18 +2317,20 @@ bool SimpleXMLTransfer::equals(SimpleXMLTransfer* item)
   // of item.
   for (int n=0; n<nSize; n++)
   {
-    if (item->indexOfAttribute(attrName[n]) == -1)
+    std::string name(attrs[n].name.p, attrs[n].name.len);
+
+    if (item->indexOfAttribute(name) == -1)
     {
 #if DEBUG == 2
-      printf("No attribute %s\n", attrName[n].c_str());
+      printf("No attribute %s\n", name.c_str());
 #endif
       return(false);
     }
 
-    if (item->attribute(attrName[n]).compare(attrVal[n]))
+    if (item->attribute(name).compare(std::string(attrs[n].val, attrs[n].len)))
     {
 #if DEBUG == 2
-      printf("%s: %s != %s\n", attrName[n].c_str(), attrVal[n].c_str(), item->attribute(attrName[n]).c_str());
+      printf("%s: %s != %s\n", name.c_str(), attrs[n].val, item->attribute(name).c_str());
 #endif
       return(false);
     }
@@ -1695,18 +2399,20 @@ bool SimpleXMLTransfer::equalsOrdered(SimpleXMLTransfer* item)
   // of item.
   for (int n=0; n<nSize; n++)
   {
-    if (item->indexOfAttribute(attrName[n]) == -1)
+    std::string name(attrs[n].name.p, attrs[n].name.len);
+
+    if (item->indexOfAttribute(name) == -1)
     {
 #if DEBUG == 2
-      printf("No attribute %s\n", attrName[n].c_str());
+      printf("No attribute %s\n", name.c_str());
 #endif
       return(false);
     }
 
-    if (item->attribute(attrName[n]).compare(attrVal[n]))
+    if (item->attribute(name).compare(std::string(attrs[n].val, attrs[n].len)))
     {
 #if DEBUG == 2
-      printf("%s: %s != %s\n", attrName[n].c_str(), attrVal[n].c_str(), item->attribute(attrName[n]).c_str());
+      printf("%s: %s != %s\n", name.c_str(), attrs[n].val, item->attribute(name).c_str());
 #endif
       return(false);
     }
@@ -1737,25 +2443,240 @@ bool SimpleXMLTransfer::equalsOrdered(SimpleXMLTransfer* item)
 
 void SimpleXMLTransfer::overwriteAttribute(unsigned int index, std::string val)
 {
-  if (index > attrName.size())
+  if (index > (unsigned int)nAttrs)
     throw XMLException("No such attribute in " + getName());
   else
-    attrVal[index] = val;
+    setValue(attrs[index], val.data(), val.length());
+  changed();
 }
 
 std::string SimpleXMLTransfer::attributeName(unsigned int index)
 {
-  if (index > attrName.size())
+  if (index > (unsigned int)nAttrs)
     throw XMLException("No such attribute in " + getName());
   else
-    return(attrName[index]);
+    return(std::string(attrs[index].name.p, attrs[index].name.len));
 }
 
 std::string SimpleXMLTransfer::attributeVal(unsigned int index)
 {
-  if (index > attrVal.size())
+  if (index > (unsigned int)nAttrs)
     throw XMLException("No such attribute in " + getName());
   else
-    return(attrVal[index]);
+    return(std::string(attrs[index].val, attrs[index].len));
+}
+
+
+/**
+ * Appends <code>n</code> to a binary document.
+ */
+static void writeU32(std::string& out, unsigned int n)
+{
+  out.append((const char*)&n, sizeof(n));
+}
+
+/**
+ * Appends the length, the string and a 0 to a binary document.
+ */
+static void writeStr(std::string& out, const char* p, unsigned int len)
+{
+  writeU32(out, len);
+  out.append(p, len);
+  out.push_back(0);
+}
+
+static bool readU32(char*& p, char* end, unsigned int& n)
+{
+  if (end - p < (long)sizeof(n))
+    return (false);
+
+  memcpy(&n, p, sizeof(n));
+  p += sizeof(n);
+  return (true);
+}
+
+/**
+ * Reads a string written by writeStr(). <code>s</code> points to
+ * it in the buffer, terminated by a 0.
+ */
+static bool readStr(char*& p, char* end, char*& s, unsigned int& len)
+{
+  if (readU32(p, end, len) == false ||
+      (unsigned long)(end - p) < (unsigned long)len + 1 || p[len] != 0)
+    return (false);
+
+  s  = p;
+  p += len + 1;
+  return (true);
+}
+
+// see header
+std::string SimpleXMLTransfer::toBinary()
+{
+  std::string out;
+
+  writeU32(out, BINARY_MAGIC);
+  writeU32(out, BINARY_VERSION);
+  writeBinary(out);
+
+  return (out);
+}
+
+/**
+ * Nur zur internen Vewendung.
+ */
+void SimpleXMLTransfer::writeBinary(std::string& out)
+{
+  writeStr(out, myName.p, myName.len);
+
+  writeU32(out, nAttrs);
+  for (int n = 0; n < nAttrs; n++)
+  {
+    writeStr(out, attrs[n].name.p, attrs[n].name.len);
+    writeStr(out, attrs[n].val, attrs[n].len);
+  }
+
+  // length + 1, 0: no content
+  if (content != (char*) 0)
+  {
+    writeU32(out, nContentLen + 1);
+    out.append(content, nContentLen);
+    out.push_back(0);
+  }
+  else
+    writeU32(out, 0);
+
+  writeU32(out, nComments);
+  for (int n = 0; n < nComments; n++)
+  {
+    writeU32(out, (unsigned int)comments[n].pos);
+    writeU32(out, comments[n].text.len);
+    out.append(comments[n].text.p, comments[n].text.len);
+  }
+
+  writeU32(out, nChildren);
+  for (int n = 0; n < nChildren; n++)
+    children[n]->writeBinary(out);
+}
+
+// see header
+SimpleXMLTransfer* SimpleXMLTransfer::fromBinary(const char*  data,
+                                                 unsigned int len,
+                                                 std::string  descr)
+{
+  unsigned int header[2];
+
+  if (len < sizeof(header))
+    return ((SimpleXMLTransfer*) 0);
+
+  memcpy(header, data, sizeof(header));
+  if (header[0] != BINARY_MAGIC || header[1] != BINARY_VERSION)
+    return ((SimpleXMLTransfer*) 0);
+
+  data += sizeof(header);
+  len  -= sizeof(header);
+
+  // The root lives in the arena as well and holds its first reference,
+  // so deleting the root releases the arena.
+  SimpleXMLArena*    home = new SimpleXMLArena((len > ARENA_MIN_BLOCK) ? len : ARENA_MIN_BLOCK);
+  char*              p    = home->copy(data, len);
+  char*              end  = p + len;
+  SimpleXMLTransfer* root = home->newElement(home->copy(descr.data(), descr.length()));
+
+  root->fOwnRef = true;
+
+  // The strings are used where they are, like when parsing XML.
+  if (root->readBinary(p, end, 0) == false || p != end)
+  {
+    // Nothing in the arena has to be destructed.
+    home->unref();
+    return ((SimpleXMLTransfer*) 0);
+  }
+
+  return (root);
 }
 
+/**
+ * Nur zur internen Vewendung.
+ *
+ * Counts are checked against what is left in the buffer, so that
+ * damaged data can't make this allocate huge arrays.
+ */
+bool SimpleXMLTransfer::readBinary(char*& p, char* end, int nDepth)
+{
+  char*        s;
+  char*        val;
+  unsigned int len;
+  unsigned int nValLen;
+  unsigned int n;
+
+  if (nDepth > BINARY_MAX_DEPTH || readStr(p, end, s, len) == false)
+    return (false);
+  myName.p   = arena->intern(s, len);
+  myName.len = len;
+
+  // attributes: at least 2 * (4 + 1) bytes each
+  if (readU32(p, end, n) == false || n > (unsigned long)(end - p) / 10)
+    return (false);
+  if (n > 0)
+  {
+    attrs     = (T_Attribute*)arena->alloc(n * sizeof(T_Attribute));
+    nAttrsMax = n;
+  }
+  while (n-- > 0)
+  {
+    if (readStr(p, end, s, len) == false || readStr(p, end, val, nValLen) == false)
+      return (false);
+
+    T_Attribute& a = newAttribute(s, len);
+
+    a.val  = val;
+    a.len  = nValLen;
+    a.size = nValLen + 1;
+  }
+
+  if (readU32(p, end, len) == false || (unsigned long)(end - p) < len)
+    return (false);
+  if (len > 0)
+  {
+    if (p[len - 1] != 0)
+      return (false);
+    content     = p;
+    nContentLen = len - 1;
+    p          += len;
+  }
+
+  // comments: at least 8 bytes each
+  if (readU32(p, end, n) == false || n > (unsigned long)(end - p) / 8)
+    return (false);
+  while (n-- > 0)
+  {
+    unsigned int pos;
+
+    if (readU32(p, end, pos) == false || readU32(p, end, len) == false ||
+        (unsigned long)(end - p) < len)
+      return (false);
+    pushComment(p, len, (int)pos);
+    p += len;
+  }
+
+  // children: at least 5 * 4 + 1 bytes each
+  if (readU32(p, end, n) == false || n > (unsigned long)(end - p) / 21)
+    return (false);
+  if (n > 0)
+  {
+    children     = (SimpleXMLTransfer**)arena->alloc(n * sizeof(SimpleXMLTransfer*));
+    nChildrenMax = n;
+  }
+  while (n-- > 0)
+  {
+    SimpleXMLTransfer* child = arena->newElement("istream");
+
+    child->pGeneration = pGeneration;
+    children[nChildren++] = child;
+    if (child->readBinary(p, end, nDepth + 1) == false)
+      return (false);
+  }
+
+  return (true);
+}
@@ -34,24 +34,6 @@
 #include <vector>
 #include <fstream>
 
-typedef enum
-{
-  STATE_IDLE,
-  STATE_START,
-  STATE_INITTAG,
-  STATE_INPUT,
-  STATE_READNAME,
-  STATE_WAIT_CONT,
-  STATE_CONT_START,
-  STATE_ENDTAG,
-  STATE_ATTR_NAME,
-  STATE_ATTR_VAL,
-  STATE_ATTR_VAL_START,
-  STATE_COMMENT,
-  STATE_ATTR_VAL_WAIT_EQ
-} T_State;
-
-
 /** \brief Standard exception for SimpleXMLTransfer.
  * 
  *  This is the standard exception which is thrown by many methods of
@@ -75,6 +57,7 @@ class XMLException
 
 
 class SimpleXMLTransfer;
+class SimpleXMLArena;
 
 /** \brief Simple XML parser class.
  *
@@ -85,6 +68,15 @@ class SimpleXMLTransfer;
  * 
  * The method 'removeChildAt(int)' is not present in the Java-class and was
  * only implemented here.
+ *
+ * A document and all elements in it are stored in one memory arena:
+ * the file is read into it and the values are used where they are,
+ * names are only stored once per document. Deleting the root element
+ * frees everything at once. Elements which have been removed from a
+ * document (removeChildAt(), removeChild(), replaceChild()) stay
+ * valid as long as the document exists. Elements created with
+ * <code>new</code> and added to a document are deleted with it,
+ * as before.
  */
 class SimpleXMLTransfer
 {
@@ -116,7 +108,7 @@ class SimpleXMLTransfer
     /**
      * Returns a string describing the source of this xml data
      */
-    std::string getSourceDescr() const { return(sourcedescr); };
+    std::string getSourceDescr() const { return(std::string(sourcedescr.p, sourcedescr.len)); };
    
     /**
      * Return the name of the object.
@@ -380,7 +372,7 @@ class SimpleXMLTransfer
      * Return the index of the first child with the name
      * <code>child</code> or -1 if no such child exists.
      */
-    int indexOfChild(std::string child);
+    int indexOfChild(const std::string& child);
 
     /**
      * Return the index of the first child with the name
@@ -451,48 +443,219 @@ class SimpleXMLTransfer
      * Returns the index of the first attribute named
      * <code>attr</code> or -1 of none exists.
      */
-    int indexOfAttribute(std::string attr) const;
+    int indexOfAttribute(const std::string& attr) const;
    
    /** 
     * Returns number of attributes
     */
-   int getAttributeCount() const { return(attrName.size()); };
+   int getAttributeCount() const { return(nAttrs); };
 
    void overwriteAttribute(unsigned int index, std::string val);
    
    std::string attributeName(unsigned int index);
    std::string attributeVal (unsigned int index);
-      
+
+    /**
+     * Returns this element and everything in it (attributes, content,
+     * comments, children) in a binary form which fromBinary() reads
+     * much faster than XML. The result depends on the byte order of
+     * the machine.
+     */
+    std::string toBinary();
+
+    /**
+     * Reads an element written by toBinary(). Returns 0 if the data is
+     * damaged or has been written by another version.
+     *
+     * \param data  output of toBinary()
+     * \param len   length of data
+     * \param descr what getSourceDescr() should return
+     */
+    static SimpleXMLTransfer* fromBinary(const char*  data,
+                                         unsigned int len,
+                                         std::string  descr);
+
+    /**
+     * Elements which are read from a file or stream, or created below
+     * an element of a document, are allocated from the memory arena of
+     * the document. Deleting an element only calls the destructors of
+     * elements which have been added from somewhere else, so these
+     * operators have to know where an element lives.
+     */
+    static void* operator new(size_t size);
+    static void  operator delete(void* ptr);
+
   private:
-    std::string                          myName;
-    std::vector<SimpleXMLTransfer*>      children;
-    std::vector<std::string>             attrName;
-    std::vector<std::string>             attrVal;
-    std::vector<std::string>             comment;
-    std::vector<int>                     commentPos;
-    std::string*                         content;
+    friend class SimpleXMLArena;
+
+    /**
+     * A string in the arena. Names, values and the content are
+     * terminated by a 0, comments are not.
+     */
+    typedef struct
+    {
+      const char*  p;
+      unsigned int len;
+    } T_Str;
+
+    typedef struct
+    {
+      T_Str        name;       ///< interned in the arena of the element
+      char*        val;
+      unsigned int len;
+      unsigned int size;       ///< bytes available at val, including the 0
+    } T_Attribute;
+
+    typedef struct
+    {
+      T_Str        text;       ///< "<!-- ... -->"
+      int          pos;        ///< printed in front of this child, -1: before the element
+    } T_Comment;
+
+    SimpleXMLArena*                      arena;       ///< holds all data, 0 until needed
+    bool                                 fInArena;    ///< this element itself lives in arena
+    bool                                 fOwnRef;     ///< holds a reference to arena although fInArena
+
+    T_Str                                myName;
+    T_Str                                sourcedescr;   ///< describes the source of the data
+    char*                                content;     ///< 0 if there is no content
+    unsigned int                         nContentLen;
+
+    SimpleXMLTransfer**                  children;
+    int                                  nChildren;
+    int                                  nChildrenMax;
+    T_Attribute*                         attrs;
+    int                                  nAttrs;
+    int                                  nAttrsMax;
+    T_Comment*                           comments;
+    int                                  nComments;
+    int                                  nCommentsMax;
+
+    /**
+     * Hash table of the index + 1 of the first child or attribute with
+     * a name. Only built for elements with many children or attributes,
+     * on the first lookup after something has been changed.
+     */
+    mutable int*                         childIndex;
+    mutable unsigned int                 childIndexSize;
+    mutable unsigned long                childIndexGen;
+    mutable int*                         attrIndex;
+    mutable unsigned int                 attrIndexSize;
+    mutable unsigned long                attrIndexGen;
+
+    /**
+     * Generation of the document, only used while this element is its
+     * root. Incremented whenever an element of the document is changed:
+     * names, attributes, children or deletion. Indexes which have been
+     * built in an older generation have to be rebuilt. Documents don't
+     * share anything, so different documents can be used by different
+     * threads.
+     */
+    unsigned long                        nDocGeneration;
+    unsigned long*                       pGeneration;  ///< nDocGeneration of the root
+
+    void changed() { (*pGeneration)++; };
+
+    /**
+     * Makes this element and everything below it part of the document
+     * whose generation is <code>gen</code>.
+     */
+    void setDocument(unsigned long* gen);
+
+    /**
+     * Makes this element the root of a document of its own, after it
+     * has been removed from its parent.
+     */
+    void detach();
+
+    /**
+     * Element which lives in the arena <code>home</code>
+     */
+    SimpleXMLTransfer(SimpleXMLArena* home, const char* descr);
+
+    // Not implemented, use SimpleXMLTransfer(SimpleXMLTransfer* source)
+    SimpleXMLTransfer(const SimpleXMLTransfer&);
+    SimpleXMLTransfer& operator=(const SimpleXMLTransfer&);
+
+    void init(const char* descr);
+
+    SimpleXMLArena* getArena();
+
+    /**
+     * Creates an empty element in the arena of this element.
+     */
+    SimpleXMLTransfer* newChild(const std::string& name);
+
+    void copyFrom(SimpleXMLTransfer* source);
+
+    /**
+     * Makes sure that <code>child</code> is deleted with this document
+     * and that its own arena lives as long as it is needed.
+     */
+    void adoptChild(SimpleXMLTransfer* child);
+
+    void pushChild(SimpleXMLTransfer* child);
+
+    void eraseChild(int index);
+
+    /**
+     * Appends an attribute with an empty value.
+     */
+    T_Attribute& newAttribute(const char* name, unsigned int nameLen);
+
+    void setValue(T_Attribute& attr, const char* val, unsigned int len);
+
+    void eraseAttribute(int index);
+
+    void pushComment(const char* text, unsigned int len, int nPos);
+
+    const T_Str& nameAt(int i, bool fChildren) const
+    {
+      return (fChildren ? children[i]->myName : attrs[i].name);
+    };
+
+    void buildIndex(int*& index, unsigned int& size, unsigned long& gen,
+                    bool fChildren) const;
+
+    int findInIndex(const int* index, unsigned int size,
+                    const std::string& name, bool fChildren) const;
 
     /**
      * Only for internal purposes!
      */
-    void readStream(std::istream&  in,
-                    int            data);
+    void readBuffer(char*&  p,
+                    char*   end,
+                    bool    fChild,
+                    std::vector<SimpleXMLTransfer*>& stack);
 
-    SimpleXMLTransfer(std::istream&  in,
-                      int            data);
+    void readComment(char*&  p,
+                     char*   end,
+                     int     nPos);
+
+    void readSource(char* buffer, unsigned int len);
+
+    void writeBinary(std::string& out);
+
+    bool readBinary(char*& p, char* end, int nDepth);
+
+    void appendContent(const char* p, const char* end);
+
+    void trimContent();
+
+    void throwNotClosed();
 
 
     /**
      * Possible notation for integer-values: decimal, hexadecimal with 
      * prefixed '0x' or binary with prefixed '0b'.
      */
-    int    convToInt(std::string value);
+    int    convToInt(const char* value);
 
     /**
      */
-    float  convToFloat(std::string value);
+    float  convToFloat(const char* value);
 
-    double convToDouble(std::string value);
+    double convToDouble(const char* value);
 
     /**
      * Converts a std::string (attribute value in an XML file)
@@ -526,10 +689,6 @@ class SimpleXMLTransfer
               int           nIndent,
               std::string   val);
    
-   /**
-    * describes the source of the data
-    */
-   std::string sourcedescr;
 };
 
 #endif
@@ -0,0 +1,487 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+  
+
+/** \file datapack.cpp
+ *
+ *  Implementation of class DataPack.
+ */
+
+#include <crrc_config.h>
+
+#include "datapack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+#endif
+
+#if ZLIB == 1
+# include <zlib.h>
+#endif
+
+/// "CRPK" -- also detects packs written on a machine with different endianness
+#define DATAPACK_MAGIC    (0x4352504b)
+#define DATAPACK_VERSION  (1)
+
+/// Number of unsigned ints in the header
+#define DATAPACK_HDR_LEN  (5)
+
+/// Entries start at a multiple of this
+#define DATAPACK_PAGE     (4096)
+
+/// Entry flag: data is compressed with zlib
+#define DATAPACK_ZLIB     (1)
+
+/// packs mounted by mountAll()
+static std::vector<DataPack*> mounted;
+
+
+DataPack::DataPack(std::string file)
+  : path(file), base(NULL), length(0), entries(NULL), names(NULL), count(0)
+{
+#ifdef WIN32
+  hFile    = INVALID_HANDLE_VALUE;
+  hMapping = NULL;
+
+  hFile = CreateFile(file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (hFile == INVALID_HANDLE_VALUE)
+    return;
+
+  length   = GetFileSize(hFile, NULL);
+  hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (hMapping == NULL)
+  {
+    unmap();
+    return;
+  }
+  base = (const char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+  int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    void* p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    if (p != MAP_FAILED)
+    {
+      base   = (const char*)p;
+      length = st.st_size;
+    }
+  }
+  ::close(fd);
+#endif
+
+  if (base == NULL)
+  {
+    unmap();
+    return;
+  }
+
+  // Check everything once, so that open() can trust the index.
+  unsigned int hdr[DATAPACK_HDR_LEN];
+  bool         ok = false;
+
+  if (length >= sizeof(hdr))
+  {
+    memcpy(hdr, base, sizeof(hdr));
+    count = hdr[3];
+    ok    = (hdr[0] == DATAPACK_MAGIC
+             && hdr[1] == DATAPACK_VERSION
+             && hdr[2] == DATAPACK_PAGE
+             && count <= (length - sizeof(hdr)) / sizeof(T_Entry)
+             && hdr[4] >= sizeof(hdr) + count * sizeof(T_Entry)
+             && hdr[4] <= length);
+  }
+
+  if (ok)
+  {
+    entries = (const T_Entry*)(base + sizeof(hdr));
+    names   = base + hdr[4];
+
+    for (unsigned int n = 0; n < count && ok; n++)
+    {
+      const T_Entry& e = entries[n];
+
+      ok = (e.name <= length - hdr[4] && e.namelen <= length - hdr[4] - e.name
+            && e.offset <= length && e.stored <= length - e.offset
+            && (e.flags & ~DATAPACK_ZLIB) == 0);
+
+      // open() returns uncompressed data where it is
+      if ((e.flags & DATAPACK_ZLIB) == 0 && e.size != e.stored)
+        ok = false;
+
+      // sorted, no duplicates
+      if (ok && n > 0)
+      {
+        const T_Entry& p   = entries[n - 1];
+        int            cmp = memcmp(names + p.name, names + e.name,
+                                    std::min(p.namelen, e.namelen));
+
+        ok = (cmp < 0 || (cmp == 0 && p.namelen < e.namelen));
+      }
+
+#if ZLIB != 1
+      if (e.flags & DATAPACK_ZLIB)
+      {
+        fprintf(stderr, "%s: compressed entries need zlib\n", file.c_str());
+        ok = false;
+      }
+#endif
+    }
+  }
+
+  if (!ok)
+  {
+    fprintf(stderr, "%s is not a valid data pack\n", file.c_str());
+    unmap();
+  }
+}
+
+
+DataPack::~DataPack()
+{
+  unmap();
+}
+
+
+void DataPack::unmap()
+{
+#ifdef WIN32
+  if (base != NULL)
+    UnmapViewOfFile(base);
+  if (hMapping != NULL)
+    CloseHandle(hMapping);
+  if (hFile != INVALID_HANDLE_VALUE)
+    CloseHandle(hFile);
+  hMapping = NULL;
+  hFile    = INVALID_HANDLE_VALUE;
+#else
+  if (base != NULL)
+    munmap((void*)base, length);
+#endif
+  base    = NULL;
+  length  = 0;
+  entries = NULL;
+  names   = NULL;
+  count   = 0;
+}
+
+
+/**
+ * Binary search in the index
+ */
+const DataPack::T_Entry* DataPack::find(const std::string& item)
+{
+  unsigned int lo = 0;
+  unsigned int hi = count;
+
+  while (lo < hi)
+  {
+    unsigned int   mid = (lo + hi) / 2;
+    const T_Entry& e   = entries[mid];
+    int            cmp = memcmp(names + e.name, item.data(),
+                                std::min((std::string::size_type)e.namelen, item.length()));
+
+    if (cmp == 0)
+    {
+      if (e.namelen == item.length())
+        return (&e);
+      cmp = (e.namelen < item.length()) ? -1 : 1;
+    }
+
+    if (cmp < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return (NULL);
+}
+
+
+// see header
+bool DataPack::contains(const std::string& item)
+{
+  return (find(item) != NULL);
+}
+
+
+// see header
+const char* DataPack::open(const std::string& item, unsigned long& len)
+{
+  const T_Entry* e = find(item);
+
+  if (e == NULL)
+    return (NULL);
+
+  len = e->size;
+
+#if ZLIB == 1
+  if (e->flags & DATAPACK_ZLIB)
+  {
+    Bytef* data    = (Bytef*)malloc(e->size > 0 ? e->size : 1);
+    uLongf destLen = e->size;
+
+    if (data == NULL
+        || uncompress(data, &destLen, (const Bytef*)base + e->offset, e->stored) != Z_OK
+        || destLen != e->size)
+    {
+      fprintf(stderr, "%s: unable to decompress %s\n", path.c_str(), item.c_str());
+      free(data);
+      return (NULL);
+    }
+    return ((const char*)data);
+  }
+#endif
+
+  // An empty entry may start at the end of the mapping, where close()
+  // wouldn't recognize it.
+  if (e->size == 0)
+    return (base);
+
+  return (base + e->offset);
+}
+
+
+// see header
+void DataPack::close(const char* data)
+{
+  // only decompressed copies are outside of the mapping
+  if (data != NULL && (data < base || data >= base + length))
+    free((void*)data);
+}
+
+
+// see header
+void DataPack::list(const std::string& dir, std::vector<std::string>& items)
+{
+  std::string prefix = dir + "/";
+
+  for (unsigned int n = 0; n < count; n++)
+  {
+    const T_Entry& e = entries[n];
+
+    if (e.namelen > prefix.length()
+        && memcmp(names + e.name, prefix.data(), prefix.length()) == 0
+        && memchr(names + e.name + prefix.length(), '/', e.namelen - prefix.length()) == NULL)
+      items.push_back(std::string(names + e.name, e.namelen));
+  }
+}
+
+
+/**
+ * Reads a file into memory
+ */
+static bool readFile(const std::string& file, std::string& data)
+{
+  FILE* fp = fopen(file.c_str(), "rb");
+
+  if (fp == NULL)
+    return (false);
+
+  char   buf[65536];
+  size_t n;
+
+  data.clear();
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+    data.append(buf, n);
+
+  bool ok = (ferror(fp) == 0);
+  fclose(fp);
+
+  return (ok);
+}
+
+
+// see header
+std::string DataPack::create(std::string file, std::string root,
+                             std::vector<std::string> items,
+                             bool fCompress)
+{
+  std::vector<T_Entry> index;
+  std::string          allnames;
+  unsigned int         hdr[DATAPACK_HDR_LEN];
+  unsigned long        offset;
+
+  std::sort(items.begin(), items.end());
+  items.erase(std::unique(items.begin(), items.end()), items.end());
+
+  for (unsigned int n = 0; n < items.size(); n++)
+  {
+    T_Entry e;
+
+    e.name    = allnames.length();
+    e.namelen = items[n].length();
+    e.offset  = 0;
+    e.stored  = 0;
+    e.size    = 0;
+    e.flags   = 0;
+    index.push_back(e);
+    allnames += items[n];
+  }
+
+  hdr[0] = DATAPACK_MAGIC;
+  hdr[1] = DATAPACK_VERSION;
+  hdr[2] = DATAPACK_PAGE;
+  hdr[3] = index.size();
+  hdr[4] = sizeof(hdr) + index.size() * sizeof(T_Entry);
+  offset = hdr[4] + allnames.length();
+
+  FILE* fp = fopen(file.c_str(), "wb");
+  if (fp == NULL)
+    return ("Unable to write " + file);
+
+  // The index is written again when the offsets are known.
+  bool        ok  = true;
+  std::string err = "";
+
+  ok = ok && fwrite(hdr, sizeof(hdr), 1, fp) == 1;
+  ok = ok && (index.size() == 0 || fwrite(&index[0], sizeof(T_Entry), index.size(), fp) == index.size());
+  ok = ok && fwrite(allnames.data(), 1, allnames.length(), fp) == allnames.length();
+
+  for (unsigned int n = 0; n < items.size() && ok; n++)
+  {
+    std::string data;
+
+    if (!readFile(root + "/" + items[n], data))
+    {
+      err = "Unable to read " + root + "/" + items[n];
+      break;
+    }
+
+    index[n].size = data.length();
+
+#if ZLIB == 1
+    if (fCompress && data.length() > 0)
+    {
+      uLongf      destLen = compressBound(data.length());
+      std::string packed(destLen, 0);
+
+      if (compress2((Bytef*)&packed[0], &destLen, (const Bytef*)data.data(),
+                    data.length(), Z_BEST_COMPRESSION) == Z_OK
+          && destLen <= data.length() - data.length() / 8)
+      {
+        packed.resize(destLen);
+        data.swap(packed);
+        index[n].flags |= DATAPACK_ZLIB;
+      }
+    }
+#endif
+
+    // page alignment
+    unsigned long pad = (DATAPACK_PAGE - offset % DATAPACK_PAGE) % DATAPACK_PAGE;
+    std::string   zeros(pad, 0);
+
+    offset += pad;
+    if (offset + data.length() > 0xFFFFFFFFul)
+    {
+      err = "Data pack too large (4 GB max.)";
+      break;
+    }
+    index[n].offset = offset;
+    index[n].stored = data.length();
+
+    ok = ok && fwrite(zeros.data(), 1, pad, fp) == pad;
+    ok = ok && fwrite(data.data(), 1, data.length(), fp) == data.length();
+    offset += data.length();
+  }
+
+  if (ok && err == "")
+  {
+    ok = fseek(fp, sizeof(hdr), SEEK_SET) == 0
+         && (index.size() == 0 || fwrite(&index[0], sizeof(T_Entry), index.size(), fp) == index.size());
+  }
+
+  ok = (fclose(fp) == 0) && ok;
+
+  if (ok && err == "")
+    return ("");
+
+  remove(file.c_str());
+  if (err == "")
+    err = "Unable to write " + file;
+
+  return (err);
+}
+
+
+// see header
+int DataPack::mountAll()
+{
+  std::vector<std::string> paths;
+
+  FileSysTools::getSearchPathList(paths, "");
+
+  for (unsigned int i = 0; i < paths.size(); i++)
+  {
+    DIR*           dir = opendir(paths[i].c_str());
+    struct dirent* ent;
+    std::vector<std::string> packs;
+
+    if (dir == NULL)
+      continue;
+
+    while ((ent = readdir(dir)) != NULL)
+    {
+      std::string name = ent->d_name;
+
+      if (name.length() > 5 && name.compare(name.length() - 5, 5, ".pack") == 0)
+        packs.push_back(paths[i] + "/" + name);
+    }
+    closedir(dir);
+
+    // same order on every system
+    std::sort(packs.begin(), packs.end());
+
+    for (unsigned int n = 0; n < packs.size(); n++)
+    {
+      DataPack* pack = new DataPack(packs[n]);
+
+      if (pack->isValid())
+      {
+        FileSysTools::mount(pack);
+        mounted.push_back(pack);
+        printf("Mounted data pack %s (%u files)\n", packs[n].c_str(), pack->getCount());
+      }
+      else
+        delete pack;
+    }
+  }
+
+  return (mounted.size());
+}
@@ -0,0 +1,133 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+  
+
+/** \file datapack.h
+ *
+ *  Reading and writing of data packs.
+ */
+
+#ifndef DATAPACK_H
+#define DATAPACK_H
+
+#include <string>
+#include <vector>
+
+#include "filesystools.h"
+
+
+/** \brief A single file containing many data files
+ *
+ *  A data pack holds files like "models/allegro.xml" or
+ *  "textures/beachsand.rgb", relative to a directory of the search
+ *  path. When it is mounted (see FileSysTools::mount()),
+ *  FileSysTools::getDataPath() finds the files in it.
+ *
+ *  Layout, all numbers are unsigned ints in the byte order of the
+ *  machine which wrote the pack:
+ *
+ *  - header: magic, version, page size, number of entries, offset of
+ *    the names
+ *  - index: for each entry the offset and length of its name, offset,
+ *    stored size and size of its data, flags. Sorted by name, so that
+ *    an entry is found by a binary search.
+ *  - names
+ *  - data of each entry, starting at a page boundary
+ *
+ *  The pack is mapped into memory. open() returns a pointer into the
+ *  mapping for an entry which is stored as it is, so nothing is copied.
+ *  Entries can also be compressed (needs zlib), open() then returns a
+ *  decompressed copy.
+ */
+class DataPack : public FileSysTools::Archive
+{
+  public:
+    /**
+     * Opens a pack. Use isValid() to find out whether this worked.
+     *
+     * \param file path to the pack
+     */
+    DataPack(std::string file);
+
+    ~DataPack();
+
+    /// true if the pack could be opened and looks sane
+    bool isValid() const { return (base != NULL); };
+
+    /// number of entries
+    unsigned int getCount() const { return (count); };
+
+    // FileSysTools::Archive
+    std::string getPath() { return (path); };
+    bool contains(const std::string& item);
+    const char* open(const std::string& item, unsigned long& len);
+    void close(const char* data);
+    void list(const std::string& dir, std::vector<std::string>& items);
+
+    /**
+     * Writes a pack.
+     *
+     * \param file      path of the pack
+     * \param root      directory the items are relative to
+     * \param items     files to put into the pack (relative to root)
+     * \param fCompress compress entries if this makes them smaller
+     *                  by at least an eighth (ignored without zlib)
+     * \return empty string or a message on error
+     */
+    static std::string create(std::string file, std::string root,
+                              std::vector<std::string> items,
+                              bool fCompress);
+
+    /**
+     * Mounts every *.pack file in the directories of the search path.
+     * Returns the number of packs which have been mounted.
+     */
+    static int mountAll();
+
+  private:
+    /// one entry of the index
+    typedef struct
+    {
+      unsigned int name;      ///< offset of the name
+      unsigned int namelen;
+      unsigned int offset;    ///< offset of the data
+      unsigned int stored;    ///< stored size of the data
+      unsigned int size;      ///< size of the data
+      unsigned int flags;
+    } T_Entry;
+
+    const T_Entry* find(const std::string& item);
+    void unmap();
+
+    std::string    path;
+    const char*    base;      ///< the mapped file, NULL if invalid
+    unsigned long  length;    ///< length of the file
+    const T_Entry* entries;
+    const char*    names;
+    unsigned int   count;
+#ifdef WIN32
+    void*          hFile;
+    void*          hMapping;
+#endif
+};
+
+#endif
@@ -44,12 +44,174 @@
 
 #ifdef WIN32
 # include <direct.h>   // mkdir
+# include <windows.h>  // CRITICAL_SECTION
+#else
+# include <pthread.h>
 #endif
 
+#include <map>
+#include <set>
+
 #include "SimpleXMLTransfer.h"
 
 std::string FileSysTools::appname;
 
+/**
+ * Names of the files in a directory of the search path
+ */
+typedef std::set<std::string> T_DirIndex;
+
+/// directories read by getDataPath(), by path
+static std::map<std::string, T_DirIndex> dirIndex;
+
+/// results of getDataPath(), by item
+static std::map<std::string, std::string> dataPaths;
+
+/// mounted archives, searched in this order
+static std::vector<FileSysTools::Archive*> archives;
+
+
+/**
+ * Protects dirIndex, dataPaths and archives, getDataPath() is used by
+ * the startup threads at the same time (see crrc_startup.h). Locked
+ * while an object of this class exists.
+ */
+class T_CacheLock
+{
+  public:
+#ifdef WIN32
+    T_CacheLock()  { EnterCriticalSection(getMutex()); };
+    ~T_CacheLock() { LeaveCriticalSection(getMutex()); };
+
+  private:
+    static CRITICAL_SECTION* getMutex()
+    {
+      // first used by the main thread, before any other thread exists
+      static CRITICAL_SECTION mutex;
+      static bool             fInit = false;
+
+      if (!fInit)
+      {
+        InitializeCriticalSection(&mutex);
+        fInit = true;
+      }
+      return (&mutex);
+    };
+#else
+    T_CacheLock()  { pthread_mutex_lock(&mutex); };
+    ~T_CacheLock() { pthread_mutex_unlock(&mutex); };
+
+  private:
+    static pthread_mutex_t mutex;
+#endif
+};
+
+#ifndef WIN32
+pthread_mutex_t T_CacheLock::mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+/**
+ * Tries to open a file.
+ */
+static bool canOpen(const std::string& path)
+{
+  std::ifstream testDat;
+
+  testDat.open(path.c_str());
+  if (!testDat)
+    return (false);
+
+  testDat.close();
+  return (true);
+}
+
+/**
+ * findArchive() without locking, the caller holds T_CacheLock.
+ */
+static FileSysTools::Archive* findArchiveUnlocked(const std::string& path, std::string& item)
+{
+  for (std::vector<FileSysTools::Archive*>::size_type i = 0; i < archives.size(); i++)
+  {
+    std::string prefix = archives[i]->getPath() + "/";
+
+    if (path.compare(0, prefix.length(), prefix) == 0 &&
+        archives[i]->contains(path.substr(prefix.length())))
+    {
+      item = path.substr(prefix.length());
+      return (archives[i]);
+    }
+  }
+
+  return (NULL);
+}
+
+/**
+ * fileExists() without locking, the caller holds T_CacheLock.
+ */
+static bool fileExistsUnlocked(const std::string& path)
+{
+  std::string item;
+
+  return (canOpen(path) || (!archives.empty() && findArchiveUnlocked(path, item) != NULL));
+}
+
+/**
+ * Checks whether a file exists by looking at the index of its
+ * directory. The directory is read when it is needed first.
+ * The caller holds T_CacheLock.
+ *
+ * The index compares names case-sensitively. On file systems which
+ * don't (Windows, Mac OS X by default), a name which is not in the
+ * index may still be found by opening the file.
+ */
+static bool isInDirIndex(const std::string& path)
+{
+  std::string::size_type slash = path.rfind('/');
+  std::string            dir;
+  std::string            name;
+
+  if (slash == std::string::npos)
+  {
+    dir  = ".";
+    name = path;
+  }
+  else
+  {
+    dir  = (slash == 0) ? "/" : path.substr(0, slash);
+    name = path.substr(slash + 1);
+  }
+
+  if (name == "" || name == "." || name == "..")
+    return (fileExistsUnlocked(path));
+
+  std::map<std::string, T_DirIndex>::iterator it = dirIndex.find(dir);
+
+  if (it == dirIndex.end())
+  {
+    T_DirIndex&    names = dirIndex[dir];
+    DIR*           dp    = opendir(dir.c_str());
+    struct dirent* ent;
+
+    if (dp != NULL)
+    {
+      while ((ent = readdir(dp)) != NULL)
+        names.insert(ent->d_name);
+      closedir(dp);
+    }
+    it = dirIndex.find(dir);
+  }
+
+  if (it->second.count(name) > 0)
+    return (true);
+
+#if defined(WIN32) || defined(__APPLE__) || defined(MACOSX)
+  return (canOpen(path));
+#else
+  return (false);
+#endif
+}
+
 // see header
 void FileSysTools::makeSurePathExists(std::string path)
 {
@@ -87,17 +249,13 @@ void FileSysTools::makeSurePathExists(std::string path)
 // see header
 bool FileSysTools::fileExists(std::string path)
 {
-  std::ifstream testDat;
-  
-  testDat.open(path.c_str());
-  
-  if (!testDat) 
-    return(false);
-  else 
-  { 
-    testDat.close();
+  if (canOpen(path))
     return(true);
-  }  
+
+  T_CacheLock lock;
+  std::string item;
+
+  return(!archives.empty() && findArchiveUnlocked(path, item) != NULL);
 }
 
 // see header
@@ -228,24 +386,42 @@ std::string FileSysTools::getHomePath()
 std::string FileSysTools::getDataPath(std::string item, bool fThrowEx)
 {
   std::string path = "";
-  
-  std::vector<std::string> possible_paths;
-  FileSysTools::getSearchPathList(possible_paths, item);
+  T_CacheLock lock;
 
-  //~ std::cout << "T_Config::getDataPath(): " << std::endl;
-  //~ for (std::vector<std::string>::size_type i = 0; i < possible_paths.size(); i++)
-  //~ {
-    //~ std::cout << possible_paths[i] << std::endl;
-  //~ }
+  std::map<std::string, std::string>::iterator it = dataPaths.find(item);
 
-  for (std::vector<std::string>::size_type i = 0; i < possible_paths.size(); i++)
+  if (it != dataPaths.end())
   {
-    if (FileSysTools::fileExists(possible_paths[i]))
+    path = it->second;
+  }
+  else
+  {
+    std::vector<std::string> possible_paths;
+    FileSysTools::getSearchPathList(possible_paths, item);
+
+    for (std::vector<std::string>::size_type i = 0; i < possible_paths.size(); i++)
     {
-      path = possible_paths[i];
-      break;
+      if (isInDirIndex(possible_paths[i]))
+      {
+        path = possible_paths[i];
+        break;
+      }
+    }
+
+    for (std::vector<Archive*>::size_type i = 0; i < archives.size() && path == ""; i++)
+    {
+      if (archives[i]->contains(item))
+        path = archives[i]->getPath() + "/" + item;
     }
+
+    // a path which has been returned for a file in an archive
+    std::string archived;
+    if (path == "" && !archives.empty() && findArchiveUnlocked(item, archived) != NULL)
+      path = item;
+
+    dataPaths[item] = path;
   }
+
   if ((path == "") && (fThrowEx))
   {
     // well..maybe another type of exception might be better here...
@@ -254,3 +430,60 @@ std::string FileSysTools::getDataPath(std::string item, bool fThrowEx)
 
   return(path);
 }
+
+// see header
+void FileSysTools::invalidateDataPaths()
+{
+  T_CacheLock lock;
+
+  dirIndex.clear();
+  dataPaths.clear();
+}
+
+// see header
+void FileSysTools::mount(Archive* archive)
+{
+  T_CacheLock lock;
+
+  archives.push_back(archive);
+  dataPaths.clear();
+}
+
+// see header
+void FileSysTools::unmount(Archive* archive)
+{
+  T_CacheLock lock;
+
+  for (std::vector<Archive*>::iterator it = archives.begin(); it != archives.end(); it++)
+  {
+    if (*it == archive)
+    {
+      archives.erase(it);
+      break;
+    }
+  }
+  dataPaths.clear();
+}
+
+// see header
+FileSysTools::Archive* FileSysTools::findArchive(const std::string& path, std::string& item)
+{
+  T_CacheLock lock;
+
+  return (findArchiveUnlocked(path, item));
+}
+
+// see header
+void FileSysTools::getArchiveFiles(std::vector<std::string>& filelist, std::string dirname)
+{
+  T_CacheLock lock;
+
+  for (std::vector<Archive*>::size_type i = 0; i < archives.size(); i++)
+  {
+    std::vector<std::string> items;
+
+    archives[i]->list(dirname, items);
+    for (std::vector<std::string>::size_type n = 0; n < items.size(); n++)
+      filelist.push_back(archives[i]->getPath() + "/" + items[n]);
+  }
+}
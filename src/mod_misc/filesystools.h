@@ -58,9 +58,82 @@ public:
    *  \param fThrowEx   if set to true, an exception will be thrown if no
    *                    matching file was found
    *
+   *  May be used by several threads at the same time.
+   *
    *  \return absolute path to the file, empty string on error
    */
   static std::string getDataPath(std::string item, bool fThrowEx = false);
+
+  /**
+   * getDataPath() reads each directory of the search path once, when a
+   * file in it is looked for the first time, and remembers what it has
+   * found for each item. This makes it forget everything, so that files
+   * which have been added or removed since then are found (or not).
+   */
+  static void invalidateDataPaths();
+
+  /**
+   * An indexed archive of data files which can be mounted as one more
+   * entry of the search path, see mount(). getDataPath() returns
+   * <code>getPath() + "/" + item</code> for a file in an archive.
+   */
+  class Archive
+  {
+  public:
+    virtual ~Archive() {};
+
+    /// path of the archive file
+    virtual std::string getPath() = 0;
+
+    /// true if the archive contains <code>item</code> (like "sounds/fan.wav")
+    virtual bool contains(const std::string& item) = 0;
+
+    /**
+     * Returns the contents of <code>item</code> and sets <code>len</code>
+     * to its length, NULL if there is no such item. The data has to be
+     * passed to close() when it isn't needed anymore.
+     */
+    virtual const char* open(const std::string& item, unsigned long& len) = 0;
+
+    /**
+     * Releases data returned by open().
+     */
+    virtual void close(const char* data) = 0;
+
+    /**
+     * Adds all items in the directory <code>dir</code> (like "models")
+     * to <code>items</code>, without those in subdirectories.
+     */
+    virtual void list(const std::string& dir, std::vector<std::string>& items) = 0;
+  };
+
+  /**
+   * Adds an archive behind all directories of the search path. Files
+   * in a directory are found first, so they override the archive.
+   * The archive is not deleted by FileSysTools. Archives have to be
+   * mounted and unmounted while no other thread reads data files.
+   */
+  static void mount(Archive* archive);
+
+  /**
+   * Removes an archive from the search path.
+   */
+  static void unmount(Archive* archive);
+
+  /**
+   * If <code>path</code> has been returned by getDataPath() for a file
+   * in a mounted archive, this returns the archive and sets
+   * <code>item</code> to the name of the file in the archive.
+   * Returns NULL otherwise.
+   */
+  static Archive* findArchive(const std::string& path, std::string& item);
+
+  /**
+   * Adds the files in the directory <code>dirname</code> (like "models")
+   * of all mounted archives to <code>filelist</code>, as paths like
+   * getDataPath() returns them.
+   */
+  static void getArchiveFiles(std::vector<std::string>& filelist, std::string dirname);
   
   /**
    * Provide a list of possible locations for data files or
@@ -79,7 +152,7 @@ public:
                                 std::string dirname = "");
   
   /**
-   *  Test if a file exists.
+   *  Test if a file exists. This includes files in mounted archives.
    *
    *  \param  path   File name and path to test.
    *  \retval true   if file exists
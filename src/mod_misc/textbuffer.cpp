@@ -0,0 +1,56 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file textbuffer.cpp
+ *
+ *  Implementation of TextBuffer.
+ */
+
+#include "textbuffer.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+
+void TextBuffer::append(const char* str)
+{
+  while (*str != '\0' && nLength < SIZE - 1)
+    text[nLength++] = *str++;
+  text[nLength] = '\0';
+}
+
+void TextBuffer::appendf(const char* format, ...)
+{
+  va_list ap;
+  int     n;
+
+  va_start(ap, format);
+  n = vsnprintf(text + nLength, SIZE - nLength, format, ap);
+  va_end(ap);
+
+  // n is the length of the complete text, even if it was cut off
+  // (or negative on old C libraries).
+  if (n < 0 || nLength + n > SIZE - 1)
+    nLength = SIZE - 1;
+  else
+    nLength += n;
+  text[nLength] = '\0';
+}
@@ -0,0 +1,73 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file textbuffer.h
+ *
+ *  Fixed size text buffer for text which is rebuilt every frame.
+ */
+#ifndef TEXTBUFFER_H
+#define TEXTBUFFER_H
+
+/**
+ * Like a std::string that is only appended to and cleared, but
+ * without any heap allocation. Text that doesn't fit is cut off.
+ */
+class TextBuffer
+{
+  public:
+    enum { SIZE = 512 };
+
+    TextBuffer() { clear(); }
+
+    /**
+     * Empties the buffer.
+     */
+    void clear()
+    {
+      nLength = 0;
+      text[0] = '\0';
+    }
+
+    /**
+     * Appends a string.
+     */
+    void append(const char* str);
+
+    /**
+     * Appends printf()-style formatted text.
+     */
+    void appendf(const char* format, ...)
+#ifdef __GNUC__
+      __attribute__ ((format (printf, 2, 3)))
+#endif
+      ;
+
+    const char* c_str() const { return(text); }
+
+    int length() const { return(nLength); }
+
+  private:
+    char text[SIZE];
+    int  nLength;
+};
+
+#endif
@@ -172,6 +172,7 @@ void HandlerF3F::display_infos(GLfloat ww, GLfloat hh)
   int iturn = 0;
   int ilost = 0;
   char astring[256];
+  char line[256];
   
   window_xsize=ww;
   window_ysize=hh;
@@ -219,9 +220,10 @@ void HandlerF3F::display_infos(GLfloat ww, GLfloat hh)
     GLfloat a_width = textLength("a");            /// \todo rather use height("X") than width("a")
 
     // start time
+    snprintf (line, sizeof(line), "Run started: %s", start_time.c_str());
     output (window_xsize - header_length,
             window_ysize - y_offset - 8 * a_width,
-            (std::string("Run started: ") + start_time).c_str());
+            line);
     
     // lap statistics
     output (window_xsize - header_length, 
@@ -239,9 +241,10 @@ void HandlerF3F::display_infos(GLfloat ww, GLfloat hh)
     }
     
     // end time
+    snprintf (line, sizeof(line), "Run finished: %s", end_time.c_str());
     output (window_xsize - header_length,
             window_ysize - (y_offset + 34 * a_width), 
-            (std::string("Run finished: ") + end_time).c_str());
+            line);
     
   }
   else
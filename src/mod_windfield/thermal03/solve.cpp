@@ -26,11 +26,6 @@
 #include <math.h>
 #include <stdlib.h>
 
-// Init of static members:
-flttype      SolveFourthOrder::precmin = 1.0;
-unsigned int SolveFourthOrder::loopmax = 0;
-
-
 const flttype valmin = 0.7;
 const flttype valmax = 1.3;
 
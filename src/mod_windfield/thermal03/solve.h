@@ -34,6 +34,8 @@
 class SolveFourthOrder
 {
   public:
+   SolveFourthOrder() : precmin(1.0), loopmax(0) {};
+
    flttype n0;
    flttype n1;
    flttype n2;
@@ -47,8 +49,12 @@ class SolveFourthOrder
    flttype yi[5];
    unsigned int     anz;
       
-   static flttype      precmin;
-   static unsigned int loopmax;
+   /**
+    * Statistics, kept per instance so that copies of a ThermikSchalen
+    * can be used in different threads.
+    */
+   flttype      precmin;
+   unsigned int loopmax;
    
    flttype ell_p1;
    flttype ell_p2;
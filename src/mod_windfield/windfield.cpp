@@ -33,6 +33,7 @@
 #include "../include_gl.h"
 #include <math.h>
 #include <stdio.h>
+#include <vector>
 #include <plib/ssg.h>   // for ssgSimpleState
 #include "../mod_windfield_config.h"
 #include "../mod_misc/ls_constants.h"
@@ -199,6 +200,26 @@ static ssgSimpleState   *td_state_blend   = NULL;
  */
 static GLUquadricObj *therm_quadric;
 
+/**
+ *  Display lists with the unit meshes used to draw thermals,
+ *  see makeThermalLists().
+ */
+enum
+{
+  TL_MARKER = 0,  ///< sphere of radius 1
+  TL_DISK,        ///< disk of radius 1 in the x/y plane
+  TL_RING,        ///< outer part of the thermal, outer radius 1
+  TL_WIND_DISK,   ///< background of the wind indicator, radius 1
+  TL_COUNT
+};
+static GLuint thermal_lists = 0;
+
+/**
+ *  Thermals to be drawn in this frame, kept to avoid
+ *  allocations in draw_thermals().
+ */
+static std::vector<Thermal*> visible_thermals;
+
 /**
  * calculates grid coordinate from absolute coordinate
  */
@@ -383,6 +404,13 @@ void clear_wind_field()
   delete td_state_blend;
   td_state_blend = NULL;
 
+  if (thermal_lists != 0)
+  {
+    glDeleteLists(thermal_lists, TL_COUNT);
+    thermal_lists = 0;
+  }
+  visible_thermals.clear();
+
   gluDeleteQuadric(therm_quadric);
 }
 
@@ -569,6 +597,14 @@ void update_thermals(float flDeltaT)
 // Description: see header file
 int calculate_wind(double  X_cg,      double  Y_cg,     double  Z_cg,
                    double& Vel_north, double& Vel_east, double& Vel_down)
+{
+  return calculate_wind(X_cg, Y_cg, Z_cg, Vel_north, Vel_east, Vel_down, thermalv3);
+}
+
+// Description: see header file
+int calculate_wind(double  X_cg,      double  Y_cg,     double  Z_cg,
+                   double& Vel_north, double& Vel_east, double& Vel_down,
+                   ThermikSchalen& tv3)
 {
   float    x_wind_velocity,y_wind_velocity,z_wind_velocity;//JL
   Thermal* thermal_ptr;
@@ -622,7 +658,7 @@ int calculate_wind(double  X_cg,      double  Y_cg,     double  Z_cg,
           {
            case 3:
             thermal_ptr->sumVelocity(X_cg, Y_cg, Z_cg,
-                                     thermalv3,
+                                     tv3,
                                      thermal_wind_x, thermal_wind_y, Vel_down);
             break;
 
@@ -741,6 +777,41 @@ int calculate_wind(double  X_cg,      double  Y_cg,     double  Z_cg,
   }
 }
 
+/**
+ *  Build the display lists for thermal drawing. The geometry only
+ *  depends on compile time constants, so it is generated once and
+ *  scaled for each thermal.
+ */
+static void makeThermalLists()
+{
+  thermal_lists = glGenLists(TL_COUNT);
+
+  glNewList(thermal_lists + TL_MARKER, GL_COMPILE);
+  gluSphere(therm_quadric, 1, 3, 3);
+  glEndList();
+
+  glNewList(thermal_lists + TL_DISK, GL_COMPILE);
+  gluDisk(therm_quadric, 0, 1, 16, 1);
+  glEndList();
+
+  glNewList(thermal_lists + TL_RING, GL_COMPILE);
+#if (THERMAL_CODE == 1)
+  {
+    // The whole radius of the thermal is limited to not get annoying.
+    double RadiusInnerPartRel = ThermalRadius;
+    if (RadiusInnerPartRel < 0.4)
+      RadiusInnerPartRel = 0.4;
+
+    gluDisk(therm_quadric, RadiusInnerPartRel, 1, 16, 1);
+  }
+#endif
+  glEndList();
+
+  glNewList(thermal_lists + TL_WIND_DISK, GL_COMPILE);
+  gluDisk(therm_quadric, 0, 1, 32, 1);
+  glEndList();
+}
+
 // Description: see header file
 void draw_thermals(CRRCMath::Vector3 pos)
 {
@@ -750,6 +821,22 @@ void draw_thermals(CRRCMath::Vector3 pos)
   double Y_cg_rwy =  pos.r[1];
   double H_cg_rwy = -pos.r[2];
 
+#if THERMAL_TEST != 0
+  if (H_cg_rwy < 3*dAltitudeFullStrength)
+    H_cg_rwy = 3*dAltitudeFullStrength;
+#endif
+
+#if (THERMAL_CODE == 1)
+  // thermals are invisible below this height
+  if (H_cg_rwy <= dAltitudeZeroStrength)
+    return;
+#endif
+
+  if (thermal_lists == 0)
+    makeThermalLists();
+
+  visible_thermals.clear();
+
   if (nDrawThermalsFromGrid)
   {
     // grid coordinates of aircraft
@@ -777,7 +864,7 @@ void draw_thermals(CRRCMath::Vector3 pos)
         thermal_ptr = thermal_occupancy_grid[x][y];
         if (thermal_ptr != NULL)
         {
-          thermal_ptr->draw(H_cg_rwy);
+          visible_thermals.push_back(thermal_ptr);
         }
       }
   }
@@ -789,12 +876,30 @@ void draw_thermals(CRRCMath::Vector3 pos)
       if (fabs(X_cg_rwy - thermal_ptr->center_x_position) < flThermalDistMax &&
           fabs(Y_cg_rwy - thermal_ptr->center_y_position) < flThermalDistMax)
       {
-        thermal_ptr->draw(H_cg_rwy);
+        visible_thermals.push_back(thermal_ptr);
       }
       thermal_ptr = thermal_ptr->next_thermal;
     }
   }
 
+  if (visible_thermals.size() == 0)
+    return;
+
+  // All opaque markers first, then all translucent areas, so that
+  // the OpenGL state only changes twice per frame.
+  td_state_noblend->apply();
+  glColor4f(1,0,0,1);
+  for (unsigned int i = 0; i < visible_thermals.size(); i++)
+  {
+    visible_thermals[i]->drawMarker(H_cg_rwy);
+  }
+
+  td_state_blend->apply();
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  for (unsigned int i = 0; i < visible_thermals.size(); i++)
+  {
+    visible_thermals[i]->drawArea(H_cg_rwy);
+  }
 }
 
 void draw_wind(double direction_face)
@@ -822,9 +927,14 @@ void draw_wind(double direction_face)
 
   // Hintergrund
   glColor3f (0, 0, 0);
+  if (thermal_lists == 0)
+    makeThermalLists();
+  glPushMatrix();
   glTranslatef(window_xsize-r-h/2, r+h/2, 0);
-  gluDisk(therm_quadric, 0, h/2, 32, 1);
-  glTranslatef(-(window_xsize-r-h/2),-(r+h/2),0.1);
+  glScalef(h/2, h/2, 1);
+  glCallList(thermal_lists + TL_WIND_DISK);
+  glPopMatrix();
+  glTranslatef(0, 0, 0.1);
 
   // Anzeiger
   glColor3f (0, 1, 0.);
@@ -1202,59 +1312,60 @@ double Thermal::getVelocity(double dX, double dY, double dZ)
 #endif
 
 /**
- *  Draws a thermal
+ *  Draws the opaque marker in the center of the thermal.
+ *  The caller sets up the OpenGL state, see draw_thermals().
  *
  *  \param H_cg_rwy height at which the thermal shall be drawn
  */
-void Thermal::draw(double H_cg_rwy)
+void Thermal::drawMarker(double H_cg_rwy)
 {
-#if THERMAL_TEST != 0
-  if (H_cg_rwy < 3*dAltitudeFullStrength)
-    H_cg_rwy = 3*dAltitudeFullStrength;
-#endif
-
   glPushMatrix();
-  td_state_noblend->apply();
+  glTranslatef(center_y_position, H_cg_rwy, -center_x_position);
+  glCallList(thermal_lists + TL_MARKER);
+  glPopMatrix();
+}
 
-#if (THERMAL_CODE == 0)
-  glColor4f(1,0,0,1);
+/**
+ *  Draws the translucent area of the thermal.
+ *  The caller sets up the OpenGL state, see draw_thermals().
+ *
+ *  \param H_cg_rwy height at which the thermal shall be drawn
+ */
+void Thermal::drawArea(double H_cg_rwy)
+{
+  glPushMatrix();
   glTranslatef(center_y_position, H_cg_rwy, -center_x_position);
-  gluSphere(therm_quadric,1,3,3);
-  td_state_blend->apply();
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   glRotatef(90,1,0,0);
+
+#if (THERMAL_CODE == 0)
   glColor4f(0.4,0,0,0.2);
-  gluDisk(therm_quadric,0, radius + boundary_thickness,16,1);
+  glScalef(radius + boundary_thickness, radius + boundary_thickness, 1);
+  glCallList(thermal_lists + TL_DISK);
 #endif
 
 #if (THERMAL_CODE == 1)
-  if (H_cg_rwy > dAltitudeZeroStrength)
-  {
-    double strength_height;
+  double strength_height;
 
-    if (H_cg_rwy < dAltitudeFullStrength)
-      strength_height = 0.2 * (H_cg_rwy - dAltitudeZeroStrength) / (dAltitudeFullStrength - dAltitudeZeroStrength);
-    else
-      strength_height = 0.2;
+  if (H_cg_rwy < dAltitudeFullStrength)
+    strength_height = 0.2 * (H_cg_rwy - dAltitudeZeroStrength) / (dAltitudeFullStrength - dAltitudeZeroStrength);
+  else
+    strength_height = 0.2;
 
-    glColor4f(1,0,0,1);
-    glTranslatef(center_y_position, H_cg_rwy, -center_x_position);
-    gluSphere(therm_quadric,1,3,3);
-    td_state_blend->apply();
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glRotatef(90,1,0,0);
-    glColor4f(0.4,0,0, strength_height);
-    gluDisk(therm_quadric,0, radius, 16, 1);
+  glPushMatrix();
+  glColor4f(0.4,0,0, strength_height);
+  glScalef(radius, radius, 1);
+  glCallList(thermal_lists + TL_DISK);
+  glPopMatrix();
 
-    // The whole radius of the thermal is limited to not get annoying.
-    double RadiusInnerPartRel = ThermalRadius;
-    if (RadiusInnerPartRel < 0.4)
-      RadiusInnerPartRel = 0.4;
+  // The whole radius of the thermal is limited to not get annoying.
+  double RadiusInnerPartRel = ThermalRadius;
+  if (RadiusInnerPartRel < 0.4)
+    RadiusInnerPartRel = 0.4;
 
-    double dRadius = radius / RadiusInnerPartRel;
-    glColor4f(0,0.4,0, strength_height);
-    gluDisk(therm_quadric, radius, dRadius, 16,1);
-  }
+  double dRadius = radius / RadiusInnerPartRel;
+  glColor4f(0,0.4,0, strength_height);
+  glScalef(dRadius, dRadius, 1);
+  glCallList(thermal_lists + TL_RING);
 #endif
   glPopMatrix();
 }
@@ -1294,6 +1405,11 @@ void Thermal::sumVelocity(double X_cg, double Y_cg, double Z_cg,
   Vel_east  += veast;
 }
 
+ThermikSchalen windfield_copyThermalModel()
+{
+  return(thermalv3);
+}
+
 double getMaxThermalDensity()
 {
   return(1.0 / (
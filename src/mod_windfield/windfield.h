@@ -81,8 +81,11 @@ class Thermal
      */    
     double getVelocity(double dX, double dY, double dZ);
     
-    /// draw the thermal
-    void draw(double H_cg_rwy);
+    /// draw the marker in the center of the thermal (opaque)
+    void drawMarker(double H_cg_rwy);
+
+    /// draw the area of the thermal (translucent)
+    void drawArea(double H_cg_rwy);
 };
 //} Thermal;
 
@@ -117,6 +120,22 @@ void update_thermals(float flDeltaT);
 int calculate_wind(double  X_cg,      double  Y_cg,     double  Z_cg,
                    double& Vel_north, double& Vel_east, double& Vel_down);
 
+/**
+ * Same as above, but uses the given thermal model (version 3) instead of
+ * the global one. The model keeps intermediate results while calculating,
+ * so threads which sample the windfield at the same time need a copy each
+ * (see windfield_copyThermalModel()). The windfield must not be updated
+ * while other threads sample it.
+ */
+int calculate_wind(double  X_cg,      double  Y_cg,     double  Z_cg,
+                   double& Vel_north, double& Vel_east, double& Vel_down,
+                   ThermikSchalen& tv3);
+
+/**
+ * Returns a copy of the current thermal model (version 3)
+ */
+ThermikSchalen windfield_copyThermalModel();
+
 
 /** \brief Draw the thermals.
  *
@@ -0,0 +1,286 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file windfield_dump.cpp
+ *
+ *  Implementation of the windfield export.
+ */
+
+#include "windfield_dump.h"
+#include "windfield.h"
+#include "thermal03/tschalen.h"
+
+#include "../crrc_main.h"
+#include "../global.h"
+#include "../aircraft.h"
+#include "../mod_misc/SimpleXMLTransfer.h"
+
+#include <SDL.h>
+#ifndef WIN32
+# include <unistd.h>   // sysconf
+#endif
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <limits>
+#include <new>
+
+
+/**
+ *  The grid and the result, shared by all threads
+ */
+typedef struct
+{
+  int        n[3];        ///< number of points north/east/height
+  double     origin[3];   ///< first point, north/east/down in ft
+  double     step[3];     ///< distance between points, north/east/down in ft
+  float*     data;        ///< n[2] x n[1] x n[0] x 3 values
+  int        next_row;    ///< next row (line in north direction) to sample, protected by mutex
+  long       outside;     ///< points outside of the thermal grid, protected by mutex
+  SDL_mutex* mutex;
+} T_DumpJob;
+
+
+/**
+ *  Number of processors available, used as default number of threads
+ */
+static int getNumberOfProcessors()
+{
+#ifdef WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return ((int)info.dwNumberOfProcessors);
+#else
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return ((n > 0) ? (int)n : 1);
+#endif
+}
+
+
+/**
+ *  Worker thread: takes one row after the other until all rows are done.
+ *  A row is small enough to balance the load between the threads and
+ *  large enough to make the locking negligible.
+ */
+static int dumpThread(void* data)
+{
+  T_DumpJob*     job     = (T_DumpJob*)data;
+  ThermikSchalen tv3     = windfield_copyThermalModel();
+  const int      nRows   = job->n[1] * job->n[2];
+  const float    nan     = std::numeric_limits<float>::quiet_NaN();
+  long           outside = 0;
+
+  while (true)
+  {
+    SDL_LockMutex(job->mutex);
+    int row = job->next_row++;
+    SDL_UnlockMutex(job->mutex);
+
+    if (row >= nRows)
+      break;
+
+    double y   = job->origin[1] + (row % job->n[1]) * job->step[1];
+    double z   = job->origin[2] + (row / job->n[1]) * job->step[2];
+    float* out = job->data + (size_t)row * job->n[0] * 3;
+
+    for (int i = 0; i < job->n[0]; i++)
+    {
+      double x = job->origin[0] + i * job->step[0];
+      double vn, ve, vd;
+
+      if (calculate_wind(x, y, z, vn, ve, vd, tv3) == 0)
+      {
+        out[0] = vn;
+        out[1] = ve;
+        out[2] = vd;
+      }
+      else
+      {
+        out[0] = out[1] = out[2] = nan;
+        outside++;
+      }
+      out += 3;
+    }
+  }
+
+  SDL_LockMutex(job->mutex);
+  job->outside += outside;
+  SDL_UnlockMutex(job->mutex);
+
+  return 0;
+}
+
+
+/**
+ *  Write a float array in NumPy format (version 1.0)
+ */
+static bool writeNpy(const std::string& file, const float* data, int nHeight, int nEast, int nNorth)
+{
+  FILE* fp = fopen(file.c_str(), "wb");
+
+  if (fp == NULL)
+    return false;
+
+  // byte order of this machine
+  unsigned short test   = 1;
+  char           endian = (*(unsigned char*)&test == 1) ? '<' : '>';
+  char           dict[200];
+
+  snprintf(dict, sizeof(dict),
+           "{'descr': '%cf4', 'fortran_order': False, 'shape': (%d, %d, %d, 3), }",
+           endian, nHeight, nEast, nNorth);
+
+  // magic string, version, header length and header, padded with
+  // spaces and a newline so that the data is aligned to 64 bytes
+  std::string header = dict;
+  while ((10 + header.length() + 1) % 64)
+    header += ' ';
+  header += '\n';
+
+  unsigned char preamble[10] = { 0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                                 (unsigned char)(header.length() & 0xFF),
+                                 (unsigned char)(header.length() >> 8) };
+
+  size_t size = (size_t)nHeight * nEast * nNorth * 3;
+
+  fwrite(preamble, 1, sizeof(preamble), fp);
+  fwrite(header.c_str(), 1, header.length(), fp);
+  fwrite(data, sizeof(float), size, fp);
+
+  bool ok = (ferror(fp) == 0);
+  if (fclose(fp) != 0)
+    ok = false;
+
+  return ok;
+}
+
+
+// see header
+bool windfield_dump_enabled(SimpleXMLTransfer* cfg)
+{
+  return (cfg->getString("windfield.dump.file", "").length() > 0);
+}
+
+
+// see header
+int windfield_dump(SimpleXMLTransfer* cfg)
+{
+  CRRCMath::Vector3 pos      = Global::aircraft->getPos();
+  std::string       file     = cfg->getString("windfield.dump.file", "");
+  int               nThreads = cfg->getInt("windfield.dump.threads", 0);
+  T_DumpJob         job;
+  double            center[3];
+  double            size[3];
+
+  center[0] = cfg->getDouble("windfield.dump.center_north",  pos.r[0]);
+  center[1] = cfg->getDouble("windfield.dump.center_east",   pos.r[1]);
+  center[2] = cfg->getDouble("windfield.dump.center_height", -pos.r[2]);
+  size[0]   = cfg->getDouble("windfield.dump.size_north",  400.0);
+  size[1]   = cfg->getDouble("windfield.dump.size_east",   400.0);
+  size[2]   = cfg->getDouble("windfield.dump.size_height", 0.0);
+  job.n[0]  = cfg->getInt("windfield.dump.n_north",  101);
+  job.n[1]  = cfg->getInt("windfield.dump.n_east",   101);
+  job.n[2]  = cfg->getInt("windfield.dump.n_height", 1);
+
+  // height is up, the windfield wants down
+  center[2] = -center[2];
+  size[2]   = -size[2];
+
+  for (int i = 0; i < 3; i++)
+  {
+    if (job.n[i] < 1)
+      job.n[i] = 1;
+    if (job.n[i] > 1)
+    {
+      job.origin[i] = center[i] - 0.5 * size[i];
+      job.step[i]   = size[i] / (job.n[i] - 1);
+    }
+    else
+    {
+      job.origin[i] = center[i];
+      job.step[i]   = 0;
+    }
+  }
+
+  if (nThreads < 1)
+    nThreads = getNumberOfProcessors();
+
+  size_t             nPoints = (size_t)job.n[0] * job.n[1] * job.n[2];
+  std::vector<float> data;
+
+  try
+  {
+    data.resize(nPoints * 3);
+  }
+  catch (std::bad_alloc& e)
+  {
+    fprintf(stderr, "Windfield dump: not enough memory for %lu points\n",
+            (unsigned long)nPoints);
+    return 1;
+  }
+
+  job.data     = &data[0];
+  job.next_row = 0;
+  job.outside  = 0;
+  job.mutex    = SDL_CreateMutex();
+
+  printf("Windfield dump: %d x %d x %d points (north x east x height), %d threads\n",
+         job.n[0], job.n[1], job.n[2], nThreads);
+
+  Uint32 t0 = SDL_GetTicks();
+
+  std::vector<SDL_Thread*> threads;
+  for (int i = 1; i < nThreads; i++)
+  {
+    SDL_Thread* thread = SDL_CreateThread(dumpThread, &job);
+    if (thread != NULL)
+      threads.push_back(thread);
+  }
+  // this thread takes part, too
+  dumpThread(&job);
+  for (unsigned int i = 0; i < threads.size(); i++)
+    SDL_WaitThread(threads[i], NULL);
+
+  Uint32 t1 = SDL_GetTicks();
+
+  SDL_DestroyMutex(job.mutex);
+
+  printf("Windfield dump: sampled in %.2f s", 0.001 * (t1 - t0));
+  if (job.outside > 0)
+    printf(", %ld points outside of the thermal grid (NaN)", job.outside);
+  printf("\n");
+
+  // how to map the array indices back to positions
+  printf("  axis 0: height %.2f ft + i * %.4f ft\n", -job.origin[2], -job.step[2]);
+  printf("  axis 1: east   %.2f ft + j * %.4f ft\n",  job.origin[1],  job.step[1]);
+  printf("  axis 2: north  %.2f ft + k * %.4f ft\n",  job.origin[0],  job.step[0]);
+  printf("  axis 3: v_north, v_east, v_down in ft/s\n");
+
+  if (!writeNpy(file, job.data, job.n[2], job.n[1], job.n[0]))
+  {
+    fprintf(stderr, "Windfield dump: unable to write %s\n", file.c_str());
+    return 1;
+  }
+  printf("Windfield dump written to %s\n", file.c_str());
+
+  return 0;
+}
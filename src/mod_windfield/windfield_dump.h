@@ -0,0 +1,56 @@
+/*
+ * CRRCsim - the Charles River Radio Control Club Flight Simulator Project
+ *
+ * Copyright (C) 2026 The CRRCsim developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+
+/** \file windfield_dump.h
+ *
+ *  Export of the windfield: samples a 2D slice or a 3D volume
+ *  of the windfield and writes it to a NumPy (.npy) file.
+ */
+
+#ifndef WINDFIELD_DUMP_H
+#define WINDFIELD_DUMP_H
+
+class SimpleXMLTransfer;
+
+/**
+ *  Returns true if a windfield dump has been requested
+ *  (windfield.dump.file is set, see command line option -e).
+ */
+bool windfield_dump_enabled(SimpleXMLTransfer* cfg);
+
+/**
+ *  Sample the windfield on a regular grid and write it to
+ *  windfield.dump.file. The scenery, the windfield and the airplane
+ *  must have been initialized. The work is split between several
+ *  threads, the windfield is not updated meanwhile.
+ *
+ *  The grid is an array of n_height x n_east x n_north points
+ *  centered around the airplane or a given position. If one of
+ *  the dimensions is 1, the result is a slice.
+ *  See documentation/options.txt.
+ *
+ *  \param cfg configuration
+ *  \return 0 on success
+ */
+int windfield_dump(SimpleXMLTransfer* cfg);
+
+#endif